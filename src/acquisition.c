@@ -0,0 +1,293 @@
+/**
+ * @file acquisition.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Block-based sample acquisition decoupled from the network tasks
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "acquisition.h"
+#include "sample_ring.h"
+#include "adc_lut.h"
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+_Static_assert((ACQ_RING_BLOCKS & (ACQ_RING_BLOCKS - 1)) == 0, "CONFIG_ACQ_RING_BLOCKS must be a power of two");
+_Static_assert((ACQ_DECIMATION_RATIO & (ACQ_DECIMATION_RATIO - 1)) == 0, "CONFIG_ACQ_DECIMATION_RATIO must be a power of two");
+
+static const acq_source_t* acq_source = NULL;
+static TaskHandle_t acq_task = NULL;
+
+// Blocks shared with the consumer task
+static sample_block_t ring_slots[ACQ_RING_BLOCKS];
+static sample_ring_t block_ring;
+static TaskHandle_t consumer_task = NULL;
+
+static uint32_t blocks_produced = 0;
+
+// Source faults
+static volatile bool source_running = false;
+static uint32_t read_timeouts = 0;
+static uint32_t source_restarts = 0;
+
+// Channel table. Channel 0 is enabled by default to match the original single-channel setup.
+static acq_channel_config_t channel_table[ACQ_ADC_CHANNELS];
+static portMUX_TYPE channel_table_lock = portMUX_INITIALIZER_UNLOCKED;
+static volatile bool scan_changed = false;
+
+// Scan currently running on the source
+static acq_scan_t active_scan;
+static uint16_t active_mask = 0;
+static uint32_t active_scan_id = 0;
+
+static esp_err_t init_channel_table(void) {
+    const uint16_t* lut = adc_lut_get(ADC_ATTEN_DB_11);
+    if(lut == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    for(int i = 0; i < ACQ_ADC_CHANNELS; i++) {
+        channel_table[i].channel = (adc_channel_t) i;
+        channel_table[i].atten = ADC_ATTEN_DB_11;
+        channel_table[i].enabled = (i == 0);
+        channel_table[i].lut = lut;
+    }
+    return ESP_OK;
+}
+
+// Build the scan pattern from the enabled entries of the channel table
+static void build_scan(acq_scan_t* scan, uint16_t* mask) {
+    scan->count = 0;
+    *mask = 0;
+
+    portENTER_CRITICAL(&channel_table_lock);
+    for(int i = 0; i < ACQ_ADC_CHANNELS && scan->count < ACQ_MAX_CHANNELS; i++) {
+        if(channel_table[i].enabled) {
+            scan->channels[scan->count] = channel_table[i].channel;
+            scan->atten[scan->count] = channel_table[i].atten;
+            scan->count++;
+            *mask |= 1 << i;
+        }
+    }
+    scan_changed = false;
+    portEXIT_CRITICAL(&channel_table_lock);
+}
+
+static esp_err_t start_scan(void) {
+    build_scan(&active_scan, &active_mask);
+    active_scan_id++;
+    if(active_scan.count == 0) {
+        ESP_LOGW(ACQ_TAG, "No channels enabled");
+        return ESP_OK;
+    }
+    return acq_source->start(ACQ_SAMPLE_RATE_HZ, &active_scan);
+}
+
+// Fills blocks from the source and hands them to the consumer through the ring. Never waits on the consumer.
+static void acquisition_task(void* pvParameters) {
+    // Target for blocks that find the ring full, so the source is still drained on time
+    static sample_block_t overrun_block;
+    uint32_t seq = 0;
+    uint32_t timeouts = 0;      // Consecutive reads that returned nothing
+    bool restart = false;       // Source stalled or failed to start
+
+    while(1) {
+        // Apply channel table changes between blocks so a block never mixes two scan patterns
+        if(scan_changed || restart) {
+            source_restarts += restart;
+            acq_source->stop();
+            esp_err_t err = start_scan();
+            restart = err != ESP_OK;
+            source_running = !restart;
+            timeouts = 0;
+            if(restart) {
+                ESP_LOGE(ACQ_TAG, "Failed to restart %s source, retrying. Error: %s", acq_source->name, esp_err_to_name(err));
+                active_scan.count = 0;
+            }
+        }
+
+        if(active_scan.count == 0) {
+            vTaskDelay(pdMS_TO_TICKS(restart ? ACQ_READ_TIMEOUT_MS : 100));
+            continue;
+        }
+
+        // Fill the next ring slot in place
+        sample_block_t* block = sample_ring_acquire(&block_ring);
+        if(block == NULL) {
+            block = &overrun_block;
+        }
+
+        block->count = 0;
+        while(block->count < ACQ_BLOCK_SIZE && !restart) {
+            size_t n = acq_source->read(&block->samples[block->count], ACQ_BLOCK_SIZE - block->count, ACQ_READ_TIMEOUT_MS);
+            block->count += n;
+            if(n > 0) {
+                timeouts = 0;
+                continue;
+            }
+
+            // A stalled source never reaches the block boundary, so a new scan is applied right away
+            read_timeouts++;
+            if(scan_changed) {
+                break;
+            }
+            if(++timeouts < ACQ_MAX_READ_TIMEOUTS) {
+                ESP_LOGW(ACQ_TAG, "Timed out waiting for samples from %s source", acq_source->name);
+                continue;
+            }
+            ESP_LOGE(ACQ_TAG, "No samples from %s source for %d ms, restarting it", acq_source->name,
+                ACQ_MAX_READ_TIMEOUTS * ACQ_READ_TIMEOUT_MS);
+            source_running = false;
+            restart = true;
+        }
+
+        // A block cut short by a restart or a scan change is discarded. Its sequence number
+        // is still used up, so the consumer sees the gap.
+        if(block->count < ACQ_BLOCK_SIZE) {
+            seq++;
+            continue;
+        }
+
+        block->seq = seq++;
+        block->timestamp_us = esp_timer_get_time();
+        block->channel_mask = active_mask;
+        block->scan_id = active_scan_id;
+        block->channel_count = active_scan.count;
+        for(int i = 0; i < active_scan.count; i++) {
+            block->channels[i] = (uint8_t) active_scan.channels[i];
+            block->atten[i] = (uint8_t) active_scan.atten[i];
+        }
+
+        if(block != &overrun_block) {
+            sample_ring_commit(&block_ring);
+            blocks_produced++;
+            if(consumer_task != NULL) {
+                xTaskNotifyGive(consumer_task);
+            }
+        }
+    }
+}
+
+esp_err_t acquisition_start(const acq_source_t* source) {
+    esp_err_t err;
+
+    if(source == NULL || acq_task != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    ESP_ERROR_CHECK(sample_ring_init(&block_ring, ring_slots, ACQ_RING_BLOCKS));
+
+    if((err = init_channel_table()) != ESP_OK) {
+        ESP_LOGE(ACQ_TAG, "Failed to build the calibration table. Error: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    acq_source = source;
+    if((err = start_scan()) != ESP_OK) {
+        ESP_LOGE(ACQ_TAG, "Failed to start %s source. Error: %s", acq_source->name, esp_err_to_name(err));
+        return err;
+    }
+    source_running = true;
+
+    ESP_LOGI(ACQ_TAG, "Sampling %s source at %d Hz per channel in blocks of %d frames", acq_source->name, ACQ_SAMPLE_RATE_HZ, ACQ_BLOCK_SIZE);
+
+    if(xTaskCreate(acquisition_task, "acquisition_task", 4096, NULL, 10, &acq_task) != pdPASS) {
+        acq_source->stop();
+        return ESP_ERR_NO_MEM;
+    }
+
+    return ESP_OK;
+}
+
+esp_err_t acquisition_set_channel(adc_channel_t channel, adc_atten_t atten, bool enabled) {
+    if(channel >= ACQ_ADC_CHANNELS || atten > ADC_ATTEN_DB_11) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Build the calibration table (once per attenuation) outside the lock
+    const uint16_t* lut = adc_lut_get(atten);
+    if(lut == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = ESP_OK;
+    portENTER_CRITICAL(&channel_table_lock);
+    int enabled_count = 0;
+    for(int i = 0; i < ACQ_ADC_CHANNELS; i++) {
+        if(channel_table[i].enabled && i != channel) {
+            enabled_count++;
+        }
+    }
+
+    if(enabled && enabled_count >= ACQ_MAX_CHANNELS) {
+        ret = ESP_ERR_INVALID_SIZE;
+    } else {
+        channel_table[channel].atten = atten;
+        channel_table[channel].enabled = enabled;
+        channel_table[channel].lut = lut;
+        scan_changed = true;
+    }
+    portEXIT_CRITICAL(&channel_table_lock);
+
+    return ret;
+}
+
+void acquisition_get_channels(acq_channel_config_t* table) {
+    portENTER_CRITICAL(&channel_table_lock);
+    memcpy(table, channel_table, sizeof(channel_table));
+    portEXIT_CRITICAL(&channel_table_lock);
+}
+
+esp_err_t acquisition_convert_block(const sample_block_t* block, uint16_t (*mv)[ACQ_MAX_CHANNELS]) {
+    const uint16_t* luts[ACQ_MAX_CHANNELS];
+
+    for(int slot = 0; slot < block->channel_count; slot++) {
+        luts[slot] = adc_lut_get(block->atten[slot]);
+        if(luts[slot] == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // One strided table pass per slot
+    for(int slot = 0; slot < block->channel_count; slot++) {
+        adc_lut_convert(luts[slot], &block->samples[0][slot], &mv[0][slot], block->count, ACQ_MAX_CHANNELS);
+    }
+    return ESP_OK;
+}
+
+const sample_block_t* acquisition_peek_block(uint32_t timeout_ms) {
+    // The first caller becomes the consumer woken by the acquisition task
+    if(consumer_task == NULL) {
+        consumer_task = xTaskGetCurrentTaskHandle();
+    }
+
+    const sample_block_t* block = sample_ring_peek(&block_ring);
+    if(block == NULL && ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) > 0) {
+        block = sample_ring_peek(&block_ring);
+    }
+    return block;
+}
+
+void acquisition_release_block(void) {
+    sample_ring_release(&block_ring);
+}
+
+void acquisition_get_status(acq_status_t* status) {
+    status->sample_rate_hz = ACQ_SAMPLE_RATE_HZ;
+    status->block_size = ACQ_BLOCK_SIZE;
+    status->channel_mask = active_mask;
+    status->blocks_produced = blocks_produced;
+    status->blocks_dropped = block_ring.overruns;
+    status->ring_blocks = ACQ_RING_BLOCKS;
+    status->ring_high_water = block_ring.high_water;
+    status->source_running = source_running;
+    status->read_timeouts = read_timeouts;
+    status->source_restarts = source_restarts;
+}
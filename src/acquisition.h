@@ -0,0 +1,149 @@
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
+#include "hal/adc_types.h"
+
+#define ACQ_TAG "acquisition"
+#define ACQ_SAMPLE_RATE_HZ CONFIG_ACQ_SAMPLE_RATE_HZ
+#define ACQ_BLOCK_SIZE CONFIG_ACQ_BLOCK_SIZE
+#define ACQ_RING_BLOCKS CONFIG_ACQ_RING_BLOCKS
+#define ACQ_MAX_CHANNELS CONFIG_ACQ_MAX_CHANNELS
+#define ACQ_DECIMATION_RATIO CONFIG_ACQ_DECIMATION_RATIO
+#define ACQ_ADC_CHANNELS SOC_ADC_MAX_CHANNEL_NUM
+#define ACQ_READ_TIMEOUT_MS 1000
+#define ACQ_MAX_READ_TIMEOUTS 3     // Consecutive empty reads before the source is restarted
+
+// Entry of the channel table
+typedef struct {
+    adc_channel_t channel;
+    adc_atten_t atten;
+    bool enabled;
+    const uint16_t* lut;    // Raw-to-millivolt table for the configured attenuation (see adc_lut.h)
+} acq_channel_config_t;
+
+// Channels converted in one pass of the scan pattern, in ascending channel order
+typedef struct {
+    uint8_t count;
+    adc_channel_t channels[ACQ_MAX_CHANNELS];
+    adc_atten_t atten[ACQ_MAX_CHANNELS];
+} acq_scan_t;
+
+// Block of raw ADC samples. Each frame holds one sample per scanned channel (one slot per channel).
+typedef struct {
+    uint32_t seq;           // Block sequence number (increments for every acquired block, including dropped ones)
+    int64_t timestamp_us;   // esp_timer time at which the last frame of the block was read
+    uint16_t count;         // Number of valid frames
+    uint16_t channel_mask;  // Bit n set when ADC channel n is scanned
+    uint32_t scan_id;       // Changes on every scan restart, attenuation-only changes included
+    uint8_t channel_count;  // Number of valid slots per frame
+    uint8_t channels[ACQ_MAX_CHANNELS];  // ADC channel of each slot
+    uint8_t atten[ACQ_MAX_CHANNELS];     // Attenuation of each slot
+    uint16_t samples[ACQ_BLOCK_SIZE][ACQ_MAX_CHANNELS];
+} sample_block_t;
+
+// Source of raw samples feeding the acquisition task
+typedef struct {
+    const char* name;
+
+    /**
+     * @brief Start scanning the given channels. frame_rate_hz is the rate per channel.
+     */
+    esp_err_t (*start)(uint32_t frame_rate_hz, const acq_scan_t* scan);
+
+    /**
+     * @brief Read up to len complete frames. Blocks for at most timeout_ms.
+     *
+     * @return size_t - number of frames written
+     */
+    size_t (*read)(uint16_t (*frames)[ACQ_MAX_CHANNELS], size_t len, uint32_t timeout_ms);
+
+    /**
+     * @brief Stop the source
+     */
+    void (*stop)(void);
+} acq_source_t;
+
+// Acquisition counters
+typedef struct {
+    uint32_t sample_rate_hz;
+    uint16_t block_size;
+    uint16_t channel_mask;
+    uint32_t blocks_produced;
+    uint32_t blocks_dropped;    // Ring overruns
+    uint32_t ring_blocks;
+    uint32_t ring_high_water;   // Most blocks ever waiting for the consumer
+    bool source_running;        // false while the source is stalled or failing to start
+    uint32_t read_timeouts;     // Reads that returned nothing within ACQ_READ_TIMEOUT_MS
+    uint32_t source_restarts;   // Restarts after ACQ_MAX_READ_TIMEOUTS consecutive timeouts or a failed start
+} acq_status_t;
+
+// Continuous (DMA) ADC source
+extern const acq_source_t acq_adc_source;
+
+// Synthetic waveform source
+extern const acq_source_t acq_mock_source;
+
+/**
+ * @brief Start the source and the acquisition task
+ *
+ * @param source - sample source (acq_adc_source or acq_mock_source)
+ * @return esp_err_t - ESP_ERR_NO_MEM if the default calibration table could not be built
+ */
+esp_err_t acquisition_start(const acq_source_t* source);
+
+/**
+ * @brief Update a channel table entry. Takes effect at the next block boundary.
+ *
+ * @param channel - ADC1 channel
+ * @param atten - input attenuation
+ * @param enabled - include the channel in the scan
+ * @return esp_err_t - ESP_ERR_INVALID_SIZE if enabling would exceed ACQ_MAX_CHANNELS,
+ *                     ESP_ERR_NO_MEM if the calibration table could not be built
+ */
+esp_err_t acquisition_set_channel(adc_channel_t channel, adc_atten_t atten, bool enabled);
+
+/**
+ * @brief Copy the channel table
+ *
+ * @param table - array of ACQ_ADC_CHANNELS entries
+ */
+void acquisition_get_channels(acq_channel_config_t* table);
+
+/**
+ * @brief Convert every sample of a block to millivolts using the calibration tables
+ *
+ * @param block - acquired block
+ * @param mv - output frames, at least block->count entries
+ * @return esp_err_t - ESP_ERR_NO_MEM if a calibration table could not be built (mv is left untouched)
+ */
+esp_err_t acquisition_convert_block(const sample_block_t* block, uint16_t (*mv)[ACQ_MAX_CHANNELS]);
+
+/**
+ * @brief Get the oldest acquired block without copying it. Single consumer only.
+ *
+ * The block stays valid until acquisition_release_block() is called.
+ *
+ * @param timeout_ms - maximum time to wait for a block
+ * @return const sample_block_t* - oldest block, or NULL on timeout
+ */
+const sample_block_t* acquisition_peek_block(uint32_t timeout_ms);
+
+/**
+ * @brief Hand the block returned by acquisition_peek_block() back to the acquisition task
+ */
+void acquisition_release_block(void);
+
+/**
+ * @brief Get the acquisition configuration and counters
+ *
+ * @param status
+ */
+void acquisition_get_status(acq_status_t* status);
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file adc_lut.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Precomputed raw-to-millivolt calibration tables
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "adc_lut.h"
+
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_adc_cal.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#define ADC_LUT_ATTEN_NUM (ADC_ATTEN_DB_11 + 1)
+
+static uint16_t* luts[ADC_LUT_ATTEN_NUM] = { NULL };
+static portMUX_TYPE lut_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint16_t* build_lut(adc_atten_t atten) {
+    uint16_t* lut = (uint16_t*) malloc(ADC_LUT_SIZE * sizeof(uint16_t));
+    if(lut == NULL) {
+        ESP_LOGE(ADC_LUT_TAG, "Failed to allocate table for atten %d", atten);
+        return NULL;
+    }
+
+    int64_t start_us = esp_timer_get_time();
+
+    esp_adc_cal_characteristics_t chars;
+    esp_adc_cal_characterize(ADC_UNIT_1, atten, ADC_WIDTH_BIT_DEFAULT, 0, &chars);
+    for(uint32_t raw = 0; raw < ADC_LUT_SIZE; raw++) {
+        lut[raw] = (uint16_t) esp_adc_cal_raw_to_voltage(raw, &chars);
+    }
+
+    ESP_LOGI(ADC_LUT_TAG, "Built table for atten %d in %lld us", atten, (long long) (esp_timer_get_time() - start_us));
+    return lut;
+}
+
+const uint16_t* adc_lut_get(adc_atten_t atten) {
+    if(atten < ADC_ATTEN_DB_0 || atten >= ADC_LUT_ATTEN_NUM) {
+        return NULL;
+    }
+
+    // Tables are never freed, so a published pointer can be read without the lock
+    if(luts[atten] != NULL) {
+        return luts[atten];
+    }
+
+    // Build outside the lock. If two callers race, the loser frees its copy.
+    uint16_t* lut = build_lut(atten);
+    if(lut == NULL) {
+        return NULL;
+    }
+
+    portENTER_CRITICAL(&lut_lock);
+    if(luts[atten] == NULL) {
+        luts[atten] = lut;
+        lut = NULL;
+    }
+    portEXIT_CRITICAL(&lut_lock);
+    free(lut);
+
+    return luts[atten];
+}
+
+void adc_lut_convert(const uint16_t* lut, const uint16_t* raw, uint16_t* mv, size_t n, size_t stride) {
+    for(size_t i = 0; i < n; i++) {
+        mv[i * stride] = lut[raw[i * stride] & (ADC_LUT_SIZE - 1)];
+    }
+}
+
+uint16_t adc_lut_find(const uint16_t* lut, uint16_t mv) {
+    // Tables are monotonic, so binary search for the first entry >= mv
+    uint16_t lo = 0;
+    uint16_t hi = ADC_LUT_SIZE;
+    while(lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if(lut[mid] < mv) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
@@ -0,0 +1,55 @@
+#ifndef ADC_LUT_H
+#define ADC_LUT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "hal/adc_types.h"
+
+#define ADC_LUT_TAG "adc_lut"
+#define ADC_LUT_SIZE 4096   // Every 12-bit raw code
+
+/**
+ * @brief Get the raw-to-millivolt table for an attenuation, building it on first use
+ *
+ * Tables are built once from the eFuse calibration characteristics and shared by every
+ * channel using the same attenuation. Each table costs ADC_LUT_SIZE * 2 bytes.
+ *
+ * @param atten - input attenuation
+ * @return const uint16_t* - ADC_LUT_SIZE entries, or NULL if out of memory
+ */
+const uint16_t* adc_lut_get(adc_atten_t atten);
+
+/**
+ * @brief Convert n raw samples to millivolts
+ *
+ * @param lut - table from adc_lut_get()
+ * @param raw - raw samples, stride elements apart
+ * @param mv - output, stride elements apart
+ * @param n - number of samples
+ * @param stride - distance between consecutive samples (1 for a packed array)
+ */
+void adc_lut_convert(const uint16_t* lut, const uint16_t* raw, uint16_t* mv, size_t n, size_t stride);
+
+/**
+ * @brief Find the smallest raw code that converts to at least mv
+ *
+ * @param lut - table from adc_lut_get()
+ * @param mv - voltage in mV
+ * @return uint16_t - raw code, or ADC_LUT_SIZE if no code reaches mv
+ */
+uint16_t adc_lut_find(const uint16_t* lut, uint16_t mv);
+
+/**
+ * @brief Convert a Q12.4 code (raw code with 4 fractional bits) to millivolts by interpolating the table
+ *
+ * @param lut - table from adc_lut_get()
+ * @param q4 - raw code << 4, e.g. decimator output
+ * @return uint16_t - voltage in mV
+ */
+static inline uint16_t adc_lut_interp_q4(const uint16_t* lut, uint16_t q4) {
+    uint16_t idx = q4 >> 4;
+    uint16_t next = idx < ADC_LUT_SIZE - 1 ? idx + 1 : idx;
+    return lut[idx] + (((int32_t) lut[next] - lut[idx]) * (q4 & 0xF) + 8) / 16;
+}
+
+#endif
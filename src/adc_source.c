@@ -0,0 +1,141 @@
+/**
+ * @file adc_source.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Continuous-mode (DMA) ADC sample source
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "acquisition.h"
+
+#include "esp_adc/adc_continuous.h"
+#include "esp_log.h"
+
+// Bytes produced by the DMA engine per conversion result
+#define ADC_RESULT_BYTES SOC_ADC_DIGI_RESULT_BYTES
+
+// Largest DMA frame: one block with every slot in use
+#define ADC_FRAME_BYTES_MAX (ACQ_BLOCK_SIZE * ACQ_MAX_CHANNELS * ADC_RESULT_BYTES)
+
+static adc_continuous_handle_t adc_handle = NULL;
+
+// Raw conversion results waiting to be unpacked
+static uint8_t frame[ADC_FRAME_BYTES_MAX];
+static uint32_t frame_bytes = 0;
+static uint32_t frame_len = 0;
+static uint32_t frame_pos = 0;
+
+// Slot of each ADC channel in the scan, and the slot expected next
+static int8_t channel_slot[ACQ_ADC_CHANNELS];
+static uint8_t slot_count = 0;
+static uint8_t next_slot = 0;
+
+static esp_err_t adc_source_start(uint32_t frame_rate_hz, const acq_scan_t* scan) {
+    esp_err_t err;
+
+    uint32_t conversion_rate_hz = frame_rate_hz * scan->count;
+    if(conversion_rate_hz > SOC_ADC_SAMPLE_FREQ_THRES_HIGH) {
+        ESP_LOGE(ACQ_TAG, "%lu Hz x %d channels exceeds the ADC conversion rate", (unsigned long) frame_rate_hz, scan->count);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // One DMA frame per block, with room for four frames in the driver pool
+    frame_bytes = ACQ_BLOCK_SIZE * scan->count * ADC_RESULT_BYTES;
+    frame_len = 0;
+    frame_pos = 0;
+
+    adc_continuous_handle_cfg_t handle_config = {
+        .max_store_buf_size = frame_bytes * 4,
+        .conv_frame_size = frame_bytes,
+    };
+
+    if((err = adc_continuous_new_handle(&handle_config, &adc_handle)) != ESP_OK) {
+        return err;
+    }
+
+    // Single pattern covering every enabled channel
+    adc_digi_pattern_config_t pattern[ACQ_MAX_CHANNELS];
+    for(int i = 0; i < ACQ_ADC_CHANNELS; i++) {
+        channel_slot[i] = -1;
+    }
+    for(int i = 0; i < scan->count; i++) {
+        pattern[i].atten = scan->atten[i];
+        pattern[i].channel = scan->channels[i];
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        channel_slot[scan->channels[i]] = i;
+    }
+    slot_count = scan->count;
+    next_slot = 0;
+
+    adc_continuous_config_t config = {
+        .pattern_num = scan->count,
+        .adc_pattern = pattern,
+        .sample_freq_hz = conversion_rate_hz,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+    };
+
+    if((err = adc_continuous_config(adc_handle, &config)) != ESP_OK) {
+        adc_continuous_deinit(adc_handle);
+        adc_handle = NULL;
+        return err;
+    }
+
+    return adc_continuous_start(adc_handle);
+}
+
+static size_t adc_source_read(uint16_t (*frames)[ACQ_MAX_CHANNELS], size_t len, uint32_t timeout_ms) {
+    size_t n = 0;
+
+    while(n < len) {
+        // Refill from the DMA pool once the current frame has been unpacked
+        if(frame_pos >= frame_len) {
+            frame_pos = 0;
+            frame_len = 0;
+            if(adc_continuous_read(adc_handle, frame, frame_bytes, &frame_len, timeout_ms) != ESP_OK) {
+                break;
+            }
+        }
+
+        for(; frame_pos < frame_len && n < len; frame_pos += ADC_RESULT_BYTES) {
+            adc_digi_output_data_t* result = (adc_digi_output_data_t*) &frame[frame_pos];
+            if(result->type2.channel >= ACQ_ADC_CHANNELS || channel_slot[result->type2.channel] < 0) {
+                continue;
+            }
+
+            // Place results by channel so a dropped conversion cannot shift the slots
+            uint8_t slot = channel_slot[result->type2.channel];
+            if(slot < next_slot) {
+                next_slot = 0;
+            }
+            frames[n][slot] = result->type2.data;
+            next_slot = slot + 1;
+
+            if(next_slot == slot_count) {
+                next_slot = 0;
+                n++;
+            }
+        }
+    }
+
+    return n;
+}
+
+static void adc_source_stop(void) {
+    if(adc_handle != NULL) {
+        adc_continuous_stop(adc_handle);
+        adc_continuous_deinit(adc_handle);
+        adc_handle = NULL;
+    }
+}
+
+const acq_source_t acq_adc_source = {
+    .name = "adc",
+    .start = adc_source_start,
+    .read = adc_source_read,
+    .stop = adc_source_stop,
+};
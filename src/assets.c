@@ -0,0 +1,377 @@
+/**
+ * @file assets.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Precompressed static assets with ETag validation
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "assets.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "content_types.h"
+
+#define ASSETS_SEND_BUFFER 1436     // One TCP segment at the default MSS
+#define ASSETS_IMAGE_MAGIC 0x31414c53   // "SLA1"
+#define ASSETS_IMAGE_VERSION 1
+
+// Image layout written by tools/pack_assets.py. Offsets are from the start of the partition.
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t size;
+    uint32_t reserved;
+} asset_image_header_t;
+
+typedef struct {
+    char path[ASSETS_MAX_NAME];
+    char content_type[32];
+    char hash[ASSETS_HASH_LEN];     // Not terminated
+    uint32_t offset;
+    uint32_t length;
+    uint32_t gz_offset;
+    uint32_t gz_length;             // 0 without a gzip copy
+} asset_image_entry_t;
+
+static asset_t assets[ASSETS_MAX];
+static size_t asset_count = 0;
+static esp_partition_mmap_handle_t image_handle;
+
+// Open-addressed hash index over assets[], kept at most half full so probes stay short
+static uint8_t asset_index[ASSETS_INDEX_SIZE];   // Position in assets[] + 1, 0 for an empty slot
+
+typedef enum {
+    RANGE_NONE,                 // No usable Range header, send the whole asset
+    RANGE_SATISFIABLE,
+    RANGE_UNSATISFIABLE,
+} range_result_t;
+
+// FNV-1a
+static uint32_t hash_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    while(*name) {
+        hash = (hash ^ (uint8_t) *name++) * 16777619u;
+    }
+    return hash;
+}
+
+static void build_index(void) {
+    memset(asset_index, 0, sizeof(asset_index));
+    for(size_t i = 0; i < asset_count; i++) {
+        uint32_t slot = hash_name(assets[i].name) & (ASSETS_INDEX_SIZE - 1);
+        while(asset_index[slot] != 0) {
+            slot = (slot + 1) & (ASSETS_INDEX_SIZE - 1);
+        }
+        asset_index[slot] = i + 1;
+    }
+}
+
+static bool in_image(uint32_t offset, uint32_t len, uint32_t size) {
+    return offset <= size && len <= size - offset;
+}
+
+// Index the assets of the image in the assets partition. The mapping is kept for the life of the firmware.
+static esp_err_t map_image(void) {
+    const esp_partition_t* part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ASSETS_PARTITION_SUBTYPE, ASSETS_PARTITION_LABEL);
+    if(part == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    const void* map;
+    esp_err_t err = esp_partition_mmap(part, 0, part->size, ESP_PARTITION_MMAP_DATA, &map, &image_handle);
+    if(err != ESP_OK) {
+        ESP_LOGE(ASSETS_TAG, "Unable to map the %s partition: %s", ASSETS_PARTITION_LABEL, esp_err_to_name(err));
+        return err;
+    }
+
+    // An erased or foreign partition is left alone
+    const uint8_t* base = map;
+    const asset_image_header_t* header = map;
+    if(header->magic != ASSETS_IMAGE_MAGIC || header->version != ASSETS_IMAGE_VERSION || header->size > part->size
+       || !in_image(sizeof(*header), header->count * sizeof(asset_image_entry_t), header->size)) {
+        ESP_LOGW(ASSETS_TAG, "No assets image in the %s partition", ASSETS_PARTITION_LABEL);
+        esp_partition_munmap(image_handle);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    const asset_image_entry_t* entries = (const asset_image_entry_t*) (header + 1);
+    asset_count = 0;
+    for(int i = 0; i < header->count && asset_count < ASSETS_MAX; i++) {
+        const asset_image_entry_t* entry = &entries[i];
+        if(memchr(entry->path, '\0', sizeof(entry->path)) == NULL || memchr(entry->content_type, '\0', sizeof(entry->content_type)) == NULL
+           || !in_image(entry->offset, entry->length, header->size) || !in_image(entry->gz_offset, entry->gz_length, header->size)) {
+            ESP_LOGW(ASSETS_TAG, "Skipping malformed entry %d", i);
+            continue;
+        }
+
+        asset_t* asset = &assets[asset_count++];
+        strcpy(asset->name, entry->path);
+        memcpy(asset->hash, entry->hash, ASSETS_HASH_LEN);
+        asset->hash[ASSETS_HASH_LEN] = '\0';
+        asset->content_type = entry->content_type;
+        asset->data = base + entry->offset;
+        asset->len = entry->length;
+        asset->gzip = entry->gz_length > 0;
+        asset->gz_data = base + entry->gz_offset;
+        asset->gz_len = entry->gz_length;
+        ESP_LOGI(ASSETS_TAG, "%s: %s, %lu bytes, flash", asset->name, asset->hash, (unsigned long) asset->len);
+    }
+
+    // tools/pack_assets.py refuses to build such an image
+    if(header->count > ASSETS_MAX) {
+        ESP_LOGE(ASSETS_TAG, "The image lists %u assets, only the first %d are served", header->count, ASSETS_MAX);
+    }
+    return ESP_OK;
+}
+
+// Index the assets listed in the SPIFFS manifest
+static esp_err_t read_manifest(void) {
+    FILE* file = fopen(ASSETS_MANIFEST, "r");
+    if(file == NULL) {
+        ESP_LOGW(ASSETS_TAG, "No %s, there are no assets to serve", ASSETS_MANIFEST);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    char line[ASSETS_MAX_NAME + ASSETS_HASH_LEN + 8];
+    asset_count = 0;
+    while(fgets(line, sizeof(line), file) && asset_count < ASSETS_MAX) {
+        asset_t* asset = &assets[asset_count];
+        memset(asset, 0, sizeof(*asset));
+        char* sep = strchr(line, ' ');
+        if(sep == NULL || sep - line >= ASSETS_MAX_NAME) {
+            continue;
+        }
+        *sep = '\0';
+        strcpy(asset->name, line);
+        strncpy(asset->hash, sep + 1, ASSETS_HASH_LEN);
+        asset->hash[ASSETS_HASH_LEN] = '\0';
+        asset->hash[strcspn(asset->hash, "\r\n")] = '\0';
+
+        char path[sizeof(ASSETS_BASE_PATH) + ASSETS_MAX_NAME + 4];
+        struct stat st;
+        snprintf(path, sizeof(path), ASSETS_BASE_PATH "/%s.gz", asset->name);
+        asset->gzip = stat(path, &st) == 0;
+        asset->content_type = content_type_for(asset->name);
+
+        ESP_LOGI(ASSETS_TAG, "%s: %s%s", asset->name, asset->hash, asset->gzip ? ", gzip" : "");
+        asset_count++;
+    }
+    if(asset_count == ASSETS_MAX && fgets(line, sizeof(line), file)) {
+        ESP_LOGE(ASSETS_TAG, "%s lists more than %d assets, the rest are not served", ASSETS_MANIFEST, ASSETS_MAX);
+    }
+    fclose(file);
+    return ESP_OK;
+}
+
+esp_err_t assets_init(void) {
+    asset_count = 0;
+    esp_err_t err = map_image();
+    if(err != ESP_OK) {
+        err = read_manifest();
+    }
+    build_index();
+    return err;
+}
+
+const asset_t* assets_find(const char* name) {
+    uint32_t slot = hash_name(name) & (ASSETS_INDEX_SIZE - 1);
+    while(asset_index[slot] != 0) {
+        const asset_t* asset = &assets[asset_index[slot] - 1];
+        if(strcmp(asset->name, name) == 0) {
+            return asset;
+        }
+        slot = (slot + 1) & (ASSETS_INDEX_SIZE - 1);
+    }
+    return NULL;
+}
+
+// Copy a request header, false if it is missing or longer than the buffer
+static bool get_header(httpd_req_t* req, const char* field, char* value, size_t size) {
+    size_t len = httpd_req_get_hdr_value_len(req, field);
+    return len > 0 && len < size && httpd_req_get_hdr_value_str(req, field, value, size) == ESP_OK;
+}
+
+// Whether a request header lists a token (compared as a substring, enough for the values we look for)
+static bool header_has(httpd_req_t* req, const char* field, const char* token) {
+    char value[128];
+    if(!get_header(req, field, value, sizeof(value))) {
+        return false;
+    }
+    return strstr(value, token) != NULL || strcmp(value, "*") == 0;
+}
+
+// Single byte range of a Range header: "bytes=first-last", "bytes=first-" or "bytes=-suffix"
+static range_result_t parse_range(httpd_req_t* req, uint32_t size, uint32_t* start, uint32_t* len) {
+    char value[64];
+    if(!get_header(req, "Range", value, sizeof(value)) || strncmp(value, "bytes=", 6) != 0 || strchr(value, ',') != NULL) {
+        // Multiple ranges are not supported, the whole asset is a valid answer
+        return RANGE_NONE;
+    }
+
+    char* spec = value + 6;
+    char* dash = strchr(spec, '-');
+    if(dash == NULL) {
+        return RANGE_NONE;
+    }
+    char* end;
+    if(dash == spec) {
+        unsigned long suffix = strtoul(dash + 1, &end, 10);
+        if(end == dash + 1 || *end != '\0') {
+            return RANGE_NONE;
+        }
+        if(suffix == 0 || size == 0) {
+            return RANGE_UNSATISFIABLE;
+        }
+        *start = suffix < size ? size - suffix : 0;
+        *len = size - *start;
+        return RANGE_SATISFIABLE;
+    }
+
+    unsigned long first = strtoul(spec, &end, 10);
+    if(end != dash) {
+        return RANGE_NONE;
+    }
+    unsigned long last = size - 1;
+    if(dash[1] != '\0') {
+        last = strtoul(dash + 1, &end, 10);
+        if(*end != '\0' || last < first) {
+            return RANGE_NONE;
+        }
+    }
+    if(first >= size) {
+        return RANGE_UNSATISFIABLE;
+    }
+    if(last >= size) {
+        last = size - 1;
+    }
+    *start = first;
+    *len = last - first + 1;
+    return RANGE_SATISFIABLE;
+}
+
+esp_err_t assets_send(httpd_req_t* req, const char* name, const char* content_type) {
+    const asset_t* asset = assets_find(name);
+    bool gzip = asset != NULL && asset->gzip && header_has(req, "Accept-Encoding", "gzip");
+
+    // Each representation has its own strong validator
+    char etag[ASSETS_HASH_LEN + 8];
+    if(asset != NULL) {
+        snprintf(etag, sizeof(etag), "\"%s%s\"", asset->hash, gzip ? "-gz" : "");
+    }
+
+    const char* data = NULL;
+    uint32_t size = 0;
+    int fd = -1;
+    if(asset != NULL && asset->data != NULL) {
+        data = (const char*) (gzip ? asset->gz_data : asset->data);
+        size = gzip ? asset->gz_len : asset->len;
+    } else {
+        char path[sizeof(ASSETS_BASE_PATH) + ASSETS_MAX_NAME + 4];
+        struct stat st;
+        snprintf(path, sizeof(path), ASSETS_BASE_PATH "/%s%s", name, gzip ? ".gz" : "");
+        fd = open(path, O_RDONLY);
+        if(fd < 0) {
+            return ESP_ERR_NOT_FOUND;
+        }
+        if(fstat(fd, &st) != 0) {
+            close(fd);
+            return ESP_ERR_NOT_FOUND;
+        }
+        size = st.st_size;
+    }
+
+    if(content_type == NULL) {
+        content_type = asset != NULL && asset->content_type != NULL ? asset->content_type : "application/octet-stream";
+    }
+    httpd_resp_set_type(req, content_type);
+    httpd_resp_set_hdr(req, "Cache-Control", "max-age=3600");
+    httpd_resp_set_hdr(req, "Accept-Ranges", "bytes");
+    if(asset != NULL) {
+        httpd_resp_set_hdr(req, "ETag", etag);
+        httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+
+        if(header_has(req, "If-None-Match", etag)) {
+            if(fd >= 0) {
+                close(fd);
+            }
+            httpd_resp_set_status(req, "304 Not Modified");
+            return httpd_resp_send(req, NULL, 0);
+        }
+    }
+    if(gzip) {
+        httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    }
+
+    // A range only applies to the representation the client already holds part of (If-Range)
+    uint32_t start = 0;
+    uint32_t len = size;
+    char content_range[48];
+    char if_range[ASSETS_HASH_LEN + 8];
+    range_result_t range = parse_range(req, size, &start, &len);
+    if(range != RANGE_NONE && get_header(req, "If-Range", if_range, sizeof(if_range)) && (asset == NULL || strcmp(if_range, etag) != 0)) {
+        range = RANGE_NONE;
+        start = 0;
+        len = size;
+    }
+    if(range == RANGE_UNSATISFIABLE) {
+        if(fd >= 0) {
+            close(fd);
+        }
+        snprintf(content_range, sizeof(content_range), "bytes */%lu", (unsigned long) size);
+        httpd_resp_set_hdr(req, "Content-Range", content_range);
+        httpd_resp_set_status(req, "416 Range Not Satisfiable");
+        return httpd_resp_send(req, NULL, 0);
+    }
+    if(range == RANGE_SATISFIABLE) {
+        snprintf(content_range, sizeof(content_range), "bytes %lu-%lu/%lu",
+                 (unsigned long) start, (unsigned long) (start + len - 1), (unsigned long) size);
+        httpd_resp_set_hdr(req, "Content-Range", content_range);
+        httpd_resp_set_status(req, "206 Partial Content");
+    }
+
+    // Without a body, httpd still sends the Content-Length given
+    if(req->method == HTTP_HEAD) {
+        if(fd >= 0) {
+            close(fd);
+        }
+        return httpd_resp_send(req, NULL, len);
+    }
+
+    // One contiguous send from the mapped flash, with a Content-Length
+    if(data != NULL) {
+        return httpd_resp_send(req, data + start, len);
+    }
+
+    // Shared by every request, since the single httpd task runs one handler at a time
+    static char buf[ASSETS_SEND_BUFFER];
+    esp_err_t err = ESP_OK;
+    if(start > 0 && lseek(fd, start, SEEK_SET) != start) {
+        err = ESP_FAIL;
+    }
+    while(err == ESP_OK && len > 0) {
+        int n = read(fd, buf, len < sizeof(buf) ? len : sizeof(buf));
+        if(n <= 0) {
+            err = ESP_FAIL;
+            break;
+        }
+        err = httpd_resp_send_chunk(req, buf, n);
+        len -= n;
+    }
+    close(fd);
+
+    if(err == ESP_OK) {
+        err = httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return err;
+}
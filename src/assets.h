@@ -0,0 +1,77 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include <esp_http_server.h>
+
+#define ASSETS_TAG "assets"
+#define ASSETS_MAX 16               // Static assets served at most, a power of two. The build scripts fail beyond it.
+#define ASSETS_INDEX_SIZE (ASSETS_MAX * 2)  // Hash index slots
+#define ASSETS_MAX_NAME 32
+#define ASSETS_HASH_LEN 16          // Hex digits of the content hash
+#ifndef ASSETS_BASE_PATH
+#define ASSETS_BASE_PATH "/spiffs"          // Overridden by the native tests
+#endif
+#define ASSETS_MANIFEST ASSETS_BASE_PATH "/etags.txt"
+#define ASSETS_PARTITION_LABEL "assets"
+#define ASSETS_PARTITION_SUBTYPE 0x40   // Custom data subtype, see partitions.csv
+
+/**
+ * Static assets served with validators. They come from the assets partition when it holds
+ * an image (tools/pack_assets.py): the partition is memory mapped and each response is sent
+ * in one piece straight from flash, with no file system access or copy. Otherwise they are
+ * read from SPIFFS, where the build (tools/compress_assets.py) stores a gzip copy of each
+ * compressible asset next to it and lists the content hash of each in ASSETS_MANIFEST. The
+ * files of data/ that are assets, and their content types, are those listed in content_types.c.
+ *
+ * Clients that accept gzip get the compressed copy; both representations carry a strong
+ * ETag derived from the hash, and a matching If-None-Match is answered with 304 Not Modified
+ * and no body. HEAD and single byte ranges (Range, If-Range) are supported. Lookup by name
+ * goes through a hash index built once at startup.
+ */
+
+// Asset listed in the image index or the manifest
+typedef struct {
+    char name[ASSETS_MAX_NAME];
+    char hash[ASSETS_HASH_LEN + 1];
+    bool gzip;                  // A gzip copy is present
+    const char* content_type;   // From the image index, or content_types.c for SPIFFS assets
+    const uint8_t* data;        // Mapped flash, NULL for SPIFFS assets
+    uint32_t len;
+    const uint8_t* gz_data;
+    uint32_t gz_len;
+} asset_t;
+
+/**
+ * @brief Map the assets partition, or if it holds no image, read the manifest and look for
+ *        the compressed copies on SPIFFS. Only the assets listed there are served; other
+ *        files, like the page templates, are not.
+ *
+ * @return esp_err_t - ESP_ERR_NOT_FOUND if there is neither an image nor a manifest
+ */
+esp_err_t assets_init(void);
+
+/**
+ * @brief Find an asset of the image or the manifest
+ *
+ * @param name - file name relative to ASSETS_BASE_PATH
+ * @return const asset_t* - NULL if the asset is not listed
+ */
+const asset_t* assets_find(const char* name);
+
+/**
+ * @brief Answer a GET or HEAD request with an asset: 304 if the client's copy is current,
+ *        otherwise the gzip copy if accepted, or the file as is, in whole or the requested range.
+ *        Call from httpd handlers only: files are read through one static buffer.
+ *
+ * @param req - request to answer
+ * @param name - file name relative to ASSETS_BASE_PATH
+ * @param content_type - MIME type, NULL to use the one of the image index
+ * @return esp_err_t - ESP_ERR_NOT_FOUND if the asset does not exist (nothing is sent)
+ */
+esp_err_t assets_send(httpd_req_t* req, const char* name, const char* content_type);
+
+#endif
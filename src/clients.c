@@ -0,0 +1,701 @@
+/**
+ * @file clients.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Registry of WebSocket clients with per-client send queues
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "clients.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+// Registry entry: public state plus the outbound queue
+typedef struct {
+    ws_client_t info;
+    ws_frame_t* queue[CLIENTS_QUEUE_LEN];
+    uint16_t queue_samples[CLIENTS_QUEUE_LEN];
+    uint8_t head;
+    int64_t full_since_us;      // 0 unless the queue has been full since the last successful send
+    int64_t last_ping_us;
+    bool closing;               // Eviction requested
+    deadband_t deadband[ACQ_MAX_CHANNELS];  // Per subscribed channel, in ascending channel order
+    httpd_req_t* async_req;     // Open request of an event stream
+    bool resume_pending;        // Live samples held back until clients_take_resume()
+    uint32_t resume_seq;
+} client_slot_t;
+
+// Selects the clients a frame is queued to. Called with registry_lock held.
+typedef bool (*client_filter_t)(client_slot_t* slot, const void* arg, int64_t now);
+
+static client_slot_t registry[CLIENTS_MAX] = {
+    [0 ... CLIENTS_MAX - 1] = { .info.fd = -1 },
+};
+static clients_fanout_t fanout;
+static portMUX_TYPE registry_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Shared frame pool
+static ws_frame_t pool[CLIENTS_POOL_SIZE];
+static ws_frame_t* pool_free = NULL;
+static uint32_t pool_available = 0;
+static uint32_t pool_exhausted = 0;
+static bool pool_ready = false;
+static portMUX_TYPE pool_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Set while a flush is queued on the httpd task
+static bool flush_scheduled = false;
+
+static const char* format_names[WS_FORMAT_COUNT] = { "json", "binary", "delta", "sse" };
+
+// SSE comment sent to event streams in place of a WebSocket ping
+static const char sse_keepalive[] = ": keepalive\n\n";
+static const char* policy_names[WS_POLICY_COUNT] = { "drop-oldest", "drop-newest" };
+
+ws_frame_t* clients_frame_alloc(void) {
+    ws_frame_t* frame;
+
+    portENTER_CRITICAL(&pool_lock);
+    if(!pool_ready) {
+        for(int i = 0; i < CLIENTS_POOL_SIZE; i++) {
+            pool[i].next = pool_free;
+            pool_free = &pool[i];
+        }
+        pool_available = CLIENTS_POOL_SIZE;
+        pool_ready = true;
+    }
+
+    frame = pool_free;
+    if(frame != NULL) {
+        pool_free = frame->next;
+        pool_available--;
+    } else {
+        pool_exhausted++;
+    }
+    portEXIT_CRITICAL(&pool_lock);
+
+    if(frame != NULL) {
+        atomic_init(&frame->refs, 1);
+        frame->type = HTTPD_WS_TYPE_TEXT;
+        frame->len = 0;
+    }
+    return frame;
+}
+
+void clients_frame_release(ws_frame_t* frame) {
+    if(atomic_fetch_sub_explicit(&frame->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    portENTER_CRITICAL(&pool_lock);
+    frame->next = pool_free;
+    pool_free = frame;
+    pool_available++;
+    portEXIT_CRITICAL(&pool_lock);
+}
+
+// Call with registry_lock held. Frames to release are returned through dropped.
+static void clear_slot(client_slot_t* slot, ws_frame_t** dropped, size_t* n) {
+    for(int i = 0; i < slot->info.depth; i++) {
+        dropped[(*n)++] = slot->queue[(slot->head + i) % CLIENTS_QUEUE_LEN];
+    }
+    slot->info.fd = -1;
+    slot->info.depth = 0;
+    slot->head = 0;
+}
+
+static void remove_fd(int sockfd) {
+    ws_frame_t* dropped[CLIENTS_MAX * CLIENTS_QUEUE_LEN];
+    size_t n = 0;
+    httpd_req_t* async_req = NULL;
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        if(registry[i].info.fd == sockfd) {
+            async_req = registry[i].async_req;
+            registry[i].async_req = NULL;
+            clear_slot(&registry[i], dropped, &n);
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+
+    for(size_t i = 0; i < n; i++) {
+        clients_frame_release(dropped[i]);
+    }
+
+    // Hands the session back to httpd and frees the request copy
+    if(async_req != NULL) {
+        httpd_req_async_handler_complete(async_req);
+    }
+}
+
+void clients_remove(int sockfd) {
+    remove_fd(sockfd);
+}
+
+esp_err_t clients_on_open(httpd_handle_t hd, int sockfd) {
+    // Descriptors are reused, so never inherit a previous connection's entry
+    remove_fd(sockfd);
+    return ESP_OK;
+}
+
+void clients_on_close(httpd_handle_t hd, int sockfd) {
+    remove_fd(sockfd);
+
+    // httpd leaves closing to close_fn when one is set
+    close(sockfd);
+}
+
+esp_err_t clients_add(int sockfd, const ws_subscription_t* sub, ws_policy_t policy, httpd_req_t* async_req) {
+    esp_err_t ret = ESP_ERR_NO_MEM;
+
+    remove_fd(sockfd);
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        client_slot_t* slot = &registry[i];
+        if(slot->info.fd < 0) {
+            memset(slot, 0, sizeof(*slot));
+            slot->info.fd = sockfd;
+            slot->info.sub = *sub;
+            for(int ch = 0; ch < ACQ_MAX_CHANNELS; ch++) {
+                deadband_init(&slot->deadband[ch], sub->deadband_mv, CONFIG_WS_MAX_SILENCE_MS);
+            }
+            slot->async_req = async_req;
+            slot->info.policy = policy;
+            slot->info.connected_us = esp_timer_get_time();
+            slot->info.last_seen_us = slot->info.connected_us;
+            slot->last_ping_us = slot->info.connected_us;
+            ret = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+
+    if(ret != ESP_OK) {
+        ESP_LOGW(CLIENTS_TAG, "Registry full, client %d not registered", sockfd);
+    }
+    return ret;
+}
+
+esp_err_t clients_subscribe(int sockfd, const ws_subscription_t* sub) {
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        client_slot_t* slot = &registry[i];
+        if(slot->info.fd == sockfd) {
+            slot->info.sub = *sub;
+            for(int ch = 0; ch < ACQ_MAX_CHANNELS; ch++) {
+                deadband_init(&slot->deadband[ch], sub->deadband_mv, CONFIG_WS_MAX_SILENCE_MS);
+            }
+            slot->resume_pending = false;
+            ret = ESP_OK;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+    return ret;
+}
+
+esp_err_t clients_get_subscription(int sockfd, ws_subscription_t* sub) {
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        if(registry[i].info.fd == sockfd) {
+            *sub = registry[i].info.sub;
+            ret = ESP_OK;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+    return ret;
+}
+
+void clients_note_resend(int sockfd, uint32_t resent, uint32_t unavailable) {
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        if(registry[i].info.fd == sockfd) {
+            registry[i].info.resend_requests++;
+            registry[i].info.resent += resent;
+            registry[i].info.unavailable += unavailable;
+        }
+    }
+    fanout.resent += resent;
+    fanout.unavailable += unavailable;
+    portEXIT_CRITICAL(&registry_lock);
+}
+
+esp_err_t clients_resume(int sockfd, const ws_subscription_t* sub, uint32_t from) {
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        client_slot_t* slot = &registry[i];
+        if(slot->info.fd == sockfd) {
+            slot->info.sub = *sub;
+            for(int ch = 0; ch < ACQ_MAX_CHANNELS; ch++) {
+                deadband_init(&slot->deadband[ch], sub->deadband_mv, CONFIG_WS_MAX_SILENCE_MS);
+            }
+            slot->resume_seq = from;
+            slot->resume_pending = true;
+            ret = ESP_OK;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+    return ret;
+}
+
+bool clients_take_resume(int* sockfd, uint32_t* from, ws_subscription_t* sub) {
+    bool taken = false;
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX && !taken; i++) {
+        client_slot_t* slot = &registry[i];
+        if(slot->info.fd >= 0 && slot->resume_pending) {
+            slot->resume_pending = false;
+            *sockfd = slot->info.fd;
+            *from = slot->resume_seq;
+            *sub = slot->info.sub;
+            taken = true;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+    return taken;
+}
+
+void clients_seen(int sockfd) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        if(registry[i].info.fd == sockfd) {
+            registry[i].info.last_seen_us = now;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+}
+
+// Non-blocking check for room in the socket's send buffer, so one stalled
+// client never holds up the httpd task (and with it every other client)
+static bool socket_writable(int fd) {
+    fd_set wfds;
+    struct timeval tv = { 0 };
+
+    FD_ZERO(&wfds);
+    FD_SET(fd, &wfds);
+    return select(fd + 1, NULL, &wfds, NULL, &tv) > 0;
+}
+
+// Runs on the httpd task. Sends one frame per writable client per round, so
+// clients are served fairly, until no client can make progress.
+static void flush_work(void* arg) {
+    httpd_handle_t hd = arg;
+    bool progress = true;
+
+    portENTER_CRITICAL(&registry_lock);
+    flush_scheduled = false;
+    portEXIT_CRITICAL(&registry_lock);
+
+    while(progress) {
+        progress = false;
+
+        for(int i = 0; i < CLIENTS_MAX; i++) {
+            client_slot_t* slot = &registry[i];
+
+            portENTER_CRITICAL(&registry_lock);
+            int fd = slot->info.depth > 0 && !slot->closing ? slot->info.fd : -1;
+            portEXIT_CRITICAL(&registry_lock);
+
+            if(fd < 0 || !socket_writable(fd)) {
+                continue;
+            }
+
+            // Take the frame off the queue. The queue's reference moves to this function.
+            ws_frame_t* frame = NULL;
+            uint16_t samples = 0;
+            portENTER_CRITICAL(&registry_lock);
+            if(slot->info.fd == fd && slot->info.depth > 0) {
+                frame = slot->queue[slot->head];
+                samples = slot->queue_samples[slot->head];
+                slot->head = (slot->head + 1) % CLIENTS_QUEUE_LEN;
+                slot->info.depth--;
+            }
+            portEXIT_CRITICAL(&registry_lock);
+
+            if(frame == NULL) {
+                continue;
+            }
+
+            // Event streams are plain HTTP responses: write the event text as is
+            esp_err_t err;
+            if(slot->info.sub.format == WS_FORMAT_SSE) {
+                err = httpd_socket_send(hd, fd, (const char*) frame->data, frame->len, 0) == (int) frame->len ? ESP_OK : ESP_FAIL;
+            } else {
+                httpd_ws_frame_t ws_pkt;
+                memset(&ws_pkt, 0, sizeof(httpd_ws_frame_t));
+                ws_pkt.payload = frame->data;
+                ws_pkt.len = frame->len;
+                ws_pkt.type = frame->type;
+                err = httpd_ws_send_frame_async(hd, fd, &ws_pkt);
+            }
+
+            bool broken = false;
+            portENTER_CRITICAL(&registry_lock);
+            if(slot->info.fd == fd && err == ESP_OK) {
+                slot->info.frames++;
+                slot->info.samples += samples;
+                slot->info.bytes += frame->len;
+                slot->full_since_us = 0;
+                // Event streams never send anything, so a completed write is their sign of life
+                if(slot->info.sub.format == WS_FORMAT_SSE) {
+                    slot->info.last_seen_us = esp_timer_get_time();
+                }
+            } else if(slot->info.fd == fd && !slot->closing) {
+                slot->closing = true;
+                fanout.evictions++;
+                broken = true;
+            }
+            portEXIT_CRITICAL(&registry_lock);
+
+            if(broken) {
+                ESP_LOGW(CLIENTS_TAG, "Send to client %d failed, disconnecting", fd);
+                httpd_sess_trigger_close(hd, fd);
+            }
+
+            clients_frame_release(frame);
+            progress = true;
+        }
+    }
+}
+
+static void schedule_flush(httpd_handle_t hd) {
+    bool schedule = false;
+
+    portENTER_CRITICAL(&registry_lock);
+    if(!flush_scheduled) {
+        flush_scheduled = true;
+        schedule = true;
+    }
+    portEXIT_CRITICAL(&registry_lock);
+
+    if(schedule && httpd_queue_work(hd, flush_work, hd) != ESP_OK) {
+        portENTER_CRITICAL(&registry_lock);
+        flush_scheduled = false;
+        portEXIT_CRITICAL(&registry_lock);
+    }
+}
+
+// Call with registry_lock held. A frame pushed out by drop-oldest is returned through evicted.
+static bool enqueue(client_slot_t* slot, ws_frame_t* frame, uint32_t samples, int64_t now, ws_frame_t** evicted) {
+    *evicted = NULL;
+
+    if(slot->info.depth == CLIENTS_QUEUE_LEN) {
+        if(slot->full_since_us == 0) {
+            slot->full_since_us = now;
+        }
+        slot->info.dropped++;
+        fanout.dropped++;
+
+        if(slot->info.policy == WS_POLICY_DROP_NEWEST) {
+            return false;
+        }
+        *evicted = slot->queue[slot->head];
+        slot->head = (slot->head + 1) % CLIENTS_QUEUE_LEN;
+        slot->info.depth--;
+    }
+
+    int tail = (slot->head + slot->info.depth) % CLIENTS_QUEUE_LEN;
+    atomic_fetch_add_explicit(&frame->refs, 1, memory_order_relaxed);
+    slot->queue[tail] = frame;
+    slot->queue_samples[tail] = samples;
+    slot->info.depth++;
+    if(slot->info.depth > slot->info.max_depth) {
+        slot->info.max_depth = slot->info.depth;
+    }
+    return true;
+}
+
+static size_t publish(httpd_handle_t hd, ws_frame_t* frame, uint32_t samples, client_filter_t filter, const void* arg) {
+    ws_frame_t* dropped[CLIENTS_MAX];
+    size_t n_dropped = 0;
+    size_t n = 0;
+
+    if(hd == NULL) {
+        clients_frame_release(frame);
+        return 0;
+    }
+
+    int64_t start = esp_timer_get_time();
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        client_slot_t* slot = &registry[i];
+        if(slot->info.fd < 0 || slot->closing || !filter(slot, arg, start)) {
+            continue;
+        }
+
+        ws_frame_t* evicted;
+        n += enqueue(slot, frame, samples, start, &evicted);
+        if(evicted != NULL) {
+            dropped[n_dropped++] = evicted;
+        }
+    }
+    if(n > 0) {
+        fanout.fanouts++;
+        fanout.sends += n;
+        fanout.total_us += esp_timer_get_time() - start;
+    }
+    portEXIT_CRITICAL(&registry_lock);
+
+    for(size_t i = 0; i < n_dropped; i++) {
+        clients_frame_release(dropped[i]);
+    }
+    clients_frame_release(frame);
+
+    if(n > 0) {
+        schedule_flush(hd);
+    }
+    return n;
+}
+
+static bool match_format(client_slot_t* slot, const void* arg, int64_t now) {
+    ws_format_t format = *(const ws_format_t*) arg;
+    return format == WS_FORMAT_ANY ? slot->info.sub.format != WS_FORMAT_SSE : slot->info.sub.format == format;
+}
+
+size_t clients_publish(httpd_handle_t hd, ws_frame_t* frame, ws_format_t format, uint32_t samples) {
+    return publish(hd, frame, samples, match_format, &format);
+}
+
+static bool match_fd(client_slot_t* slot, const void* arg, int64_t now) {
+    return slot->info.fd == *(const int*) arg;
+}
+
+esp_err_t clients_send(httpd_handle_t hd, int sockfd, ws_frame_t* frame, uint32_t samples) {
+    return publish(hd, frame, samples, match_fd, &sockfd) > 0 ? ESP_OK : ESP_ERR_NOT_FOUND;
+}
+
+static bool same_stream(const ws_subscription_t* a, const ws_subscription_t* b) {
+    return a->format == b->format && a->channel_mask == b->channel_mask && a->decimation == b->decimation;
+}
+
+typedef struct {
+    const ws_subscription_t* sub;
+    const uint16_t* last_mv;
+    uint8_t channel_count;
+} sample_match_t;
+
+static bool match_stream(client_slot_t* slot, const void* arg, int64_t now) {
+    const sample_match_t* match = arg;
+    if(slot->resume_pending || !same_stream(&slot->info.sub, match->sub)) {
+        return false;
+    }
+
+    // Report by exception: send when any channel crossed its deadband (or is due a heartbeat).
+    // Every channel is checked so each filter tracks what the client last received.
+    bool send = false;
+    for(int ch = 0; ch < match->channel_count; ch++) {
+        send |= deadband_check(&slot->deadband[ch], match->last_mv[ch], now);
+    }
+    return send;
+}
+
+size_t clients_publish_samples(httpd_handle_t hd, ws_frame_t* frame, const ws_subscription_t* sub, uint32_t samples,
+    const uint16_t* last_mv, uint8_t channel_count) {
+    sample_match_t match = {
+        .sub = sub,
+        .last_mv = last_mv,
+        .channel_count = channel_count < ACQ_MAX_CHANNELS ? channel_count : ACQ_MAX_CHANNELS,
+    };
+    return publish(hd, frame, samples, match_stream, &match);
+}
+
+size_t clients_subscriptions(ws_subscription_t* subs) {
+    size_t n = 0;
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        const ws_client_t* info = &registry[i].info;
+        if(info->fd < 0 || registry[i].closing || info->sub.decimation == 0) {
+            continue;
+        }
+
+        bool seen = false;
+        for(size_t j = 0; j < n && !seen; j++) {
+            seen = same_stream(&subs[j], &info->sub);
+        }
+        if(!seen) {
+            subs[n] = info->sub;
+            subs[n].deadband_mv = 0;
+            n++;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+    return n;
+}
+
+void clients_tick(httpd_handle_t hd) {
+    int evict[CLIENTS_MAX];
+    size_t n_evict = 0;
+    bool ping[CLIENTS_MAX] = { false };
+    bool any_ping = false;
+    bool any_keepalive = false;
+    bool pending = false;
+
+    if(hd == NULL) {
+        return;
+    }
+
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        client_slot_t* slot = &registry[i];
+        if(slot->info.fd < 0 || slot->closing) {
+            continue;
+        }
+
+        bool stalled = slot->full_since_us != 0 && now - slot->full_since_us > CONFIG_WS_STALL_TIMEOUT_MS * 1000LL;
+        bool silent = now - slot->info.last_seen_us > CONFIG_WS_PONG_TIMEOUT_MS * 1000LL;
+        if(stalled || silent) {
+            slot->closing = true;
+            evict[n_evict++] = slot->info.fd;
+            fanout.evictions++;
+            continue;
+        }
+
+        if(now - slot->last_ping_us >= CONFIG_WS_PING_INTERVAL_MS * 1000LL) {
+            slot->last_ping_us = now;
+            ping[i] = true;
+            if(slot->info.sub.format == WS_FORMAT_SSE) {
+                any_keepalive = true;
+            } else {
+                any_ping = true;
+            }
+        }
+        pending |= slot->info.depth > 0;
+    }
+    portEXIT_CRITICAL(&registry_lock);
+
+    for(size_t i = 0; i < n_evict; i++) {
+        ESP_LOGW(CLIENTS_TAG, "Disconnecting unresponsive client %d", evict[i]);
+        httpd_sess_trigger_close(hd, evict[i]);
+    }
+
+    // One empty PING frame shared by every WebSocket client that is due (browsers answer
+    // automatically), and one comment shared by every event stream that is due
+    ws_frame_t* frame = any_ping ? clients_frame_alloc() : NULL;
+    ws_frame_t* keepalive = any_keepalive ? clients_frame_alloc() : NULL;
+    if(frame != NULL) {
+        frame->type = HTTPD_WS_TYPE_PING;
+    }
+    if(keepalive != NULL) {
+        keepalive->type = HTTPD_WS_TYPE_TEXT;
+        keepalive->len = sizeof(sse_keepalive) - 1;
+        memcpy(keepalive->data, sse_keepalive, keepalive->len);
+    }
+    if(frame != NULL || keepalive != NULL) {
+        ws_frame_t* dropped[CLIENTS_MAX];
+        size_t n_dropped = 0;
+
+        portENTER_CRITICAL(&registry_lock);
+        for(int i = 0; i < CLIENTS_MAX; i++) {
+            ws_frame_t* evicted;
+            ws_frame_t* due = registry[i].info.sub.format == WS_FORMAT_SSE ? keepalive : frame;
+            if(ping[i] && due != NULL && registry[i].info.fd >= 0 && !registry[i].closing) {
+                enqueue(&registry[i], due, 0, now, &evicted);
+                if(evicted != NULL) {
+                    dropped[n_dropped++] = evicted;
+                }
+            }
+        }
+        portEXIT_CRITICAL(&registry_lock);
+
+        for(size_t i = 0; i < n_dropped; i++) {
+            clients_frame_release(dropped[i]);
+        }
+        if(frame != NULL) {
+            clients_frame_release(frame);
+        }
+        if(keepalive != NULL) {
+            clients_frame_release(keepalive);
+        }
+        pending = true;
+    }
+
+    // Retry clients that were not writable during the last flush
+    if(pending) {
+        schedule_flush(hd);
+    }
+}
+
+size_t clients_count(ws_format_t format) {
+    size_t n = 0;
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        ws_format_t client_format = registry[i].info.sub.format;
+        if(registry[i].info.fd >= 0 && (format == WS_FORMAT_ANY ? client_format != WS_FORMAT_SSE : client_format == format)) {
+            n++;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+    return n;
+}
+
+size_t clients_get(ws_client_t* clients) {
+    size_t n = 0;
+
+    portENTER_CRITICAL(&registry_lock);
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        if(registry[i].info.fd >= 0) {
+            clients[n++] = registry[i].info;
+        }
+    }
+    portEXIT_CRITICAL(&registry_lock);
+    return n;
+}
+
+void clients_get_fanout(clients_fanout_t* out) {
+    portENTER_CRITICAL(&registry_lock);
+    *out = fanout;
+    portEXIT_CRITICAL(&registry_lock);
+
+    portENTER_CRITICAL(&pool_lock);
+    out->pool_free = pool_ready ? pool_available : CLIENTS_POOL_SIZE;
+    out->pool_exhausted = pool_exhausted;
+    portEXIT_CRITICAL(&pool_lock);
+}
+
+const char* clients_format_name(ws_format_t format) {
+    return format < WS_FORMAT_COUNT ? format_names[format] : "unknown";
+}
+
+ws_format_t clients_parse_format(const char* name) {
+    for(int i = 0; i < WS_FORMAT_COUNT; i++) {
+        if(strcmp(name, format_names[i]) == 0) {
+            return (ws_format_t) i;
+        }
+    }
+    return WS_FORMAT_COUNT;
+}
+
+const char* clients_policy_name(ws_policy_t policy) {
+    return policy < WS_POLICY_COUNT ? policy_names[policy] : "unknown";
+}
+
+ws_policy_t clients_parse_policy(const char* name) {
+    for(int i = 0; i < WS_POLICY_COUNT; i++) {
+        if(strcmp(name, policy_names[i]) == 0) {
+            return (ws_policy_t) i;
+        }
+    }
+    return WS_POLICY_COUNT;
+}
@@ -0,0 +1,285 @@
+#ifndef CLIENTS_H
+#define CLIENTS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+#include <esp_http_server.h>
+#include "protocol.h"
+#include "codec.h"
+#include "stream.h"
+#include "deadband.h"
+
+#define CLIENTS_TAG "clients"
+#define CLIENTS_MAX 7   // Also the web server's max_open_sockets
+#define CLIENTS_POOL_SIZE CONFIG_WS_FRAME_POOL
+#define CLIENTS_QUEUE_LEN CONFIG_WS_CLIENT_QUEUE_LEN
+
+// Largest outbound frame: a delta-encoded batch of the largest size, or a JSON text frame
+#define CLIENTS_BATCH_FRAME_SIZE (PROTO_HEADER_SIZE + CODEC_DELTA_MAX_SIZE(STREAM_BATCH_LIMIT * ACQ_MAX_CHANNELS))
+#define CLIENTS_TEXT_FRAME_SIZE 1024
+#define CLIENTS_FRAME_SIZE (CLIENTS_BATCH_FRAME_SIZE > CLIENTS_TEXT_FRAME_SIZE ? CLIENTS_BATCH_FRAME_SIZE : CLIENTS_TEXT_FRAME_SIZE)
+
+// Sample encoding negotiated by a WebSocket client at connect time ("/ws?format=json|binary|delta")
+typedef enum {
+    WS_FORMAT_JSON,
+    WS_FORMAT_BINARY,   // PROTO_TYPE_SAMPLES
+    WS_FORMAT_DELTA,    // PROTO_TYPE_SAMPLES_DELTA
+    WS_FORMAT_SSE,      // Server-sent events of JSON samples on /events, written raw to the socket
+    WS_FORMAT_COUNT
+} ws_format_t;
+
+#define WS_FORMAT_ANY WS_FORMAT_COUNT   // Every WebSocket client
+
+// What to drop when a client's queue is full ("/ws?policy=drop-oldest|drop-newest")
+typedef enum {
+    WS_POLICY_DROP_OLDEST,  // Keep the freshest data
+    WS_POLICY_DROP_NEWEST,  // Keep the stream contiguous up to the gap
+    WS_POLICY_COUNT
+} ws_policy_t;
+
+// Sample stream a client subscribed to ("subscribe?..." text message on /ws). Clients with the
+// same format, channels and decimation share every encoded frame.
+typedef struct {
+    ws_format_t format;
+    uint16_t channel_mask;      // ADC channels to send, 0 for every scanned channel
+    uint16_t decimation;        // Send every Nth stream frame, 0 for no sample stream
+    uint16_t deadband_mv;       // Skip batches in which no channel moved this far, 0 sends every batch
+} ws_subscription_t;
+
+// Refcounted outbound frame from the shared pool
+typedef struct ws_frame {
+    struct ws_frame* next;      // Free list link
+    atomic_int refs;
+    httpd_ws_type_t type;
+    size_t len;
+    uint8_t data[CLIENTS_FRAME_SIZE];
+} ws_frame_t;
+
+// Registered WebSocket client
+typedef struct {
+    int fd;                     // -1 when the entry is free
+    ws_subscription_t sub;
+    ws_policy_t policy;
+    int64_t connected_us;
+    int64_t last_seen_us;       // Last frame (pong or other) received
+    uint32_t frames;
+    uint32_t samples;           // Samples per channel
+    uint32_t bytes;
+    uint8_t depth;              // Frames queued
+    uint8_t max_depth;
+    uint32_t dropped;           // Frames dropped by the queue policy
+    uint32_t resend_requests;
+    uint32_t resent;            // Samples per channel sent again on request
+    uint32_t unavailable;       // Samples requested again that had left the history
+} ws_client_t;
+
+// Fan-out cost and pool counters
+typedef struct {
+    uint32_t fanouts;
+    uint32_t sends;             // Frames queued over all fan-outs
+    uint64_t total_us;
+    uint32_t pool_free;
+    uint32_t pool_exhausted;    // Frames that could not be allocated
+    uint32_t evictions;         // Clients disconnected for a stalled queue or missing pongs
+    uint32_t dropped;           // Frames dropped by queue policies, all clients
+    uint32_t resent;            // Samples sent again, all clients
+    uint32_t unavailable;       // Samples requested again that had left the history, all clients
+} clients_fanout_t;
+
+/**
+ * @brief httpd open_fn. Clears any entry left on the descriptor.
+ */
+esp_err_t clients_on_open(httpd_handle_t hd, int sockfd);
+
+/**
+ * @brief httpd close_fn. Removes the client, drops its queue and closes the socket.
+ */
+void clients_on_close(httpd_handle_t hd, int sockfd);
+
+/**
+ * @brief Register a client after its WebSocket handshake, or an event stream after its response headers
+ *
+ * @param sockfd
+ * @param sub - initial subscription
+ * @param policy - queue overflow policy
+ * @param async_req - request kept open by httpd_req_async_handler_begin() (event streams), completed when
+ *                    the client is removed. NULL for WebSocket clients.
+ * @return esp_err_t - ESP_ERR_NO_MEM if the registry is full
+ */
+esp_err_t clients_add(int sockfd, const ws_subscription_t* sub, ws_policy_t policy, httpd_req_t* async_req);
+
+/**
+ * @brief Remove a client and drop its queue. Completes its open request, if any, on the calling task.
+ *
+ * @param sockfd
+ */
+void clients_remove(int sockfd);
+
+/**
+ * @brief Replace a client's subscription and hold back its live samples until the stream task has
+ *        sent it everything from a sequence number on (see clients_take_resume())
+ *
+ * @param sockfd
+ * @param sub - new subscription
+ * @param from - first sequence number the client is missing
+ * @return esp_err_t - ESP_ERR_NOT_FOUND if the client is not registered
+ */
+esp_err_t clients_resume(int sockfd, const ws_subscription_t* sub, uint32_t from);
+
+/**
+ * @brief Take one client waiting to resume. The caller, the task publishing samples, sends it the
+ *        samples from the returned sequence number up to its next batch before publishing that batch.
+ *
+ * @param sockfd - client
+ * @param from - first sequence number to send
+ * @param sub - the client's subscription
+ * @return true if a client was taken
+ */
+bool clients_take_resume(int* sockfd, uint32_t* from, ws_subscription_t* sub);
+
+/**
+ * @brief Replace a client's subscription
+ *
+ * @param sockfd
+ * @param sub - new subscription
+ * @return esp_err_t - ESP_ERR_NOT_FOUND if the client is not registered
+ */
+esp_err_t clients_subscribe(int sockfd, const ws_subscription_t* sub);
+
+/**
+ * @brief Get a client's subscription
+ *
+ * @param sockfd
+ * @param sub - destination
+ * @return esp_err_t - ESP_ERR_NOT_FOUND if the client is not registered
+ */
+esp_err_t clients_get_subscription(int sockfd, ws_subscription_t* sub);
+
+/**
+ * @brief Count a resend request of a client
+ *
+ * @param sockfd
+ * @param resent - samples sent again
+ * @param unavailable - samples no longer held
+ */
+void clients_note_resend(int sockfd, uint32_t resent, uint32_t unavailable);
+
+/**
+ * @brief Record that a frame was received from a client (keeps it alive)
+ */
+void clients_seen(int sockfd);
+
+/**
+ * @brief Take a frame from the pool. The caller holds one reference.
+ *
+ * @return ws_frame_t* - NULL if the pool is exhausted
+ */
+ws_frame_t* clients_frame_alloc(void);
+
+/**
+ * @brief Drop a reference to a frame, returning it to the pool on the last one
+ */
+void clients_frame_release(ws_frame_t* frame);
+
+/**
+ * @brief Queue a frame to every registered client of one format and schedule the sends on the
+ *        httpd task. Never blocks on the network. Consumes the caller's reference.
+ *
+ * @param hd - server handle
+ * @param frame - frame from clients_frame_alloc()
+ * @param format - clients to send to, or WS_FORMAT_ANY
+ * @param samples - samples per channel in the frame, for the client counters
+ * @return size_t - clients the frame was queued to
+ */
+size_t clients_publish(httpd_handle_t hd, ws_frame_t* frame, ws_format_t format, uint32_t samples);
+
+/**
+ * @brief Queue a frame to one client. Consumes the caller's reference.
+ *
+ * @param hd - server handle
+ * @param sockfd - client
+ * @param frame - frame from clients_frame_alloc()
+ * @param samples - samples per channel in the frame, for the client counters
+ * @return esp_err_t - ESP_ERR_NOT_FOUND if the client is not registered or its queue is full
+ */
+esp_err_t clients_send(httpd_handle_t hd, int sockfd, ws_frame_t* frame, uint32_t samples);
+
+/**
+ * @brief Queue a sample frame to every client subscribed to the same format, channels and
+ *        decimation, skipping clients whose deadband the batch does not cross. Consumes the
+ *        caller's reference.
+ *
+ * @param hd - server handle
+ * @param frame - frame from clients_frame_alloc()
+ * @param sub - subscription the frame was encoded for
+ * @param samples - samples per channel in the frame
+ * @param last_mv - last sample of each channel in the frame, in ascending channel order
+ * @param channel_count - entries in last_mv
+ * @return size_t - clients the frame was queued to
+ */
+size_t clients_publish_samples(httpd_handle_t hd, ws_frame_t* frame, const ws_subscription_t* sub, uint32_t samples,
+    const uint16_t* last_mv, uint8_t channel_count);
+
+/**
+ * @brief Distinct sample streams the registered clients subscribed to
+ *
+ * @param subs - CLIENTS_MAX entries. The deadband of each entry is unset.
+ * @return size_t - entries written
+ */
+size_t clients_subscriptions(ws_subscription_t* subs);
+
+/**
+ * @brief Ping clients that are due and disconnect stalled or silent ones. Call periodically.
+ *
+ * @param hd - server handle
+ */
+void clients_tick(httpd_handle_t hd);
+
+/**
+ * @brief Number of registered clients using a format
+ *
+ * @param format - or WS_FORMAT_ANY
+ */
+size_t clients_count(ws_format_t format);
+
+/**
+ * @brief Copy the registered clients
+ *
+ * @param clients - CLIENTS_MAX entries
+ * @return size_t - entries written
+ */
+size_t clients_get(ws_client_t* clients);
+
+/**
+ * @brief Get the fan-out cost and pool counters
+ */
+void clients_get_fanout(clients_fanout_t* fanout);
+
+/**
+ * @brief Name of a format
+ */
+const char* clients_format_name(ws_format_t format);
+
+/**
+ * @brief Parse a format name
+ *
+ * @return ws_format_t - WS_FORMAT_COUNT if the name is unknown
+ */
+ws_format_t clients_parse_format(const char* name);
+
+/**
+ * @brief Name of a queue policy
+ */
+const char* clients_policy_name(ws_policy_t policy);
+
+/**
+ * @brief Parse a queue policy name
+ *
+ * @return ws_policy_t - WS_POLICY_COUNT if the name is unknown
+ */
+ws_policy_t clients_parse_policy(const char* name);
+
+#endif
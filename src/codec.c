@@ -0,0 +1,69 @@
+/**
+ * @file codec.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Delta + zigzag varint sample compression
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "codec.h"
+
+static inline uint32_t zigzag(int32_t v) {
+    return ((uint32_t) v << 1) ^ (uint32_t) (v >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t v) {
+    return (int32_t) (v >> 1) ^ -(int32_t) (v & 1);
+}
+
+size_t codec_delta_encode(const uint16_t* samples, size_t count, size_t stride, uint8_t* out, size_t len) {
+    uint8_t* p = out;
+    uint8_t* end = out + len;
+    uint16_t prev = 0;
+
+    for(size_t i = 0; i < count; i++, samples += stride) {
+        uint32_t v = zigzag((int32_t) *samples - prev);
+        prev = *samples;
+
+        // One byte per 7 bits, high bit set on every byte but the last
+        while(v >= 0x80) {
+            if(p == end) {
+                return 0;
+            }
+            *p++ = (uint8_t) v | 0x80;
+            v >>= 7;
+        }
+        if(p == end) {
+            return 0;
+        }
+        *p++ = (uint8_t) v;
+    }
+    return p - out;
+}
+
+size_t codec_delta_decode(const uint8_t* in, size_t len, uint16_t* samples, size_t count, size_t stride) {
+    const uint8_t* p = in;
+    const uint8_t* end = in + len;
+    uint16_t prev = 0;
+
+    for(size_t i = 0; i < count; i++, samples += stride) {
+        uint32_t v = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            if(p == end || shift > 14) {
+                return 0;
+            }
+            byte = *p++;
+            v |= (uint32_t) (byte & 0x7F) << shift;
+            shift += 7;
+        } while(byte & 0x80);
+
+        prev = (uint16_t) (prev + unzigzag(v));
+        *samples = prev;
+    }
+    return p - in;
+}
@@ -0,0 +1,43 @@
+#ifndef CODEC_H
+#define CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * Delta + zigzag varint block codec for 16-bit samples.
+ *
+ * Each value is stored as the difference from the previous one (the first
+ * relative to 0), zigzag-mapped so small negative steps stay small, then
+ * written as a little-endian base-128 varint. A slowly varying channel costs
+ * one byte per sample instead of two. The worst case is 3 bytes per sample.
+ */
+
+// Largest encoding of count samples
+#define CODEC_DELTA_MAX_SIZE(count) ((count) * 3)
+
+/**
+ * @brief Encode count samples
+ *
+ * @param samples - first sample
+ * @param count - number of samples
+ * @param stride - distance between consecutive samples in samples (1 for a plain array)
+ * @param out - destination
+ * @param len - size of out
+ * @return size_t - bytes written, or 0 if out is too small
+ */
+size_t codec_delta_encode(const uint16_t* samples, size_t count, size_t stride, uint8_t* out, size_t len);
+
+/**
+ * @brief Decode count samples
+ *
+ * @param in - encoded data
+ * @param len - bytes available in in
+ * @param samples - destination
+ * @param count - number of samples to decode
+ * @param stride - distance between consecutive samples in samples
+ * @return size_t - bytes consumed, or 0 if in is truncated or malformed
+ */
+size_t codec_delta_decode(const uint8_t* in, size_t len, uint16_t* samples, size_t count, size_t stride);
+
+#endif
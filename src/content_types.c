@@ -0,0 +1,54 @@
+/**
+ * @file content_types.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Content types of the static assets, shared with the asset build scripts
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "content_types.h"
+
+#include <string.h>
+
+// Parsed by tools/compress_assets.py and tools/pack_assets.py: keep one { ".ext", "type", gzip } per line
+static const struct {
+    const char* ext;
+    const char* type;
+    bool gzip;
+} content_types[] = {
+    { ".js",    "application/javascript",   true },
+    { ".css",   "text/css",                 true },
+    { ".svg",   "image/svg+xml",            true },
+    { ".json",  "application/json",         true },
+    { ".txt",   "text/plain",               true },
+    { ".ico",   "image/x-icon",             true },
+    { ".png",   "image/png",                false },
+    { ".jpg",   "image/jpeg",               false },
+    { ".jpeg",  "image/jpeg",               false },
+    { ".gif",   "image/gif",                false },
+    { ".woff",  "font/woff",                false },
+    { ".woff2", "font/woff2",               false },
+};
+
+static int find_type(const char* name) {
+    const char* ext = strrchr(name, '.');
+    for(int i = 0; ext != NULL && i < sizeof(content_types) / sizeof(content_types[0]); i++) {
+        if(strcmp(ext, content_types[i].ext) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char* content_type_for(const char* name) {
+    int i = find_type(name);
+    return i >= 0 ? content_types[i].type : NULL;
+}
+
+bool content_type_compressible(const char* name) {
+    int i = find_type(name);
+    return i >= 0 && content_types[i].gzip;
+}
@@ -0,0 +1,29 @@
+#ifndef CONTENT_TYPES_H
+#define CONTENT_TYPES_H
+
+#include <stdbool.h>
+
+/**
+ * Static asset types by file extension. The table in content_types.c is the only list:
+ * tools/compress_assets.py and tools/pack_assets.py read it from there, so a file in data/
+ * is hashed, compressed and packed exactly when the server knows its content type. Files
+ * with other extensions, like the HTML page templates, are not assets.
+ */
+
+/**
+ * @brief Content type of an asset by the extension of its name
+ *
+ * @param name - file name
+ * @return const char* - MIME type, NULL if the extension is not listed
+ */
+const char* content_type_for(const char* name);
+
+/**
+ * @brief Whether assets of this name are worth a gzip copy (not for already compressed formats)
+ *
+ * @param name - file name
+ * @return bool - false if the extension is not listed
+ */
+bool content_type_compressible(const char* name);
+
+#endif
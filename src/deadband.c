@@ -0,0 +1,46 @@
+/**
+ * @file deadband.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Report-by-exception filter with a heartbeat
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "deadband.h"
+
+#include <string.h>
+
+void deadband_init(deadband_t* db, uint16_t deadband_mv, uint32_t max_silence_ms) {
+    memset(db, 0, sizeof(*db));
+    db->deadband_mv = deadband_mv;
+    db->max_silence_us = (int64_t) max_silence_ms * 1000;
+}
+
+bool deadband_check(deadband_t* db, uint16_t mv, int64_t now_us) {
+    bool send;
+
+    if(!db->has_last || db->deadband_mv == 0) {
+        send = true;
+    } else {
+        int delta = (int) mv - db->last_mv;
+        send = (delta < 0 ? -delta : delta) > db->deadband_mv;
+        if(!send && now_us - db->last_us >= db->max_silence_us) {
+            send = true;
+            db->heartbeats++;
+        }
+    }
+
+    if(!send) {
+        db->suppressed++;
+        return false;
+    }
+
+    db->has_last = true;
+    db->last_mv = mv;
+    db->last_us = now_us;
+    db->sent++;
+    return true;
+}
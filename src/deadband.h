@@ -0,0 +1,42 @@
+#ifndef DEADBAND_H
+#define DEADBAND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Accepted range of max_silence_ms, the same as CONFIG_WS_MAX_SILENCE_MS
+#define DEADBAND_MIN_SILENCE_MS 100
+#define DEADBAND_MAX_SILENCE_MS 3600000
+
+// Report-by-exception filter of one value stream
+typedef struct {
+    uint16_t deadband_mv;       // 0 reports every value
+    int64_t max_silence_us;     // Longest time without a report
+    bool has_last;
+    uint16_t last_mv;           // Last value reported
+    int64_t last_us;            // Time of the last report
+    uint32_t sent;
+    uint32_t heartbeats;        // Reports forced by max_silence_us (included in sent)
+    uint32_t suppressed;
+} deadband_t;
+
+/**
+ * @brief Initialize a filter
+ *
+ * @param db
+ * @param deadband_mv - minimum change to report
+ * @param max_silence_ms - report at least this often
+ */
+void deadband_init(deadband_t* db, uint16_t deadband_mv, uint32_t max_silence_ms);
+
+/**
+ * @brief Decide whether a value should be reported and update the counters
+ *
+ * @param db
+ * @param mv - new value
+ * @param now_us - esp_timer time
+ * @return true if the value should be sent
+ */
+bool deadband_check(deadband_t* db, uint16_t mv, int64_t now_us);
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file decimator.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief CIC decimation filter for acquired sample blocks
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "decimator.h"
+
+#include <string.h>
+
+esp_err_t decimator_init(decimator_t* decim, uint32_t ratio, uint8_t channels) {
+    if(ratio == 0 || ratio > DECIM_MAX_RATIO || (ratio & (ratio - 1)) != 0 || channels > ACQ_MAX_CHANNELS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    int log2_ratio = 0;
+    while((1u << log2_ratio) < ratio) {
+        log2_ratio++;
+    }
+
+    memset(decim, 0, sizeof(decimator_t));
+    decim->ratio = ratio;
+    decim->shift = DECIM_ORDER * log2_ratio - DECIM_OUT_FRAC_BITS;
+    decim->channels = channels;
+    return ESP_OK;
+}
+
+size_t decimator_process(decimator_t* decim, const uint16_t (*in)[ACQ_MAX_CHANNELS], size_t n, uint16_t (*out)[ACQ_MAX_CHANNELS]) {
+    size_t produced = 0;
+
+    for(size_t i = 0; i < n; i++) {
+        // Integrators run at the input rate
+        for(int ch = 0; ch < decim->channels; ch++) {
+            uint32_t* integ = decim->integ[ch];
+            integ[0] += in[i][ch];
+            integ[1] += integ[0];
+            integ[2] += integ[1];
+        }
+
+        if(++decim->phase < decim->ratio) {
+            continue;
+        }
+        decim->phase = 0;
+
+        // Combs run at the output rate
+        for(int ch = 0; ch < decim->channels; ch++) {
+            uint32_t* comb = decim->comb[ch];
+            uint32_t y0 = decim->integ[ch][2] - comb[0];
+            comb[0] = decim->integ[ch][2];
+            uint32_t y1 = y0 - comb[1];
+            comb[1] = y0;
+            uint32_t y2 = y1 - comb[2];
+            comb[2] = y1;
+
+            // Normalize the gain with rounding. The impulse response is non-negative, so y2 never exceeds the input full scale.
+            uint32_t q4;
+            if(decim->shift > 0) {
+                q4 = (y2 + (1u << (decim->shift - 1))) >> decim->shift;
+            } else {
+                q4 = y2 << -decim->shift;
+            }
+            out[produced][ch] = q4 > UINT16_MAX ? UINT16_MAX : (uint16_t) q4;
+        }
+        produced++;
+    }
+
+    return produced;
+}
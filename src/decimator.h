@@ -0,0 +1,50 @@
+#ifndef DECIMATOR_H
+#define DECIMATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "acquisition.h"
+
+#define DECIM_ORDER 3       // CIC stages
+#define DECIM_MAX_RATIO 64  // Keeps the integrators within 32 bits (12 + 3 * 6 = 30 bits)
+#define DECIM_OUT_FRAC_BITS 4
+
+/**
+ * Integer CIC decimator for interleaved frames.
+ *
+ * Output samples are raw ADC codes with DECIM_OUT_FRAC_BITS fractional bits (Q12.4),
+ * so oversampling gains resolution instead of being truncated back to 12 bits.
+ * The filter only uses modular 32-bit adds, so results are bit-identical on any target.
+ */
+typedef struct {
+    uint32_t ratio;
+    int8_t shift;           // Right shift that normalizes the CIC gain (ratio ^ DECIM_ORDER) to Q12.4
+    uint8_t channels;
+    uint32_t phase;
+    uint32_t integ[ACQ_MAX_CHANNELS][DECIM_ORDER];
+    uint32_t comb[ACQ_MAX_CHANNELS][DECIM_ORDER];
+} decimator_t;
+
+/**
+ * @brief Initialize (or reset) a decimator
+ *
+ * @param decim
+ * @param ratio - decimation ratio, power of two up to DECIM_MAX_RATIO
+ * @param channels - number of slots per frame
+ * @return esp_err_t
+ */
+esp_err_t decimator_init(decimator_t* decim, uint32_t ratio, uint8_t channels);
+
+/**
+ * @brief Decimate frames
+ *
+ * @param decim
+ * @param in - raw input frames
+ * @param n - number of input frames
+ * @param out - Q12.4 output frames, room for n / ratio + 1 frames
+ * @return size_t - number of output frames written
+ */
+size_t decimator_process(decimator_t* decim, const uint16_t (*in)[ACQ_MAX_CHANNELS], size_t n, uint16_t (*out)[ACQ_MAX_CHANNELS]);
+
+#endif
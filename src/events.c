@@ -0,0 +1,186 @@
+/**
+ * @file events.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Threshold crossing detection on the raw sample stream
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "events.h"
+#include "adc_lut.h"
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_log.h"
+
+// Detector of one scan slot. Thresholds are mapped to raw codes when the slot is
+// bound, so the per-sample work is two integer compares.
+typedef struct {
+    bool enabled;
+    bool primed;            // Level has been set from the first sample
+    bool above;             // Current debounced level
+    uint16_t rise_raw;      // First raw code at or above the threshold
+    uint16_t fall_raw;      // First raw code above the falling level
+    uint16_t debounce;
+    uint16_t run;           // Consecutive samples on the other side of the band
+    const uint16_t* lut;
+} event_detector_t;
+
+static event_config_t configs[ACQ_ADC_CHANNELS];
+static uint32_t config_generation = 0;
+static portMUX_TYPE config_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static uint32_t rising_count[ACQ_ADC_CHANNELS];
+static uint32_t falling_count[ACQ_ADC_CHANNELS];
+static uint32_t dropped = 0;
+
+static QueueHandle_t event_queue = NULL;
+
+// Owned by the pipeline task
+static event_detector_t detectors[ACQ_MAX_CHANNELS];
+static uint32_t bound_scan_id = 0;
+static uint32_t bound_generation = UINT32_MAX;
+
+esp_err_t events_init(void) {
+    event_queue = xQueueCreate(EVENTS_QUEUE_LEN, sizeof(event_t));
+    if(event_queue == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    // Matches the 3000 mV crossing previously detected by the web interface
+    configs[0].enabled = true;
+    configs[0].threshold_mv = 3000;
+    configs[0].hysteresis_mv = 100;
+    configs[0].debounce = 2;
+    return ESP_OK;
+}
+
+esp_err_t events_configure(uint8_t channel, const event_config_t* config) {
+    if(channel >= ACQ_ADC_CHANNELS || config->threshold_mv > EVENTS_MAX_MV || config->hysteresis_mv == 0 ||
+        config->hysteresis_mv > config->threshold_mv || config->debounce > EVENTS_MAX_DEBOUNCE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&config_lock);
+    configs[channel] = *config;
+    if(configs[channel].debounce == 0) {
+        configs[channel].debounce = 1;
+    }
+    config_generation++;
+    portEXIT_CRITICAL(&config_lock);
+    return ESP_OK;
+}
+
+void events_get_config(uint8_t channel, event_config_t* config) {
+    portENTER_CRITICAL(&config_lock);
+    *config = configs[channel];
+    portEXIT_CRITICAL(&config_lock);
+}
+
+// Rebuild the slot detectors for a new scan pattern or configuration
+static void bind_detectors(const sample_block_t* block) {
+    event_config_t slot_configs[ACQ_MAX_CHANNELS];
+
+    portENTER_CRITICAL(&config_lock);
+    for(int slot = 0; slot < block->channel_count; slot++) {
+        slot_configs[slot] = configs[block->channels[slot]];
+    }
+    bound_generation = config_generation;
+    portEXIT_CRITICAL(&config_lock);
+
+    memset(detectors, 0, sizeof(detectors));
+    for(int slot = 0; slot < block->channel_count; slot++) {
+        event_detector_t* det = &detectors[slot];
+        const event_config_t* cfg = &slot_configs[slot];
+
+        det->lut = adc_lut_get(block->atten[slot]);
+        if(!cfg->enabled || det->lut == NULL) {
+            continue;
+        }
+        det->enabled = true;
+        det->rise_raw = adc_lut_find(det->lut, cfg->threshold_mv);
+        det->fall_raw = adc_lut_find(det->lut, cfg->threshold_mv - cfg->hysteresis_mv + 1);
+
+        // At least one code of hysteresis, or a signal sitting on the threshold chatters
+        if(det->fall_raw >= det->rise_raw && det->rise_raw > 0) {
+            det->fall_raw = det->rise_raw - 1;
+        }
+        det->debounce = cfg->debounce;
+    }
+    bound_scan_id = block->scan_id;
+}
+
+static void emit(uint8_t channel, event_edge_t edge, uint16_t mv, int64_t timestamp_us) {
+    event_t event = {
+        .timestamp_us = timestamp_us,
+        .mv = mv,
+        .channel = channel,
+        .edge = (uint8_t) edge,
+    };
+
+    portENTER_CRITICAL(&config_lock);
+    event.count = edge == EVENT_RISING ? ++rising_count[channel] : ++falling_count[channel];
+    portEXIT_CRITICAL(&config_lock);
+
+    if(xQueueSend(event_queue, &event, 0) != pdTRUE) {
+        dropped++;
+    }
+}
+
+void events_process(const sample_block_t* block) {
+    if(block->scan_id != bound_scan_id || config_generation != bound_generation) {
+        bind_detectors(block);
+    }
+
+    // Sample i was read (count - 1 - i) periods before the block timestamp
+    const int64_t period_us = 1000000 / ACQ_SAMPLE_RATE_HZ;
+
+    for(int slot = 0; slot < block->channel_count; slot++) {
+        event_detector_t* det = &detectors[slot];
+        if(!det->enabled) {
+            continue;
+        }
+
+        for(int i = 0; i < block->count; i++) {
+            uint16_t raw = block->samples[i][slot];
+
+            if(!det->primed) {
+                det->above = raw >= det->rise_raw;
+                det->primed = true;
+                continue;
+            }
+
+            bool crossed = det->above ? raw < det->fall_raw : raw >= det->rise_raw;
+            if(!crossed) {
+                det->run = 0;
+                continue;
+            }
+
+            if(++det->run >= det->debounce) {
+                det->above = !det->above;
+                det->run = 0;
+                emit(block->channels[slot], det->above ? EVENT_RISING : EVENT_FALLING, det->lut[raw],
+                     block->timestamp_us - (block->count - 1 - i) * period_us);
+            }
+        }
+    }
+}
+
+bool events_receive(event_t* event, TickType_t timeout) {
+    return xQueueReceive(event_queue, event, timeout) == pdTRUE;
+}
+
+void events_get_counters(uint8_t channel, uint32_t* rising, uint32_t* falling) {
+    portENTER_CRITICAL(&config_lock);
+    *rising = rising_count[channel];
+    *falling = falling_count[channel];
+    portEXIT_CRITICAL(&config_lock);
+}
+
+uint32_t events_dropped(void) {
+    return dropped;
+}
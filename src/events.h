@@ -0,0 +1,86 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "acquisition.h"
+
+#define EVENTS_TAG "events"
+#define EVENTS_QUEUE_LEN 32
+#define EVENTS_MAX_MV 3300          // Largest threshold or hysteresis
+#define EVENTS_MAX_DEBOUNCE 1000    // Largest debounce, in samples
+
+typedef enum {
+    EVENT_RISING,
+    EVENT_FALLING
+} event_edge_t;
+
+// Threshold detector settings of one ADC channel
+typedef struct {
+    bool enabled;
+    uint16_t threshold_mv;      // Rising edge when the signal reaches threshold_mv
+    uint16_t hysteresis_mv;     // Falling edge when the signal drops to threshold_mv - hysteresis_mv, at least 1
+    uint16_t debounce;          // Consecutive samples required to confirm an edge
+} event_config_t;
+
+// Detected edge
+typedef struct {
+    int64_t timestamp_us;       // esp_timer time of the sample that confirmed the edge
+    uint32_t count;             // Edges of this direction seen on the channel so far
+    uint16_t mv;
+    uint8_t channel;
+    uint8_t edge;               // event_edge_t
+} event_t;
+
+/**
+ * @brief Create the event queue and load the default configuration
+ *        (channel 0: 3000 mV threshold, 100 mV hysteresis)
+ *
+ * @return esp_err_t
+ */
+esp_err_t events_init(void);
+
+/**
+ * @brief Configure the detector of one ADC channel. Takes effect at the next block.
+ *
+ * @param channel - ADC1 channel
+ * @param config
+ * @return esp_err_t - ESP_ERR_INVALID_ARG if the hysteresis is 0 or above the threshold, the threshold is
+ *                     above EVENTS_MAX_MV or the debounce above EVENTS_MAX_DEBOUNCE
+ */
+esp_err_t events_configure(uint8_t channel, const event_config_t* config);
+
+/**
+ * @brief Get the detector configuration of one ADC channel
+ */
+void events_get_config(uint8_t channel, event_config_t* config);
+
+/**
+ * @brief Run the detectors over every raw sample of a block
+ *
+ * @param block - acquired block
+ */
+void events_process(const sample_block_t* block);
+
+/**
+ * @brief Wait for the next detected edge
+ *
+ * @param event - destination
+ * @param timeout - in ticks, portMAX_DELAY to wait forever
+ * @return true if an event was received
+ */
+bool events_receive(event_t* event, TickType_t timeout);
+
+/**
+ * @brief Get the edge counters of one ADC channel
+ */
+void events_get_counters(uint8_t channel, uint32_t* rising, uint32_t* falling);
+
+/**
+ * @brief Number of events lost because the queue was full
+ */
+uint32_t events_dropped(void);
+
+#endif
@@ -0,0 +1,340 @@
+/**
+ * @file history.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Compact RAM history of the sample stream for client backfill and retransmission
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "history.h"
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+
+_Static_assert(HISTORY_SECONDS >= 2 && HISTORY_RECENT_SECONDS >= 2, "History tiers must hold at least 2 s");
+
+// One tier. Points are written by the producer only; the counters are published under history_lock.
+typedef struct {
+    uint8_t* data;              // Slot s starts at data + s * ring_bytes
+    size_t ring_bytes;
+    uint32_t len;               // Points per channel
+    uint32_t guard;             // Points a reader leaves alone at the old end of a full ring, so the
+                                // producer can keep writing during a read without overwriting the copy
+    uint32_t decimation;        // Input frames averaged into one point
+    uint32_t acc_frames;
+    uint32_t acc_sum[ACQ_MAX_CHANNELS];
+    uint32_t written;           // Points written since the reset, wraps: only differences of it are used
+    uint32_t head;              // Ring position of the next point
+    uint32_t held;              // Points in the ring, at most len
+    uint32_t newest_seq;        // Sequence number of the last frame of the newest point
+    int64_t newest_us;          // Time of the newest point
+    uint32_t period_us;
+} history_ring_t;
+
+// Counters of a tier copied under the lock
+typedef struct {
+    uint32_t written;
+    uint32_t head;
+    uint32_t held;
+    uint32_t newest_seq;
+    int64_t newest_us;
+    uint32_t period_us;
+    uint32_t generation;
+} history_snapshot_t;
+
+static uint8_t averaged_data[ACQ_MAX_CHANNELS][HISTORY_RING_BYTES];
+static uint8_t recent_data[ACQ_MAX_CHANNELS][HISTORY_RECENT_RING_BYTES];
+
+static history_ring_t averaged = {
+    .data = averaged_data[0],
+    .ring_bytes = HISTORY_RING_BYTES,
+    .len = HISTORY_LEN,
+    .guard = HISTORY_RATE_HZ,
+    .decimation = 1,
+};
+static history_ring_t recent = {
+    .data = recent_data[0],
+    .ring_bytes = HISTORY_RECENT_RING_BYTES,
+    .len = HISTORY_RECENT_LEN,
+    .guard = HISTORY_RECENT_LEN / HISTORY_RECENT_SECONDS,
+    .decimation = 1,
+};
+
+static uint32_t generation = 0;         // Incremented by every reset
+static uint16_t history_mask = 0;
+static uint8_t history_channels = 0;
+static portMUX_TYPE history_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Point i of a ring lives in bytes 3 * (i / 2) .. 3 * (i / 2) + 2: the even point in the low
+// 12 bits, the odd point in the high 12 bits
+static inline void put_point(uint8_t* buf, uint32_t i, uint16_t mv) {
+    uint8_t* p = buf + i / 2 * 3;
+    if(i & 1) {
+        p[1] = (p[1] & 0x0f) | (mv << 4);
+        p[2] = mv >> 4;
+    } else {
+        p[0] = mv;
+        p[1] = (p[1] & 0xf0) | (mv >> 8);
+    }
+}
+
+static inline uint16_t get_point(const uint8_t* buf, uint32_t i) {
+    const uint8_t* p = buf + i / 2 * 3;
+    return i & 1 ? (p[1] >> 4) | (p[2] << 4) : p[0] | ((p[1] & 0x0f) << 8);
+}
+
+// Call with history_lock held
+static void ring_reset(history_ring_t* ring, uint32_t decimation, uint32_t input_rate_hz) {
+    ring->decimation = decimation;
+    ring->acc_frames = 0;
+    memset(ring->acc_sum, 0, sizeof(ring->acc_sum));
+    ring->written = 0;
+    ring->head = 0;
+    ring->held = 0;
+    ring->period_us = (uint32_t) ((uint64_t) decimation * 1000000 / input_rate_hz);
+}
+
+static void ring_push(history_ring_t* ring, uint32_t seq, int64_t timestamp_us, const uint16_t* mv) {
+    for(int slot = 0; slot < history_channels; slot++) {
+        ring->acc_sum[slot] += mv[slot];
+    }
+    if(++ring->acc_frames < ring->decimation) {
+        return;
+    }
+
+    // Only the producer writes, so the point can be stored before it is published
+    uint32_t pos = ring->head;
+    for(int slot = 0; slot < history_channels; slot++) {
+        uint32_t avg = (ring->acc_sum[slot] + ring->acc_frames / 2) / ring->acc_frames;
+        put_point(ring->data + slot * ring->ring_bytes, pos, avg < HISTORY_MAX_MV ? avg : HISTORY_MAX_MV);
+        ring->acc_sum[slot] = 0;
+    }
+    ring->acc_frames = 0;
+
+    portENTER_CRITICAL(&history_lock);
+    ring->written++;
+    ring->head = pos + 1 < ring->len ? pos + 1 : 0;
+    if(ring->held < ring->len) {
+        ring->held++;
+    }
+    ring->newest_seq = seq;
+    ring->newest_us = timestamp_us;
+    portEXIT_CRITICAL(&history_lock);
+}
+
+static void ring_snapshot(const history_ring_t* ring, history_snapshot_t* snap, history_span_t* span) {
+    portENTER_CRITICAL(&history_lock);
+    snap->written = ring->written;
+    snap->head = ring->head;
+    snap->held = ring->held;
+    snap->newest_seq = ring->newest_seq;
+    snap->newest_us = ring->newest_us;
+    snap->period_us = ring->period_us;
+    snap->generation = generation;
+    span->channel_mask = history_mask;
+    span->channel_count = history_channels;
+    portEXIT_CRITICAL(&history_lock);
+}
+
+// Points a reader may copy
+static inline uint32_t ring_readable(const history_ring_t* ring, const history_snapshot_t* snap) {
+    return snap->held < ring->len - ring->guard ? snap->held : ring->len - ring->guard;
+}
+
+// Ring position of a point given by its write index. The index is taken relative to the newest
+// point, so the wrap of the write counter does not matter; the point must still be in the ring.
+static inline uint32_t ring_pos(const history_ring_t* ring, const history_snapshot_t* snap, uint32_t index) {
+    uint32_t back = snap->written - 1 - index;
+    return (snap->head + ring->len - 1 - back) % ring->len;
+}
+
+// A reset during the copy invalidates it
+static bool snapshot_valid(const history_snapshot_t* snap) {
+    portENTER_CRITICAL(&history_lock);
+    bool valid = generation == snap->generation;
+    portEXIT_CRITICAL(&history_lock);
+    return valid;
+}
+
+void history_reset(uint16_t channel_mask, uint8_t channel_count, uint32_t input_rate_hz) {
+    uint32_t decimation = (input_rate_hz + HISTORY_RATE_HZ / 2) / HISTORY_RATE_HZ;
+
+    portENTER_CRITICAL(&history_lock);
+    generation++;
+    history_mask = channel_mask;
+    history_channels = channel_count;
+    ring_reset(&averaged, decimation > 0 ? decimation : 1, input_rate_hz);
+    ring_reset(&recent, 1, input_rate_hz);
+    portEXIT_CRITICAL(&history_lock);
+}
+
+void history_push_frame(uint32_t seq, int64_t timestamp_us, const uint16_t* mv) {
+    ring_push(&recent, seq, timestamp_us, mv);
+    ring_push(&averaged, seq, timestamp_us, mv);
+}
+
+size_t history_read(uint32_t seconds, uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t max, history_span_t* span) {
+    history_snapshot_t snap;
+    ring_snapshot(&averaged, &snap, span);
+
+    uint32_t available = ring_readable(&averaged, &snap);
+    if(available == 0) {
+        return 0;
+    }
+    uint64_t wanted = (uint64_t) seconds * 1000000 / snap.period_us;
+    if(wanted < available) {
+        available = wanted;
+    }
+    if(available == 0 || max == 0 || span->channel_count == 0) {
+        return 0;
+    }
+
+    // Average groups of step points. Groups end on the newest point; a partial group at the old end is left out.
+    uint32_t step = (available + max - 1) / max;
+    size_t n = available / step;
+    uint32_t start = snap.written - n * step;
+
+    for(size_t i = 0; i < n; i++) {
+        for(int slot = 0; slot < span->channel_count; slot++) {
+            const uint8_t* buf = averaged.data + slot * averaged.ring_bytes;
+            uint32_t sum = 0;
+            for(uint32_t k = 0; k < step; k++) {
+                sum += get_point(buf, ring_pos(&averaged, &snap, start + i * step + k));
+            }
+            mv[i][slot] = (sum + step / 2) / step;
+        }
+    }
+
+    if(!snapshot_valid(&snap)) {
+        return 0;
+    }
+
+    span->period_us = snap.period_us * step;
+    span->first_us = snap.newest_us - (int64_t) (n - 1) * span->period_us;
+    span->first_seq = 0;
+    return n;
+}
+
+size_t history_read_recent(uint32_t from, uint32_t end, uint16_t step, uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t max,
+    history_span_t* span) {
+    history_snapshot_t snap;
+    ring_snapshot(&recent, &snap, span);
+
+    uint32_t readable = ring_readable(&recent, &snap);
+    if(readable == 0 || max == 0 || step == 0 || span->channel_count == 0) {
+        return 0;
+    }
+
+    // Sequence numbers wrap, so compare through signed differences
+    uint32_t oldest = snap.newest_seq - (readable - 1);
+    uint32_t seq = (int32_t) (from - oldest) < 0 ? oldest : from;
+    if(seq % step != 0) {
+        seq += step - seq % step;
+    }
+
+    uint32_t first = seq;
+    size_t n = 0;
+    while(n < max && (int32_t) (seq - end) < 0 && (int32_t) (seq - snap.newest_seq) <= 0) {
+        uint32_t pos = ring_pos(&recent, &snap, snap.written - 1 - (snap.newest_seq - seq));
+        for(int slot = 0; slot < span->channel_count; slot++) {
+            mv[n][slot] = get_point(recent.data + slot * recent.ring_bytes, pos);
+        }
+        seq += step;
+        n++;
+    }
+
+    if(n == 0 || !snapshot_valid(&snap)) {
+        return 0;
+    }
+
+    span->first_seq = first;
+    span->period_us = snap.period_us * step;
+    span->first_us = snap.newest_us - (int64_t) (snap.newest_seq - first) * snap.period_us;
+    return n;
+}
+
+size_t history_find(int64_t from_us, int64_t to_us, history_range_t* range) {
+    history_snapshot_t snap;
+    history_span_t span;
+    ring_snapshot(&averaged, &snap, &span);
+
+    memset(range, 0, sizeof(*range));
+    uint32_t readable = ring_readable(&averaged, &snap);
+    if(readable == 0 || span.channel_count == 0 || to_us < from_us || from_us > snap.newest_us) {
+        return 0;
+    }
+
+    // Points counted back from the newest: the first wanted is the oldest one at or after from_us,
+    // the last the newest one at or before to_us
+    int64_t back_first = (snap.newest_us - from_us) / snap.period_us;
+    int64_t back_last = to_us < snap.newest_us ? (snap.newest_us - to_us + snap.period_us - 1) / snap.period_us : 0;
+    if(back_first >= readable) {
+        back_first = readable - 1;
+    }
+    if(back_last > back_first) {
+        return 0;
+    }
+
+    range->first = snap.written - 1 - back_first;
+    range->count = back_first - back_last + 1;
+    range->generation = snap.generation;
+    range->first_us = snap.newest_us - back_first * snap.period_us;
+    range->period_us = snap.period_us;
+    range->channel_mask = span.channel_mask;
+    range->channel_count = span.channel_count;
+    return range->count;
+}
+
+size_t history_aggregate(const history_range_t* range, uint8_t slot, uint32_t offset, uint32_t per_bucket,
+    history_bucket_t* buckets, size_t n) {
+    if(slot >= range->channel_count || per_bucket == 0 || offset >= range->count) {
+        return 0;
+    }
+
+    // The points must still be in the ring when the copy starts...
+    history_snapshot_t snap;
+    history_span_t span;
+    ring_snapshot(&averaged, &snap, &span);
+    uint32_t start = range->first + offset;
+    if(snap.generation != range->generation || snap.written - start > averaged.len - averaged.guard) {
+        return 0;
+    }
+
+    const uint8_t* buf = averaged.data + slot * averaged.ring_bytes;
+    size_t filled = 0;
+    for(uint32_t pos = offset; filled < n && pos < range->count; pos += per_bucket) {
+        uint32_t len = range->count - pos < per_bucket ? range->count - pos : per_bucket;
+        uint16_t min = UINT16_MAX;
+        uint16_t max = 0;
+        uint32_t sum = 0;
+        for(uint32_t k = 0; k < len; k++) {
+            uint16_t mv = get_point(buf, ring_pos(&averaged, &snap, range->first + pos + k));
+            min = mv < min ? mv : min;
+            max = mv > max ? mv : max;
+            sum += mv;
+        }
+        buckets[filled].min_mv = min;
+        buckets[filled].max_mv = max;
+        buckets[filled].mean_mv = (sum + len / 2) / len;
+        filled++;
+    }
+
+    // ...and not have been overwritten by the time it ends
+    ring_snapshot(&averaged, &snap, &span);
+    if(snap.generation != range->generation || snap.written - start > averaged.len) {
+        return 0;
+    }
+    return filled;
+}
+
+uint32_t history_recent_oldest(void) {
+    history_snapshot_t snap;
+    history_span_t span;
+    ring_snapshot(&recent, &snap, &span);
+
+    uint32_t readable = ring_readable(&recent, &snap);
+    return readable > 0 ? snap.newest_seq - (readable - 1) : snap.newest_seq + 1;
+}
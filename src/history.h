@@ -0,0 +1,142 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include "acquisition.h"
+
+#define HISTORY_TAG "history"
+#define HISTORY_RATE_HZ CONFIG_HISTORY_RATE_HZ
+#define HISTORY_SECONDS CONFIG_HISTORY_SECONDS
+#define HISTORY_LEN (HISTORY_SECONDS * HISTORY_RATE_HZ)    // Averaged points kept per channel
+#define HISTORY_RECENT_SECONDS CONFIG_HISTORY_RECENT_SECONDS
+#define HISTORY_RECENT_LEN (HISTORY_RECENT_SECONDS * ACQ_SAMPLE_RATE_HZ / ACQ_DECIMATION_RATIO)  // Full-rate points per channel
+#define HISTORY_MAX_MV 4095                                 // Largest value a point can hold
+
+/**
+ * RAM history of the decimated stream in two tiers:
+ *  - averaged: HISTORY_LEN points averaged down to about HISTORY_RATE_HZ, for backfill
+ *  - recent: the last HISTORY_RECENT_SECONDS at the full stream rate, addressed by frame
+ *    sequence number, for retransmission
+ *
+ * Points are 12-bit fixed-point millivolts (1 mV LSB), packed two to three bytes, so a
+ * point costs 1.5 bytes and a channel-second 1.5 bytes per Hz of the tier: 15 B averaged
+ * at the default 10 Hz, 187.5 B recent at the default 125 Hz stream. With the defaults
+ * (300 s and 8 s of ACQ_MAX_CHANNELS = 4 channels) the two rings take 18 KB + 6 KB of
+ * internal SRAM.
+ *
+ * The averaged tier decimates by the whole number of input frames closest to
+ * input rate / HISTORY_RATE_HZ, so its actual rate is only approximately HISTORY_RATE_HZ:
+ * the default 125 Hz stream averages 13 frames per point, about 9.6 Hz, and the ring then
+ * spans HISTORY_LEN points = about 312 s rather than HISTORY_SECONDS. Spans and ranges
+ * carry the actual period_us, which callers must use instead of HISTORY_RATE_HZ.
+ */
+#define HISTORY_RING_BYTES ((HISTORY_LEN + 1) / 2 * 3)
+#define HISTORY_RECENT_RING_BYTES ((HISTORY_RECENT_LEN + 1) / 2 * 3)
+
+// Points returned by a history read
+typedef struct {
+    uint16_t channel_mask;
+    uint8_t channel_count;
+    int64_t first_us;           // esp_timer time of the first point
+    uint32_t period_us;         // Spacing of the points
+    uint32_t first_seq;         // Frame sequence number of the first point (recent tier only)
+} history_span_t;
+
+// Averaged points covering a time range, resolved once and then aggregated in pieces
+typedef struct {
+    uint32_t first;             // Index of the first point since the reset
+    uint32_t count;
+    uint32_t generation;
+    int64_t first_us;           // esp_timer time of the first point
+    uint32_t period_us;         // Spacing of the points
+    uint16_t channel_mask;
+    uint8_t channel_count;
+} history_range_t;
+
+// Aggregate of consecutive averaged points of one channel
+typedef struct {
+    uint16_t min_mv;
+    uint16_t max_mv;
+    uint16_t mean_mv;
+} history_bucket_t;
+
+/**
+ * @brief Restart the history for a new set of channels
+ *
+ * @param channel_mask - ADC channels of the slots
+ * @param channel_count - number of slots
+ * @param input_rate_hz - rate at which history_push_frame() will be called; the averaged
+ *                        tier keeps one point per round(input_rate_hz / HISTORY_RATE_HZ) frames
+ */
+void history_reset(uint16_t channel_mask, uint8_t channel_count, uint32_t input_rate_hz);
+
+/**
+ * @brief Feed one frame (one millivolt value per slot). Single producer.
+ *
+ * @param seq - frame sequence number, consecutive between resets
+ * @param timestamp_us - esp_timer time of the frame
+ * @param mv - one value per slot
+ */
+void history_push_frame(uint32_t seq, int64_t timestamp_us, const uint16_t* mv);
+
+/**
+ * @brief Copy the newest averaged points covering up to the given time, averaged further in
+ *        groups so that no more than max points come back. Does not block the producer.
+ *
+ * @param seconds - history to read
+ * @param mv - destination, max entries
+ * @param max - points to return at most
+ * @param span - layout and timing of the points
+ * @return size_t - points written
+ */
+size_t history_read(uint32_t seconds, uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t max, history_span_t* span);
+
+/**
+ * @brief Copy full-rate frames by sequence number: the frames from the first one at or after
+ *        from whose sequence number is a multiple of step, taking every step-th, up to max frames
+ *        and stopping before end. Does not block the producer.
+ *
+ * @param from - first sequence number wanted
+ * @param end - sequence number to stop before
+ * @param step - decimation of the reader (1 for every frame)
+ * @param mv - destination, max entries
+ * @param max - frames to return at most
+ * @param span - layout, timing and first sequence number of the frames
+ * @return size_t - frames written, 0 if none of the range is still held
+ */
+size_t history_read_recent(uint32_t from, uint32_t end, uint16_t step, uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t max,
+    history_span_t* span);
+
+/**
+ * @brief Find the averaged points with times in [from_us, to_us]. Does not block the producer.
+ *
+ * @param from_us - esp_timer time of the first point wanted
+ * @param to_us - esp_timer time of the last point wanted
+ * @param range - the points found
+ * @return size_t - points in the range
+ */
+size_t history_find(int64_t from_us, int64_t to_us, history_range_t* range);
+
+/**
+ * @brief Reduce points of a range to min/max/mean buckets of per_bucket points each (the last
+ *        one may be shorter). Does not block the producer.
+ *
+ * @param range - from history_find()
+ * @param slot - channel slot
+ * @param offset - first point, counted from the start of the range
+ * @param per_bucket - points per bucket
+ * @param buckets - destination, n entries
+ * @param n - buckets to fill
+ * @return size_t - buckets filled, 0 if the points have left the history or it was reset
+ */
+size_t history_aggregate(const history_range_t* range, uint8_t slot, uint32_t offset, uint32_t per_bucket,
+    history_bucket_t* buckets, size_t n);
+
+/**
+ * @brief Oldest sequence number history_read_recent() can still return
+ */
+uint32_t history_recent_oldest(void);
+
+#endif
@@ -23,6 +23,10 @@
 #include "driver/adc.h"
 #include "wifi.h"
 #include "web.h"
+#include "acquisition.h"
+#include "pipeline.h"
+#include "events.h"
+#include "udp_stream.h"
 
 #include "lwip/err.h"
 #include "lwip/sys.h"
@@ -104,21 +108,20 @@ void heap_monitor_task(void *pvParameter) {
 
 
 void setup_io() {
-    // Initialize the ADC with default configuration and calibrate it
-    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_DEFAULT, 0, &adc1_chars);
-
-    // Configure the ADC channel with the default configuration width
-    ESP_ERROR_CHECK(adc1_config_width(ADC_WIDTH_BIT_DEFAULT));
-    
-    // Configure the ADC0 channel with the default configuration attenuation
-    ESP_ERROR_CHECK(adc1_config_channel_atten(ADC1_CHANNEL_0, ADC_ATTEN_DB_11));
+    // Start continuous (DMA) acquisition. Channels, attenuation and calibration come from the channel table
+#if CONFIG_ACQ_MOCK_SOURCE
+    ESP_ERROR_CHECK(acquisition_start(&acq_mock_source));
+#else
+    ESP_ERROR_CHECK(acquisition_start(&acq_adc_source));
+#endif
 
     // Configure the GPIO pin as an input/output pin
     ESP_ERROR_CHECK(gpio_set_direction(OUTPUT_GPIO_PIN, GPIO_MODE_INPUT_OUTPUT)); 
    
 }
 
-// Main application entry point
+// Main application entry point. Unit tests under test/ supply their own.
+#ifndef PIO_UNIT_TESTING
 void app_main() {
     ESP_LOGI(TAG, "Hello, from ESP32 SensorLink!");
     // Initialize the Serial Peripheral Interface Flash File System (SPIFFS)
@@ -149,9 +152,26 @@ void app_main() {
     // Setup the GPIO pins
     setup_io();
 
-    // Create a task to broadcast a random value every second 
+    // Detectors are fed by the pipeline task
+    ESP_ERROR_CHECK(events_init());
+
+    // Create a task to process acquired blocks
+    xTaskCreate(pipeline_task, "pipeline_task", 4096, NULL, 6, NULL);
+
+    // Create a task to broadcast the averaged ADC values on every publish tick
     xTaskCreate(broadcast_adc_values, "broadcast_adc_values", 4096, NULL, 5, NULL);
 
+    // Create a task to stream the decimated samples to binary clients in batches
+    xTaskCreate(stream_samples, "stream_samples", 4096, NULL, 5, NULL);
+
+    // Create a task to push detected edges as soon as they occur
+    xTaskCreate(broadcast_events, "broadcast_events", 3072, NULL, 5, NULL);
+
+#if CONFIG_UDP_STREAM
+    // Create a task to send the raw UDP stream
+    xTaskCreate(udp_stream_task, "udp_stream_task", 3072, NULL, 5, NULL);
+#endif
+
     // Create a task to monitor the free heap size
     xTaskCreate(heap_monitor_task, "heap_monitor_task", 2048, NULL, 5, NULL);
 
@@ -168,4 +188,5 @@ void app_main() {
     esp_vfs_spiffs_unregister(NULL);
 
     ESP_LOGI(TAG, "Goodbye!");
-}
\ No newline at end of file
+}
+#endif
@@ -0,0 +1,47 @@
+/**
+ * @file mock_signal.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Synthetic waveform generator of the mock sample source
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "mock_signal.h"
+
+#include <math.h>
+
+// 1 Hz sine spanning most of the 12-bit range, with a little noise
+#define MOCK_SIGNAL_HZ 1
+#define MOCK_OFFSET 2048.0f
+#define MOCK_AMPLITUDE 1800.0f
+#define MOCK_NOISE_LSB 8
+
+void mock_signal_init(mock_signal_t* sig, uint32_t frame_rate_hz, uint8_t channels) {
+    sig->period = frame_rate_hz / MOCK_SIGNAL_HZ > 0 ? frame_rate_hz / MOCK_SIGNAL_HZ : 1;
+    sig->index = 0;
+    sig->channels = channels;
+    sig->noise_state = 1;
+}
+
+void mock_signal_fill(mock_signal_t* sig, uint16_t (*frames)[ACQ_MAX_CHANNELS], size_t len) {
+    for(size_t i = 0; i < len; i++) {
+        float phase = 2.0f * (float) M_PI * sig->index / sig->period;
+        if(++sig->index == sig->period) {
+            sig->index = 0;
+        }
+
+        // Each slot gets the same sine shifted by a quarter period per slot
+        for(int slot = 0; slot < sig->channels; slot++) {
+            sig->noise_state ^= sig->noise_state << 13;
+            sig->noise_state ^= sig->noise_state >> 17;
+            sig->noise_state ^= sig->noise_state << 5;
+            int noise = (int) (sig->noise_state % (2 * MOCK_NOISE_LSB + 1)) - MOCK_NOISE_LSB;
+
+            int value = (int) (MOCK_OFFSET + MOCK_AMPLITUDE * sinf(phase + slot * (float) M_PI_2)) + noise;
+            frames[i][slot] = (uint16_t) (value < 0 ? 0 : (value > 4095 ? 4095 : value));
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef MOCK_SIGNAL_H
+#define MOCK_SIGNAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "acquisition.h"
+
+/**
+ * Synthetic waveform behind acq_mock_source: a 1 Hz sine per slot, shifted a quarter period
+ * per slot, spanning most of the 12-bit range with a little noise. Pure computation, so it
+ * builds and runs the same on the host. The phase wraps every signal period, so the waveform
+ * stays exact however long it runs.
+ */
+typedef struct {
+    uint32_t period;        // Samples per signal period
+    uint32_t index;         // Sample index within the period
+    uint8_t channels;
+    uint32_t noise_state;   // xorshift32 state
+} mock_signal_t;
+
+/**
+ * @brief Initialize a generator
+ *
+ * @param sig
+ * @param frame_rate_hz - frames per second
+ * @param channels - slots filled per frame
+ */
+void mock_signal_init(mock_signal_t* sig, uint32_t frame_rate_hz, uint8_t channels);
+
+/**
+ * @brief Generate the next frames
+ *
+ * @param sig
+ * @param frames - destination
+ * @param len - frames to generate
+ */
+void mock_signal_fill(mock_signal_t* sig, uint16_t (*frames)[ACQ_MAX_CHANNELS], size_t len);
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file mock_source.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Synthetic sample source for running the acquisition path without an ADC
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "acquisition.h"
+#include "mock_signal.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+
+static uint32_t mock_rate_hz = 0;
+static uint64_t mock_frames = 0;    // Frames released since start, for pacing
+static int64_t mock_start_us = 0;
+static mock_signal_t mock_signal;
+
+static esp_err_t mock_source_start(uint32_t frame_rate_hz, const acq_scan_t* scan) {
+    mock_rate_hz = frame_rate_hz;
+    mock_frames = 0;
+    mock_start_us = esp_timer_get_time();
+    mock_signal_init(&mock_signal, frame_rate_hz, scan->count);
+    return ESP_OK;
+}
+
+static size_t mock_source_read(uint16_t (*frames)[ACQ_MAX_CHANNELS], size_t len, uint32_t timeout_ms) {
+    // Release samples at the configured rate, as the ADC would
+    int64_t due = (esp_timer_get_time() - mock_start_us) * mock_rate_hz / 1000000;
+    int64_t missing = (int64_t) (mock_frames + len) - due;
+    if(missing > 0) {
+        uint32_t wait_ms = (uint32_t) (missing * 1000 / mock_rate_hz) + 1;
+        vTaskDelay(pdMS_TO_TICKS(wait_ms < timeout_ms ? wait_ms : timeout_ms) + 1);
+    }
+
+    mock_signal_fill(&mock_signal, frames, len);
+    mock_frames += len;
+    return len;
+}
+
+static void mock_source_stop(void) {
+    mock_rate_hz = 0;
+}
+
+const acq_source_t acq_mock_source = {
+    .name = "mock",
+    .start = mock_source_start,
+    .read = mock_source_read,
+    .stop = mock_source_stop,
+};
@@ -0,0 +1,175 @@
+/**
+ * @file pipeline.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Processing of acquired blocks, independent of the publishing cadence
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "pipeline.h"
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include "decimator.h"
+#include "adc_lut.h"
+#include "stats.h"
+#include "events.h"
+#include "stream.h"
+#include "history.h"
+#include "udp_stream.h"
+
+// Accumulators shared with the publisher
+static portMUX_TYPE avg_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t avg_sum[ACQ_MAX_CHANNELS];
+static uint32_t avg_frames = 0;
+static uint8_t avg_channel_count = 0;
+static uint8_t avg_channels[ACQ_MAX_CHANNELS];
+
+// Decimation cost
+static uint64_t decim_cycles = 0;
+static uint64_t decim_samples = 0;
+
+// Block arrival timing. Blocks are expected every ACQ_BLOCK_SIZE sample periods.
+static timing_monitor_t block_timing;
+static portMUX_TYPE timing_lock = portMUX_INITIALIZER_UNLOCKED;
+
+void pipeline_task(void* pvParameters) {
+    static decimator_t decim;
+    static uint16_t q4[ACQ_BLOCK_SIZE / ACQ_DECIMATION_RATIO + 1][ACQ_MAX_CHANNELS];
+    const uint16_t* luts[ACQ_MAX_CHANNELS] = { NULL };
+    uint32_t last_scan_id = 0;
+    bool decim_ready = false;
+    uint32_t next_seq = 0;
+    uint32_t frame_seq = 0;     // Sequence number of the next decimated frame, never reset
+
+    timing_init(&block_timing, "blocks", (uint32_t) ((uint64_t) ACQ_BLOCK_SIZE * 1000000 / ACQ_SAMPLE_RATE_HZ));
+
+    while(1) {
+        const sample_block_t* block = acquisition_peek_block(ACQ_READ_TIMEOUT_MS);
+        if(block == NULL) {
+            continue;
+        }
+
+        // Blocks missing from the sequence were dropped on overrun
+        portENTER_CRITICAL(&timing_lock);
+        if(block->seq != next_seq && next_seq != 0) {
+            timing_miss(&block_timing, block->seq - next_seq);
+        }
+        timing_record(&block_timing, block->timestamp_us);
+        portEXIT_CRITICAL(&timing_lock);
+        next_seq = block->seq + 1;
+
+        // A scan change, even one of attenuation only, restarts the filter and the averages
+        if(block->scan_id != last_scan_id) {
+            last_scan_id = block->scan_id;
+            esp_err_t err = decimator_init(&decim, ACQ_DECIMATION_RATIO, block->channel_count);
+            decim_ready = err == ESP_OK;
+            if(!decim_ready) {
+                ESP_LOGE(PIPELINE_TAG, "Failed to set up the decimator for %u channels. Error: %s", block->channel_count, esp_err_to_name(err));
+            }
+            stats_reset(block->channel_count, block->channels, ACQ_SAMPLE_RATE_HZ / ACQ_DECIMATION_RATIO);
+            history_reset(block->channel_mask, block->channel_count, ACQ_SAMPLE_RATE_HZ / ACQ_DECIMATION_RATIO);
+
+            portENTER_CRITICAL(&avg_lock);
+            memset(avg_sum, 0, sizeof(avg_sum));
+            avg_frames = 0;
+            avg_channel_count = block->channel_count;
+            memcpy(avg_channels, block->channels, sizeof(avg_channels));
+            portEXIT_CRITICAL(&avg_lock);
+        }
+
+        // Edge detection runs on every raw sample, ahead of the filter
+        events_process(block);
+
+#if CONFIG_UDP_STREAM
+        // The UDP stream carries the undecimated samples
+        udp_stream_push_block(block);
+#endif
+
+        // Nothing is published for a scan the filter cannot take
+        if(!decim_ready) {
+            acquisition_release_block();
+            continue;
+        }
+
+        // A calibration table that could not be allocated drops the block instead of converting through NULL
+        bool luts_ready = true;
+        for(int slot = 0; slot < block->channel_count; slot++) {
+            luts[slot] = adc_lut_get(block->atten[slot]);
+            luts_ready &= luts[slot] != NULL;
+        }
+        if(!luts_ready) {
+            ESP_LOGW(PIPELINE_TAG, "No calibration table for block %lu, dropped", (unsigned long) block->seq);
+            acquisition_release_block();
+            continue;
+        }
+
+        uint32_t start_cycles = esp_cpu_get_cycle_count();
+        size_t n = decimator_process(&decim, block->samples, block->count, q4);
+        decim_cycles += esp_cpu_get_cycle_count() - start_cycles;
+        decim_samples += block->count * block->channel_count;
+
+        int64_t sum[ACQ_MAX_CHANNELS] = { 0 };
+        for(size_t i = 0; i < n; i++) {
+            uint16_t mv[ACQ_MAX_CHANNELS] = { 0 };
+            for(int slot = 0; slot < block->channel_count; slot++) {
+                mv[slot] = adc_lut_interp_q4(luts[slot], q4[i][slot]);
+                sum[slot] += mv[slot];
+            }
+            // Output i lies (n - 1 - i) output periods before the end of the block
+            int64_t timestamp_us = block->timestamp_us - (int64_t) (n - 1 - i) * STREAM_PERIOD_US;
+            stats_push_frame(mv);
+            history_push_frame(frame_seq, timestamp_us, mv);
+            stream_push(frame_seq, block->channel_mask, timestamp_us, mv);
+            frame_seq++;
+        }
+        uint8_t channel_count = block->channel_count;
+        acquisition_release_block();
+
+        portENTER_CRITICAL(&avg_lock);
+        for(int slot = 0; slot < channel_count; slot++) {
+            avg_sum[slot] += sum[slot];
+        }
+        avg_frames += n;
+        portEXIT_CRITICAL(&avg_lock);
+    }
+}
+
+bool pipeline_take_average(pipeline_average_t* avg) {
+    int64_t sum[ACQ_MAX_CHANNELS];
+
+    portENTER_CRITICAL(&avg_lock);
+    memcpy(sum, avg_sum, sizeof(sum));
+    avg->frames = avg_frames;
+    avg->channel_count = avg_channel_count;
+    memcpy(avg->channels, avg_channels, sizeof(avg->channels));
+    memset(avg_sum, 0, sizeof(avg_sum));
+    avg_frames = 0;
+    portEXIT_CRITICAL(&avg_lock);
+
+    if(avg->frames == 0) {
+        return false;
+    }
+
+    for(int slot = 0; slot < avg->channel_count; slot++) {
+        avg->mv[slot] = (uint16_t) (sum[slot] / avg->frames);
+    }
+    return true;
+}
+
+void pipeline_get_status(pipeline_status_t* status) {
+    status->decimation_ratio = ACQ_DECIMATION_RATIO;
+    status->decimation_cycles_per_sample = decim_samples > 0 ? (float) decim_cycles / decim_samples : 0.0f;
+}
+
+void pipeline_get_block_timing(timing_monitor_t* mon) {
+    portENTER_CRITICAL(&timing_lock);
+    *mon = block_timing;
+    portEXIT_CRITICAL(&timing_lock);
+}
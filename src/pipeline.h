@@ -0,0 +1,55 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "acquisition.h"
+#include "timing.h"
+
+#define PIPELINE_TAG "pipeline"
+
+// Per-channel average of the decimated stream over one publish period
+typedef struct {
+    uint8_t channel_count;
+    uint8_t channels[ACQ_MAX_CHANNELS];
+    uint16_t mv[ACQ_MAX_CHANNELS];
+    uint32_t frames;            // Decimated frames averaged
+} pipeline_average_t;
+
+// Processing counters
+typedef struct {
+    uint32_t decimation_ratio;
+    float decimation_cycles_per_sample;
+} pipeline_status_t;
+
+/**
+ * @brief Consumer task for acquired blocks: runs the edge detectors, decimates, converts to millivolts, feeds the statistics, the history
+ *        and the sample stream, feeds the UDP stream, and accumulates averages
+ *
+ * @param pvParameters - unused
+ */
+void pipeline_task(void* pvParameters);
+
+/**
+ * @brief Take the averages accumulated since the previous call and restart accumulation
+ *
+ * @param avg - destination
+ * @return true if at least one frame was averaged
+ */
+bool pipeline_take_average(pipeline_average_t* avg);
+
+/**
+ * @brief Get processing counters
+ *
+ * @param status
+ */
+void pipeline_get_status(pipeline_status_t* status);
+
+/**
+ * @brief Get a copy of the block arrival timing monitor
+ *
+ * @param mon
+ */
+void pipeline_get_block_timing(timing_monitor_t* mon);
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file protocol.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Binary WebSocket frame encoding
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "protocol.h"
+#include "codec.h"
+
+static inline void put_le16(uint8_t* p, uint16_t v) {
+    p[0] = v;
+    p[1] = v >> 8;
+}
+
+static inline void put_le32(uint8_t* p, uint32_t v) {
+    put_le16(p, v);
+    put_le16(p + 2, v >> 16);
+}
+
+static inline uint16_t get_le16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t get_le32(const uint8_t* p) {
+    return get_le16(p) | ((uint32_t) get_le16(p + 2) << 16);
+}
+
+size_t proto_encode_header(uint8_t* buf, size_t len, const proto_header_t* header) {
+    uint8_t channel_count = __builtin_popcount(header->channel_mask);
+    bool extra = header->type == PROTO_TYPE_HISTORY || header->type == PROTO_TYPE_RAW;
+
+    if(len < PROTO_HEADER_SIZE + (extra ? 4 : 0)) {
+        return 0;
+    }
+
+    buf[0] = PROTO_VERSION;
+    buf[1] = header->type;
+    buf[2] = header->flags;
+    buf[3] = channel_count;
+    put_le16(buf + 4, header->channel_mask);
+    put_le16(buf + 6, header->sample_count);
+    put_le32(buf + 8, header->seq);
+    put_le32(buf + 12, (uint32_t) header->timestamp_us);
+    put_le32(buf + 16, (uint32_t) ((uint64_t) header->timestamp_us >> 32));
+
+    if(extra) {
+        put_le32(buf + PROTO_HEADER_SIZE, header->type == PROTO_TYPE_HISTORY ? header->period_us : header->rate_hz);
+        return PROTO_HEADER_SIZE + 4;
+    }
+    return PROTO_HEADER_SIZE;
+}
+
+size_t proto_encode(uint8_t* buf, size_t len, const proto_header_t* header, const uint16_t* samples, size_t stride) {
+    uint8_t channel_count = __builtin_popcount(header->channel_mask);
+    bool plain = header->type == PROTO_TYPE_SAMPLES || header->type == PROTO_TYPE_RAW;
+    size_t size = proto_frame_size(channel_count, header->sample_count) + (header->type == PROTO_TYPE_RAW ? 4 : 0);
+
+    if(plain && size > len) {
+        return 0;
+    }
+
+    size_t header_size = proto_encode_header(buf, len, header);
+    if(header_size == 0) {
+        return 0;
+    }
+
+    uint8_t* p = buf + header_size;
+
+    if(header->type == PROTO_TYPE_SAMPLES_DELTA || header->type == PROTO_TYPE_HISTORY) {
+        for(int slot = 0; slot < channel_count; slot++) {
+            size_t n = codec_delta_encode(samples + slot, header->sample_count, stride, p, buf + len - p);
+            if(n == 0 && header->sample_count > 0) {
+                return 0;
+            }
+            p += n;
+        }
+        return p - buf;
+    }
+
+    for(size_t i = 0; i < header->sample_count; i++, samples += stride) {
+        for(int slot = 0; slot < channel_count; slot++, p += 2) {
+            put_le16(p, samples[slot]);
+        }
+    }
+    return size;
+}
+
+const uint8_t* proto_decode_header(const uint8_t* buf, size_t len, proto_header_t* header) {
+    if(len < PROTO_HEADER_SIZE || buf[0] != PROTO_VERSION) {
+        return NULL;
+    }
+
+    header->version = buf[0];
+    header->type = buf[1];
+    header->flags = buf[2];
+    header->channel_count = buf[3];
+    header->channel_mask = get_le16(buf + 4);
+    header->sample_count = get_le16(buf + 6);
+    header->seq = get_le32(buf + 8);
+    header->timestamp_us = (int64_t) ((uint64_t) get_le32(buf + 16) << 32 | get_le32(buf + 12));
+
+    if(header->channel_count != __builtin_popcount(header->channel_mask)) {
+        return NULL;
+    }
+    // Delta payloads are variable length and checked by the codec
+    if(header->type == PROTO_TYPE_SAMPLES && len < proto_frame_size(header->channel_count, header->sample_count)) {
+        return NULL;
+    }
+    if(header->type == PROTO_TYPE_RAW && len < proto_frame_size(header->channel_count, header->sample_count) + 4) {
+        return NULL;
+    }
+
+    header->period_us = 0;
+    header->rate_hz = 0;
+    if(header->type == PROTO_TYPE_HISTORY || header->type == PROTO_TYPE_RAW) {
+        if(len < PROTO_HEADER_SIZE + 4) {
+            return NULL;
+        }
+        if(header->type == PROTO_TYPE_HISTORY) {
+            header->period_us = get_le32(buf + PROTO_HEADER_SIZE);
+        } else {
+            header->rate_hz = get_le32(buf + PROTO_HEADER_SIZE);
+        }
+        return buf + PROTO_HEADER_SIZE + 4;
+    }
+    return buf + PROTO_HEADER_SIZE;
+}
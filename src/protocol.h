@@ -0,0 +1,112 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Binary WebSocket frame format (all fields little-endian)
+ *
+ *   offset  size  field
+ *   0       1     version (PROTO_VERSION)
+ *   1       1     type (proto_type_t)
+ *   2       1     flags (PROTO_FLAG_*)
+ *   3       1     channel count
+ *   4       2     channel mask (bit n set when ADC channel n is present)
+ *   6       2     sample count (frames)
+ *   8       4     sequence number of the first sample
+ *   12      8     device timestamp of the first sample (esp_timer, us)
+ *   20      ...   samples, in ascending channel order
+ *
+ * PROTO_TYPE_SAMPLES carries sample count frames of channel count uint16 values.
+ * A one-channel update is 22 bytes, against about 90 for the equivalent JSON text
+ * (test_benchmark_against_json in test/test_protocol measures both).
+ *
+ * Every decimated sample of the stream has a sequence number, one more than the previous
+ * one. A client streaming at decimation d receives the samples whose sequence numbers are
+ * multiples of d, so a frame of n samples starting at s is followed by one starting at
+ * s + n * d; anything else is a gap that can be filled with "resend?from=&to=".
+ *
+ * PROTO_TYPE_SAMPLES_DELTA carries each channel in turn (all of its samples, then
+ * the next channel) as a codec_delta_encode() block (see codec.h).
+ *
+ * PROTO_TYPE_HISTORY carries a uint32 point spacing in us, then the points in the
+ * PROTO_TYPE_SAMPLES_DELTA layout. The timestamp is the time of the first point.
+ *
+ * PROTO_TYPE_RAW (UDP stream) carries a uint32 sample rate in Hz, then undecimated
+ * samples in the PROTO_TYPE_SAMPLES layout. Its sequence numbers count ADC frames
+ * (block sequence number * block size + frame), so a datagram of n samples starting
+ * at s is followed by one starting at s + n.
+ */
+#define PROTO_VERSION 1
+#define PROTO_HEADER_SIZE 20
+
+// Set when digital pin 22 reads high
+#define PROTO_FLAG_PIN 0x01
+// Set on frames sent again in answer to a resend request
+#define PROTO_FLAG_RETRANSMIT 0x02
+
+typedef enum {
+    PROTO_TYPE_SAMPLES = 1,         // Samples in mV
+    PROTO_TYPE_SAMPLES_DELTA = 2,   // Samples in mV, delta + zigzag varint per channel
+    PROTO_TYPE_HISTORY = 3,         // Backfill of recent history, delta encoded
+    PROTO_TYPE_RAW = 4,             // Undecimated samples in mV (UDP stream)
+} proto_type_t;
+
+// Decoded frame header
+typedef struct {
+    uint8_t version;
+    uint8_t type;
+    uint8_t flags;
+    uint8_t channel_count;
+    uint16_t channel_mask;
+    uint16_t sample_count;
+    uint32_t seq;
+    int64_t timestamp_us;
+    uint32_t period_us;         // PROTO_TYPE_HISTORY only
+    uint32_t rate_hz;           // PROTO_TYPE_RAW only
+} proto_header_t;
+
+/**
+ * @brief Size of a PROTO_TYPE_SAMPLES frame carrying the given samples (upper bound for PROTO_TYPE_SAMPLES_DELTA is
+ *        PROTO_HEADER_SIZE + CODEC_DELTA_MAX_SIZE(channel_count * sample_count))
+ */
+static inline size_t proto_frame_size(uint8_t channel_count, uint16_t sample_count) {
+    return PROTO_HEADER_SIZE + (size_t) channel_count * sample_count * sizeof(uint16_t);
+}
+
+/**
+ * @brief Encode the header of a frame (with the point spacing or sample rate of the types that carry one)
+ *
+ * @param buf - destination
+ * @param len - size of buf
+ * @param header - version and channel_count are filled in by the encoder
+ * @return size_t - bytes written, or 0 if buf is too small
+ */
+size_t proto_encode_header(uint8_t* buf, size_t len, const proto_header_t* header);
+
+/**
+ * @brief Encode a frame of the type given in the header. channel_count is taken from the population
+ *        count of the channel mask.
+ *
+ * @param buf - destination
+ * @param len - size of buf
+ * @param header - version and channel_count are filled in by the encoder
+ * @param samples - sample_count frames of channel_count values
+ * @param stride - distance between the starts of consecutive frames in samples (>= channel_count)
+ * @return size_t - bytes written, or 0 if buf is too small
+ */
+size_t proto_encode(uint8_t* buf, size_t len, const proto_header_t* header, const uint16_t* samples, size_t stride);
+
+/**
+ * @brief Decode a frame header (and the point spacing or sample rate) and check that the payload is complete
+ *
+ * @param buf - received frame
+ * @param len - size of the frame
+ * @param header - destination
+ * @return const uint8_t* - first sample byte, or NULL if the frame is malformed or of another version
+ */
+const uint8_t* proto_decode_header(const uint8_t* buf, size_t len, proto_header_t* header);
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file sample_ring.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Lock-free SPSC ring of sample blocks between the acquisition task and its consumer
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "sample_ring.h"
+
+esp_err_t sample_ring_init(sample_ring_t* ring, sample_block_t* slots, uint32_t capacity) {
+    if(slots == NULL || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    ring->slots = slots;
+    ring->mask = capacity - 1;
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->overruns = 0;
+    ring->high_water = 0;
+    return ESP_OK;
+}
+
+sample_block_t* sample_ring_acquire(sample_ring_t* ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if(head - tail > ring->mask) {
+        ring->overruns++;
+        return NULL;
+    }
+    return &ring->slots[head & ring->mask];
+}
+
+void sample_ring_commit(sample_ring_t* ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed) + 1;
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if(head - tail > ring->high_water) {
+        ring->high_water = head - tail;
+    }
+
+    // Release so the block contents are visible before the consumer sees the new head
+    atomic_store_explicit(&ring->head, head, memory_order_release);
+}
+
+const sample_block_t* sample_ring_peek(sample_ring_t* ring) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+    if(head == tail) {
+        return NULL;
+    }
+    return &ring->slots[tail & ring->mask];
+}
+
+void sample_ring_release(sample_ring_t* ring) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    // Release so the consumer is done with the slot before the producer may reuse it
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+uint32_t sample_ring_count(sample_ring_t* ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return head - tail;
+}
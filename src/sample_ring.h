@@ -0,0 +1,65 @@
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+#include "acquisition.h"
+
+/**
+ * Lock-free single-producer/single-consumer ring of sample blocks.
+ *
+ * Blocks are filled and read in place. The producer owns the slot returned by
+ * sample_ring_acquire() until sample_ring_commit(); the consumer owns the slot
+ * returned by sample_ring_peek() until sample_ring_release(). head and tail are
+ * free-running indices, so the capacity must be a power of two.
+ */
+typedef struct {
+    sample_block_t* slots;
+    uint32_t mask;               // capacity - 1
+    atomic_uint_fast32_t head;   // Next slot to commit (written by producer only)
+    atomic_uint_fast32_t tail;   // Next slot to release (written by consumer only)
+    uint32_t overruns;           // Blocks the producer could not store because the ring was full
+    uint32_t high_water;         // Largest number of blocks waiting at commit time
+} sample_ring_t;
+
+/**
+ * @brief Initialize a ring over caller-provided storage
+ *
+ * @param ring
+ * @param slots - storage for capacity blocks
+ * @param capacity - number of slots, power of two
+ * @return esp_err_t - ESP_ERR_INVALID_ARG if capacity is not a power of two
+ */
+esp_err_t sample_ring_init(sample_ring_t* ring, sample_block_t* slots, uint32_t capacity);
+
+/**
+ * @brief Producer: get the next free slot to fill
+ *
+ * @return sample_block_t* - slot to fill, or NULL if the ring is full (counted as an overrun)
+ */
+sample_block_t* sample_ring_acquire(sample_ring_t* ring);
+
+/**
+ * @brief Producer: publish the slot returned by sample_ring_acquire()
+ */
+void sample_ring_commit(sample_ring_t* ring);
+
+/**
+ * @brief Consumer: get the oldest committed block without copying it
+ *
+ * @return const sample_block_t* - oldest block, or NULL if the ring is empty
+ */
+const sample_block_t* sample_ring_peek(sample_ring_t* ring);
+
+/**
+ * @brief Consumer: return the slot returned by sample_ring_peek() to the producer
+ */
+void sample_ring_release(sample_ring_t* ring);
+
+/**
+ * @brief Number of committed blocks waiting for the consumer
+ */
+uint32_t sample_ring_count(sample_ring_t* ring);
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * @file stats.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Incremental sliding-window statistics of the sample stream
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "stats.h"
+
+#include <math.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+
+// Total deque capacity of all windows of one channel (one entry per sample of each window)
+#define STATS_DEQUE_TOTAL ((1 + 10 + 60) * STATS_RATE_HZ)
+
+// Ring positions of window samples, ordered by value so the extreme is at the front
+typedef struct {
+    uint16_t* buf;
+    uint16_t cap;
+    uint16_t head;
+    uint16_t len;
+} stats_deque_t;
+
+// Running state of one channel over one window. Sums are exact integers, so
+// samples can be added and removed indefinitely without drift.
+typedef struct {
+    uint16_t size;          // Window length in samples
+    uint16_t len;           // Samples currently in the window
+    int64_t sum;
+    uint64_t sum_sq;
+    uint16_t hist[STATS_HIST_BINS];
+    stats_deque_t min_q;    // Increasing values
+    stats_deque_t max_q;    // Decreasing values
+} stats_window_t;
+
+typedef struct {
+    uint8_t channel;
+    uint16_t pos;           // Next ring position
+    uint16_t ring[STATS_HISTORY];
+    stats_window_t windows[STATS_WINDOWS];
+} stats_channel_t;
+
+static const uint16_t window_seconds[STATS_WINDOWS] = STATS_WINDOW_SECONDS;
+
+static stats_channel_t stats[ACQ_MAX_CHANNELS];
+static uint16_t deque_pool[ACQ_MAX_CHANNELS][2][STATS_DEQUE_TOTAL];
+static uint8_t stats_channels = 0;
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Input frames are averaged in groups of stats_decimation before entering the windows
+static uint32_t stats_decimation = 1;
+static uint32_t stats_input_rate_hz = STATS_RATE_HZ;
+static uint32_t acc_frames = 0;
+static uint32_t acc_sum[ACQ_MAX_CHANNELS];
+
+static inline uint16_t deque_front(const stats_deque_t* q) {
+    return q->buf[q->head];
+}
+
+static inline uint16_t deque_back(const stats_deque_t* q) {
+    return q->buf[(q->head + q->len - 1) % q->cap];
+}
+
+static inline void deque_pop_front(stats_deque_t* q) {
+    q->head = (q->head + 1) % q->cap;
+    q->len--;
+}
+
+static inline void deque_push_back(stats_deque_t* q, uint16_t pos) {
+    q->buf[(q->head + q->len) % q->cap] = pos;
+    q->len++;
+}
+
+static inline int hist_bin(uint16_t mv) {
+    int bin = mv / STATS_HIST_BIN_MV;
+    return bin < STATS_HIST_BINS ? bin : STATS_HIST_BINS - 1;
+}
+
+static void push_sample(stats_channel_t* ch, uint16_t mv) {
+    uint16_t pos = ch->pos;
+
+    for(int w = 0; w < STATS_WINDOWS; w++) {
+        stats_window_t* win = &ch->windows[w];
+
+        // Expire the sample leaving the window. Read it before the ring slot is overwritten.
+        if(win->len == win->size) {
+            uint16_t old_pos = (pos + STATS_HISTORY - win->size) % STATS_HISTORY;
+            uint16_t old = ch->ring[old_pos];
+            win->sum -= old;
+            win->sum_sq -= (uint32_t) old * old;
+            win->hist[hist_bin(old)]--;
+            win->len--;
+
+            if(win->min_q.len > 0 && deque_front(&win->min_q) == old_pos) {
+                deque_pop_front(&win->min_q);
+            }
+            if(win->max_q.len > 0 && deque_front(&win->max_q) == old_pos) {
+                deque_pop_front(&win->max_q);
+            }
+        }
+
+        win->sum += mv;
+        win->sum_sq += (uint32_t) mv * mv;
+        win->hist[hist_bin(mv)]++;
+        win->len++;
+
+        // Monotonic deques: drop samples that can no longer be the extreme
+        while(win->min_q.len > 0 && ch->ring[deque_back(&win->min_q)] >= mv) {
+            win->min_q.len--;
+        }
+        deque_push_back(&win->min_q, pos);
+
+        while(win->max_q.len > 0 && ch->ring[deque_back(&win->max_q)] <= mv) {
+            win->max_q.len--;
+        }
+        deque_push_back(&win->max_q, pos);
+    }
+
+    ch->ring[pos] = mv;
+    ch->pos = (pos + 1) % STATS_HISTORY;
+}
+
+void stats_reset(uint8_t channel_count, const uint8_t* channels, uint32_t input_rate_hz) {
+    portENTER_CRITICAL(&stats_lock);
+    memset(stats, 0, sizeof(stats));
+    for(int slot = 0; slot < channel_count; slot++) {
+        stats[slot].channel = channels[slot];
+
+        uint16_t offset = 0;
+        for(int w = 0; w < STATS_WINDOWS; w++) {
+            stats_window_t* win = &stats[slot].windows[w];
+            win->size = window_seconds[w] * STATS_RATE_HZ;
+            win->min_q.buf = &deque_pool[slot][0][offset];
+            win->min_q.cap = win->size;
+            win->max_q.buf = &deque_pool[slot][1][offset];
+            win->max_q.cap = win->size;
+            offset += win->size;
+        }
+    }
+    stats_channels = channel_count;
+
+    stats_input_rate_hz = input_rate_hz;
+    stats_decimation = (input_rate_hz + STATS_RATE_HZ / 2) / STATS_RATE_HZ;
+    if(stats_decimation == 0) {
+        stats_decimation = 1;
+    }
+    acc_frames = 0;
+    memset(acc_sum, 0, sizeof(acc_sum));
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+void stats_push_frame(const uint16_t* mv) {
+    portENTER_CRITICAL(&stats_lock);
+    for(int slot = 0; slot < stats_channels; slot++) {
+        acc_sum[slot] += mv[slot];
+    }
+
+    if(++acc_frames >= stats_decimation) {
+        for(int slot = 0; slot < stats_channels; slot++) {
+            push_sample(&stats[slot], (uint16_t) ((acc_sum[slot] + acc_frames / 2) / acc_frames));
+            acc_sum[slot] = 0;
+        }
+        acc_frames = 0;
+    }
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+bool stats_get(uint8_t slot, uint8_t window, stats_result_t* result) {
+    if(window >= STATS_WINDOWS) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&stats_lock);
+    if(slot >= stats_channels || stats[slot].windows[window].len == 0) {
+        portEXIT_CRITICAL(&stats_lock);
+        return false;
+    }
+
+    const stats_channel_t* ch = &stats[slot];
+    const stats_window_t* win = &ch->windows[window];
+    uint32_t n = win->len;
+    int64_t sum = win->sum;
+    uint64_t sum_sq = win->sum_sq;
+
+    result->channel = ch->channel;
+    result->window_s = window_seconds[window];
+    result->count = n;
+    result->min_mv = ch->ring[deque_front(&win->min_q)];
+    result->max_mv = ch->ring[deque_front(&win->max_q)];
+    memcpy(result->hist, win->hist, sizeof(result->hist));
+    portEXIT_CRITICAL(&stats_lock);
+
+    // Finish outside the lock. Variance from exact integer sums: (n * sum_sq - sum^2) / n^2
+    double mean = (double) sum / n;
+    double var = ((double) sum_sq - (double) sum * mean) / n;
+    result->mean_mv = (float) mean;
+    result->rms_mv = (float) sqrt((double) sum_sq / n);
+    result->stddev_mv = (float) sqrt(var > 0 ? var : 0);
+    return true;
+}
+
+uint8_t stats_channel_count(void) {
+    return stats_channels;
+}
+
+float stats_effective_rate_hz(void) {
+    return (float) stats_input_rate_hz / stats_decimation;
+}
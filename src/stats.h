@@ -0,0 +1,67 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "acquisition.h"
+
+#define STATS_TAG "stats"
+#define STATS_RATE_HZ CONFIG_STATS_RATE_HZ
+#define STATS_WINDOWS 3
+#define STATS_WINDOW_SECONDS { 1, 10, 60 }
+#define STATS_HISTORY (60 * STATS_RATE_HZ)     // Samples kept per channel, enough for the longest window
+#define STATS_HIST_BINS 16
+#define STATS_HIST_BIN_MV 220                  // 16 x 220 mV covers the 0-3.3 V input range
+
+// Statistics of one channel over one window
+typedef struct {
+    uint8_t channel;
+    uint16_t window_s;
+    uint32_t count;             // Samples currently in the window
+    uint16_t min_mv;
+    uint16_t max_mv;
+    float mean_mv;
+    float rms_mv;
+    float stddev_mv;
+    uint16_t hist[STATS_HIST_BINS];
+} stats_result_t;
+
+/**
+ * @brief Restart statistics for a new set of channels
+ *
+ * @param channel_count - number of slots
+ * @param channels - ADC channel of each slot
+ * @param input_rate_hz - rate at which stats_push_frame() will be called
+ */
+void stats_reset(uint8_t channel_count, const uint8_t* channels, uint32_t input_rate_hz);
+
+/**
+ * @brief Feed one frame (one millivolt value per slot). Frames are averaged down to STATS_RATE_HZ
+ *        before entering the windows. O(1) per frame.
+ *
+ * @param mv - value of each slot
+ */
+void stats_push_frame(const uint16_t* mv);
+
+/**
+ * @brief Get the statistics of one slot over one window
+ *
+ * @param slot - slot index
+ * @param window - window index (0 .. STATS_WINDOWS - 1)
+ * @param result - destination
+ * @return true if the slot exists and the window holds at least one sample
+ */
+bool stats_get(uint8_t slot, uint8_t window, stats_result_t* result);
+
+/**
+ * @brief Number of slots currently tracked
+ */
+uint8_t stats_channel_count(void);
+
+/**
+ * @brief Effective rate of the samples entering the windows
+ */
+float stats_effective_rate_hz(void);
+
+#endif
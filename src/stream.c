@@ -0,0 +1,102 @@
+/**
+ * @file stream.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Queue of decimated frames for batched streaming
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "stream.h"
+
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+_Static_assert((STREAM_RING_FRAMES & (STREAM_RING_FRAMES - 1)) == 0, "STREAM_RING_FRAMES must be a power of two");
+
+typedef struct {
+    int64_t timestamp_us;
+    uint32_t seq;
+    uint16_t channel_mask;
+    uint16_t mv[ACQ_MAX_CHANNELS];
+} stream_frame_t;
+
+static stream_frame_t frames[STREAM_RING_FRAMES];
+static atomic_uint_fast32_t head;   // Written by the producer only
+static atomic_uint_fast32_t tail;   // Written by the consumer only
+static uint32_t overruns = 0;
+
+static TaskHandle_t consumer_task = NULL;
+static volatile uint32_t wake_batch = UINT32_MAX;
+
+void stream_push(uint32_t seq, uint16_t channel_mask, int64_t timestamp_us, const uint16_t* mv) {
+    uint32_t h = atomic_load_explicit(&head, memory_order_relaxed);
+    uint32_t t = atomic_load_explicit(&tail, memory_order_acquire);
+
+    if(h - t >= STREAM_RING_FRAMES) {
+        overruns++;
+        return;
+    }
+
+    stream_frame_t* frame = &frames[h & (STREAM_RING_FRAMES - 1)];
+    frame->timestamp_us = timestamp_us;
+    frame->seq = seq;
+    frame->channel_mask = channel_mask;
+    memcpy(frame->mv, mv, sizeof(frame->mv));
+    atomic_store_explicit(&head, h + 1, memory_order_release);
+
+    // Wake the consumer when the batch it waits for is complete
+    if(consumer_task != NULL && h + 1 - t >= wake_batch) {
+        xTaskNotifyGive(consumer_task);
+    }
+}
+
+bool stream_wait(uint32_t batch, uint32_t timeout_ms) {
+    if(consumer_task == NULL) {
+        consumer_task = xTaskGetCurrentTaskHandle();
+    }
+
+    wake_batch = batch;
+    if(stream_pending() < batch) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+    }
+    return stream_pending() >= batch;
+}
+
+size_t stream_read(uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t max, uint16_t* channel_mask, int64_t* timestamp_us, uint32_t* seq) {
+    uint32_t t = atomic_load_explicit(&tail, memory_order_relaxed);
+    uint32_t h = atomic_load_explicit(&head, memory_order_acquire);
+    size_t n = 0;
+
+    if(h != t) {
+        const stream_frame_t* first = &frames[t & (STREAM_RING_FRAMES - 1)];
+        *channel_mask = first->channel_mask;
+        *timestamp_us = first->timestamp_us;
+        *seq = first->seq;
+    }
+
+    // A batch never spans a scan change or the gap left by an overrun
+    while(t + n != h && n < max) {
+        const stream_frame_t* frame = &frames[(t + n) & (STREAM_RING_FRAMES - 1)];
+        if(frame->channel_mask != *channel_mask || frame->seq != *seq + n) {
+            break;
+        }
+        memcpy(mv[n], frame->mv, sizeof(frame->mv));
+        n++;
+    }
+
+    atomic_store_explicit(&tail, t + n, memory_order_release);
+    return n;
+}
+
+uint32_t stream_pending(void) {
+    return atomic_load_explicit(&head, memory_order_acquire) - atomic_load_explicit(&tail, memory_order_acquire);
+}
+
+uint32_t stream_overruns(void) {
+    return overruns;
+}
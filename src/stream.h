@@ -0,0 +1,71 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "acquisition.h"
+
+#define STREAM_TAG "stream"
+#define STREAM_RING_FRAMES 512      // Power of two, larger than the largest batch
+
+// Spacing of the decimated frames
+#define STREAM_PERIOD_US ((int64_t) ACQ_DECIMATION_RATIO * 1000000 / ACQ_SAMPLE_RATE_HZ)
+
+// Largest number of frames sent in one batch
+#if CONFIG_WS_BATCH_ADAPTIVE && CONFIG_WS_BATCH_MAX_SAMPLES > CONFIG_WS_BATCH_SAMPLES
+#define STREAM_BATCH_LIMIT CONFIG_WS_BATCH_MAX_SAMPLES
+#else
+#define STREAM_BATCH_LIMIT CONFIG_WS_BATCH_SAMPLES
+#endif
+
+/**
+ * Lock-free single-producer/single-consumer queue of decimated frames in mV,
+ * from the pipeline task to the task batching them onto the network.
+ */
+
+/**
+ * @brief Producer: append one decimated frame. Dropped (and counted) when the queue is full.
+ *
+ * @param seq - frame sequence number, incremented by one for every decimated frame
+ * @param channel_mask - channels present in the frame
+ * @param timestamp_us - esp_timer time of the frame
+ * @param mv - one value per channel, in ascending channel order
+ */
+void stream_push(uint32_t seq, uint16_t channel_mask, int64_t timestamp_us, const uint16_t* mv);
+
+/**
+ * @brief Consumer: wait until at least batch frames are queued
+ *
+ * The first caller becomes the consumer woken by the producer.
+ *
+ * @param batch - frames to wait for
+ * @param timeout_ms - maximum time to wait
+ * @return true if batch frames are queued
+ */
+bool stream_wait(uint32_t batch, uint32_t timeout_ms);
+
+/**
+ * @brief Consumer: copy out and remove up to max of the oldest frames sharing one channel mask,
+ *        with consecutive sequence numbers
+ *
+ * @param mv - destination, max entries
+ * @param max - frames to read at most
+ * @param channel_mask - mask of the frames read
+ * @param timestamp_us - time of the first frame read
+ * @param seq - sequence number of the first frame read
+ * @return size_t - frames read
+ */
+size_t stream_read(uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t max, uint16_t* channel_mask, int64_t* timestamp_us, uint32_t* seq);
+
+/**
+ * @brief Number of frames waiting for the consumer
+ */
+uint32_t stream_pending(void);
+
+/**
+ * @brief Number of frames dropped because the queue was full
+ */
+uint32_t stream_overruns(void);
+
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file template.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Precompiled page templates rendered without allocation
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "template.h"
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "esp_log.h"
+
+#define MIN(a,b) (((a)<(b))?(a):(b))
+
+typedef enum {
+    SCAN_LITERAL,
+    SCAN_OPEN,                  // One '{' seen
+    SCAN_NAME,                  // Inside "{{"
+    SCAN_CLOSE,                 // One '}' seen after the name
+} scan_state_t;
+
+static esp_err_t add_segment(template_t* tpl, uint32_t offset, uint32_t len, int16_t var) {
+    if(len == 0) {
+        return ESP_OK;
+    }
+    if(tpl->segment_count == TEMPLATE_MAX_SEGMENTS) {
+        return ESP_ERR_NO_MEM;
+    }
+    tpl->segments[tpl->segment_count++] = (template_segment_t) { .offset = offset, .len = len, .var = var };
+    return ESP_OK;
+}
+
+static int16_t find_var(const char* name, size_t len, const char* const* vars, size_t var_count) {
+    for(size_t i = 0; i < var_count; i++) {
+        if(strlen(vars[i]) == len && memcmp(vars[i], name, len) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+esp_err_t template_compile(template_t* tpl, const char* path, const char* const* vars, size_t var_count) {
+    memset(tpl, 0, sizeof(*tpl));
+    tpl->path = path;
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) {
+        ESP_LOGE(TEMPLATE_TAG, "Unable to open %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    char buf[256];
+    char name[TEMPLATE_MAX_NAME];
+    size_t name_len = 0;
+    scan_state_t state = SCAN_LITERAL;
+    uint32_t pos = 0;
+    uint32_t literal_start = 0;
+    uint32_t placeholder_start = 0;
+    esp_err_t err = ESP_OK;
+
+    int n;
+    while(err == ESP_OK && (n = read(fd, buf, sizeof(buf))) > 0) {
+        for(int i = 0; i < n; i++, pos++) {
+            char c = buf[i];
+            switch(state) {
+            case SCAN_OPEN:
+                if(c == '{') {
+                    placeholder_start = pos - 1;
+                    name_len = 0;
+                    state = SCAN_NAME;
+                    continue;
+                }
+                break;
+            case SCAN_NAME:
+                if(((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_') && name_len < sizeof(name)) {
+                    name[name_len++] = c;
+                    continue;
+                }
+                if(c == '}' && name_len > 0) {
+                    state = SCAN_CLOSE;
+                    continue;
+                }
+                break;
+            case SCAN_CLOSE:
+                if(c == '}') {
+                    // Unknown names stay part of the literal run
+                    int16_t var = find_var(name, name_len, vars, var_count);
+                    if(var >= 0) {
+                        err = add_segment(tpl, literal_start, placeholder_start - literal_start, -1);
+                        if(err == ESP_OK) {
+                            err = add_segment(tpl, placeholder_start, pos + 1 - placeholder_start, var);
+                        }
+                        literal_start = pos + 1;
+                    }
+                    state = SCAN_LITERAL;
+                    continue;
+                }
+                break;
+            case SCAN_LITERAL:
+                break;
+            }
+
+            // Anything unexpected ends the placeholder. A '{' may start the next one.
+            state = c == '{' ? SCAN_OPEN : SCAN_LITERAL;
+        }
+    }
+    close(fd);
+
+    if(err == ESP_OK && n < 0) {
+        err = ESP_ERR_NOT_FOUND;
+    }
+    if(err == ESP_OK) {
+        err = add_segment(tpl, literal_start, pos - literal_start, -1);
+    }
+    if(err != ESP_OK) {
+        ESP_LOGE(TEMPLATE_TAG, "Unable to compile %s: %s", path, esp_err_to_name(err));
+        tpl->segment_count = 0;
+        return err;
+    }
+
+    tpl->size = pos;
+    tpl->compiled = true;
+    ESP_LOGI(TEMPLATE_TAG, "Compiled %s: %lu bytes, %u segments", path, (unsigned long) pos, tpl->segment_count);
+    return ESP_OK;
+}
+
+esp_err_t template_render(const template_t* tpl, httpd_req_t* req, const char* const* values) {
+    if(!tpl->compiled) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Plain file descriptors: a stdio stream would allocate its buffer
+    int fd = open(tpl->path, O_RDONLY);
+    if(fd < 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size != tpl->size) {
+        close(fd);
+        ESP_LOGE(TEMPLATE_TAG, "%s changed since it was compiled", tpl->path);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Static rather than on the 4 KB default stack of the httpd task, which renders one page at a time
+    static char buf[TEMPLATE_SEND_BUFFER];
+    size_t used = 0;
+    esp_err_t err = ESP_OK;
+
+    for(int i = 0; i < tpl->segment_count && err == ESP_OK; i++) {
+        const template_segment_t* seg = &tpl->segments[i];
+        const char* value = NULL;
+        uint32_t left = seg->len;
+
+        // Segments cover the file in order, so a placeholder is skipped by seeking past it
+        if(seg->var >= 0) {
+            value = values[seg->var] != NULL ? values[seg->var] : "";
+            left = strlen(value);
+            lseek(fd, seg->len, SEEK_CUR);
+        }
+
+        while(left > 0 && err == ESP_OK) {
+            if(used == sizeof(buf)) {
+                err = httpd_resp_send_chunk(req, buf, used);
+                used = 0;
+                continue;
+            }
+
+            size_t n = MIN(left, sizeof(buf) - used);
+            if(value != NULL) {
+                memcpy(buf + used, value, n);
+                value += n;
+            } else {
+                int got = read(fd, buf + used, n);
+                if(got <= 0) {
+                    err = ESP_FAIL;
+                    break;
+                }
+                n = got;
+            }
+            used += n;
+            left -= n;
+        }
+    }
+    close(fd);
+
+    if(err == ESP_OK && used > 0) {
+        err = httpd_resp_send_chunk(req, buf, used);
+    }
+    if(err == ESP_OK) {
+        err = httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return err;
+}
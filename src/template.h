@@ -0,0 +1,61 @@
+#ifndef TEMPLATE_H
+#define TEMPLATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include <esp_http_server.h>
+
+#define TEMPLATE_TAG "template"
+#define TEMPLATE_MAX_SEGMENTS 64        // Literal runs and placeholders of one page
+#define TEMPLATE_MAX_NAME 32            // Longest placeholder name
+#define TEMPLATE_SEND_BUFFER 1436       // Coalesced chunk size, one TCP segment at the default MSS
+
+/**
+ * HTML pages with {{NAME}} placeholders, parsed once into a list of segments: runs of
+ * literal bytes of the file and placeholders. Rendering copies the literal runs from the
+ * file and the placeholder values into one static buffer sent in MSS-sized chunks, so a
+ * page costs no heap allocation and no per-line work. Call from httpd handlers only: they
+ * run one at a time on the server task and share the buffer. Placeholders whose name is not
+ * in the template's variable table are left in the page as they are.
+ */
+
+// Part of a page: file bytes [offset, offset + len), sent as is or replaced by a value
+typedef struct {
+    uint32_t offset;
+    uint32_t len;
+    int16_t var;                // Index in the variable table, -1 for literal bytes
+} template_segment_t;
+
+typedef struct {
+    const char* path;
+    uint32_t size;              // File size when compiled
+    uint16_t segment_count;
+    bool compiled;
+    template_segment_t segments[TEMPLATE_MAX_SEGMENTS];
+} template_t;
+
+/**
+ * @brief Parse a page into segments
+ *
+ * @param tpl - template to fill
+ * @param path - page file, kept by reference
+ * @param vars - placeholder names without the braces, indexed by variable ID
+ * @param var_count - entries in vars
+ * @return esp_err_t - ESP_ERR_NOT_FOUND if the file cannot be read,
+ *                     ESP_ERR_NO_MEM if the page has more than TEMPLATE_MAX_SEGMENTS segments
+ */
+esp_err_t template_compile(template_t* tpl, const char* path, const char* const* vars, size_t var_count);
+
+/**
+ * @brief Send a page as a chunked response, placeholders replaced by their values. Finalizes the response.
+ *
+ * @param tpl - compiled template
+ * @param req - request to answer
+ * @param values - value of each variable ID, NULL for an empty string
+ * @return esp_err_t - ESP_ERR_INVALID_STATE if the template is not compiled or the file has changed since
+ */
+esp_err_t template_render(const template_t* tpl, httpd_req_t* req, const char* const* values);
+
+#endif
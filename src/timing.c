@@ -0,0 +1,70 @@
+/**
+ * @file timing.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Interval jitter and deadline-miss instrumentation
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "timing.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const uint32_t hist_bounds_us[TIMING_HIST_BINS - 1] = TIMING_HIST_BOUNDS_US;
+
+void timing_init(timing_monitor_t* mon, const char* name, uint32_t period_us) {
+    memset(mon, 0, sizeof(timing_monitor_t));
+    mon->name = name;
+    mon->period_us = period_us;
+}
+
+void timing_record(timing_monitor_t* mon, int64_t now_us) {
+    int64_t last_us = mon->last_us;
+    mon->last_us = now_us;
+    if(last_us == 0) {
+        return;
+    }
+
+    int32_t dev_us = (int32_t) (now_us - last_us - mon->period_us);
+    if(mon->intervals == 0 || dev_us < mon->min_dev_us) {
+        mon->min_dev_us = dev_us;
+    }
+    if(mon->intervals == 0 || dev_us > mon->max_dev_us) {
+        mon->max_dev_us = dev_us;
+    }
+    mon->intervals++;
+
+    uint32_t abs_dev_us = dev_us < 0 ? -dev_us : dev_us;
+    int bin = 0;
+    while(bin < TIMING_HIST_BINS - 1 && abs_dev_us >= hist_bounds_us[bin]) {
+        bin++;
+    }
+    mon->hist[bin]++;
+
+    if(dev_us > (int32_t) (mon->period_us / 2)) {
+        mon->missed++;
+    }
+}
+
+void timing_miss(timing_monitor_t* mon, uint32_t count) {
+    mon->missed += count;
+}
+
+int timing_to_json(const timing_monitor_t* mon, char* buf, size_t len) {
+    int n = snprintf(buf, len,
+        "{\"name\": \"%s\", \"period_us\": %lu, \"intervals\": %lu, \"missed\": %lu, \"min_dev_us\": %ld, \"max_dev_us\": %ld, \"hist\": [",
+        mon->name, (unsigned long) mon->period_us, (unsigned long) mon->intervals, (unsigned long) mon->missed,
+        (long) mon->min_dev_us, (long) mon->max_dev_us);
+
+    for(int i = 0; i < TIMING_HIST_BINS && n < (int) len; i++) {
+        n += snprintf(buf + n, len - n, "%s%lu", i > 0 ? "," : "", (unsigned long) mon->hist[i]);
+    }
+    if(n < (int) len) {
+        n += snprintf(buf + n, len - n, "]}");
+    }
+    return n;
+}
@@ -0,0 +1,57 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define TIMING_HIST_BINS 8
+
+// Upper bounds (us) of the deviation bins. The last bin collects everything above.
+#define TIMING_HIST_BOUNDS_US { 10, 50, 100, 500, 1000, 5000, 10000 }
+
+// Interval monitor for a periodic activity
+typedef struct {
+    const char* name;
+    uint32_t period_us;
+    int64_t last_us;
+    uint32_t intervals;         // Intervals recorded
+    uint32_t missed;            // Deadlines missed
+    int32_t min_dev_us;         // Smallest (most negative) deviation from the period
+    int32_t max_dev_us;         // Largest deviation from the period
+    uint32_t hist[TIMING_HIST_BINS];  // Absolute deviation histogram
+} timing_monitor_t;
+
+/**
+ * @brief Initialize a monitor
+ *
+ * @param mon
+ * @param name - reported name
+ * @param period_us - expected interval
+ */
+void timing_init(timing_monitor_t* mon, const char* name, uint32_t period_us);
+
+/**
+ * @brief Record an occurrence. The interval from the previous occurrence goes into the histogram,
+ *        and an interval longer than 1.5 periods counts as a missed deadline.
+ *
+ * @param mon
+ * @param now_us - esp_timer time of the occurrence
+ */
+void timing_record(timing_monitor_t* mon, int64_t now_us);
+
+/**
+ * @brief Count deadlines missed outright (e.g. coalesced timer ticks or lost blocks)
+ *
+ * @param mon
+ * @param count
+ */
+void timing_miss(timing_monitor_t* mon, uint32_t count);
+
+/**
+ * @brief Write the monitor as a JSON object
+ *
+ * @return int - number of characters written (as snprintf)
+ */
+int timing_to_json(const timing_monitor_t* mon, char* buf, size_t len);
+
+#endif
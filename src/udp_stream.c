@@ -0,0 +1,304 @@
+/**
+ * @file udp_stream.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Raw UDP output of the undecimated sample stream
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include "sdkconfig.h"
+
+#if CONFIG_UDP_STREAM
+
+#include "udp_stream.h"
+
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lwip/udp.h"
+#include "lwip/pbuf.h"
+#include "lwip/ip_addr.h"
+#include "lwip/sys.h"
+#include "lwip/priv/tcpip_priv.h"
+#include "adc_lut.h"
+
+_Static_assert((UDP_STREAM_PACKETS & (UDP_STREAM_PACKETS - 1)) == 0, "UDP_STREAM_PACKETS must be a power of two");
+_Static_assert(UDP_STREAM_FRAMES(ACQ_MAX_CHANNELS) > 0, "UDP_STREAM_MTU too small for one frame");
+
+typedef struct {
+    struct pbuf* pbuf;          // UDP_STREAM_PAYLOAD bytes with room for the UDP, IP and link headers in front
+    uint16_t len;
+    uint16_t samples;           // Frames in the datagram
+} udp_packet_t;
+
+// Raw API call run on the tcpip thread by tcpip_api_call(). The call waits for it, so it lives on the caller's stack.
+typedef struct {
+    struct tcpip_api_call_data call;
+    udp_packet_t* packet;
+    ip_addr_t addr;
+    uint16_t port;
+    uint8_t ttl;
+} udp_call_t;
+
+static udp_packet_t packets[UDP_STREAM_PACKETS];
+static atomic_bool packets_ready = false;
+static struct udp_pcb* pcb = NULL;  // Used on the tcpip thread only
+static atomic_uint_fast32_t head;   // Written by the producer only
+static atomic_uint_fast32_t tail;   // Written by the consumer only
+static TaskHandle_t consumer_task = NULL;
+
+// Datagram being filled by the producer: packets[head & (UDP_STREAM_PACKETS - 1)] while filling
+static bool filling = false;
+static proto_header_t open_header;
+static uint8_t* open_pos;
+static uint16_t open_max;
+
+// Destination, written by udp_stream_configure() and applied by the task when the generation changes
+static udp_stream_status_t status = {
+    .host = CONFIG_UDP_STREAM_HOST,
+    .port = CONFIG_UDP_STREAM_PORT,
+    .payload_size = UDP_STREAM_PAYLOAD,
+};
+static atomic_bool enabled = false;
+static uint32_t generation = 0;
+static portMUX_TYPE udp_lock = portMUX_INITIALIZER_UNLOCKED;
+
+esp_err_t udp_stream_configure(const char* host, uint16_t port, bool enable) {
+    ip4_addr_t addr;
+    if(port == 0 || strlen(host) >= sizeof(status.host) || ip4addr_aton(host, &addr) == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&udp_lock);
+    strcpy(status.host, host);
+    status.port = port;
+    status.multicast = ip4_addr_ismulticast(&addr);
+    if(enable && !status.enabled) {
+        status.started_us = esp_timer_get_time();
+        status.packets = 0;
+        status.bytes = 0;
+        status.samples = 0;
+        status.dropped = 0;
+        status.send_errors = 0;
+    }
+    status.enabled = enable;
+    generation++;
+    portEXIT_CRITICAL(&udp_lock);
+
+    // The producer stops filling datagrams at once; the task removes the control block
+    atomic_store(&enabled, enable);
+    if(consumer_task != NULL) {
+        xTaskNotifyGive(consumer_task);
+    }
+    ESP_LOGI(UDP_STREAM_TAG, "Streaming %s to %s:%u", enable ? "on" : "off", host, port);
+    return ESP_OK;
+}
+
+// Hand the open datagram to the task
+static void commit(void) {
+    uint32_t h = atomic_load_explicit(&head, memory_order_relaxed);
+    udp_packet_t* packet = &packets[h & (UDP_STREAM_PACKETS - 1)];
+    uint8_t* data = packet->pbuf->payload;
+
+    proto_encode_header(data, UDP_STREAM_PAYLOAD, &open_header);
+    packet->len = open_pos - data;
+    packet->samples = open_header.sample_count;
+    filling = false;
+    atomic_store_explicit(&head, h + 1, memory_order_release);
+
+    if(consumer_task != NULL) {
+        xTaskNotifyGive(consumer_task);
+    }
+}
+
+// A sent pbuf is referenced by the Wi-Fi driver until it has been transmitted when the driver
+// sends by reference (with PSRAM), and must not be refilled until then
+static bool packet_released(const udp_packet_t* packet) {
+    LWIP_PBUF_REF_T ref;
+    SYS_ARCH_GET(packet->pbuf->ref, ref);
+    return ref == 1;
+}
+
+void udp_stream_push_block(const sample_block_t* block) {
+    if(!atomic_load_explicit(&enabled, memory_order_relaxed) || !atomic_load_explicit(&packets_ready, memory_order_acquire)) {
+        filling = false;
+        return;
+    }
+
+    const uint16_t* luts[ACQ_MAX_CHANNELS];
+    for(int slot = 0; slot < block->channel_count; slot++) {
+        luts[slot] = adc_lut_get(block->atten[slot]);
+        if(luts[slot] == NULL) {
+            return;
+        }
+    }
+
+    uint32_t first_seq = block->seq * ACQ_BLOCK_SIZE;
+    for(uint16_t i = 0; i < block->count; i++) {
+        uint32_t seq = first_seq + i;
+
+        // A datagram never spans a scan change or a gap
+        if(filling && (block->channel_mask != open_header.channel_mask || seq != open_header.seq + open_header.sample_count)) {
+            commit();
+        }
+
+        if(!filling) {
+            uint32_t h = atomic_load_explicit(&head, memory_order_relaxed);
+            udp_packet_t* packet = &packets[h & (UDP_STREAM_PACKETS - 1)];
+            if(h - atomic_load_explicit(&tail, memory_order_acquire) >= UDP_STREAM_PACKETS || !packet_released(packet)) {
+                portENTER_CRITICAL(&udp_lock);
+                status.dropped++;
+                portEXIT_CRITICAL(&udp_lock);
+                continue;
+            }
+
+            // The last frame of the block was read at its timestamp
+            open_header = (proto_header_t) {
+                .type = PROTO_TYPE_RAW,
+                .channel_mask = block->channel_mask,
+                .seq = seq,
+                .timestamp_us = block->timestamp_us - (int64_t) (block->count - 1 - i) * 1000000 / ACQ_SAMPLE_RATE_HZ,
+                .rate_hz = ACQ_SAMPLE_RATE_HZ,
+            };
+            open_pos = (uint8_t*) packet->pbuf->payload + PROTO_HEADER_SIZE + 4;
+            open_max = UDP_STREAM_FRAMES(block->channel_count);
+            filling = true;
+        }
+
+        // Little-endian millivolts, straight into the datagram
+        for(int slot = 0; slot < block->channel_count; slot++) {
+            uint16_t mv = luts[slot][block->samples[i][slot]];
+            *open_pos++ = mv;
+            *open_pos++ = mv >> 8;
+        }
+        if(++open_header.sample_count == open_max) {
+            commit();
+        }
+    }
+}
+
+static err_t open_pcb(struct tcpip_api_call_data* call) {
+    udp_call_t* msg = (udp_call_t*) call;
+
+    pcb = udp_new();
+    if(pcb == NULL) {
+        return ERR_MEM;
+    }
+    udp_set_multicast_ttl(pcb, msg->ttl);
+    return ERR_OK;
+}
+
+static err_t close_pcb(struct tcpip_api_call_data* call) {
+    if(pcb != NULL) {
+        udp_remove(pcb);
+        pcb = NULL;
+    }
+    return ERR_OK;
+}
+
+static err_t send_packet(struct tcpip_api_call_data* call) {
+    udp_call_t* msg = (udp_call_t*) call;
+    struct pbuf* p = msg->packet->pbuf;
+
+    // A single PBUF_RAM pbuf, so its length can be set directly up to the size it was allocated with
+    p->len = p->tot_len = msg->packet->len;
+    err_t err = udp_sendto(pcb, p, &msg->addr, msg->port);
+
+    // The headers are added in front of the payload in place and left there
+    pbuf_remove_header(p, p->tot_len - msg->packet->len);
+    return err;
+}
+
+// Allocate every datagram once, with the headers' room in front so lwIP never chains a header pbuf
+static bool alloc_packets(void) {
+    for(int i = 0; i < UDP_STREAM_PACKETS; i++) {
+        packets[i].pbuf = pbuf_alloc(PBUF_TRANSPORT, UDP_STREAM_PAYLOAD, PBUF_RAM);
+        if(packets[i].pbuf == NULL) {
+            ESP_LOGE(UDP_STREAM_TAG, "Unable to allocate %d datagrams", UDP_STREAM_PACKETS);
+            return false;
+        }
+    }
+    atomic_store_explicit(&packets_ready, true, memory_order_release);
+    return true;
+}
+
+void udp_stream_task(void* pvParameters) {
+    udp_stream_status_t dest;
+    udp_call_t msg = { .ttl = CONFIG_UDP_STREAM_TTL };
+    uint32_t applied = 0;
+    bool open = false;
+
+    if(!alloc_packets()) {
+        vTaskDelete(NULL);
+    }
+
+    consumer_task = xTaskGetCurrentTaskHandle();
+#if CONFIG_UDP_STREAM_AUTOSTART
+    udp_stream_configure(CONFIG_UDP_STREAM_HOST, CONFIG_UDP_STREAM_PORT, true);
+#endif
+
+    while(true) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000));
+
+        portENTER_CRITICAL(&udp_lock);
+        bool changed = generation != applied;
+        applied = generation;
+        dest = status;
+        portEXIT_CRITICAL(&udp_lock);
+
+        if(changed) {
+            if(open) {
+                tcpip_api_call(close_pcb, &msg.call);
+                open = false;
+            }
+            if(dest.enabled) {
+                ipaddr_aton(dest.host, &msg.addr);
+                msg.port = dest.port;
+                open = tcpip_api_call(open_pcb, &msg.call) == ERR_OK;
+                if(!open) {
+                    ESP_LOGE(UDP_STREAM_TAG, "Unable to create UDP control block");
+                }
+            }
+        }
+
+        // Datagrams queued while the stream is off are dropped with the control block gone
+        uint32_t t = atomic_load_explicit(&tail, memory_order_relaxed);
+        while(t != atomic_load_explicit(&head, memory_order_acquire)) {
+            msg.packet = &packets[t & (UDP_STREAM_PACKETS - 1)];
+            if(open) {
+                err_t err = tcpip_api_call(send_packet, &msg.call);
+                // Wi-Fi transmit buffers run out under bursts. Give them one tick.
+                if(err == ERR_MEM) {
+                    vTaskDelay(1);
+                    err = tcpip_api_call(send_packet, &msg.call);
+                }
+
+                portENTER_CRITICAL(&udp_lock);
+                if(err == ERR_OK) {
+                    status.packets++;
+                    status.bytes += msg.packet->len;
+                    status.samples += msg.packet->samples;
+                } else {
+                    status.send_errors++;
+                }
+                portEXIT_CRITICAL(&udp_lock);
+            }
+            atomic_store_explicit(&tail, ++t, memory_order_release);
+        }
+    }
+}
+
+void udp_stream_get_status(udp_stream_status_t* out) {
+    portENTER_CRITICAL(&udp_lock);
+    *out = status;
+    portEXIT_CRITICAL(&udp_lock);
+    out->pending = atomic_load(&head) - atomic_load(&tail);
+}
+
+#endif
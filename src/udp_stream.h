@@ -0,0 +1,77 @@
+#ifndef UDP_STREAM_H
+#define UDP_STREAM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "sdkconfig.h"
+#include "acquisition.h"
+#include "protocol.h"
+
+#define UDP_STREAM_TAG "udp_stream"
+#define UDP_STREAM_PAYLOAD (CONFIG_UDP_STREAM_MTU - 28)   // MTU less the IPv4 and UDP headers
+#define UDP_STREAM_PACKETS CONFIG_UDP_STREAM_PACKETS
+
+// Undecimated frames of the given channel count that fit in one datagram
+#define UDP_STREAM_FRAMES(channel_count) ((UDP_STREAM_PAYLOAD - PROTO_HEADER_SIZE - 4) / (2 * (channel_count)))
+
+/**
+ * Raw UDP output of the undecimated sample stream for high-rate captures, alongside the web UI.
+ *
+ * The pipeline converts every acquired frame to millivolts straight into one of UDP_STREAM_PACKETS
+ * MTU-sized pbufs allocated when the UDP task starts (PROTO_TYPE_RAW, see protocol.h). Full
+ * datagrams are handed to the UDP task through a lock-free queue and sent to a unicast or multicast
+ * destination with the raw udp_sendto() on the tcpip thread, which writes the UDP and IP headers
+ * into the room left in front of the payload. lwIP allocates and copies nothing per packet; the
+ * Wi-Fi driver copies each frame into its own transmit buffer, or holds a reference to the pbuf
+ * until it is sent when PSRAM is enabled. Frames arriving while every datagram is queued or still
+ * held by the driver are dropped and counted; the receiver sees the gap in the sequence numbers.
+ */
+
+// Destination and counters
+typedef struct {
+    bool enabled;
+    char host[16];              // Dotted IPv4 destination
+    uint16_t port;
+    bool multicast;
+    uint16_t payload_size;      // Largest datagram payload
+    int64_t started_us;         // When streaming was last enabled
+    uint32_t packets;           // Datagrams sent
+    uint32_t bytes;
+    uint32_t samples;           // Frames sent
+    uint32_t dropped;           // Frames dropped for want of a free datagram
+    uint32_t send_errors;       // Datagrams the socket refused
+    uint32_t pending;           // Datagrams waiting to be sent
+} udp_stream_status_t;
+
+/**
+ * @brief Set the destination and turn the stream on or off. Applied by the UDP task.
+ *
+ * @param host - dotted IPv4 address, unicast or multicast
+ * @param port - destination port
+ * @param enabled - stream
+ * @return esp_err_t - ESP_ERR_INVALID_ARG if the address or port is invalid
+ */
+esp_err_t udp_stream_configure(const char* host, uint16_t port, bool enabled);
+
+/**
+ * @brief Producer (pipeline task): append the frames of an acquired block. Returns at once when the stream is off.
+ *
+ * @param block - acquired block
+ */
+void udp_stream_push_block(const sample_block_t* block);
+
+/**
+ * @brief Task sending the queued datagrams
+ *
+ * @param pvParameters - unused
+ */
+void udp_stream_task(void* pvParameters);
+
+/**
+ * @brief Get the destination and counters
+ */
+void udp_stream_get_status(udp_stream_status_t* status);
+
+#endif
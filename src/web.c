@@ -10,12 +10,32 @@
 #include <esp_http_server.h>
 #include "esp_adc_cal.h"
 #include "driver/adc.h"
+#include "esp_timer.h"
+#include "acquisition.h"
+#include "pipeline.h"
+#include "timing.h"
+#include "stats.h"
+#include "events.h"
+#include "deadband.h"
+#include "protocol.h"
+#include "stream.h"
+#include "codec.h"
+#include "clients.h"
+#include "history.h"
+#include "udp_stream.h"
+#include "template.h"
+#include "assets.h"
 
 // MIN macro
 #ifndef MIN
 #define MIN(a,b) (((a)<(b))?(a):(b))
 #endif 
 
+#ifndef MAX
+#define MAX(a,b) (((a)>(b))?(a):(b))
+#endif
+
+#include <errno.h>
 #include "lwip/err.h"
 #include "lwip/sys.h"
 
@@ -26,6 +46,66 @@
 
 httpd_handle_t server_handle = NULL;
 
+// Publish pacing
+static TaskHandle_t broadcast_task = NULL;
+static timing_monitor_t publish_timing;
+static portMUX_TYPE publish_timing_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Batched streaming to binary clients
+#define WS_BATCH_SHRINK_FLUSHES 16  // Flushes that must keep up before an adaptive batch is halved
+
+static volatile uint32_t stream_batch = CONFIG_WS_BATCH_SAMPLES;
+
+// History points that always fit in one frame: worst-case delta encoding, or five-digit JSON values
+// (with room for the event stream framing around them)
+#define WS_BACKFILL_POINTS ((CLIENTS_FRAME_SIZE - PROTO_HEADER_SIZE - 4) / CODEC_DELTA_MAX_SIZE(ACQ_MAX_CHANNELS))
+#define WS_BACKFILL_JSON_POINTS MIN(WS_BACKFILL_POINTS, (CLIENTS_FRAME_SIZE - 192) / (4 + 6 * ACQ_MAX_CHANNELS))
+
+// Buckets returned by /api/history by default and at most
+#define WS_HISTORY_API_POINTS 500
+#define WS_HISTORY_API_MAX_POINTS 5000
+
+// Placeholders of the pages, by variable ID
+typedef enum {
+    PAGE_GIT_COMMIT_HASH,
+    PAGE_MAC_ADDRESS,
+    PAGE_AP_IP,
+    PAGE_STA_SSID,
+    PAGE_AP_SSID,
+    PAGE_AP_PASSKEY,
+    PAGE_STA_IP,
+    PAGE_MODE,
+    PAGE_STA_STATIC_IP,
+    PAGE_STA_GATEWAY,
+    PAGE_STA_NETMASK,
+    PAGE_STA_IP_MODE,
+    PAGE_VAR_COUNT
+} page_var_t;
+
+static const char* const page_vars[PAGE_VAR_COUNT] = {
+    [PAGE_GIT_COMMIT_HASH] = "GIT_COMMIT_HASH",
+    [PAGE_MAC_ADDRESS] = "MAC_ADDRESS",
+    [PAGE_AP_IP] = "AP_IP",
+    [PAGE_STA_SSID] = "STA_SSID",
+    [PAGE_AP_SSID] = "AP_SSID",
+    [PAGE_AP_PASSKEY] = "AP_PASSKEY",
+    [PAGE_STA_IP] = "STA_IP",
+    [PAGE_MODE] = "MODE",
+    [PAGE_STA_STATIC_IP] = "STA_STATIC_IP",
+    [PAGE_STA_GATEWAY] = "STA_GATEWAY",
+    [PAGE_STA_NETMASK] = "STA_NETMASK",
+    [PAGE_STA_IP_MODE] = "STA_IP_MODE",
+};
+
+// Page compiled when the server starts
+static template_t index_template;
+
+// Report-by-exception state of each ADC channel
+static deadband_t deadbands[ACQ_ADC_CHANNELS];
+static uint32_t frames_sent = 0;
+static uint32_t frames_suppressed = 0;
+static portMUX_TYPE deadband_lock = portMUX_INITIALIZER_UNLOCKED;
+
 //==== URI handlers ====//
 httpd_uri_t uri_get = {
     .uri      = "/",
@@ -46,7 +126,8 @@ httpd_uri_t uri_version = {
     .method       = HTTP_GET,
     .handler      = ws_handler,
     .user_ctx     = NULL,
-    .is_websocket = true
+    .is_websocket = true,
+    .handle_ws_control_frames = true    // Pongs keep clients alive (see clients_tick)
 };
 
 httpd_uri_t wifi_config_uri = {
@@ -72,13 +153,6 @@ httpd_uri_t wifi_ip_config_uri = {
 };
 
 
-httpd_uri_t chart_js_uri = {
-    .uri      = "/chartjs",
-    .method   = HTTP_GET,
-    .handler  = chart_js_handler,
-    .user_ctx = NULL
-};
-
 httpd_uri_t toggle_led_uri = {
     .uri      = "/led",
     .method   = HTTP_GET,
@@ -100,175 +174,166 @@ httpd_uri_t get_all_networks_uri = {
     .user_ctx = NULL
 };
 
-// Web server handle
-esp_err_t httpd_ws_send_frame_to_all_clients(httpd_ws_frame_t *ws_pkt) {
-    size_t max_clients = CONFIG_LWIP_MAX_LISTENING_TCP;
-    size_t fds = max_clients;
-    int* client_fds = (int*)malloc(sizeof(int) * max_clients);
-
-    esp_err_t ret = httpd_get_client_list(server_handle, &fds, client_fds);
-
-    if (ret != ESP_OK) {
-        return ret;
-    }
-
-    // Send the frame to all connected websocket clients
-    for (int i = 0; i < fds; i++) {
-        httpd_ws_client_info_t client_info = httpd_ws_get_fd_info(server_handle, client_fds[i]);
-
-        if (client_info == HTTPD_WS_CLIENT_WEBSOCKET) {
-            httpd_ws_send_frame_async(server_handle, client_fds[i], ws_pkt);
-        }
-    }
-
-    // Free the client list
-    free(client_fds);
-
-    return ESP_OK;
-}
-
-esp_err_t index_handler(httpd_req_t *req) {
-    // Open file from SPIFFS
-    ESP_LOGI(WEB_TAG, "Request received!");
-
-    FILE* file = fopen("/spiffs/index.html", "r");
-    if (file == NULL) {
-        httpd_resp_send_404(req);
-        return ESP_FAIL;
-    }
-
-    network_info_t* net_info = get_network_info();
-    ip_config_t* ip_info = fetch_ip_info_from_nvs();
-
-    // Read the line by line, check for placeholders and replace them
-    char line[1024];
-    while(fgets(line, sizeof(line), file)) {
-        char *temp = NULL;
-        char* newLine = replace_variable(line, "{{GIT_COMMIT_HASH}}", GIT_COMMIT_HASH);
-
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{MAC_ADDRESS}}", net_info->mac_address);
-        free(temp);
-
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{AP_IP}}", net_info->ap_ip);
-        free(temp);
-
-        temp = newLine;
-        newLine = replace_variable(newLine,"{{STA_SSID}}", net_info->station_ssid);
-        free(temp);
-
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{AP_SSID}}", net_info->ap_ssid);
-        free(temp);
-
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{AP_PASSKEY}}", net_info->ap_passkey);
-        free(temp);
-
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{STA_IP}}", net_info->station_ip);
-        free(temp);
-
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{MODE}}", net_info->mode);
-        free(temp);
+httpd_uri_t channels_uri = {
+    .uri      = "/channels",
+    .method   = HTTP_GET,
+    .handler  = channels_handler,
+    .user_ctx = NULL
+};
 
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{STA_STATIC_IP}}", ip_info->ip);
-        free(temp);
+httpd_uri_t channels_config_uri = {
+    .uri      = "/channels",
+    .method   = HTTP_POST,
+    .handler  = channels_handler,
+    .user_ctx = NULL
+};
 
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{STA_GATEWAY}}", ip_info->gateway);
-        free(temp);
+httpd_uri_t timing_uri = {
+    .uri      = "/timing",
+    .method   = HTTP_GET,
+    .handler  = timing_handler,
+    .user_ctx = NULL
+};
 
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{STA_NETMASK}}", ip_info->netmask);
-        free(temp);
+httpd_uri_t stats_uri = {
+    .uri      = "/stats",
+    .method   = HTTP_GET,
+    .handler  = stats_handler,
+    .user_ctx = NULL
+};
 
-        temp = newLine;
-        newLine = replace_variable(newLine, "{{STA_IP_MODE}}", ip_info->mode == 0 ? "0" : "1");
-        free(temp);
+httpd_uri_t acquisition_status_uri = {
+    .uri      = "/acquisition",
+    .method   = HTTP_GET,
+    .handler  = acquisition_status_handler,
+    .user_ctx = NULL
+};
 
-        httpd_resp_send_chunk(req, newLine, strlen(newLine));
-        free(newLine);
-    }
+httpd_uri_t detector_uri = {
+    .uri      = "/detector",
+    .method   = HTTP_GET,
+    .handler  = detector_handler,
+    .user_ctx = NULL
+};
 
-    // Free current network info
+httpd_uri_t detector_config_uri = {
+    .uri      = "/detector",
+    .method   = HTTP_POST,
+    .handler  = detector_handler,
+    .user_ctx = NULL
+};
 
-    if (net_info->ap_ip != NULL) {
-        free(net_info->ap_ip);
-    }
+httpd_uri_t deadband_uri = {
+    .uri      = "/deadband",
+    .method   = HTTP_GET,
+    .handler  = deadband_handler,
+    .user_ctx = NULL
+};
 
-    if (net_info->station_ip != NULL) {
-        free(net_info->station_ip);
-    }
+httpd_uri_t deadband_config_uri = {
+    .uri      = "/deadband",
+    .method   = HTTP_POST,
+    .handler  = deadband_handler,
+    .user_ctx = NULL
+};
 
-    if (net_info->station_ssid != NULL) {
-        free(net_info->station_ssid);
-    }
+httpd_uri_t clients_uri = {
+    .uri      = "/clients",
+    .method   = HTTP_GET,
+    .handler  = clients_handler,
+    .user_ctx = NULL
+};
 
-    if (net_info->ap_ssid != NULL) {
-        free(net_info->ap_ssid);
-    }
+httpd_uri_t events_stream_uri = {
+    .uri      = "/events",
+    .method   = HTTP_GET,
+    .handler  = sse_handler,
+    .user_ctx = NULL
+};
 
-    if (net_info->mac_address != NULL) {
-        free(net_info->mac_address);
-    }
+httpd_uri_t history_api_uri = {
+    .uri      = "/api/history",
+    .method   = HTTP_GET,
+    .handler  = history_api_handler,
+    .user_ctx = NULL
+};
 
-    if (net_info->ap_passkey != NULL) {
-        free(net_info->ap_passkey);
-    }
+// Catch-all for the static assets, registered last so every other route matches first
+httpd_uri_t static_uri = {
+    .uri      = "/*",
+    .method   = HTTP_GET,
+    .handler  = static_handler,
+    .user_ctx = NULL
+};
 
-    if (net_info != NULL) {
-        free(net_info);
-    }
+httpd_uri_t static_head_uri = {
+    .uri      = "/*",
+    .method   = HTTP_HEAD,
+    .handler  = static_handler,
+    .user_ctx = NULL
+};
 
-    // Free stored static ip info
-    if (ip_info->ip != NULL) {
-        free(ip_info->ip);
-    }
+#if CONFIG_UDP_STREAM
+httpd_uri_t udp_uri = {
+    .uri      = "/udp",
+    .method   = HTTP_GET,
+    .handler  = udp_handler,
+    .user_ctx = NULL
+};
 
-    if (ip_info->gateway != NULL) {
-        free(ip_info->gateway);
-    }
+httpd_uri_t udp_config_uri = {
+    .uri      = "/udp",
+    .method   = HTTP_POST,
+    .handler  = udp_handler,
+    .user_ctx = NULL
+};
+#endif
 
-    if (ip_info->netmask != NULL) {
-        free(ip_info->netmask);
+// Queue a copy of a frame to every WebSocket client in the registry
+esp_err_t httpd_ws_send_frame_to_all_clients(httpd_ws_frame_t *ws_pkt) {
+    if (ws_pkt->len > CLIENTS_FRAME_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
     }
 
-    if (ip_info != NULL) {
-        free(ip_info);
+    ws_frame_t* frame = clients_frame_alloc();
+    if (frame == NULL) {
+        return ESP_ERR_NO_MEM;
     }
 
-    fclose(file);
-
-    // Finalize the response
-    httpd_resp_send_chunk(req, NULL, 0); 
+    memcpy(frame->data, ws_pkt->payload, ws_pkt->len);
+    frame->len = ws_pkt->len;
+    frame->type = ws_pkt->type;
+    clients_publish(server_handle, frame, WS_FORMAT_ANY, 0);
     return ESP_OK;
 }
 
-esp_err_t network_page_handler(httpd_req_t *req) {
-    // Open file from SPIFFS
+esp_err_t index_handler(httpd_req_t *req) {
     ESP_LOGI(WEB_TAG, "Request received!");
 
-    FILE* file = fopen("/spiffs/network.html", "r");
-    if (file == NULL) {
+    // Cached copy, no driver or NVS access on a page load
+    network_state_t net;
+    get_network_state(&net);
+
+    const char* values[PAGE_VAR_COUNT] = {
+        [PAGE_GIT_COMMIT_HASH] = GIT_COMMIT_HASH,
+        [PAGE_MAC_ADDRESS] = net.mac_address,
+        [PAGE_AP_IP] = net.ap_ip,
+        [PAGE_STA_SSID] = net.station_ssid,
+        [PAGE_AP_SSID] = net.ap_ssid,
+        [PAGE_AP_PASSKEY] = net.ap_passkey,
+        [PAGE_STA_IP] = net.station_ip,
+        [PAGE_MODE] = net.mode,
+        [PAGE_STA_STATIC_IP] = net.static_ip,
+        [PAGE_STA_GATEWAY] = net.gateway,
+        [PAGE_STA_NETMASK] = net.netmask,
+        [PAGE_STA_IP_MODE] = net.ip_mode == 0 ? "0" : "1",
+    };
+
+    esp_err_t err = template_render(&index_template, req, values);
+    if (err == ESP_ERR_INVALID_STATE || err == ESP_ERR_NOT_FOUND) {
         httpd_resp_send_404(req);
-        return ESP_FAIL;
     }
-
-    // Read the line by line, check for placeholders and replace them
-    char line[1024];
-    while(fgets(line, sizeof(line), file)) {
-        char* newLine = replace_variable(line, "{{GIT_COMMIT_HASH}}", GIT_COMMIT_HASH);
-        httpd_resp_send_chunk(req, newLine, strlen(newLine));
-        free(newLine);
-    }
-
-    fclose(file);
-    httpd_resp_send_chunk(req, NULL, 0); // Finalize the response
-    return ESP_OK;
+    return err;
 }
 
 esp_err_t wifi_credential_handler(httpd_req_t *req) {
@@ -459,27 +524,22 @@ esp_err_t get_all_networks_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
-esp_err_t chart_js_handler(httpd_req_t *req) {
-    // Open file from SPIFFS
-    ESP_LOGI(WEB_TAG, "Request received!");
-
-    FILE* file = fopen("/spiffs/chart.js", "r");
-    if (file == NULL) {
+esp_err_t static_handler(httpd_req_t *req) {
+    // Asset name is the path without the leading '/' and the query string
+    char name[ASSETS_MAX_NAME];
+    size_t len = strcspn(req->uri + 1, "?#");
+    if (len == 0 || len >= sizeof(name)) {
         httpd_resp_send_404(req);
         return ESP_FAIL;
     }
+    memcpy(name, req->uri + 1, len);
+    name[len] = '\0';
 
-    // Set header for cache control
-    httpd_resp_set_hdr(req, "Cache-Control", "max-age=3600");
-
-    // Read the line by line, check for placeholders and replace them
-    char line[1024];
-    while(fgets(line, sizeof(line), file)) {
-        httpd_resp_send_chunk(req, line, strlen(line));
+    // Only indexed assets are served, so the page templates are not exposed unrendered
+    if (assets_find(name) == NULL || assets_send(req, name, NULL) == ESP_ERR_NOT_FOUND) {
+        httpd_resp_send_404(req);
+        return ESP_FAIL;
     }
-
-    fclose(file);
-    httpd_resp_send_chunk(req, NULL, 0); // Finalize the response
     return ESP_OK;
 }
 
@@ -491,10 +551,999 @@ esp_err_t version_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+esp_err_t acquisition_status_handler(httpd_req_t *req) {
+    acq_status_t status;
+    pipeline_status_t pipeline;
+    acquisition_get_status(&status);
+    pipeline_get_status(&pipeline);
+
+    char buf[384];
+    snprintf(buf, sizeof(buf),
+        "{\"sample_rate_hz\": %lu, \"block_size\": %u, \"channel_mask\": %u, \"blocks_produced\": %lu, \"blocks_dropped\": %lu, "
+        "\"ring_blocks\": %lu, \"ring_high_water\": %lu, \"source_running\": %s, \"read_timeouts\": %lu, \"source_restarts\": %lu, "
+        "\"decimation_ratio\": %d, \"decimation_cycles_per_sample\": %.2f}",
+        (unsigned long) status.sample_rate_hz, status.block_size, status.channel_mask,
+        (unsigned long) status.blocks_produced, (unsigned long) status.blocks_dropped,
+        (unsigned long) status.ring_blocks, (unsigned long) status.ring_high_water,
+        status.source_running ? "true" : "false", (unsigned long) status.read_timeouts, (unsigned long) status.source_restarts,
+        (int) pipeline.decimation_ratio, pipeline.decimation_cycles_per_sample);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, buf, strlen(buf));
+    return ESP_OK;
+}
+
+esp_err_t channels_handler(httpd_req_t *req) {
+    if (req->method == HTTP_POST) {
+        char buf[128];
+
+        // Clear the buffer
+        memset(buf, 0, sizeof(buf));
+
+        /* Truncate if content length larger than the buffer */
+        size_t recv_size = MIN(req->content_len, sizeof(buf) - 1);
+
+        int ret = httpd_req_recv(req, buf, recv_size);
+        if (ret <= 0) {  /* 0 return value indicates connection closed */
+            /* Check if timeout occurred */
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
+            }
+            return ESP_FAIL;
+        }
+
+        char channel[8];
+        char atten[8];
+        char enabled[8];
+        if (httpd_query_key_value(buf, "channel", channel, sizeof(channel)) != ESP_OK ||
+            httpd_query_key_value(buf, "atten", atten, sizeof(atten)) != ESP_OK ||
+            httpd_query_key_value(buf, "enabled", enabled, sizeof(enabled)) != ESP_OK) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "channel, atten and enabled are required");
+            return ESP_FAIL;
+        }
+
+        esp_err_t err = acquisition_set_channel(atoi(channel), atoi(atten), atoi(enabled) != 0);
+        if (err != ESP_OK) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, esp_err_to_name(err));
+            return ESP_FAIL;
+        }
+
+        ESP_LOGI(WEB_TAG, "Channel %s set to atten %s, enabled %s", channel, atten, enabled);
+    }
+
+    acq_channel_config_t table[ACQ_ADC_CHANNELS];
+    acquisition_get_channels(table);
+
+    char json[64 * ACQ_ADC_CHANNELS];
+    int len = snprintf(json, sizeof(json), "[");
+    for (int i = 0; i < ACQ_ADC_CHANNELS; i++) {
+        len += snprintf(json + len, sizeof(json) - len, "%s{\"channel\": %d, \"atten\": %d, \"enabled\": %s}",
+            i > 0 ? "," : "", table[i].channel, table[i].atten, table[i].enabled ? "true" : "false");
+    }
+    snprintf(json + len, sizeof(json) - len, "]");
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json, strlen(json));
+    return ESP_OK;
+}
+
+esp_err_t timing_handler(httpd_req_t *req) {
+    timing_monitor_t blocks;
+    timing_monitor_t publish;
+
+    pipeline_get_block_timing(&blocks);
+    portENTER_CRITICAL(&publish_timing_lock);
+    publish = publish_timing;
+    portEXIT_CRITICAL(&publish_timing_lock);
+
+    static const uint32_t bounds[] = TIMING_HIST_BOUNDS_US;
+    char json[768];
+    int len = snprintf(json, sizeof(json), "{\"hist_bounds_us\": [");
+    for (int i = 0; i < sizeof(bounds) / sizeof(bounds[0]); i++) {
+        len += snprintf(json + len, sizeof(json) - len, "%s%lu", i > 0 ? "," : "", (unsigned long) bounds[i]);
+    }
+    len += snprintf(json + len, sizeof(json) - len, "], \"blocks\": ");
+    len += timing_to_json(&blocks, json + len, sizeof(json) - len);
+    len += snprintf(json + len, sizeof(json) - len, ", \"publish\": ");
+    len += timing_to_json(&publish, json + len, sizeof(json) - len);
+    snprintf(json + len, sizeof(json) - len, "}");
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json, strlen(json));
+    return ESP_OK;
+}
+
+// Parse a whole decimal form field. Returns false for an empty or partly numeric field, or a value outside [min, max].
+static bool parse_long(const char* param, long min, long max, long* value) {
+    char* end;
+
+    errno = 0;
+    *value = strtol(param, &end, 10);
+    return end != param && *end == '\0' && errno == 0 && *value >= min && *value <= max;
+}
+
+esp_err_t detector_handler(httpd_req_t *req) {
+    if (req->method == HTTP_POST) {
+        char buf[128];
+
+        // Clear the buffer
+        memset(buf, 0, sizeof(buf));
+
+        /* Truncate if content length larger than the buffer */
+        size_t recv_size = MIN(req->content_len, sizeof(buf) - 1);
+
+        int ret = httpd_req_recv(req, buf, recv_size);
+        if (ret <= 0) {  /* 0 return value indicates connection closed */
+            /* Check if timeout occurred */
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
+            }
+            return ESP_FAIL;
+        }
+
+        char channel[8];
+        char threshold[8];
+        char hysteresis[8];
+        char debounce[8];
+        char enabled[8];
+        if (httpd_query_key_value(buf, "channel", channel, sizeof(channel)) != ESP_OK ||
+            httpd_query_key_value(buf, "threshold", threshold, sizeof(threshold)) != ESP_OK ||
+            httpd_query_key_value(buf, "hysteresis", hysteresis, sizeof(hysteresis)) != ESP_OK ||
+            httpd_query_key_value(buf, "debounce", debounce, sizeof(debounce)) != ESP_OK ||
+            httpd_query_key_value(buf, "enabled", enabled, sizeof(enabled)) != ESP_OK) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "channel, threshold, hysteresis, debounce and enabled are required");
+            return ESP_FAIL;
+        }
+
+        long ch, threshold_mv, hysteresis_mv, debounce_samples;
+        if (!parse_long(channel, 0, ACQ_ADC_CHANNELS - 1, &ch) ||
+            !parse_long(threshold, 0, EVENTS_MAX_MV, &threshold_mv) ||
+            !parse_long(hysteresis, 0, EVENTS_MAX_MV, &hysteresis_mv) ||
+            !parse_long(debounce, 0, EVENTS_MAX_DEBOUNCE, &debounce_samples)) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "channel, threshold, hysteresis (0-3300 mV) or debounce (0-1000) out of range");
+            return ESP_FAIL;
+        }
+
+        event_config_t config = {
+            .enabled = atoi(enabled) != 0,
+            .threshold_mv = threshold_mv,
+            .hysteresis_mv = hysteresis_mv,
+            .debounce = debounce_samples,
+        };
+        esp_err_t err = events_configure(ch, &config);
+        if (err != ESP_OK) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, esp_err_to_name(err));
+            return ESP_FAIL;
+        }
+
+        ESP_LOGI(WEB_TAG, "Detector on channel %s set to %s mV, hysteresis %s mV, debounce %s, enabled %s",
+            channel, threshold, hysteresis, debounce, enabled);
+    }
+
+    char json[32 + 128 * ACQ_ADC_CHANNELS];
+    int len = snprintf(json, sizeof(json), "{\"dropped\": %lu, \"channels\": [", (unsigned long) events_dropped());
+    for (int i = 0; i < ACQ_ADC_CHANNELS; i++) {
+        event_config_t config;
+        uint32_t rising;
+        uint32_t falling;
+        events_get_config(i, &config);
+        events_get_counters(i, &rising, &falling);
+        len += snprintf(json + len, sizeof(json) - len,
+            "%s{\"channel\": %d, \"enabled\": %s, \"threshold\": %u, \"hysteresis\": %u, \"debounce\": %u, \"rising\": %lu, \"falling\": %lu}",
+            i > 0 ? "," : "", i, config.enabled ? "true" : "false", config.threshold_mv, config.hysteresis_mv,
+            config.debounce, (unsigned long) rising, (unsigned long) falling);
+    }
+    snprintf(json + len, sizeof(json) - len, "]}");
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json, strlen(json));
+    return ESP_OK;
+}
+
+esp_err_t deadband_handler(httpd_req_t *req) {
+    if (req->method == HTTP_POST) {
+        char buf[128];
+
+        // Clear the buffer
+        memset(buf, 0, sizeof(buf));
+
+        /* Truncate if content length larger than the buffer */
+        size_t recv_size = MIN(req->content_len, sizeof(buf) - 1);
+
+        int ret = httpd_req_recv(req, buf, recv_size);
+        if (ret <= 0) {  /* 0 return value indicates connection closed */
+            /* Check if timeout occurred */
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
+            }
+            return ESP_FAIL;
+        }
+
+        char channel[8];
+        char deadband[8];
+        char max_silence[12];
+        if (httpd_query_key_value(buf, "channel", channel, sizeof(channel)) != ESP_OK ||
+            httpd_query_key_value(buf, "deadband", deadband, sizeof(deadband)) != ESP_OK) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "channel and deadband are required");
+            return ESP_FAIL;
+        }
+
+        int ch = atoi(channel);
+        int mv = atoi(deadband);
+        if (ch < 0 || ch >= ACQ_ADC_CHANNELS || mv < 0 || mv > 3300) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "channel or deadband out of range");
+            return ESP_FAIL;
+        }
+
+        // max_silence (ms) is optional and keeps its current value when omitted
+        portENTER_CRITICAL(&deadband_lock);
+        long silence_ms = (long) (deadbands[ch].max_silence_us / 1000);
+        portEXIT_CRITICAL(&deadband_lock);
+        if (httpd_query_key_value(buf, "max_silence", max_silence, sizeof(max_silence)) == ESP_OK &&
+            !parse_long(max_silence, DEADBAND_MIN_SILENCE_MS, DEADBAND_MAX_SILENCE_MS, &silence_ms)) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "max_silence must be 100-3600000 ms");
+            return ESP_FAIL;
+        }
+
+        portENTER_CRITICAL(&deadband_lock);
+        deadband_init(&deadbands[ch], mv, silence_ms);
+        portEXIT_CRITICAL(&deadband_lock);
+
+        ESP_LOGI(WEB_TAG, "Deadband on channel %d set to %d mV, max silence %ld ms", ch, mv, silence_ms);
+    }
+
+    deadband_t table[ACQ_ADC_CHANNELS];
+    uint32_t sent;
+    uint32_t suppressed;
+    portENTER_CRITICAL(&deadband_lock);
+    memcpy(table, deadbands, sizeof(table));
+    sent = frames_sent;
+    suppressed = frames_suppressed;
+    portEXIT_CRITICAL(&deadband_lock);
+
+    char json[64 + 128 * ACQ_ADC_CHANNELS];
+    int len = snprintf(json, sizeof(json), "{\"frames_sent\": %lu, \"frames_suppressed\": %lu, \"channels\": [",
+        (unsigned long) sent, (unsigned long) suppressed);
+    for (int i = 0; i < ACQ_ADC_CHANNELS; i++) {
+        len += snprintf(json + len, sizeof(json) - len,
+            "%s{\"channel\": %d, \"deadband\": %u, \"max_silence\": %lu, \"sent\": %lu, \"heartbeats\": %lu, \"suppressed\": %lu}",
+            i > 0 ? "," : "", i, table[i].deadband_mv, (unsigned long) (table[i].max_silence_us / 1000),
+            (unsigned long) table[i].sent, (unsigned long) table[i].heartbeats, (unsigned long) table[i].suppressed);
+    }
+    snprintf(json + len, sizeof(json) - len, "]}");
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json, strlen(json));
+    return ESP_OK;
+}
+
+esp_err_t clients_handler(httpd_req_t *req) {
+    // Handlers run on the single httpd task, so the snapshot can live outside its stack
+    static ws_client_t clients[CLIENTS_MAX];
+    size_t count = clients_get(clients);
+
+    clients_fanout_t fanout;
+    clients_get_fanout(&fanout);
+
+    // Sent as one chunk for the header and one per client, so the buffer does not grow with CLIENTS_MAX
+    char json[512];
+    int len = snprintf(json, sizeof(json),
+        "{\"batch\": %lu, \"pending\": %lu, \"overruns\": %lu, \"fanouts\": %lu, \"fanout_us\": %.1f, \"send_us\": %.1f, "
+        "\"pool_free\": %lu, \"pool_exhausted\": %lu, \"evictions\": %lu, \"dropped\": %lu, \"resent\": %lu, "
+        "\"unavailable\": %lu, \"retransmit_window\": %lu, \"clients\": [",
+        (unsigned long) stream_batch, (unsigned long) stream_pending(), (unsigned long) stream_overruns(),
+        (unsigned long) fanout.fanouts,
+        fanout.fanouts > 0 ? (float) fanout.total_us / fanout.fanouts : 0.0f,
+        fanout.sends > 0 ? (float) fanout.total_us / fanout.sends : 0.0f,
+        (unsigned long) fanout.pool_free, (unsigned long) fanout.pool_exhausted, (unsigned long) fanout.evictions,
+        (unsigned long) fanout.dropped, (unsigned long) fanout.resent, (unsigned long) fanout.unavailable,
+        (unsigned long) HISTORY_RECENT_LEN);
+
+    httpd_resp_set_type(req, "application/json");
+    esp_err_t err = httpd_resp_send_chunk(req, json, MIN(len, (int) sizeof(json) - 1));
+
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < count && err == ESP_OK; i++) {
+        ws_client_t* client = &clients[i];
+
+        // Achieved rates since the client connected
+        float seconds = (now - client->connected_us) / 1e6f;
+        if (seconds <= 0) {
+            seconds = 1;
+        }
+        len = snprintf(json, sizeof(json),
+            "%s{\"fd\": %d, \"format\": \"%s\", \"policy\": \"%s\", \"mask\": %u, \"decimation\": %u, \"deadband\": %u, \"frames\": %lu, \"samples\": %lu, \"bytes\": %lu, "
+            "\"frames_per_s\": %.2f, \"samples_per_s\": %.2f, \"depth\": %u, \"max_depth\": %u, \"dropped\": %lu, "
+            "\"resend_requests\": %lu, \"resent\": %lu, \"unavailable\": %lu, \"last_seen_ms\": %lu}",
+            i > 0 ? "," : "", client->fd, clients_format_name(client->sub.format), clients_policy_name(client->policy),
+            client->sub.channel_mask, client->sub.decimation, client->sub.deadband_mv,
+            (unsigned long) client->frames, (unsigned long) client->samples, (unsigned long) client->bytes,
+            client->frames / seconds, client->samples / seconds, client->depth, client->max_depth,
+            (unsigned long) client->dropped, (unsigned long) client->resend_requests, (unsigned long) client->resent,
+            (unsigned long) client->unavailable, (unsigned long) ((now - client->last_seen_us) / 1000));
+        err = httpd_resp_send_chunk(req, json, MIN(len, (int) sizeof(json) - 1));
+    }
+
+    if (err == ESP_OK) {
+        err = httpd_resp_send_chunk(req, "]}", 2);
+    }
+    if (err == ESP_OK) {
+        err = httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return err;
+}
+
+#if CONFIG_UDP_STREAM
+esp_err_t udp_handler(httpd_req_t *req) {
+    udp_stream_status_t status;
+
+    if (req->method == HTTP_POST) {
+        char buf[128];
+
+        // Clear the buffer
+        memset(buf, 0, sizeof(buf));
+
+        /* Truncate if content length larger than the buffer */
+        size_t recv_size = MIN(req->content_len, sizeof(buf) - 1);
+
+        int ret = httpd_req_recv(req, buf, recv_size);
+        if (ret <= 0) {  /* 0 return value indicates connection closed */
+            /* Check if timeout occurred */
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
+            }
+            return ESP_FAIL;
+        }
+
+        // Fields left out keep their current value
+        udp_stream_get_status(&status);
+        char host[sizeof(status.host)];
+        char port[8];
+        char enabled[4];
+        strcpy(host, status.host);
+        int port_num = status.port;
+        bool enable = status.enabled;
+        httpd_query_key_value(buf, "host", host, sizeof(host));
+        if (httpd_query_key_value(buf, "port", port, sizeof(port)) == ESP_OK) {
+            port_num = atoi(port);
+        }
+        if (httpd_query_key_value(buf, "enabled", enabled, sizeof(enabled)) == ESP_OK) {
+            enable = atoi(enabled) != 0;
+        }
+
+        if (port_num <= 0 || port_num > 65535 || udp_stream_configure(host, port_num, enable) != ESP_OK) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "host must be an IPv4 address and port 1-65535");
+            return ESP_FAIL;
+        }
+    }
+
+    udp_stream_get_status(&status);
+
+    // Achieved rates since streaming was enabled
+    float seconds = status.enabled ? (esp_timer_get_time() - status.started_us) / 1e6f : 0;
+    if (seconds <= 0) {
+        seconds = 1;
+    }
+
+    char json[512];
+    snprintf(json, sizeof(json),
+        "{\"enabled\": %s, \"host\": \"%s\", \"port\": %u, \"multicast\": %s, \"rate\": %d, \"payload_size\": %u, "
+        "\"packets\": %lu, \"bytes\": %lu, \"samples\": %lu, \"dropped\": %lu, \"send_errors\": %lu, \"pending\": %lu, "
+        "\"packets_per_s\": %.1f, \"bytes_per_s\": %.1f, \"samples_per_s\": %.1f}",
+        status.enabled ? "true" : "false", status.host, status.port, status.multicast ? "true" : "false",
+        ACQ_SAMPLE_RATE_HZ, status.payload_size, (unsigned long) status.packets, (unsigned long) status.bytes,
+        (unsigned long) status.samples, (unsigned long) status.dropped, (unsigned long) status.send_errors,
+        (unsigned long) status.pending, status.packets / seconds, status.bytes / seconds, status.samples / seconds);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json, strlen(json));
+    return ESP_OK;
+}
+#endif
+
+// Write one statistics result as a JSON object
+static int stats_result_to_json(const stats_result_t* r, char* buf, size_t len, bool with_hist) {
+    int n = snprintf(buf, len,
+        "{\"window_s\": %u, \"count\": %lu, \"min\": %u, \"max\": %u, \"mean\": %.1f, \"rms\": %.1f, \"stddev\": %.2f",
+        r->window_s, (unsigned long) r->count, r->min_mv, r->max_mv, r->mean_mv, r->rms_mv, r->stddev_mv);
+
+    if (with_hist) {
+        n += snprintf(buf + n, len - n, ", \"hist\": [");
+        for (int i = 0; i < STATS_HIST_BINS; i++) {
+            n += snprintf(buf + n, len - n, "%s%u", i > 0 ? "," : "", r->hist[i]);
+        }
+        n += snprintf(buf + n, len - n, "]");
+    }
+    n += snprintf(buf + n, len - n, "}");
+    return n;
+}
+
+esp_err_t stats_handler(httpd_req_t *req) {
+    static const uint16_t windows[STATS_WINDOWS] = STATS_WINDOW_SECONDS;
+    int only_window = -1;
+
+    char query[32];
+    char param[8];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "window", param, sizeof(param)) == ESP_OK) {
+        int seconds = atoi(param);
+        for (int w = 0; w < STATS_WINDOWS; w++) {
+            if (windows[w] == seconds) {
+                only_window = w;
+            }
+        }
+        if (only_window < 0) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "window must be 1, 10 or 60");
+            return ESP_FAIL;
+        }
+    }
+
+    // One chunk per channel keeps the buffer small
+    httpd_resp_set_type(req, "application/json");
+
+    char buf[640];
+    snprintf(buf, sizeof(buf), "{\"rate_hz\": %.2f, \"hist_bin_mv\": %d, \"channels\": [", stats_effective_rate_hz(), STATS_HIST_BIN_MV);
+    httpd_resp_send_chunk(req, buf, strlen(buf));
+
+    uint8_t channel_count = stats_channel_count();
+    for (int slot = 0; slot < channel_count; slot++) {
+        stats_result_t result;
+        int len = 0;
+        bool first = true;
+
+        for (int w = 0; w < STATS_WINDOWS; w++) {
+            if ((only_window >= 0 && w != only_window) || !stats_get(slot, w, &result)) {
+                continue;
+            }
+            if (first) {
+                len += snprintf(buf + len, sizeof(buf) - len, "%s{\"ch\": %d, \"windows\": [", slot > 0 ? "," : "", result.channel);
+                first = false;
+            } else {
+                len += snprintf(buf + len, sizeof(buf) - len, ",");
+            }
+            len += stats_result_to_json(&result, buf + len, sizeof(buf) - len, true);
+        }
+
+        if (!first) {
+            len += snprintf(buf + len, sizeof(buf) - len, "]}");
+            httpd_resp_send_chunk(req, buf, len);
+        }
+    }
+
+    httpd_resp_sendstr_chunk(req, "]}");
+    httpd_resp_send_chunk(req, NULL, 0);
+    return ESP_OK;
+}
+
+// Parse a history query time: a device time in us, or seconds before now when negative
+static int64_t history_query_time(const char* param, int64_t now) {
+    long long value = strtoll(param, NULL, 10);
+    return value < 0 ? now + value * 1000000LL : value;
+}
+
+esp_err_t history_api_handler(httpd_req_t *req) {
+    int64_t now = esp_timer_get_time();
+    int64_t from_us = 0;
+    int64_t to_us = now;
+    int channel = -1;
+    uint32_t max_points = WS_HISTORY_API_POINTS;
+
+    char query[96];
+    char param[24];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        if (httpd_query_key_value(query, "channel", param, sizeof(param)) == ESP_OK) {
+            channel = atoi(param);
+        }
+        if (httpd_query_key_value(query, "from", param, sizeof(param)) == ESP_OK) {
+            from_us = history_query_time(param, now);
+        }
+        if (httpd_query_key_value(query, "to", param, sizeof(param)) == ESP_OK) {
+            to_us = history_query_time(param, now);
+        }
+        if (httpd_query_key_value(query, "points", param, sizeof(param)) == ESP_OK) {
+            max_points = atoi(param);
+        }
+    }
+    if (max_points < 1 || max_points > WS_HISTORY_API_MAX_POINTS) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "points must be 1-5000");
+        return ESP_FAIL;
+    }
+
+    history_range_t range;
+    history_find(from_us, to_us, &range);
+
+    // Slot of the channel, the first one held by default
+    int slot = -1;
+    for (int ch = 0, held = 0; ch < ACQ_ADC_CHANNELS; ch++) {
+        if (range.channel_mask & (1 << ch)) {
+            if (channel < 0 || ch == channel) {
+                channel = ch;
+                slot = held;
+                break;
+            }
+            held++;
+        }
+    }
+    if (range.count > 0 && slot < 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "channel not in history");
+        return ESP_FAIL;
+    }
+
+    // Buckets of equal length bound the response whatever the span. Each is streamed as
+    // [t, min, max, mean] in chunks as it is aggregated.
+    uint32_t per_bucket = range.count > 0 ? (range.count + max_points - 1) / max_points : 1;
+    uint32_t n_buckets = range.count > 0 ? (range.count + per_bucket - 1) / per_bucket : 0;
+
+    int64_t last_us = range.count > 0 ? range.first_us + (int64_t) (range.count - 1) * range.period_us : 0;
+
+    httpd_resp_set_type(req, "application/json");
+
+    char buf[512];
+    int len = snprintf(buf, sizeof(buf),
+        "{\"channel\": %d, \"from\": %lld, \"to\": %lld, \"period\": %lu, \"bucket\": %lld, \"points\": [",
+        channel, (long long) range.first_us, (long long) last_us, (unsigned long) range.period_us,
+        (long long) per_bucket * range.period_us);
+
+    history_bucket_t buckets[16];
+    bool complete = true;
+    for (uint32_t b = 0; b < n_buckets;) {
+        size_t n = history_aggregate(&range, slot, b * per_bucket, per_bucket, buckets, MIN(n_buckets - b, 16));
+        if (n == 0) {
+            // The rest has left the history since the query started
+            complete = false;
+            break;
+        }
+        for (size_t i = 0; i < n; i++, b++) {
+            if ((size_t) len > sizeof(buf) - 48) {
+                httpd_resp_send_chunk(req, buf, len);
+                len = 0;
+            }
+            len += snprintf(buf + len, sizeof(buf) - len, "%s[%lld,%u,%u,%u]", b > 0 ? "," : "",
+                (long long) (range.first_us + (int64_t) b * per_bucket * range.period_us),
+                buckets[i].min_mv, buckets[i].max_mv, buckets[i].mean_mv);
+        }
+    }
+    len += snprintf(buf + len, sizeof(buf) - len, "], \"complete\": %s}", complete ? "true" : "false");
+    httpd_resp_send_chunk(req, buf, len);
+    httpd_resp_send_chunk(req, NULL, 0);
+    return ESP_OK;
+}
+
 // WebSocket handler
+// Encode up to count frames as a JSON text message: {"<key>": {"seq", "t", "dt", "pin", "ch": [...], "mv": [[...], ...]}}.
+// Returns the frames written, fewer than count if the buffer filled up.
+static size_t encode_json_samples(char* buf, size_t len, const char* key, const proto_header_t* header, int64_t period_us,
+    const uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t count, uint8_t channel_count, size_t* written) {
+    int n = snprintf(buf, len, "{\"%s\": {\"seq\": %lu, \"t\": %lld, \"dt\": %lld, \"pin\": %d, %s\"ch\": [",
+        key, (unsigned long) header->seq, (long long) header->timestamp_us, (long long) period_us,
+        header->flags & PROTO_FLAG_PIN ? 1 : 0, header->flags & PROTO_FLAG_RETRANSMIT ? "\"resent\": true, " : "");
+    for (int ch = 0, slot = 0; ch < ACQ_ADC_CHANNELS; ch++) {
+        if (header->channel_mask & (1 << ch)) {
+            n += snprintf(buf + n, len - n, "%s%d", slot++ > 0 ? "," : "", ch);
+        }
+    }
+    n += snprintf(buf + n, len - n, "], \"mv\": [");
+
+    // Room for one row of five-digit values and the closing brackets
+    const size_t row_max = 4 + 6 * channel_count;
+    size_t frames = 0;
+    while (frames < count && n + row_max + 4 < len) {
+        n += snprintf(buf + n, len - n, "%s[", frames > 0 ? "," : "");
+        for (int slot = 0; slot < channel_count; slot++) {
+            n += snprintf(buf + n, len - n, "%s%u", slot > 0 ? "," : "", mv[frames][slot]);
+        }
+        n += snprintf(buf + n, len - n, "]");
+        frames++;
+    }
+    n += snprintf(buf + n, len - n, "]}}");
+
+    *written = n;
+    return frames;
+}
+
+// Encode up to count frames into a text frame: the JSON message of encode_json_samples(), wrapped as
+// "data: <json>\nid: <seq of the last frame>\n\n" for event streams. step is the sequence number spacing
+// of the frames, 0 to leave the id out. Returns the frames written.
+static size_t encode_text_samples(ws_frame_t* frame, ws_format_t format, const char* key, const proto_header_t* header,
+    int64_t period_us, const uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t count, uint8_t channel_count, uint16_t step) {
+    char* buf = (char*)frame->data;
+    size_t len = sizeof(frame->data);
+
+    frame->type = HTTPD_WS_TYPE_TEXT;
+    if (format != WS_FORMAT_SSE) {
+        return encode_json_samples(buf, len, key, header, period_us, mv, count, channel_count, &frame->len);
+    }
+
+    // Room for the id line and the blank line ending the event
+    const size_t prefix = strlen("data: ");
+    size_t written;
+    memcpy(buf, "data: ", prefix);
+    size_t frames = encode_json_samples(buf + prefix, len - prefix - 24, key, header, period_us, mv, count,
+        channel_count, &written);
+    size_t n = prefix + written;
+    if (step > 0 && frames > 0) {
+        n += snprintf(buf + n, len - n, "\nid: %lu", (unsigned long) (header->seq + (frames - 1) * step));
+    }
+    n += snprintf(buf + n, len - n, "\n\n");
+
+    frame->len = n;
+    return frames;
+}
+
+// Slots of the channels a subscription wants among those present, in ascending channel order
+static uint8_t subscription_slots(const ws_subscription_t* sub, uint16_t present_mask, uint8_t* slots, uint16_t* mask) {
+    uint8_t channel_count = 0;
+
+    *mask = 0;
+    for (int ch = 0, slot = 0; ch < ACQ_ADC_CHANNELS; ch++) {
+        if (!(present_mask & (1 << ch))) {
+            continue;
+        }
+        if (sub->channel_mask == 0 || (sub->channel_mask & (1 << ch))) {
+            slots[channel_count++] = slot;
+            *mask |= 1 << ch;
+        }
+        slot++;
+    }
+    return channel_count;
+}
+
+// History points being sent to a client (httpd task only)
+static uint16_t history_points[WS_BACKFILL_POINTS][ACQ_MAX_CHANNELS];
+
+// Encode n history points into a frame in the client's format, keeping only the subscribed channels
+// (compacted in place). The caller sets type, flags and seq of the header; sample_count is set to the
+// points encoded. Returns NULL if none of the channels are subscribed or the pool is empty.
+static ws_frame_t* encode_history(const ws_subscription_t* sub, const char* json_key, proto_header_t* header,
+    uint16_t (*points)[ACQ_MAX_CHANNELS], size_t n, const history_span_t* span) {
+    uint8_t slots[ACQ_MAX_CHANNELS];
+    uint16_t mask;
+    uint8_t channel_count = subscription_slots(sub, span->channel_mask, slots, &mask);
+    if (n == 0 || channel_count == 0) {
+        return NULL;
+    }
+
+    // slots[i] >= i, so this can run in place
+    for (size_t i = 0; i < n; i++) {
+        for (int slot = 0; slot < channel_count; slot++) {
+            points[i][slot] = points[i][slots[slot]];
+        }
+    }
+
+    ws_frame_t* frame = clients_frame_alloc();
+    if (frame == NULL) {
+        return NULL;
+    }
+
+    header->channel_mask = mask;
+    header->sample_count = n;
+    header->timestamp_us = span->first_us;
+    header->period_us = span->period_us;
+    if (sub->format == WS_FORMAT_JSON || sub->format == WS_FORMAT_SSE) {
+        // Averaged history has no sequence numbers to resume from
+        header->sample_count = encode_text_samples(frame, sub->format, json_key, header, span->period_us,
+            (const uint16_t (*)[ACQ_MAX_CHANNELS]) points, n, channel_count,
+            header->type == PROTO_TYPE_HISTORY ? 0 : sub->decimation);
+    } else {
+        frame->type = HTTPD_WS_TYPE_BINARY;
+        frame->len = proto_encode(frame->data, sizeof(frame->data), header, points[0], ACQ_MAX_CHANNELS);
+    }
+    return frame;
+}
+
+// Queue the last seconds of history to one client as a single frame: PROTO_TYPE_HISTORY for
+// binary and delta clients, {"history": ...} for JSON clients. Long spans are averaged down to fit.
+static void send_backfill(httpd_handle_t hd, int fd, const ws_subscription_t* sub, uint32_t seconds) {
+    if (seconds == 0) {
+        return;
+    }
+
+    size_t max = sub->format == WS_FORMAT_BINARY || sub->format == WS_FORMAT_DELTA ? WS_BACKFILL_POINTS : WS_BACKFILL_JSON_POINTS;
+    history_span_t span;
+    size_t n = history_read(seconds, history_points, max, &span);
+
+    proto_header_t header = { .type = PROTO_TYPE_HISTORY };
+    ws_frame_t* frame = encode_history(sub, "history", &header, history_points, n, &span);
+    if (frame != NULL) {
+        clients_send(hd, fd, frame, header.sample_count);
+    }
+}
+
+// Queue a client's frames with sequence numbers in [from, to) again from the full-rate history, flagged
+// PROTO_FLAG_RETRANSMIT, in as many frames as needed, and count them against the client. points is the
+// caller's scratch buffer of WS_BACKFILL_POINTS entries. Returns the frames sent; the frames of the range
+// that have aged out of the history are returned through unavailable.
+static uint32_t resend_range(httpd_handle_t hd, int fd, const ws_subscription_t* sub, uint32_t from, uint32_t to,
+    uint16_t (*points)[ACQ_MAX_CHANNELS], uint32_t* unavailable) {
+    // Frames of the stream on the client's decimation grid
+    uint32_t first = from % sub->decimation ? from + sub->decimation - from % sub->decimation : from;
+    uint32_t wanted = (int32_t) (to - first) > 0 ? (to - first + sub->decimation - 1) / sub->decimation : 0;
+    uint32_t resent = 0;
+
+    bool binary = sub->format == WS_FORMAT_BINARY || sub->format == WS_FORMAT_DELTA;
+    size_t max = binary ? MIN(STREAM_BATCH_LIMIT, WS_BACKFILL_POINTS) : WS_BACKFILL_JSON_POINTS;
+    uint32_t seq = first;
+    history_span_t span;
+    size_t n;
+    while ((n = history_read_recent(seq, to, sub->decimation, points, max, &span)) > 0) {
+        proto_header_t header = {
+            .type = sub->format == WS_FORMAT_DELTA ? PROTO_TYPE_SAMPLES_DELTA : PROTO_TYPE_SAMPLES,
+            .flags = PROTO_FLAG_RETRANSMIT,
+            .seq = span.first_seq,
+        };
+        ws_frame_t* frame = encode_history(sub, "samples", &header, points, n, &span);
+        if (frame == NULL || header.sample_count == 0) {
+            if (frame != NULL) {
+                clients_frame_release(frame);
+            }
+            break;
+        }
+        if (clients_send(hd, fd, frame, header.sample_count) != ESP_OK) {
+            break;
+        }
+        resent += header.sample_count;
+        seq = span.first_seq + header.sample_count * sub->decimation;
+    }
+
+    *unavailable = wanted - MIN(resent, wanted);
+    clients_note_resend(fd, resent, *unavailable);
+    return resent;
+}
+
+// Answer "resend?from=S&to=E": queue the client's frames with sequence numbers in [S, E) again.
+// Frames that have aged out of the history are reported as unavailable.
+static void ws_resend(httpd_req_t *req, int fd, const char* msg) {
+    ws_subscription_t sub;
+    char param[16];
+    char buf[160];
+    const char* query = strchr(msg, '?');
+
+    uint32_t from = 0;
+    uint32_t to = 0;
+    const char* err = NULL;
+    if (clients_get_subscription(fd, &sub) != ESP_OK) {
+        err = "not registered";
+    } else if (sub.decimation == 0) {
+        err = "no sample stream";
+    } else if (query == NULL || httpd_query_key_value(query + 1, "from", param, sizeof(param)) != ESP_OK) {
+        err = "missing from";
+    } else {
+        from = strtoul(param, NULL, 10);
+        to = from + sub.decimation;
+        if (httpd_query_key_value(query + 1, "to", param, sizeof(param)) == ESP_OK) {
+            to = strtoul(param, NULL, 10);
+        }
+        // Nothing beyond what the history can hold, counted from the end of the range
+        if ((int32_t) (to - from) <= 0 || to - from > (uint32_t) HISTORY_RECENT_LEN * sub.decimation) {
+            err = "invalid range";
+        }
+    }
+
+    if (err != NULL) {
+        snprintf(buf, sizeof(buf), "{\"error\": \"%s\"}", err);
+    } else {
+        uint32_t unavailable;
+        uint32_t resent = resend_range(req->handle, fd, &sub, from, to, history_points, &unavailable);
+        snprintf(buf, sizeof(buf), "{\"resend\": {\"from\": %lu, \"to\": %lu, \"resent\": %lu, \"unavailable\": %lu}}",
+            (unsigned long) from, (unsigned long) to, (unsigned long) resent, (unsigned long) unavailable);
+    }
+
+    httpd_ws_frame_t ws_pkt;
+    memset(&ws_pkt, 0, sizeof(httpd_ws_frame_t));
+    ws_pkt.payload = (uint8_t*)buf;
+    ws_pkt.len = strlen(buf);
+    ws_pkt.type = HTTPD_WS_TYPE_TEXT;
+    httpd_ws_send_frame(req, &ws_pkt);
+}
+
+// Decode a "subscribe?channels=0,3&rate=50&format=delta&deadband=5&history=30" (or "unsubscribe") message.
+// Fields left out keep their current value; history defaults to none. Returns an error message, or NULL on success.
+static const char* parse_subscription(const char* msg, ws_subscription_t* sub, uint32_t* history_s) {
+    char param[48];
+    bool rate_given = false;
+
+    *history_s = 0;
+
+    if (strcmp(msg, "unsubscribe") == 0) {
+        sub->decimation = 0;
+        return NULL;
+    }
+
+    const char* query = strchr(msg, '?');
+    if (strncmp(msg, "subscribe", strlen("subscribe")) != 0 || (query == NULL && msg[strlen("subscribe")] != '\0')) {
+        return "unknown message";
+    }
+    if (query == NULL) {
+        query = "";
+    } else {
+        query++;
+    }
+
+    if (httpd_query_key_value(query, "format", param, sizeof(param)) == ESP_OK) {
+        sub->format = clients_parse_format(param);
+        if (sub->format == WS_FORMAT_COUNT) {
+            return "unknown format";
+        }
+    }
+
+    if (httpd_query_key_value(query, "channels", param, sizeof(param)) == ESP_OK) {
+        sub->channel_mask = 0;
+        if (strcmp(param, "all") != 0) {
+            for (char* tok = strtok(param, ","); tok != NULL; tok = strtok(NULL, ",")) {
+                int ch = atoi(tok);
+                if (ch < 0 || ch >= ACQ_ADC_CHANNELS) {
+                    return "invalid channel";
+                }
+                sub->channel_mask |= 1 << ch;
+            }
+        }
+    }
+
+    // Rate in Hz, rounded to a whole decimation of the stream. 0 stops the sample stream.
+    if (httpd_query_key_value(query, "rate", param, sizeof(param)) == ESP_OK) {
+        float rate = atof(param);
+        if (rate < 0) {
+            return "invalid rate";
+        }
+        float decimation = rate > 0 ? 1e6f / STREAM_PERIOD_US / rate : 0;
+        sub->decimation = rate > 0 ? MIN(MAX((int) (decimation + 0.5f), 1), UINT16_MAX) : 0;
+        rate_given = true;
+    }
+    if (httpd_query_key_value(query, "decimation", param, sizeof(param)) == ESP_OK) {
+        int decimation = atoi(param);
+        if (decimation < 0 || decimation > UINT16_MAX) {
+            return "invalid decimation";
+        }
+        sub->decimation = decimation;
+        rate_given = true;
+    }
+    // A subscription without a rate streams at the full rate
+    if (!rate_given && sub->decimation == 0) {
+        sub->decimation = 1;
+    }
+
+    if (httpd_query_key_value(query, "deadband", param, sizeof(param)) == ESP_OK) {
+        int deadband = atoi(param);
+        if (deadband < 0 || deadband > UINT16_MAX) {
+            return "invalid deadband";
+        }
+        sub->deadband_mv = deadband;
+    }
+
+    if (httpd_query_key_value(query, "history", param, sizeof(param)) == ESP_OK) {
+        int history = atoi(param);
+        if (history < 0) {
+            return "invalid history";
+        }
+        *history_s = history;
+    }
+    return NULL;
+}
+
+// Apply a subscription message from a client and reply with the resulting subscription
+static void ws_subscribe(httpd_req_t *req, int fd, const char* msg) {
+    ws_subscription_t sub;
+    bool found = clients_get_subscription(fd, &sub) == ESP_OK;
+
+    char buf[192];
+    uint32_t history_s = 0;
+    const char* err = found ? parse_subscription(msg, &sub, &history_s) : "not registered";
+    if (err == NULL && sub.format == WS_FORMAT_SSE) {
+        err = "unknown format";
+    }
+    if (err == NULL) {
+        // Queued ahead of the first live frame of the new subscription
+        send_backfill(req->handle, fd, &sub, history_s);
+        if (clients_subscribe(fd, &sub) != ESP_OK) {
+            err = "not registered";
+        }
+    }
+
+    if (err != NULL) {
+        snprintf(buf, sizeof(buf), "{\"error\": \"%s\"}", err);
+    } else {
+        float rate = sub.decimation > 0 ? 1e6f / STREAM_PERIOD_US / sub.decimation : 0;
+        snprintf(buf, sizeof(buf),
+            "{\"subscribed\": {\"format\": \"%s\", \"mask\": %u, \"decimation\": %u, \"rate\": %.3f, \"deadband\": %u}}",
+            clients_format_name(sub.format), sub.channel_mask, sub.decimation, rate, sub.deadband_mv);
+        ESP_LOGI(WEB_TAG, "Client %d subscribed: %s", fd, buf);
+    }
+
+    httpd_ws_frame_t ws_pkt;
+    memset(&ws_pkt, 0, sizeof(httpd_ws_frame_t));
+    ws_pkt.payload = (uint8_t*)buf;
+    ws_pkt.len = strlen(buf);
+    ws_pkt.type = HTTPD_WS_TYPE_TEXT;
+    httpd_ws_send_frame(req, &ws_pkt);
+}
+
 esp_err_t ws_handler(httpd_req_t *req) {
     ESP_LOGI(WEB_TAG, "Websocket request received!");
     ESP_LOGI(WEB_TAG, "Data: %s", req->uri);
+
+    int fd = httpd_req_to_sockfd(req);
+
+    // The handshake is the GET request. Negotiate the sample encoding, queue policy and history
+    // backfill from the query string and register the client for fan-out.
+    if (req->method == HTTP_GET) {
+        ws_format_t format = WS_FORMAT_JSON;
+        ws_policy_t policy = WS_POLICY_DROP_OLDEST;
+        uint32_t history_s = CONFIG_WS_BACKFILL_SECONDS;
+        char query[96];
+        char param[16];
+        if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+            if (httpd_query_key_value(query, "format", param, sizeof(param)) == ESP_OK &&
+                clients_parse_format(param) != WS_FORMAT_COUNT && clients_parse_format(param) != WS_FORMAT_SSE) {
+                format = clients_parse_format(param);
+            }
+            if (httpd_query_key_value(query, "policy", param, sizeof(param)) == ESP_OK &&
+                clients_parse_policy(param) != WS_POLICY_COUNT) {
+                policy = clients_parse_policy(param);
+            }
+            if (httpd_query_key_value(query, "history", param, sizeof(param)) == ESP_OK) {
+                history_s = MAX(atoi(param), 0);
+            }
+        }
+
+        // JSON clients start without a sample stream; binary and delta clients start with every
+        // channel at the full stream rate. The stream is held back until the backfill is queued.
+        ws_subscription_t sub = {
+            .format = format,
+            .decimation = format == WS_FORMAT_JSON ? 0 : 1,
+        };
+        ws_subscription_t held = sub;
+        held.decimation = 0;
+        if (clients_add(fd, &held, policy, NULL) != ESP_OK) {
+            return ESP_FAIL;
+        }
+        send_backfill(req->handle, fd, &sub, history_s);
+        clients_subscribe(fd, &sub);
+        ESP_LOGI(WEB_TAG, "Client %d streams %s, %s", fd, clients_format_name(format), clients_policy_name(policy));
+    } else {
+        // Data or control frame. Every frame counts as a sign of life.
+        uint8_t payload[128] = { 0 };
+        httpd_ws_frame_t frame;
+        memset(&frame, 0, sizeof(httpd_ws_frame_t));
+
+        esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+        if (ret != ESP_OK) {
+            return ret;
+        }
+        if (frame.len >= sizeof(payload)) {
+            ESP_LOGW(WEB_TAG, "Client %d sent an oversized frame", fd);
+            return ESP_FAIL;
+        }
+        if (frame.len > 0) {
+            frame.payload = payload;
+            if ((ret = httpd_ws_recv_frame(req, &frame, frame.len)) != ESP_OK) {
+                return ret;
+            }
+        }
+        clients_seen(fd);
+
+        // Control frames are ours to answer since handle_ws_control_frames is set
+        if (frame.type == HTTPD_WS_TYPE_PONG) {
+            return ESP_OK;
+        }
+        if (frame.type == HTTPD_WS_TYPE_PING || frame.type == HTTPD_WS_TYPE_CLOSE) {
+            frame.type = frame.type == HTTPD_WS_TYPE_PING ? HTTPD_WS_TYPE_PONG : HTTPD_WS_TYPE_CLOSE;
+            httpd_ws_send_frame(req, &frame);
+            if (frame.type == HTTPD_WS_TYPE_CLOSE) {
+                httpd_sess_trigger_close(req->handle, fd);
+            }
+            return ESP_OK;
+        }
+
+        // Subscription changes are answered with the resulting subscription
+        if (frame.type == HTTPD_WS_TYPE_TEXT && (strncmp((char*)payload, "subscribe", strlen("subscribe")) == 0 || strcmp((char*)payload, "unsubscribe") == 0)) {
+            ws_subscribe(req, fd, (char*)payload);
+            return ESP_OK;
+        }
+        if (frame.type == HTTPD_WS_TYPE_TEXT && strncmp((char*)payload, "resend?", strlen("resend?")) == 0) {
+            ws_resend(req, fd, (char*)payload);
+            return ESP_OK;
+        }
+    }
    
     // Send back acknowledge
     httpd_ws_frame_t ws_pkt;
@@ -511,68 +1560,148 @@ esp_err_t ws_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+esp_err_t sse_handler(httpd_req_t *req) {
+    static const char headers[] = "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/event-stream\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: close\r\n"
+        "Access-Control-Allow-Origin: *\r\n\r\n"
+        "retry: 2000\n\n";
+
+    // The query takes the fields of a "subscribe?..." message, plus the queue policy
+    char query[128];
+    char msg[sizeof(query) + 16] = "subscribe";
+    char param[16];
+    ws_policy_t policy = WS_POLICY_DROP_OLDEST;
+    bool resume = false;
+    uint32_t last_id = 0;
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK) {
+        snprintf(msg, sizeof(msg), "subscribe?%s", query);
+        if (httpd_query_key_value(query, "policy", param, sizeof(param)) == ESP_OK &&
+            clients_parse_policy(param) != WS_POLICY_COUNT) {
+            policy = clients_parse_policy(param);
+        }
+        // For clients that cannot set headers
+        if (httpd_query_key_value(query, "last_event_id", param, sizeof(param)) == ESP_OK) {
+            last_id = strtoul(param, NULL, 10);
+            resume = true;
+        }
+    }
+
+    // EventSource sends the id of the last event it received when it reconnects
+    size_t id_len = httpd_req_get_hdr_value_len(req, "Last-Event-ID");
+    if (id_len > 0 && id_len < sizeof(param) && httpd_req_get_hdr_value_str(req, "Last-Event-ID", param, sizeof(param)) == ESP_OK) {
+        last_id = strtoul(param, NULL, 10);
+        resume = true;
+    }
+
+    ws_subscription_t sub = { .format = WS_FORMAT_SSE };
+    uint32_t history_s = 0;
+    const char* err = parse_subscription(msg, &sub, &history_s);
+    if (err == NULL && sub.format != WS_FORMAT_SSE) {
+        err = "format must be sse";
+    }
+    if (err == NULL && sub.decimation == 0) {
+        err = "rate must be above 0";
+    }
+    if (err != NULL) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, err);
+        return ESP_OK;
+    }
+    if (strstr(msg, "history=") == NULL) {
+        history_s = CONFIG_WS_BACKFILL_SECONDS;
+    }
+
+    // Keep the request open past this handler. The session then belongs to the client registry,
+    // which writes the events straight to the socket and completes the request on disconnect.
+    httpd_req_t* async_req;
+    if (httpd_req_async_handler_begin(req, &async_req) != ESP_OK) {
+        return ESP_FAIL;
+    }
+    int fd = httpd_req_to_sockfd(async_req);
+
+    // Sends run on this task, so nothing can reach the socket before the headers
+    ws_subscription_t held = sub;
+    held.decimation = 0;
+    if (clients_add(fd, &held, policy, async_req) != ESP_OK) {
+        httpd_req_async_handler_complete(async_req);
+        return ESP_FAIL;
+    }
+    if (httpd_socket_send(req->handle, fd, headers, strlen(headers), 0) != (int) strlen(headers)) {
+        // Complete the request here rather than from the close callback
+        clients_remove(fd);
+        httpd_sess_trigger_close(req->handle, fd);
+        return ESP_OK;
+    }
+
+    // A reconnecting client continues after its last event from the full-rate history, sent by the
+    // stream task ahead of the next live batch. A new one gets the usual averaged backfill.
+    if (resume) {
+        clients_resume(fd, &sub, last_id + 1);
+    } else {
+        send_backfill(req->handle, fd, &sub, history_s);
+        clients_subscribe(fd, &sub);
+    }
+    ESP_LOGI(WEB_TAG, "Client %d streams events, %s%s", fd, clients_policy_name(policy), resume ? ", resuming" : "");
+    return ESP_OK;
+}
+
 // Start the web server
 httpd_handle_t start_webserver(void) {
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
 
-    config.max_uri_handlers = 16;
+    config.max_uri_handlers = 28;
+    config.max_open_sockets = CLIENTS_MAX;
+    config.uri_match_fn = httpd_uri_match_wildcard;
+
+    // WebSocket clients are tracked from the session callbacks and the handshake
+    config.open_fn = clients_on_open;
+    config.close_fn = clients_on_close;
+
+    for (int i = 0; i < ACQ_ADC_CHANNELS; i++) {
+        deadband_init(&deadbands[i], CONFIG_WS_DEADBAND_MV, CONFIG_WS_MAX_SILENCE_MS);
+    }
+
+    assets_init();
+
+    // The page is parsed once. If it fails to compile, / is answered with 404.
+    template_compile(&index_template, "/spiffs/index.html", page_vars, PAGE_VAR_COUNT);
     
     if(httpd_start(&server_handle, &config) == ESP_OK) {
         // Register URI handlers
         httpd_register_uri_handler(server_handle, &uri_get);
         httpd_register_uri_handler(server_handle, &ws_uri);
         httpd_register_uri_handler(server_handle, &uri_version);
-        httpd_register_uri_handler(server_handle, &chart_js_uri);
         httpd_register_uri_handler(server_handle, &toggle_led_uri);
         httpd_register_uri_handler(server_handle, &wifi_config_uri);
         httpd_register_uri_handler(server_handle, &restart_esp_uri);
         httpd_register_uri_handler(server_handle, &get_all_networks_uri);
         httpd_register_uri_handler(server_handle, &wifi_ap_config_uri);
         httpd_register_uri_handler(server_handle, &wifi_ip_config_uri);
+        httpd_register_uri_handler(server_handle, &acquisition_status_uri);
+        httpd_register_uri_handler(server_handle, &channels_uri);
+        httpd_register_uri_handler(server_handle, &channels_config_uri);
+        httpd_register_uri_handler(server_handle, &timing_uri);
+        httpd_register_uri_handler(server_handle, &stats_uri);
+        httpd_register_uri_handler(server_handle, &detector_uri);
+        httpd_register_uri_handler(server_handle, &detector_config_uri);
+        httpd_register_uri_handler(server_handle, &deadband_uri);
+        httpd_register_uri_handler(server_handle, &deadband_config_uri);
+        httpd_register_uri_handler(server_handle, &clients_uri);
+        httpd_register_uri_handler(server_handle, &events_stream_uri);
+        httpd_register_uri_handler(server_handle, &history_api_uri);
+#if CONFIG_UDP_STREAM
+        httpd_register_uri_handler(server_handle, &udp_uri);
+        httpd_register_uri_handler(server_handle, &udp_config_uri);
+#endif
+        httpd_register_uri_handler(server_handle, &static_uri);
+        httpd_register_uri_handler(server_handle, &static_head_uri);
         return server_handle;
     }
 
     return NULL;
 }
 
-char* replace_variable(char* source, char* placeholder, char* replacement) {
-    const char *p = source;
-
-    // If either the placeholder or replacement is NULL, return the source string
-    if(replacement == NULL) {
-        // If replacement is NULL, replace with an empty string
-        replacement = "";
-    }
-
-    int count = 0;
-    int placeholderLen = strlen(placeholder);
-    int replacementLen = strlen(replacement);
-    
-    // Counting the number of times the placeholder occurs in the source
-    while ((p = strstr(p, placeholder))) {
-        p += placeholderLen;
-        count++;
-    }
-    
-    // Allocating memory for the new string
-    int newSize = strlen(source) + count * (replacementLen - placeholderLen) + 1;
-    char *result = malloc(newSize);
-    if (result == NULL) return NULL;
-    
-    char *newStr = result;
-    while (*source) {
-        if (strstr(source, placeholder) == source) {
-            memcpy(newStr, replacement, replacementLen);
-            newStr += replacementLen;
-            source += placeholderLen;
-        } else {
-            *newStr++ = *source++;
-        }
-    }
-    *newStr = '\0';
-    return result;
-}
-
 esp_err_t toggle_led_handler(httpd_req_t *req) {
    // Get query for pin number and state. Toggle the pin based on state (HTTP GET REQUEST)
     char buf[128];
@@ -601,33 +1730,267 @@ esp_err_t toggle_led_handler(httpd_req_t *req) {
     return ESP_FAIL;
 }
 
-// Broadcast a random value every second
+static void publish_timer_callback(void* arg) {
+    xTaskNotifyGive(broadcast_task);
+}
+
+// Broadcast the per-channel average of the decimated samples on every publish timer tick.
+// Channels within their deadband are left out, and a frame with no channel left is not sent.
 void broadcast_adc_values(void* pvParameters) {
+    pipeline_average_t avg;
+    uint32_t update_seq = 0;    // Counts the updates actually published, so a gap means one was lost
+
+    broadcast_task = xTaskGetCurrentTaskHandle();
+    timing_init(&publish_timing, "publish", WS_INTERVAL_MS * 1000);
+
+    // Pace from a periodic hardware timer so the work done per tick doesn't add to the period
+    esp_timer_handle_t publish_timer;
+    esp_timer_create_args_t timer_args = {
+        .callback = publish_timer_callback,
+        .name = "publish",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &publish_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(publish_timer, WS_INTERVAL_MS * 1000));
+
+    while(true) {
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        // More than one pending tick means the previous publish overran its period
+        portENTER_CRITICAL(&publish_timing_lock);
+        timing_record(&publish_timing, esp_timer_get_time());
+        if(ticks > 1) {
+            timing_miss(&publish_timing, ticks - 1);
+        }
+        portEXIT_CRITICAL(&publish_timing_lock);
+
+        if(!pipeline_take_average(&avg)) {
+            continue;
+        }
+
+        bool due[ACQ_MAX_CHANNELS];
+        int due_count = 0;
+        int64_t now = esp_timer_get_time();
+        portENTER_CRITICAL(&deadband_lock);
+        for(int slot = 0; slot < avg.channel_count; slot++) {
+            due[slot] = deadband_check(&deadbands[avg.channels[slot]], avg.mv[slot], now);
+            due_count += due[slot];
+        }
+        if(due_count == 0) {
+            frames_suppressed++;
+        } else {
+            frames_sent++;
+        }
+        portEXIT_CRITICAL(&deadband_lock);
+
+        if(due_count == 0) {
+            continue;
+        }
+
+        // Create a packet with every channel due in JSON format, along with the current
+        // digital state of pin 22. "adc" carries the first channel for existing clients when it is due.
+        if(clients_count(WS_FORMAT_JSON) == 0) {
+            continue;
+        }
+
+        // Build the packet in place in a pooled frame shared by every JSON client
+        ws_frame_t* frame = clients_frame_alloc();
+        if(frame == NULL) {
+            continue;
+        }
+        char* buf = (char*) frame->data;
+        const size_t size = sizeof(frame->data);
+        int len = snprintf(buf, size, "{\"seq\": %lu, \"t\": %lld, \"pin\": %d, ",
+            (unsigned long) update_seq++, (long long) now, gpio_get_level(22));
+        if(due[0]) {
+            len += snprintf(buf + len, size - len, "\"adc\": %d, ", avg.mv[0]);
+        }
+        len += snprintf(buf + len, size - len, "\"channels\": [");
+        bool first = true;
+        for(int slot = 0; slot < avg.channel_count; slot++) {
+            if(!due[slot]) {
+                continue;
+            }
+            len += snprintf(buf + len, size - len, "%s{\"ch\": %d, \"mv\": %d", first ? "" : ",", avg.channels[slot], avg.mv[slot]);
+            first = false;
+#if CONFIG_WS_STATS_IN_FRAME
+            stats_result_t result;
+            if(stats_get(slot, 0, &result)) {
+                len += snprintf(buf + len, size - len, ", \"stats\": ");
+                len += stats_result_to_json(&result, buf + len, size - len, false);
+            }
+#endif
+            len += snprintf(buf + len, size - len, "}");
+        }
+        snprintf(buf + len, size - len, "]}");
+
+        frame->len = strlen(buf);
+        frame->type = HTTPD_WS_TYPE_TEXT;
+
+        // Queue the packet to all JSON clients. Binary and delta clients receive the full stream from stream_samples().
+        clients_publish(server_handle, frame, WS_FORMAT_JSON, 1);
+    }
+}
+
+// Pick one subscription's frames out of a batch and queue them to its clients. The frames are selected
+// and encoded once for every client sharing the subscription.
+static void publish_subscription(const ws_subscription_t* sub, uint16_t (*mv)[ACQ_MAX_CHANNELS], size_t count,
+    const proto_header_t* batch) {
+    static uint16_t picked[STREAM_BATCH_LIMIT][ACQ_MAX_CHANNELS];
+
+    uint8_t slots[ACQ_MAX_CHANNELS];
+    uint16_t mask;
+    uint8_t channel_count = subscription_slots(sub, batch->channel_mask, slots, &mask);
+
+    // Decimate on a grid of sequence numbers so consecutive batches (and retransmits) line up
+    size_t first = (sub->decimation - batch->seq % sub->decimation) % sub->decimation;
+    if (channel_count == 0 || first >= count) {
+        return;
+    }
+
+    uint16_t (*frames)[ACQ_MAX_CHANNELS] = mv + first;
+    size_t n = (count - first + sub->decimation - 1) / sub->decimation;
+    if (sub->decimation > 1 || mask != batch->channel_mask) {
+        for (size_t i = 0; i < n; i++) {
+            for (int slot = 0; slot < channel_count; slot++) {
+                picked[i][slot] = mv[first + i * sub->decimation][slots[slot]];
+            }
+        }
+        frames = picked;
+    }
+
+    proto_header_t header = *batch;
+    header.channel_mask = mask;
+    header.seq = batch->seq + first;
+    header.timestamp_us = batch->timestamp_us + (int64_t) first * STREAM_PERIOD_US;
+
+    if (sub->format == WS_FORMAT_BINARY || sub->format == WS_FORMAT_DELTA) {
+        ws_frame_t* frame = clients_frame_alloc();
+        if (frame == NULL) {
+            return;
+        }
+        header.type = sub->format == WS_FORMAT_DELTA ? PROTO_TYPE_SAMPLES_DELTA : PROTO_TYPE_SAMPLES;
+        header.sample_count = n;
+        frame->type = HTTPD_WS_TYPE_BINARY;
+        frame->len = proto_encode(frame->data, sizeof(frame->data), &header, frames[0], ACQ_MAX_CHANNELS);
+        clients_publish_samples(server_handle, frame, sub, n, frames[n - 1], channel_count);
+        return;
+    }
+
+    // JSON and event streams take several text frames when the batch does not fit in one
+    int64_t period_us = STREAM_PERIOD_US * sub->decimation;
+    for (size_t done = 0; done < n;) {
+        ws_frame_t* frame = clients_frame_alloc();
+        if (frame == NULL) {
+            return;
+        }
+        header.seq = batch->seq + first + done * sub->decimation;
+        header.timestamp_us = batch->timestamp_us + (int64_t) first * STREAM_PERIOD_US + (int64_t) done * period_us;
+        size_t sent = encode_text_samples(frame, sub->format, "samples", &header, period_us,
+            (const uint16_t (*)[ACQ_MAX_CHANNELS]) (frames + done), n - done, channel_count, sub->decimation);
+        if (sent == 0) {
+            clients_frame_release(frame);
+            return;
+        }
+        clients_publish_samples(server_handle, frame, sub, sent, frames[done + sent - 1], channel_count);
+        done += sent;
+    }
+}
+
+// Stream the decimated samples to every client with a sample subscription, packing up to stream_batch
+// frames per WebSocket frame. A partial batch is flushed every CONFIG_WS_BATCH_FLUSH_MS.
+void stream_samples(void* pvParameters) {
+    static uint16_t mv[STREAM_BATCH_LIMIT][ACQ_MAX_CHANNELS];
+    static uint16_t resume_points[WS_BACKFILL_POINTS][ACQ_MAX_CHANNELS];
+    ws_subscription_t subs[CLIENTS_MAX];
+#if CONFIG_WS_BATCH_ADAPTIVE
+    uint32_t keeping_up = 0;
+    uint32_t last_losses = 0;
+#endif
+    int64_t last_flush = esp_timer_get_time();
+
     while(true) {
+        uint32_t batch = stream_batch;
+        bool full = stream_wait(batch, CONFIG_WS_BATCH_FLUSH_MS);
+
+        // Client keep-alive and eviction run at the flush cadence at least
+        clients_tick(server_handle);
 
-        // Get 64 samples from the ADC
-        int adc_reading = 0;
-        for(int i = 0; i < 64; i++) {
-            adc_reading += adc1_get_raw(ADC1_CHANNEL_0);
+        int64_t now = esp_timer_get_time();
+        if(!full && now - last_flush < CONFIG_WS_BATCH_FLUSH_MS * 1000) {
+            continue;
+        }
+        last_flush = now;
+
+        // Queue every full batch, then whatever is left. Each distinct subscription is encoded
+        // once, in place in a pooled buffer shared by all of its clients.
+        while(stream_pending() > 0) {
+            proto_header_t header = {
+                .flags = gpio_get_level(22) ? PROTO_FLAG_PIN : 0,
+            };
+            size_t count = stream_read(mv, batch, &header.channel_mask, &header.timestamp_us, &header.seq);
+
+            // Catch resuming event streams up to this batch before it goes out
+            int fd;
+            uint32_t from;
+            ws_subscription_t sub;
+            while(clients_take_resume(&fd, &from, &sub)) {
+                uint32_t unavailable;
+                resend_range(server_handle, fd, &sub, from, header.seq, resume_points, &unavailable);
+            }
+
+            size_t n_subs = clients_subscriptions(subs);
+            for(size_t i = 0; i < n_subs; i++) {
+                publish_subscription(&subs[i], mv, count, &header);
+            }
         }
-        adc_reading /= 64; 
 
-        int voltage = esp_adc_cal_raw_to_voltage(adc_reading, &adc1_chars);
+#if CONFIG_WS_BATCH_ADAPTIVE
+        // Frames lost to full client queues, an exhausted pool or a full stream queue mean the
+        // send path is falling behind. Fewer, larger frames cut the per-frame overhead.
+        clients_fanout_t fanout;
+        clients_get_fanout(&fanout);
+        uint32_t losses = fanout.dropped + fanout.pool_exhausted + stream_overruns();
+        if(losses != last_losses) {
+            stream_batch = MIN(batch * 2, STREAM_BATCH_LIMIT);
+            keeping_up = 0;
+        } else if(batch > CONFIG_WS_BATCH_SAMPLES && ++keeping_up >= WS_BATCH_SHRINK_FLUSHES) {
+            stream_batch = MAX(batch / 2, CONFIG_WS_BATCH_SAMPLES);
+            keeping_up = 0;
+        }
+        last_losses = losses;
+#endif
+    }
+}
+
+// Push every detected edge to the connected clients as soon as the pipeline reports it.
+// Detection and counting happen in the pipeline, so no client needs to be connected.
+void broadcast_events(void* pvParameters) {
+    event_t event;
+
+    while(true) {
+        if(!events_receive(&event, portMAX_DELAY)) {
+            continue;
+        }
 
-        // Create a packet containing the integer as a string in JSON format with the current
-        // digital state of pin 22
         char buf[128];
-        sprintf(buf, "{\"adc\": %d, \"pin\": %d}", voltage, gpio_get_level(22));
+        snprintf(buf, sizeof(buf), "{\"event\": \"%s\", \"ch\": %d, \"mv\": %d, \"n\": %lu, \"t\": %lld}",
+            event.edge == EVENT_RISING ? "rise" : "fall", event.channel, event.mv,
+            (unsigned long) event.count, (long long) event.timestamp_us);
+
         httpd_ws_frame_t ws_pkt;
         memset(&ws_pkt, 0, sizeof(httpd_ws_frame_t));
         ws_pkt.payload = (uint8_t*)buf;
         ws_pkt.len = strlen(buf);
         ws_pkt.type = HTTPD_WS_TYPE_TEXT;
 
-        // Send the packet to all connected clients
         httpd_ws_send_frame_to_all_clients(&ws_pkt);
 
-        // Wait for 1 second
-        vTaskDelay(WS_INTERVAL_MS / portTICK_PERIOD_MS);
+        // Event streams get the same object as a named event, through the same fan-out
+        ws_frame_t* frame = clients_frame_alloc();
+        if (frame != NULL) {
+            frame->len = snprintf((char*) frame->data, CLIENTS_FRAME_SIZE, "event: edge\ndata: %s\n\n", buf);
+            frame->type = HTTPD_WS_TYPE_TEXT;
+            clients_publish(server_handle, frame, WS_FORMAT_SSE, 0);
+        }
     }
-}
\ No newline at end of file
+}
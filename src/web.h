@@ -9,12 +9,9 @@
 #include "driver/adc.h"
 
 #define WEB_TAG "web"
-#define WS_INTERVAL_MS 1000
+#define WS_INTERVAL_MS CONFIG_WS_INTERVAL_MS
 #define JSON_BUFFER_SIZE 4096
 
-// ADC calibration characteristics for ADC1
-extern esp_adc_cal_characteristics_t adc1_chars;
-
 // URI Handlers
 
 /**
@@ -50,20 +47,112 @@ esp_err_t version_handler(httpd_req_t *req);
 esp_err_t toggle_led_handler(httpd_req_t *req);
 
 /**
- * @brief Serves chart.js file "/chartjs"
+ * @brief Serves any indexed static asset by name, GET and HEAD "/<name>"
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t static_handler(httpd_req_t *req);
+
+/**
+ * @brief Reports sample rate, block size and block counters as JSON "/acquisition"
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t acquisition_status_handler(httpd_req_t *req);
+
+/**
+ * @brief Reads or updates the ADC channel table "/channels"
+ * 
+ * GET returns the table as JSON. POST takes channel, atten and enabled form fields.
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t channels_handler(httpd_req_t *req);
+
+/**
+ * @brief Reports block arrival and publish interval histograms and missed deadlines "/timing"
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t timing_handler(httpd_req_t *req);
+
+/**
+ * @brief Reports sliding-window statistics of every channel "/stats"
+ * 
+ * Optional query: window=1|10|60 (seconds). All windows are returned by default.
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t stats_handler(httpd_req_t *req);
+
+/**
+ * @brief Reads or updates the edge detector of each channel "/detector"
+ * 
+ * GET returns the configuration and edge counters as JSON. POST takes channel, threshold,
+ * hysteresis, debounce (samples) and enabled form fields.
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t detector_handler(httpd_req_t *req);
+
+/**
+ * @brief Reads or updates the report-by-exception deadband of each channel "/deadband"
+ * 
+ * GET returns the configuration with sent, heartbeat and suppressed counters as JSON. POST takes
+ * channel and deadband (mV) form fields, and optionally max_silence (ms).
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t deadband_handler(httpd_req_t *req);
+
+/**
+ * @brief Reports the stream batch size and the frames, samples and bytes sent to each
+ *        WebSocket client, with the achieved rates "/clients"
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t clients_handler(httpd_req_t *req);
+
+/**
+ * @brief Server-sent event stream of JSON samples "/events"
+ *        Query: the fields of a /ws subscribe message (channels, rate, decimation, deadband,
+ *        history) and policy. Reconnecting clients resume after their Last-Event-ID header
+ *        (or last_event_id query) from the full-rate history. Detector edges arrive as
+ *        "edge" events.
+ * 
+ * @param req 
+ * @return esp_err_t 
+ */
+esp_err_t sse_handler(httpd_req_t *req);
+
+/**
+ * @brief Downsampled history of one channel "/api/history"
+ *        Query: channel (default the first one held), from and to (device time in us as in
+ *        "t", or seconds before now when negative; default everything held) and points
+ *        (buckets at most, default 500). Each bucket is [t, min, max, mean] of the averaged
+ *        history points it covers. The response is streamed in chunks.
  * 
  * @param req 
  * @return esp_err_t 
  */
-esp_err_t chart_js_handler(httpd_req_t *req);
+esp_err_t history_api_handler(httpd_req_t *req);
 
 /**
- * @brief Deprecated. Used for sending network configuration page. 
+ * @brief Reports the UDP stream destination and counters "/udp". On POST, sets
+ *        host, port and enabled (URL-encoded form, fields left out are kept).
  * 
  * @param req 
  * @return esp_err_t 
  */
-esp_err_t network_page_handler(httpd_req_t *req);
+esp_err_t udp_handler(httpd_req_t *req);
 
 /**
  * @brief Configure the wifi
@@ -76,8 +165,9 @@ esp_err_t get_all_networks_handler(httpd_req_t *req);
 esp_err_t restart_esp_handler(httpd_req_t *req);
 
 // Util Functions
-char* replace_variable(char* source, char* placeholder, char* replacement);
 void broadcast_adc_values(void* pvParameters);
+void broadcast_events(void* pvParameters);
+void stream_samples(void* pvParameters);
 esp_err_t httpd_ws_send_frame_to_all_clients(httpd_ws_frame_t *ws_pkt);
 httpd_handle_t start_webserver(void);
 esp_err_t wifi_ap_credential_handler(httpd_req_t *req);
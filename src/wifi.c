@@ -19,12 +19,88 @@
 #include "nvs_flash.h"
 #include "string.h"
 #include "lwip/inet.h"
+#include "freertos/FreeRTOS.h"
 
 // Interfaces
 esp_netif_t *sta_netif;
 esp_netif_t *ap_netif;
 
+// Network state served to the web pages, see get_network_state()
+static network_state_t network_state;
+static portMUX_TYPE network_state_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Re-read the driver and interface part of the network state. Called from the Wi-Fi/IP events.
+static void refresh_network_state(void) {
+    network_state_t fresh;
+    wifi_config_t conf;
+    esp_netif_ip_info_t ip_info;
+    uint8_t mac[6];
+
+    memset(&fresh, 0, sizeof(fresh));
+
+    // SSIDs and passwords fill their arrays without a terminator when at full length.
+    // The copies are one byte longer and zeroed.
+    if(esp_wifi_get_config(WIFI_IF_STA, &conf) == ESP_OK) {
+        memcpy(fresh.station_ssid, conf.sta.ssid, MAX_SSID_LEN);
+    }
+    if(esp_wifi_get_config(WIFI_IF_AP, &conf) == ESP_OK) {
+        memcpy(fresh.ap_ssid, conf.ap.ssid, MAX_SSID_LEN);
+        memcpy(fresh.ap_passkey, conf.ap.password, MAX_PASSWORD_LEN);
+    }
+
+    if(esp_netif_get_ip_info(sta_netif, &ip_info) == ESP_OK) {
+        esp_ip4addr_ntoa(&ip_info.ip, fresh.station_ip, sizeof(fresh.station_ip));
+    }
+    if(esp_netif_get_ip_info(ap_netif, &ip_info) == ESP_OK) {
+        esp_ip4addr_ntoa(&ip_info.ip, fresh.ap_ip, sizeof(fresh.ap_ip));
+    }
+
+    if(esp_wifi_get_mac(WIFI_IF_STA, mac) == ESP_OK) {
+        snprintf(fresh.mac_address, sizeof(fresh.mac_address), "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    }
+    fresh.mode = get_mode();
+
+    // The stored IP configuration only changes on load and save
+    portENTER_CRITICAL(&network_state_lock);
+    fresh.ip_mode = network_state.ip_mode;
+    memcpy(fresh.static_ip, network_state.static_ip, sizeof(fresh.static_ip));
+    memcpy(fresh.gateway, network_state.gateway, sizeof(fresh.gateway));
+    memcpy(fresh.netmask, network_state.netmask, sizeof(fresh.netmask));
+    network_state = fresh;
+    portEXIT_CRITICAL(&network_state_lock);
+}
+
+// Update the stored IP configuration part of the network state. NULL fields are not configured.
+static void set_ip_config_state(IPMode mode, const char* ip, const char* gateway, const char* netmask) {
+    char fresh_ip[MAX_IP_CONFIG_LEN];
+    char fresh_gateway[MAX_IP_CONFIG_LEN];
+    char fresh_netmask[MAX_IP_CONFIG_LEN];
+
+    snprintf(fresh_ip, sizeof(fresh_ip), "%s", ip != NULL ? ip : "");
+    snprintf(fresh_gateway, sizeof(fresh_gateway), "%s", gateway != NULL ? gateway : "");
+    snprintf(fresh_netmask, sizeof(fresh_netmask), "%s", netmask != NULL ? netmask : "");
+
+    portENTER_CRITICAL(&network_state_lock);
+    network_state.ip_mode = mode;
+    memcpy(network_state.static_ip, fresh_ip, sizeof(fresh_ip));
+    memcpy(network_state.gateway, fresh_gateway, sizeof(fresh_gateway));
+    memcpy(network_state.netmask, fresh_netmask, sizeof(fresh_netmask));
+    portEXIT_CRITICAL(&network_state_lock);
+}
+
+void get_network_state(network_state_t* state) {
+    portENTER_CRITICAL(&network_state_lock);
+    *state = network_state;
+    portEXIT_CRITICAL(&network_state_lock);
+}
+
 void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data) {
+    // IP events share this handler. Their IDs overlap the Wi-Fi ones, so they only refresh the state.
+    if (event_base == IP_EVENT) {
+        refresh_network_state();
+        return;
+    }
+
     if (event_id == WIFI_EVENT_AP_STACONNECTED) {
         wifi_event_ap_staconnected_t* event = (wifi_event_ap_staconnected_t*) event_data;
         ESP_LOGI(WIFI_TAG, "station "MACSTR" join, AID=%d",
@@ -39,16 +115,13 @@ void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id
     } else if (event_id == WIFI_EVENT_STA_CONNECTED) {
         ESP_LOGI(WIFI_TAG, "Connected to Station Network. Stopping AP Server...");
         // Stop the AP Mode since we're connected to the Station Network
-        ip_config_t* ip_config = fetch_ip_info_from_nvs();
-        if(ip_config->mode == STATIC) {
-            set_ip_configuration(ip_config->ip, ip_config->gateway, ip_config->netmask);
+        network_state_t state;
+        get_network_state(&state);
+        if(state.ip_mode == STATIC) {
+            set_ip_configuration(state.static_ip, state.gateway, state.netmask);
         } else {
             ESP_LOGI(WIFI_TAG, "DHCP Mode. Not setting IP Configuration");
         }
-        free(ip_config->ip);
-        free(ip_config->gateway);
-        free(ip_config->netmask);
-        free(ip_config);
         stop_wifi_ap();
     } else if (event_id == WIFI_EVENT_STA_DISCONNECTED) {
         wifi_event_sta_disconnected_t* event = (wifi_event_sta_disconnected_t*) event_data;
@@ -58,6 +131,9 @@ void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id
             start_wifi_ap();
         }
     }
+
+    // Connection and mode changes all come through here
+    refresh_network_state();
 }
 
 char** get_sta_ap_ip(void) {
@@ -209,6 +285,7 @@ esp_err_t save_ip_info_to_nvs(char* static_ip, char* gateway, char* subnet, uint
     }
 
     nvs_close(nvs_handle);
+    set_ip_config_state(mode, static_ip, gateway, subnet);
     return ESP_OK;
 }
 
@@ -283,55 +360,6 @@ ip_config_t* fetch_ip_info_from_nvs(void) {
     return ip_config;
 }
 
-network_info_t* get_network_info(void) {
-    network_info_t* net_info = (network_info_t*) malloc(sizeof(network_info_t));
-    esp_netif_ip_info_t ip_info;
-    wifi_config_t* sta_conf;
-    wifi_config_t* ap_conf;
-    esp_err_t err;
-
-    sta_conf = (wifi_config_t*) malloc(sizeof(wifi_config_t));
-    ap_conf = (wifi_config_t*) malloc(sizeof(wifi_config_t));
-
-    err = esp_wifi_get_config(WIFI_IF_STA, sta_conf);
-    if(err != ESP_OK) {
-        ESP_LOGI(WIFI_TAG, "Failed to get configuration for station interface");
-    }
-
-    err = esp_wifi_get_config(WIFI_IF_AP, ap_conf);
-    if(err != ESP_OK) {
-        ESP_LOGI(WIFI_TAG, "Failed to get configuration for AP interface");
-    }
-    
-    net_info->station_ip = (char*)malloc(16 * sizeof(char));
-    net_info->ap_ip = (char*)malloc(16 * sizeof(char));
-
-    // Get AP/Station IP Addresses
-    esp_netif_get_ip_info(sta_netif, &ip_info);
-    esp_ip4addr_ntoa(&ip_info.ip, net_info->station_ip, 16);
-    esp_netif_get_ip_info(ap_netif, &ip_info);
-    esp_ip4addr_ntoa(&ip_info.ip, net_info->ap_ip, 16);
-
-    // Get MAC Address
-    net_info->mac_address = get_mac_addr();
-
-    // Get AP Credentials
-    net_info->station_ssid = (char*) malloc(MAX_SSID_LEN * sizeof(char));
-    strcpy(net_info->station_ssid, (char*) sta_conf->sta.ssid);
-    net_info->ap_ssid = (char*) malloc(MAX_SSID_LEN * sizeof(char));
-    strcpy(net_info->ap_ssid, (char*) ap_conf->ap.ssid);
-    net_info->ap_passkey = (char*) malloc(MAX_SSID_LEN * sizeof(char));
-    strcpy(net_info->ap_passkey, (char*) ap_conf->ap.password);
-
-    // Get the network adapter mode
-    net_info->mode = get_mode();
-
-    free(sta_conf);
-    free(ap_conf);
-
-    return net_info;
-}
-
 wifi_mode_t get_wifi_mode(void) {
     // Get the current Wi-Fi mode (STA or AP) from wifi driver
     wifi_mode_t mode;
@@ -540,6 +568,17 @@ void init_wifi() {
         mode = WIFI_MODE_AP;
     }
 
+    // Seed the stored IP configuration before any event can run: STA_CONNECTED applies it from the
+    // network state. It is read here and updated on save only.
+    ip_config_t* ip_config = fetch_ip_info_from_nvs();
+    if(ip_config != NULL) {
+        set_ip_config_state(ip_config->mode, ip_config->ip, ip_config->gateway, ip_config->netmask);
+        free(ip_config->ip);
+        free(ip_config->gateway);
+        free(ip_config->netmask);
+        free(ip_config);
+    }
+
     // Initialize the netif stack
     ESP_LOGI(WIFI_TAG, "Initializing the TCP/IP stack...");
     ESP_ERROR_CHECK(esp_netif_init());
@@ -547,6 +586,7 @@ void init_wifi() {
     // Initializer and register event handler for the default network interface
     // Creates a network interface instance by binding the Wi-Fi driver and TCP/IP stack
     ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL));
     ap_netif = esp_netif_create_default_wifi_ap();
     sta_netif = esp_netif_create_default_wifi_sta();
     
@@ -566,6 +606,8 @@ void init_wifi() {
 
     ESP_ERROR_CHECK(esp_wifi_start());
 
+    refresh_network_state();
+
     free(sta_ssid);
     free(sta_passphrase);
     free(ap_ssid);
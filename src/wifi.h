@@ -9,6 +9,8 @@
 #define WIFI_TAG "wifi"
 #define MAX_SSID_LEN 32
 #define MAX_PASSWORD_LEN 64
+#define MAX_IP_LEN 16               // Dotted IPv4 address
+#define MAX_IP_CONFIG_LEN 32        // Stored IP configuration field, as entered
 
 // Used to store the list of available WiFi networks
 typedef struct {
@@ -16,16 +18,6 @@ typedef struct {
     int size;
 } ssid_list_t;
 
-typedef struct {
-    char* station_ssid;
-    char* ap_ssid;
-    char* station_ip;
-    char* ap_ip;
-    char* mac_address;
-    char* mode;
-    char* ap_passkey;
-} network_info_t;
-
 typedef enum {
     DHCP,
     STATIC
@@ -38,6 +30,22 @@ typedef struct {
     char* netmask;
 } ip_config_t;
 
+// Network state kept in RAM for the web pages. Updated from the Wi-Fi/IP events and
+// when the IP configuration is saved, so reading it needs no driver call, NVS access or allocation.
+typedef struct {
+    char station_ssid[MAX_SSID_LEN + 1];
+    char ap_ssid[MAX_SSID_LEN + 1];
+    char ap_passkey[MAX_PASSWORD_LEN + 1];
+    char station_ip[MAX_IP_LEN];
+    char ap_ip[MAX_IP_LEN];
+    char mac_address[18];
+    const char* mode;           // From get_mode(), NULL before the driver starts
+    IPMode ip_mode;             // Stored station IP configuration
+    char static_ip[MAX_IP_CONFIG_LEN];
+    char gateway[MAX_IP_CONFIG_LEN];
+    char netmask[MAX_IP_CONFIG_LEN];
+} network_state_t;
+
 /**
  * @brief Event handler for WiFi events
  * 
@@ -125,11 +133,11 @@ char** get_sta_ap_ip(void);
 char* get_mode(void);
 
 /**
- * @brief Get the network info object
+ * @brief Copy the cached network state
  * 
- * @return network_info_t* 
+ * @param state - filled with the current state
  */
-network_info_t* get_network_info(void);
+void get_network_state(network_state_t* state);
 
 /**
  * @brief Fetches the station credentials from the Non-Volatile Storage (NVS)
@@ -164,13 +172,6 @@ void start_wifi_ap(void);
  */
 esp_err_t set_ip_configuration(char *ip, char* gateway, char* netmask);
 
-/**
- * @brief Returns info about the current network
- * 
- * @return network_info_t* 
- */
-network_info_t* get_network_info(void);
-
 /**
  * @brief Saves IP configuration to the Non-Volatile Storage (NVS)
  * 
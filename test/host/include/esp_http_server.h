@@ -0,0 +1,52 @@
+#ifndef ESP_HTTP_SERVER_H
+#define ESP_HTTP_SERVER_H
+
+#include <sys/types.h>
+#include "esp_err.h"
+
+// Host stand-in for the request and response side of esp_http_server used by the page templates
+// and the static assets. There is no server: a test fills in the request, receives what is sent
+// through its callbacks and reads the status and headers set from the request.
+
+#define HTTPD_RESP_HDRS_MAX 8
+
+enum http_method {
+    HTTP_DELETE = 0,
+    HTTP_GET = 1,
+    HTTP_HEAD = 2,
+    HTTP_POST = 3,
+};
+
+typedef struct httpd_req {
+    int method;
+    const char* uri;
+    const char* headers;        // Request headers, "Field: value\r\n" each
+    void* user_ctx;
+
+    // Body sent in one piece (httpd_resp_send) or in chunks, a NULL buf ending the chunks
+    esp_err_t (*send)(struct httpd_req* req, const char* buf, ssize_t buf_len);
+    esp_err_t (*send_chunk)(struct httpd_req* req, const char* buf, ssize_t buf_len);
+
+    // Set by the handler. Header values are copied, as they may live on the handler's stack.
+    const char* status;
+    const char* content_type;
+    const char* resp_hdr_field[HTTPD_RESP_HDRS_MAX];
+    char resp_hdr_value[HTTPD_RESP_HDRS_MAX][64];
+    int resp_hdr_count;
+} httpd_req_t;
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t* req, const char* field);
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t* req, const char* field, char* val, size_t val_size);
+
+esp_err_t httpd_resp_set_status(httpd_req_t* req, const char* status);
+esp_err_t httpd_resp_set_type(httpd_req_t* req, const char* type);
+esp_err_t httpd_resp_set_hdr(httpd_req_t* req, const char* field, const char* value);
+esp_err_t httpd_resp_send(httpd_req_t* req, const char* buf, ssize_t buf_len);
+esp_err_t httpd_resp_send_chunk(httpd_req_t* req, const char* buf, ssize_t buf_len);
+
+/**
+ * @brief Host only: a response header set by the handler, NULL if it was not set
+ */
+const char* httpd_resp_get_hdr(httpd_req_t* req, const char* field);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef ESP_TIMER_H
+#define ESP_TIMER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Host stand-in: microseconds of the monotonic clock since the first call
+ */
+int64_t esp_timer_get_time(void);
+
+#endif
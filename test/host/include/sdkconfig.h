@@ -0,0 +1,19 @@
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+// Host build configuration: the Kconfig defaults of src/Kconfig.projbuild and the ESP-IDF
+// options the tested modules read. Keep in step with the Kconfig defaults.
+
+#define CONFIG_FREERTOS_HZ 100
+
+#define CONFIG_ACQ_SAMPLE_RATE_HZ 2000
+#define CONFIG_ACQ_BLOCK_SIZE 128
+#define CONFIG_ACQ_RING_BLOCKS 8
+#define CONFIG_ACQ_MAX_CHANNELS 4
+#define CONFIG_ACQ_DECIMATION_RATIO 16
+
+#define CONFIG_HISTORY_RATE_HZ 10
+#define CONFIG_HISTORY_SECONDS 300
+#define CONFIG_HISTORY_RECENT_SECONDS 8
+
+#endif
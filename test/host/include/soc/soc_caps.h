@@ -0,0 +1,8 @@
+#ifndef SOC_CAPS_H
+#define SOC_CAPS_H
+
+// Host stand-in with the ESP32-S3 values the tested modules use
+
+#define SOC_ADC_MAX_CHANNEL_NUM 10
+
+#endif
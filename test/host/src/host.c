@@ -0,0 +1,459 @@
+/**
+ * @file host.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief pthread-based stand-ins for FreeRTOS, esp_timer and esp_err, and request, response and partition
+ *        stand-ins for the web modules, for running the unit tests natively
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <strings.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_http_server.h"
+#include "esp_partition.h"
+
+// Wait state shared by tasks, semaphores and queues: a mutex and a condition on the monotonic clock
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} host_wait_t;
+
+struct host_task {
+    host_wait_t wait;
+    uint32_t notifications;
+    TaskFunction_t fn;
+    void* arg;
+};
+
+struct host_semaphore {
+    host_wait_t wait;
+    UBaseType_t count;
+    UBaseType_t max_count;
+};
+
+struct host_queue {
+    host_wait_t wait;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t items[];
+};
+
+static __thread struct host_task* current_task = NULL;
+
+static void wait_init(host_wait_t* wait) {
+    pthread_condattr_t attr;
+
+    pthread_mutex_init(&wait->mutex, NULL);
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&wait->cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+static void wait_destroy(host_wait_t* wait) {
+    pthread_cond_destroy(&wait->cond);
+    pthread_mutex_destroy(&wait->mutex);
+}
+
+static struct timespec deadline(TickType_t ticks) {
+    struct timespec ts;
+    uint64_t ns = (uint64_t) ticks * (1000000000ULL / configTICK_RATE_HZ);
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ns += ts.tv_nsec;
+    ts.tv_sec += ns / 1000000000ULL;
+    ts.tv_nsec = ns % 1000000000ULL;
+    return ts;
+}
+
+// Wait on the condition with the mutex held. Returns false once the ticks have passed.
+static bool wait_for(host_wait_t* wait, const struct timespec* until, TickType_t ticks) {
+    if(ticks == portMAX_DELAY) {
+        pthread_cond_wait(&wait->cond, &wait->mutex);
+        return true;
+    }
+    return ticks > 0 && pthread_cond_timedwait(&wait->cond, &wait->mutex, until) != ETIMEDOUT;
+}
+
+static struct timespec clock_start;
+
+static void start_clock(void) {
+    clock_gettime(CLOCK_MONOTONIC, &clock_start);
+}
+
+int64_t esp_timer_get_time(void) {
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    struct timespec now;
+
+    pthread_once(&once, start_clock);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - clock_start.tv_sec) * 1000000LL + (now.tv_nsec - clock_start.tv_nsec) / 1000;
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch(code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED: return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+void esp_error_check_failed(esp_err_t rc, const char* file, int line, const char* expression) {
+    fprintf(stderr, "ESP_ERROR_CHECK failed: %s (0x%x) at %s:%d: %s\n", esp_err_to_name(rc), rc, file, line, expression);
+    abort();
+}
+
+void vPortEnterCritical(portMUX_TYPE* mux) {
+    pthread_mutex_lock(&mux->mutex);
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+    pthread_mutex_unlock(&mux->mutex);
+}
+
+static struct host_task* task_new(TaskFunction_t fn, void* arg) {
+    struct host_task* task = calloc(1, sizeof(struct host_task));
+    if(task != NULL) {
+        wait_init(&task->wait);
+        task->fn = fn;
+        task->arg = arg;
+    }
+    return task;
+}
+
+static void* task_entry(void* arg) {
+    current_task = arg;
+    current_task->fn(current_task->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg,
+    UBaseType_t priority, TaskHandle_t* handle, BaseType_t core) {
+    pthread_t thread;
+    struct host_task* task = task_new(fn, arg);
+
+    if(task == NULL || pthread_create(&thread, NULL, task_entry, task) != 0) {
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+
+    if(handle != NULL) {
+        *handle = task;
+    }
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char* name, uint32_t stack_depth, void* arg, UBaseType_t priority,
+    TaskHandle_t* handle) {
+    return xTaskCreatePinnedToCore(fn, name, stack_depth, arg, priority, handle, 0);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if(task != NULL && task != current_task) {
+        fprintf(stderr, "vTaskDelete: only the calling task can be deleted on the host\n");
+        abort();
+    }
+
+    // Handles may still be notified, so the task state is never freed
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if(ticks == 0) {
+        sched_yield();
+        return;
+    }
+
+    struct timespec until = deadline(ticks);
+    while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR) {
+    }
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t) (esp_timer_get_time() * configTICK_RATE_HZ / 1000000);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    // The main thread and other foreign threads get their state on first use
+    if(current_task == NULL) {
+        current_task = task_new(NULL, NULL);
+    }
+    return current_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    pthread_mutex_lock(&task->wait.mutex);
+    task->notifications++;
+    pthread_cond_broadcast(&task->wait.cond);
+    pthread_mutex_unlock(&task->wait.mutex);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+    struct host_task* task = xTaskGetCurrentTaskHandle();
+    struct timespec until = deadline(ticks == portMAX_DELAY ? 0 : ticks);
+    uint32_t value;
+
+    pthread_mutex_lock(&task->wait.mutex);
+    while(task->notifications == 0 && wait_for(&task->wait, &until, ticks)) {
+    }
+    value = task->notifications;
+    if(value > 0) {
+        task->notifications = clear_on_exit ? 0 : value - 1;
+    }
+    pthread_mutex_unlock(&task->wait.mutex);
+    return value;
+}
+
+static SemaphoreHandle_t semaphore_new(UBaseType_t max_count, UBaseType_t initial_count) {
+    struct host_semaphore* sem = calloc(1, sizeof(struct host_semaphore));
+    if(sem != NULL) {
+        wait_init(&sem->wait);
+        sem->count = initial_count;
+        sem->max_count = max_count;
+    }
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return semaphore_new(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return semaphore_new(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max_count, UBaseType_t initial_count) {
+    return semaphore_new(max_count, initial_count);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks) {
+    struct timespec until = deadline(ticks == portMAX_DELAY ? 0 : ticks);
+    BaseType_t taken;
+
+    pthread_mutex_lock(&sem->wait.mutex);
+    while(sem->count == 0 && wait_for(&sem->wait, &until, ticks)) {
+    }
+    taken = sem->count > 0;
+    sem->count -= taken;
+    pthread_mutex_unlock(&sem->wait.mutex);
+    return taken ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    BaseType_t given;
+
+    pthread_mutex_lock(&sem->wait.mutex);
+    given = sem->count < sem->max_count;
+    sem->count += given;
+    pthread_cond_broadcast(&sem->wait.cond);
+    pthread_mutex_unlock(&sem->wait.mutex);
+    return given ? pdTRUE : pdFALSE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) {
+    wait_destroy(&sem->wait);
+    free(sem);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    struct host_queue* queue = calloc(1, sizeof(struct host_queue) + (size_t) length * item_size);
+    if(queue != NULL) {
+        wait_init(&queue->wait);
+        queue->length = length;
+        queue->item_size = item_size;
+    }
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+    struct timespec until = deadline(ticks == portMAX_DELAY ? 0 : ticks);
+    BaseType_t sent;
+
+    pthread_mutex_lock(&queue->wait.mutex);
+    while(queue->count == queue->length && wait_for(&queue->wait, &until, ticks)) {
+    }
+    sent = queue->count < queue->length;
+    if(sent) {
+        UBaseType_t tail = (queue->head + queue->count) % queue->length;
+        memcpy(&queue->items[tail * queue->item_size], item, queue->item_size);
+        queue->count++;
+        pthread_cond_broadcast(&queue->wait.cond);
+    }
+    pthread_mutex_unlock(&queue->wait.mutex);
+    return sent ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+    struct timespec until = deadline(ticks == portMAX_DELAY ? 0 : ticks);
+    BaseType_t received;
+
+    pthread_mutex_lock(&queue->wait.mutex);
+    while(queue->count == 0 && wait_for(&queue->wait, &until, ticks)) {
+    }
+    received = queue->count > 0;
+    if(received) {
+        memcpy(item, &queue->items[queue->head * queue->item_size], queue->item_size);
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->wait.cond);
+    }
+    pthread_mutex_unlock(&queue->wait.mutex);
+    return received ? pdTRUE : pdFALSE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    UBaseType_t count;
+
+    pthread_mutex_lock(&queue->wait.mutex);
+    count = queue->count;
+    pthread_mutex_unlock(&queue->wait.mutex);
+    return count;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    wait_destroy(&queue->wait);
+    free(queue);
+}
+
+// Value of a request header: its start and length, NULL if the request does not have it
+static const char* find_header(httpd_req_t* req, const char* field, size_t* len) {
+    size_t field_len = strlen(field);
+
+    for(const char* line = req->headers; line != NULL && *line != '\0';) {
+        const char* end = strstr(line, "\r\n");
+        if(end == NULL) {
+            end = line + strlen(line);
+        }
+        if(strncasecmp(line, field, field_len) == 0 && line[field_len] == ':') {
+            const char* value = line + field_len + 1;
+            while(*value == ' ') {
+                value++;
+            }
+            *len = end - value;
+            return value;
+        }
+        line = *end != '\0' ? end + 2 : end;
+    }
+    return NULL;
+}
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t* req, const char* field) {
+    size_t len = 0;
+    return find_header(req, field, &len) != NULL ? len : 0;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t* req, const char* field, char* val, size_t val_size) {
+    size_t len = 0;
+    const char* value = find_header(req, field, &len);
+    if(value == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    // Truncated to the buffer like the real one
+    size_t n = len < val_size - 1 ? len : val_size - 1;
+    memcpy(val, value, n);
+    val[n] = '\0';
+    return n == len ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t* req, const char* status) {
+    req->status = status;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t* req, const char* type) {
+    req->content_type = type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t* req, const char* field, const char* value) {
+    if(req->resp_hdr_count == HTTPD_RESP_HDRS_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+    req->resp_hdr_field[req->resp_hdr_count] = field;
+    strncpy(req->resp_hdr_value[req->resp_hdr_count], value, sizeof(req->resp_hdr_value[0]) - 1);
+    req->resp_hdr_count++;
+    return ESP_OK;
+}
+
+const char* httpd_resp_get_hdr(httpd_req_t* req, const char* field) {
+    for(int i = 0; i < req->resp_hdr_count; i++) {
+        if(strcasecmp(req->resp_hdr_field[i], field) == 0) {
+            return req->resp_hdr_value[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t* req, const char* buf, ssize_t buf_len) {
+    return req->send != NULL ? req->send(req, buf, buf_len) : ESP_FAIL;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t* req, const char* buf, ssize_t buf_len) {
+    return req->send_chunk != NULL ? req->send_chunk(req, buf, buf_len) : ESP_FAIL;
+}
+
+static esp_partition_t partition;
+static const void* partition_data = NULL;
+
+void host_partition_set(const char* label, esp_partition_subtype_t subtype, const void* data, size_t size) {
+    memset(&partition, 0, sizeof(partition));
+    partition.type = ESP_PARTITION_TYPE_DATA;
+    partition.subtype = subtype;
+    partition.size = size;
+    strncpy(partition.label, label, sizeof(partition.label) - 1);
+    partition_data = data;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label) {
+    if(partition_data == NULL || type != partition.type || subtype != partition.subtype
+       || (label != NULL && strcmp(label, partition.label) != 0)) {
+        return NULL;
+    }
+    return &partition;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* part, size_t offset, size_t size, esp_partition_mmap_memory_t memory,
+    const void** out_ptr, esp_partition_mmap_handle_t* out_handle) {
+    if(part != &partition || partition_data == NULL || offset > part->size || size > part->size - offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *out_ptr = (const uint8_t*) partition_data + offset;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t handle) {
+}
+
+void app_main(void);
+
+// Each test defines app_main(), as it does on the board
+int main(void) {
+    app_main();
+    return 0;
+}
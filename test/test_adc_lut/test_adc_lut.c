@@ -0,0 +1,146 @@
+/**
+ * @file test_adc_lut.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity tests of the calibration tables against the calibration driver, with a block conversion benchmark
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_adc_cal.h"
+#include "esp_timer.h"
+#include "adc_lut.h"
+
+#define BENCH_MAX_BLOCK 1024
+#define BENCH_ROUNDS 20
+
+static const adc_atten_t attens[] = { ADC_ATTEN_DB_0, ADC_ATTEN_DB_2_5, ADC_ATTEN_DB_6, ADC_ATTEN_DB_11 };
+
+static uint16_t raw[BENCH_MAX_BLOCK];
+static uint16_t mv[BENCH_MAX_BLOCK];
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static void test_tables_match_calibration(void) {
+    esp_adc_cal_characteristics_t chars;
+
+    for(size_t a = 0; a < sizeof(attens) / sizeof(attens[0]); a++) {
+        const uint16_t* lut = adc_lut_get(attens[a]);
+        TEST_ASSERT_NOT_NULL(lut);
+        TEST_ASSERT_EQUAL_PTR(lut, adc_lut_get(attens[a]));
+
+        esp_adc_cal_characterize(ADC_UNIT_1, attens[a], ADC_WIDTH_BIT_DEFAULT, 0, &chars);
+        for(uint32_t code = 0; code < ADC_LUT_SIZE; code++) {
+            TEST_ASSERT_EQUAL_UINT16(esp_adc_cal_raw_to_voltage(code, &chars), lut[code]);
+        }
+    }
+}
+
+static void test_unknown_attenuation(void) {
+    TEST_ASSERT_NULL(adc_lut_get((adc_atten_t) (ADC_ATTEN_DB_11 + 1)));
+}
+
+static void test_convert_block_with_stride(void) {
+    const uint16_t* lut = adc_lut_get(ADC_ATTEN_DB_11);
+    uint16_t frames[64][2];
+    uint16_t out[64][2];
+
+    for(int i = 0; i < 64; i++) {
+        frames[i][0] = i * 64;
+        frames[i][1] = 4095 - i;
+        out[i][1] = 0xBEEF;
+    }
+
+    // Only the first slot of each frame is converted
+    adc_lut_convert(lut, &frames[0][0], &out[0][0], 64, 2);
+    for(int i = 0; i < 64; i++) {
+        TEST_ASSERT_EQUAL_UINT16(lut[frames[i][0]], out[i][0]);
+        TEST_ASSERT_EQUAL_UINT16(0xBEEF, out[i][1]);
+    }
+}
+
+static void test_find_is_the_inverse(void) {
+    const uint16_t* lut = adc_lut_get(ADC_ATTEN_DB_11);
+
+    TEST_ASSERT_EQUAL_UINT16(0, adc_lut_find(lut, 0));
+    TEST_ASSERT_EQUAL_UINT16(0, adc_lut_find(lut, lut[0]));
+    TEST_ASSERT_EQUAL_UINT16(ADC_LUT_SIZE, adc_lut_find(lut, lut[ADC_LUT_SIZE - 1] + 1));
+
+    for(uint32_t code = 1; code < ADC_LUT_SIZE; code++) {
+        uint16_t found = adc_lut_find(lut, lut[code]);
+        TEST_ASSERT_TRUE(found <= code);
+        TEST_ASSERT_EQUAL_UINT16(lut[code], lut[found]);
+        TEST_ASSERT_TRUE(found == 0 || lut[found - 1] < lut[code]);
+    }
+}
+
+static void test_interpolation_between_codes(void) {
+    const uint16_t* lut = adc_lut_get(ADC_ATTEN_DB_11);
+
+    for(uint32_t code = 0; code < ADC_LUT_SIZE - 1; code++) {
+        uint16_t lo = lut[code];
+        uint16_t hi = lut[code + 1];
+        TEST_ASSERT_EQUAL_UINT16(lo, adc_lut_interp_q4(lut, code << 4));
+        uint16_t mid = adc_lut_interp_q4(lut, code << 4 | 8);
+        TEST_ASSERT_TRUE(mid >= lo && mid <= hi);
+    }
+
+    // The top code has no neighbour to interpolate towards
+    TEST_ASSERT_EQUAL_UINT16(lut[ADC_LUT_SIZE - 1], adc_lut_interp_q4(lut, (ADC_LUT_SIZE - 1) << 4 | 0xF));
+}
+
+// Per-block cost of the table against one calibration call per sample
+static void test_benchmark_block_conversion(void) {
+    const size_t blocks[] = { 32, 128, 512, BENCH_MAX_BLOCK };
+    const uint16_t* lut = adc_lut_get(ADC_ATTEN_DB_11);
+    esp_adc_cal_characteristics_t chars;
+    char msg[96];
+
+    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_DEFAULT, 0, &chars);
+    for(size_t i = 0; i < BENCH_MAX_BLOCK; i++) {
+        raw[i] = (i * 37) % ADC_LUT_SIZE;
+    }
+
+    for(size_t b = 0; b < sizeof(blocks) / sizeof(blocks[0]); b++) {
+        size_t n = blocks[b];
+
+        int64_t start = esp_timer_get_time();
+        for(int r = 0; r < BENCH_ROUNDS; r++) {
+            adc_lut_convert(lut, raw, mv, n, 1);
+        }
+        int64_t lut_us = esp_timer_get_time() - start;
+
+        start = esp_timer_get_time();
+        for(int r = 0; r < BENCH_ROUNDS; r++) {
+            for(size_t i = 0; i < n; i++) {
+                mv[i] = esp_adc_cal_raw_to_voltage(raw[i], &chars);
+            }
+        }
+        int64_t cal_us = esp_timer_get_time() - start;
+
+        snprintf(msg, sizeof(msg), "block %4u: table %5.1f us, calibration call %6.1f us per block", (unsigned) n,
+            (double) lut_us / BENCH_ROUNDS, (double) cal_us / BENCH_ROUNDS);
+        TEST_MESSAGE(msg);
+        TEST_ASSERT_TRUE(lut_us <= cal_us);
+    }
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_tables_match_calibration);
+    RUN_TEST(test_unknown_attenuation);
+    RUN_TEST(test_convert_block_with_stride);
+    RUN_TEST(test_find_is_the_inverse);
+    RUN_TEST(test_interpolation_between_codes);
+    RUN_TEST(test_benchmark_block_conversion);
+    UNITY_END();
+}
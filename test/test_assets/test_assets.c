@@ -0,0 +1,322 @@
+/**
+ * @file test_assets.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity tests of the static assets from the packed image and the SPIFFS fallback, with a benchmark of
+ *        serving chart.js from mapped flash against the file path
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "assets.h"
+#include "content_types.h"
+
+// Run from the project directory, like the build scripts
+#define DATA_DIR "data"
+#define IMAGE_FILE ASSETS_BASE_PATH ".bin"
+#define SCRATCH_DIR ASSETS_BASE_PATH "_data"
+#define PARTITION_SIZE (512 * 1024)     // As in partitions.csv
+#define BODY_SIZE (256 * 1024)
+#define BENCH_ROUNDS 200
+
+// What was sent
+typedef struct {
+    size_t len;                 // Body bytes, or the Content-Length of a HEAD response
+    size_t sends;               // httpd_resp_send() and httpd_resp_send_chunk() calls with data
+    bool chunked;
+    bool finished;
+    bool capture;
+    uint8_t body[BODY_SIZE];
+} response_t;
+
+static response_t response;
+static httpd_req_t req;
+static uint8_t image[PARTITION_SIZE];
+static uint8_t chart_js[BODY_SIZE];
+static size_t chart_js_len;
+
+static esp_err_t send(httpd_req_t* r, const char* buf, ssize_t buf_len) {
+    TEST_ASSERT_FALSE(response.finished);
+    TEST_ASSERT_TRUE((size_t) buf_len <= sizeof(response.body));
+    if(buf != NULL && response.capture) {
+        memcpy(response.body, buf, buf_len);
+    }
+    response.len = buf_len;
+    response.sends += buf != NULL && buf_len > 0;
+    response.finished = true;
+    return ESP_OK;
+}
+
+static esp_err_t send_chunk(httpd_req_t* r, const char* buf, ssize_t buf_len) {
+    TEST_ASSERT_FALSE(response.finished);
+    response.chunked = true;
+    if(buf == NULL) {
+        response.finished = true;
+        return ESP_OK;
+    }
+    TEST_ASSERT_TRUE(response.len + buf_len <= sizeof(response.body));
+    if(response.capture) {
+        memcpy(response.body + response.len, buf, buf_len);
+    }
+    response.len += buf_len;
+    response.sends++;
+    return ESP_OK;
+}
+
+// Answer a GET (or HEAD) for name with the given request headers
+static esp_err_t get(int method, const char* name, const char* headers) {
+    bool capture = response.capture;
+
+    memset(&response, 0, sizeof(response));
+    response.capture = capture;
+    memset(&req, 0, sizeof(req));
+    req.method = method;
+    req.headers = headers;
+    req.send = send;
+    req.send_chunk = send_chunk;
+    return assets_send(&req, name, NULL);
+}
+
+static size_t read_file(const char* path, uint8_t* buf, size_t size) {
+    FILE* f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, path);
+    size_t n = fread(buf, 1, size, f);
+    TEST_ASSERT_TRUE(feof(f));
+    fclose(f);
+    return n;
+}
+
+// The image the build would flash from data_dir, in a partition otherwise erased
+static void use_image_from(const char* data_dir) {
+    char cmd[160];
+
+    memset(image, 0xff, sizeof(image));
+    snprintf(cmd, sizeof(cmd), "python3 tools/pack_assets.py %s " IMAGE_FILE " > /dev/null", data_dir);
+    TEST_ASSERT_EQUAL(0, system(cmd));
+    read_file(IMAGE_FILE, image, sizeof(image));
+    host_partition_set(ASSETS_PARTITION_LABEL, ASSETS_PARTITION_SUBTYPE, image, sizeof(image));
+    TEST_ASSERT_EQUAL(ESP_OK, assets_init());
+}
+
+static void use_image(void) {
+    use_image_from(DATA_DIR);
+}
+
+// An erased partition, with the assets, their gzip copies and the manifest on the file system
+static void use_spiffs(void) {
+    memset(image, 0xff, sizeof(image));
+    TEST_ASSERT_EQUAL(0, system("mkdir -p " ASSETS_BASE_PATH " && rm -f " ASSETS_BASE_PATH "/*"
+        " && cp " DATA_DIR "/chart.js " ASSETS_BASE_PATH
+        " && python3 tools/compress_assets.py " ASSETS_BASE_PATH " > /dev/null"));
+    host_partition_set(ASSETS_PARTITION_LABEL, ASSETS_PARTITION_SUBTYPE, image, sizeof(image));
+    TEST_ASSERT_EQUAL(ESP_OK, assets_init());
+}
+
+void setUp(void) {
+    response.capture = true;
+    chart_js_len = read_file(DATA_DIR "/chart.js", chart_js, sizeof(chart_js));
+}
+
+void tearDown(void) {
+}
+
+static void test_image_sent_in_one_piece(void) {
+    use_image();
+    const asset_t* asset = assets_find("chart.js");
+    TEST_ASSERT_NOT_NULL(asset);
+    TEST_ASSERT_NOT_NULL(asset->data);
+
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", ""));
+    TEST_ASSERT_FALSE(response.chunked);
+    TEST_ASSERT_EQUAL(1, response.sends);
+    TEST_ASSERT_EQUAL(chart_js_len, response.len);
+    TEST_ASSERT_EQUAL_MEMORY(chart_js, response.body, chart_js_len);
+    TEST_ASSERT_EQUAL_STRING("application/javascript", req.content_type);
+    TEST_ASSERT_NULL(httpd_resp_get_hdr(&req, "Content-Encoding"));
+
+    char etag[ASSETS_HASH_LEN + 8];
+    snprintf(etag, sizeof(etag), "\"%s\"", asset->hash);
+    TEST_ASSERT_EQUAL_STRING(etag, httpd_resp_get_hdr(&req, "ETag"));
+
+    // The gzip copy, with its own validator
+    TEST_ASSERT_TRUE(asset->gzip);
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", "Accept-Encoding: gzip, deflate\r\n"));
+    TEST_ASSERT_EQUAL(asset->gz_len, response.len);
+    TEST_ASSERT_EQUAL_MEMORY(asset->gz_data, response.body, asset->gz_len);
+    TEST_ASSERT_EQUAL_STRING("gzip", httpd_resp_get_hdr(&req, "Content-Encoding"));
+    snprintf(etag, sizeof(etag), "\"%s-gz\"", asset->hash);
+    TEST_ASSERT_EQUAL_STRING(etag, httpd_resp_get_hdr(&req, "ETag"));
+
+    // HEAD gives the length without the body
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_HEAD, "chart.js", ""));
+    TEST_ASSERT_EQUAL(0, response.sends);
+    TEST_ASSERT_EQUAL(chart_js_len, response.len);
+}
+
+static void test_validators_and_ranges(void) {
+    char headers[128];
+
+    use_image();
+    const asset_t* asset = assets_find("chart.js");
+
+    snprintf(headers, sizeof(headers), "If-None-Match: \"%s\"\r\n", asset->hash);
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", headers));
+    TEST_ASSERT_EQUAL_STRING("304 Not Modified", req.status);
+    TEST_ASSERT_EQUAL(0, response.len);
+
+    // The identity validator does not match the gzip copy
+    snprintf(headers, sizeof(headers), "Accept-Encoding: gzip\r\nIf-None-Match: \"%s\"\r\n", asset->hash);
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", headers));
+    TEST_ASSERT_NULL(req.status);
+    TEST_ASSERT_EQUAL(asset->gz_len, response.len);
+
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", "Range: bytes=100-199\r\n"));
+    TEST_ASSERT_EQUAL_STRING("206 Partial Content", req.status);
+    TEST_ASSERT_EQUAL(100, response.len);
+    TEST_ASSERT_EQUAL_MEMORY(chart_js + 100, response.body, 100);
+
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", "Range: bytes=-10\r\n"));
+    TEST_ASSERT_EQUAL(10, response.len);
+    TEST_ASSERT_EQUAL_MEMORY(chart_js + chart_js_len - 10, response.body, 10);
+
+    snprintf(headers, sizeof(headers), "Range: bytes=%zu-\r\n", chart_js_len);
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", headers));
+    TEST_ASSERT_EQUAL_STRING("416 Range Not Satisfiable", req.status);
+
+    // A stale If-Range gets the whole asset
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", "Range: bytes=100-199\r\nIf-Range: \"0000000000000000\"\r\n"));
+    TEST_ASSERT_NULL(req.status);
+    TEST_ASSERT_EQUAL(chart_js_len, response.len);
+}
+
+static void test_spiffs_fallback(void) {
+    use_spiffs();
+    const asset_t* asset = assets_find("chart.js");
+    TEST_ASSERT_NOT_NULL(asset);
+    TEST_ASSERT_NULL(asset->data);
+    TEST_ASSERT_TRUE(asset->gzip);
+
+    // Read through the send buffer in chunks, with the same validator as from the image
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", ""));
+    TEST_ASSERT_TRUE(response.chunked);
+    TEST_ASSERT_EQUAL(chart_js_len, response.len);
+    TEST_ASSERT_EQUAL_MEMORY(chart_js, response.body, chart_js_len);
+    TEST_ASSERT_EQUAL_STRING("application/javascript", req.content_type);
+
+    char hash[ASSETS_HASH_LEN + 1];
+    strcpy(hash, asset->hash);
+    use_image();
+    TEST_ASSERT_EQUAL_STRING(hash, assets_find("chart.js")->hash);
+}
+
+static void test_pages_and_missing_files_not_listed(void) {
+    use_image();
+    TEST_ASSERT_NULL(assets_find("index.html"));
+    TEST_ASSERT_NULL(assets_find("missing.js"));
+
+    // Without an image or a manifest nothing is listed
+    host_partition_set(ASSETS_PARTITION_LABEL, ASSETS_PARTITION_SUBTYPE, NULL, 0);
+    TEST_ASSERT_EQUAL(0, system("rm -rf " ASSETS_BASE_PATH));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, assets_init());
+    TEST_ASSERT_NULL(assets_find("chart.js"));
+}
+
+static void test_content_types(void) {
+    TEST_ASSERT_EQUAL_STRING("application/javascript", content_type_for("chart.js"));
+    TEST_ASSERT_EQUAL_STRING("image/png", content_type_for("logo.png"));
+    TEST_ASSERT_EQUAL_STRING("font/woff2", content_type_for("a.b.woff2"));
+    TEST_ASSERT_NULL(content_type_for("index.html"));
+    TEST_ASSERT_NULL(content_type_for("js"));
+    TEST_ASSERT_TRUE(content_type_compressible("chart.js"));
+    TEST_ASSERT_FALSE(content_type_compressible("logo.png"));
+    TEST_ASSERT_FALSE(content_type_compressible("index.html"));
+
+    // The scripts index an image with the type from the same table, without a gzip copy
+    TEST_ASSERT_EQUAL(0, system("rm -rf " SCRATCH_DIR " && mkdir -p " SCRATCH_DIR
+        " && cp " DATA_DIR "/chart.js " SCRATCH_DIR " && head -c 2000 /dev/zero > " SCRATCH_DIR "/logo.png"));
+    use_image_from(SCRATCH_DIR);
+    const asset_t* asset = assets_find("logo.png");
+    TEST_ASSERT_NOT_NULL(asset);
+    TEST_ASSERT_FALSE(asset->gzip);
+    TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "logo.png", "Accept-Encoding: gzip\r\n"));
+    TEST_ASSERT_EQUAL(2000, response.len);
+    TEST_ASSERT_EQUAL_STRING("image/png", req.content_type);
+    TEST_ASSERT_NULL(httpd_resp_get_hdr(&req, "Content-Encoding"));
+
+    TEST_ASSERT_EQUAL(0, system("python3 tools/compress_assets.py " SCRATCH_DIR " > /dev/null"));
+    struct stat st;
+    TEST_ASSERT_EQUAL(0, stat(SCRATCH_DIR "/chart.js.gz", &st));
+    TEST_ASSERT_NOT_EQUAL(0, stat(SCRATCH_DIR "/logo.png.gz", &st));
+}
+
+static void test_too_many_assets_fail_the_build(void) {
+    char cmd[160];
+
+    TEST_ASSERT_EQUAL(0, system("rm -rf " SCRATCH_DIR " && mkdir -p " SCRATCH_DIR));
+    for(int i = 0; i <= ASSETS_MAX; i++) {
+        snprintf(cmd, sizeof(cmd), "echo %d > " SCRATCH_DIR "/%d.txt", i, i);
+        TEST_ASSERT_EQUAL(0, system(cmd));
+    }
+    TEST_ASSERT_NOT_EQUAL(0, system("python3 tools/pack_assets.py " SCRATCH_DIR " " IMAGE_FILE " 2> /dev/null"));
+    TEST_ASSERT_NOT_EQUAL(0, system("python3 tools/compress_assets.py " SCRATCH_DIR " 2> /dev/null"));
+
+    // One less is accepted
+    TEST_ASSERT_EQUAL(0, system("rm " SCRATCH_DIR "/0.txt"));
+    use_image_from(SCRATCH_DIR);
+    TEST_ASSERT_NOT_NULL(assets_find("1.txt"));
+    TEST_ASSERT_NOT_NULL(assets_find("16.txt"));
+    TEST_ASSERT_EQUAL(0, system("rm -rf " SCRATCH_DIR));
+}
+
+// Handler time and sends per request for chart.js from mapped flash and through the file path. On the
+// host the file comes from the page cache and sends are counted, not made, so this is the handler's
+// own cost; flash and SPIFFS read speeds and the network are not part of it.
+static void test_benchmark_chart_js(void) {
+    const char* const accept[] = { "", "Accept-Encoding: gzip\r\n" };
+    char msg[160];
+
+    response.capture = false;
+    for(int spiffs = 0; spiffs < 2; spiffs++) {
+        if(spiffs) {
+            use_spiffs();
+        } else {
+            use_image();
+        }
+
+        for(int gz = 0; gz < 2; gz++) {
+            int64_t start = esp_timer_get_time();
+            for(int r = 0; r < BENCH_ROUNDS; r++) {
+                TEST_ASSERT_EQUAL(ESP_OK, get(HTTP_GET, "chart.js", accept[gz]));
+            }
+            double request_us = (double) (esp_timer_get_time() - start) / BENCH_ROUNDS;
+
+            snprintf(msg, sizeof(msg), "%s, %s: %zu B in %zu sends, %.1f us per request, %.0f requests/s",
+                spiffs ? "spiffs" : "flash", gz ? "gzip" : "identity", response.len, response.sends, request_us,
+                1e6 / request_us);
+            TEST_MESSAGE(msg);
+            TEST_ASSERT_EQUAL(spiffs ? (response.len + 1435) / 1436 : 1, response.sends);
+        }
+    }
+    response.capture = true;
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_image_sent_in_one_piece);
+    RUN_TEST(test_validators_and_ranges);
+    RUN_TEST(test_spiffs_fallback);
+    RUN_TEST(test_pages_and_missing_files_not_listed);
+    RUN_TEST(test_content_types);
+    RUN_TEST(test_too_many_assets_fail_the_build);
+    RUN_TEST(test_benchmark_chart_js);
+    UNITY_END();
+}
@@ -0,0 +1,705 @@
+/**
+ * @file test_clients.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity stress tests of the shared frame pool and the client fan-out under concurrent tasks, and of the
+ *        eviction of stalled and silent clients, with benchmarks of the fan-out cost against client count and of
+ *        event stream against WebSocket throughput
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/select.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "clients.h"
+
+#define PRODUCERS 4                 // Two per core
+#define PRODUCER_FRAMES 5000        // Frames each producer allocates
+#define POOL_CONSUMERS 2
+#define POOL_MAX_REFS 3             // References a pool producer hands out per frame
+#define CHURN_MS 2                  // Time between client re-registrations in the fan-out test
+#define STREAMS 2                   // Loopback event streams in the eviction tests
+#define MAX_STREAMS 4               // Two sockets each, within CONFIG_LWIP_MAX_SOCKETS next to the server's
+#define EVENT_MS 50                 // Time between events (and ticks) in the eviction tests
+#define EVENTS_AFTER 20             // Events published after an eviction
+#define EVICT_SLACK_MS 500          // Allowed lateness of an eviction past its timeout
+#define BENCH_ROUNDS 200            // Fan-outs per client count
+#define BENCH_FRAME_LEN 256
+#define THROUGHPUT_FRAMES 2000      // Frames sent to every stream per throughput run
+
+static const char event_text[] = "data: #\n\n";    // One '#' per event; keepalives have none
+static const char ws_upgrade[] = "GET /ws HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+    "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+
+// Descriptors at the top of the lwIP socket range, which nothing in this test opens. select()
+// reports them unwritable, so published frames stay queued until a client is removed.
+#define FAKE_FD(i) (FD_SETSIZE - 1 - (i))
+
+// One reference to a pooled frame handed from a producer to a consumer
+typedef struct {
+    ws_frame_t* frame;
+    uint32_t stamp;
+} frame_ref_t;
+
+static httpd_handle_t server = NULL;
+static uint16_t server_port;
+static int streams[MAX_STREAMS];    // Our end of each loopback connection
+static int stream_fds[MAX_STREAMS]; // The server's end, registered with the registry
+static uint32_t stream_events[MAX_STREAMS];
+static uint64_t stream_bytes[MAX_STREAMS];
+static int n_streams;
+static uint8_t bench_payload[BENCH_FRAME_LEN];
+static QueueHandle_t refs_queue;
+static SemaphoreHandle_t done;
+static atomic_bool producers_running;
+static atomic_uint torn;            // Frames whose stamp changed while a reference was held
+static atomic_uint exhausted;       // Allocations that found the pool empty
+static atomic_uint queued;          // Client queue entries reported by clients_publish()
+static atomic_uint overfull;        // Client queues seen deeper than CLIENTS_QUEUE_LEN
+static atomic_uint unregistered;    // Re-registrations the registry refused
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static uint32_t make_stamp(int producer, uint32_t i) {
+    return (uint32_t) producer << 24 | (i & 0xFFFFFF);
+}
+
+static void put_stamp(ws_frame_t* frame, uint32_t stamp) {
+    memcpy(frame->data, &stamp, sizeof(stamp));
+    frame->len = sizeof(stamp);
+}
+
+static uint32_t get_stamp(const ws_frame_t* frame) {
+    uint32_t stamp;
+    memcpy(&stamp, frame->data, sizeof(stamp));
+    return stamp;
+}
+
+// Allocate, retrying while the pool is exhausted, and check that nobody else was handed the same frame
+static ws_frame_t* alloc_stamped(uint32_t stamp) {
+    ws_frame_t* frame;
+    while((frame = clients_frame_alloc()) == NULL) {
+        atomic_fetch_add(&exhausted, 1);
+        taskYIELD();
+    }
+
+    put_stamp(frame, stamp);
+    taskYIELD();
+    if(get_stamp(frame) != stamp || atomic_load(&frame->refs) != 1) {
+        atomic_fetch_add(&torn, 1);
+    }
+    return frame;
+}
+
+static uint32_t pool_free(void) {
+    clients_fanout_t fanout;
+    clients_get_fanout(&fanout);
+    return fanout.pool_free;
+}
+
+static void start_tasks(TaskFunction_t producer, TaskFunction_t consumer, int consumers) {
+    producers_running = true;
+    for(int i = 0; i < PRODUCERS; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(producer, "producer", 4096, (void*) (intptr_t) i, 5, NULL, i % 2));
+    }
+    for(int i = 0; i < consumers; i++) {
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(consumer, "consumer", 4096, (void*) (intptr_t) i, 5, NULL, i % 2));
+    }
+}
+
+static void wait_tasks(int n) {
+    for(int i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done, pdMS_TO_TICKS(60000)));
+    }
+}
+
+static void test_pool_exhaustion(void) {
+    ws_frame_t* frames[CLIENTS_POOL_SIZE];
+    clients_fanout_t before, after;
+
+    clients_get_fanout(&before);
+    TEST_ASSERT_EQUAL_UINT32(CLIENTS_POOL_SIZE, before.pool_free);
+
+    for(int i = 0; i < CLIENTS_POOL_SIZE; i++) {
+        frames[i] = clients_frame_alloc();
+        TEST_ASSERT_NOT_NULL(frames[i]);
+        for(int j = 0; j < i; j++) {
+            TEST_ASSERT_TRUE(frames[i] != frames[j]);
+        }
+    }
+    TEST_ASSERT_NULL(clients_frame_alloc());
+
+    clients_get_fanout(&after);
+    TEST_ASSERT_EQUAL_UINT32(0, after.pool_free);
+    TEST_ASSERT_EQUAL_UINT32(before.pool_exhausted + 1, after.pool_exhausted);
+
+    // A frame only returns to the pool with its last reference
+    atomic_fetch_add(&frames[0]->refs, 1);
+    clients_frame_release(frames[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, pool_free());
+    for(int i = 0; i < CLIENTS_POOL_SIZE; i++) {
+        clients_frame_release(frames[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(CLIENTS_POOL_SIZE, pool_free());
+}
+
+// Hands each frame to the consumers as 1 to POOL_MAX_REFS references
+static void pool_producer_task(void* arg) {
+    int id = (int) (intptr_t) arg;
+
+    for(uint32_t i = 0; i < PRODUCER_FRAMES; i++) {
+        frame_ref_t ref = { .stamp = make_stamp(id, i) };
+        int refs = 1 + i % POOL_MAX_REFS;
+
+        ref.frame = alloc_stamped(ref.stamp);
+        atomic_fetch_add(&ref.frame->refs, refs - 1);
+        for(int r = 0; r < refs; r++) {
+            xQueueSend(refs_queue, &ref, portMAX_DELAY);
+        }
+    }
+
+    xSemaphoreGive(done);
+    vTaskDelete(NULL);
+}
+
+static void pool_consumer_task(void* arg) {
+    frame_ref_t ref;
+
+    while(producers_running || uxQueueMessagesWaiting(refs_queue) > 0) {
+        if(xQueueReceive(refs_queue, &ref, pdMS_TO_TICKS(10)) != pdTRUE) {
+            continue;
+        }
+        if(get_stamp(ref.frame) != ref.stamp) {
+            atomic_fetch_add(&torn, 1);
+        }
+        clients_frame_release(ref.frame);
+    }
+
+    xSemaphoreGive(done);
+    vTaskDelete(NULL);
+}
+
+static void test_pool_concurrent_refs(void) {
+    atomic_store(&torn, 0);
+    atomic_store(&exhausted, 0);
+    refs_queue = xQueueCreate(CLIENTS_POOL_SIZE, sizeof(frame_ref_t));
+    done = xSemaphoreCreateCounting(PRODUCERS + POOL_CONSUMERS, 0);
+    TEST_ASSERT_NOT_NULL(refs_queue);
+    TEST_ASSERT_NOT_NULL(done);
+
+    start_tasks(pool_producer_task, pool_consumer_task, POOL_CONSUMERS);
+    wait_tasks(PRODUCERS);
+    producers_running = false;
+    wait_tasks(POOL_CONSUMERS);
+
+    vQueueDelete(refs_queue);
+    vSemaphoreDelete(done);
+    TEST_ASSERT_EQUAL_UINT32(0, atomic_load(&torn));
+    TEST_ASSERT_EQUAL_UINT32(CLIENTS_POOL_SIZE, pool_free());
+}
+
+// Publishes to every WebSocket client, alternating between the broadcast and one format
+static void fanout_producer_task(void* arg) {
+    int id = (int) (intptr_t) arg;
+
+    for(uint32_t i = 0; i < PRODUCER_FRAMES; i++) {
+        ws_frame_t* frame = alloc_stamped(make_stamp(id, i));
+        ws_format_t format = i % 2 ? WS_FORMAT_ANY : (id % 2 ? WS_FORMAT_BINARY : WS_FORMAT_DELTA);
+        atomic_fetch_add(&queued, clients_publish(server, frame, format, 1));
+    }
+
+    xSemaphoreGive(done);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t add_client(int i) {
+    ws_subscription_t sub = {
+        .format = i % 2 ? WS_FORMAT_BINARY : WS_FORMAT_DELTA,
+        .decimation = 1,
+    };
+    return clients_add(FAKE_FD(i), &sub, i % 3 ? WS_POLICY_DROP_OLDEST : WS_POLICY_DROP_NEWEST, NULL);
+}
+
+// Re-registers clients one after another, which drops their queues while producers publish
+static void churn_task(void* arg) {
+    ws_client_t clients[CLIENTS_MAX];
+
+    for(int i = 0; producers_running; i = (i + 1) % CLIENTS_MAX) {
+        clients_remove(FAKE_FD(i));
+        if(add_client(i) != ESP_OK) {
+            atomic_fetch_add(&unregistered, 1);
+        }
+
+        size_t n = clients_get(clients);
+        for(size_t c = 0; c < n; c++) {
+            if(clients[c].depth > CLIENTS_QUEUE_LEN || clients[c].max_depth > CLIENTS_QUEUE_LEN) {
+                atomic_fetch_add(&overfull, 1);
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(CHURN_MS));
+    }
+
+    xSemaphoreGive(done);
+    vTaskDelete(NULL);
+}
+
+static void test_fanout_concurrent(void) {
+    clients_fanout_t before, after;
+
+    atomic_store(&torn, 0);
+    atomic_store(&exhausted, 0);
+    atomic_store(&queued, 0);
+    atomic_store(&overfull, 0);
+    atomic_store(&unregistered, 0);
+    done = xSemaphoreCreateCounting(PRODUCERS + 1, 0);
+    TEST_ASSERT_NOT_NULL(done);
+
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, add_client(i));
+    }
+    TEST_ASSERT_EQUAL(CLIENTS_MAX, clients_count(WS_FORMAT_ANY));
+    clients_get_fanout(&before);
+
+    start_tasks(fanout_producer_task, churn_task, 1);
+    wait_tasks(PRODUCERS);
+    producers_running = false;
+    wait_tasks(1);
+    vSemaphoreDelete(done);
+
+    clients_get_fanout(&after);
+    TEST_ASSERT_EQUAL_UINT32(0, atomic_load(&torn));
+    TEST_ASSERT_EQUAL_UINT32(0, atomic_load(&overfull));
+    TEST_ASSERT_EQUAL_UINT32(0, atomic_load(&unregistered));
+    TEST_ASSERT_EQUAL_UINT32(atomic_load(&queued), after.sends - before.sends);
+    TEST_ASSERT_EQUAL_UINT32(0, after.evictions - before.evictions);
+
+    // Every queued reference must come back once the clients are gone
+    for(int i = 0; i < CLIENTS_MAX; i++) {
+        clients_remove(FAKE_FD(i));
+    }
+    TEST_ASSERT_EQUAL(0, clients_count(WS_FORMAT_ANY));
+    TEST_ASSERT_EQUAL_UINT32(CLIENTS_POOL_SIZE, pool_free());
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "queued %u, dropped %lu, pool exhausted %u times", atomic_load(&queued),
+        (unsigned long) (after.dropped - before.dropped), atomic_load(&exhausted));
+    TEST_MESSAGE(msg);
+}
+
+// Sends the upgrade request and waits for the end of the 101 response
+static void websocket_handshake(int sock) {
+    char response[256];
+    size_t len = 0;
+
+    TEST_ASSERT_EQUAL(sizeof(ws_upgrade) - 1, send(sock, ws_upgrade, sizeof(ws_upgrade) - 1, 0));
+    for(int tries = 0; tries < 100 && (len < 4 || memcmp(&response[len - 4], "\r\n\r\n", 4) != 0); tries++) {
+        int n = recv(sock, &response[len], sizeof(response) - 1 - len, 0);
+        if(n > 0) {
+            len += n;
+        } else {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    response[len] = '\0';
+    TEST_ASSERT_EQUAL(0, strncmp(response, "HTTP/1.1 101", 12));
+}
+
+// Connects to the test server over loopback and registers the server's end of each connection
+// in the given format, so flushes really write to a socket that is read. WebSocket connections
+// complete the handshake first.
+static void open_streams(int count, ws_format_t format) {
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(server_port),
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+    };
+    ws_subscription_t sub = { .format = format, .decimation = format == WS_FORMAT_SSE ? 0 : 1 };
+    int fds[CLIENTS_MAX];
+    size_t n = 0;
+
+    n_streams = count;
+    for(int i = 0; i < n_streams; i++) {
+        streams[i] = socket(AF_INET, SOCK_STREAM, 0);
+        TEST_ASSERT_TRUE(streams[i] >= 0);
+        TEST_ASSERT_EQUAL(0, connect(streams[i], (struct sockaddr*) &addr, sizeof(addr)));
+        fcntl(streams[i], F_SETFL, O_NONBLOCK);
+        if(format != WS_FORMAT_SSE) {
+            websocket_handshake(streams[i]);
+        }
+        stream_events[i] = 0;
+        stream_bytes[i] = 0;
+    }
+
+    for(int tries = 0; tries < 100 && n < (size_t) n_streams; tries++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        n = CLIENTS_MAX;
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_get_client_list(server, &n, fds));
+    }
+    TEST_ASSERT_EQUAL(n_streams, n);
+
+    for(int i = 0; i < n_streams; i++) {
+        stream_fds[i] = fds[i];
+        TEST_ASSERT_TRUE(stream_fds[i] < FAKE_FD(1));
+        TEST_ASSERT_EQUAL(ESP_OK, clients_add(stream_fds[i], &sub, WS_POLICY_DROP_OLDEST, NULL));
+    }
+}
+
+// Closes our ends and waits for the server to close its sessions, so the next test starts with none
+static void close_streams(void) {
+    int fds[CLIENTS_MAX];
+    size_t n = CLIENTS_MAX;
+
+    for(int i = 0; i < n_streams; i++) {
+        clients_remove(stream_fds[i]);
+        close(streams[i]);
+    }
+
+    for(int tries = 0; tries < 100 && n > 0; tries++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+        n = CLIENTS_MAX;
+        TEST_ASSERT_EQUAL(ESP_OK, httpd_get_client_list(server, &n, fds));
+    }
+    TEST_ASSERT_EQUAL(0, n);
+}
+
+// Counts the events and bytes that arrived on each stream since the last call
+static void read_streams(void) {
+    char buf[256];
+
+    for(int i = 0; i < n_streams; i++) {
+        int len;
+        while((len = recv(streams[i], buf, sizeof(buf), 0)) > 0) {
+            stream_bytes[i] += len;
+            for(int j = 0; j < len; j++) {
+                stream_events[i] += buf[j] == '#';
+            }
+        }
+    }
+}
+
+// Waits for every stream to have read sent events
+static void wait_streams(uint32_t sent) {
+    for(int tries = 0; tries < 100; tries++) {
+        read_streams();
+        bool all = true;
+        for(int i = 0; i < n_streams; i++) {
+            all &= stream_events[i] >= sent;
+        }
+        if(all) {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    for(int i = 0; i < n_streams; i++) {
+        TEST_ASSERT_EQUAL_UINT32(sent, stream_events[i]);
+    }
+}
+
+static size_t publish_event(void) {
+    ws_frame_t* frame = clients_frame_alloc();
+    TEST_ASSERT_NOT_NULL(frame);
+    frame->type = HTTPD_WS_TYPE_TEXT;
+    frame->len = sizeof(event_text) - 1;
+    memcpy(frame->data, event_text, frame->len);
+    return clients_publish(server, frame, WS_FORMAT_SSE, 1);
+}
+
+static bool find_client(int fd, ws_client_t* client) {
+    ws_client_t clients[CLIENTS_MAX];
+    size_t n = clients_get(clients);
+
+    for(size_t i = 0; i < n; i++) {
+        if(clients[i].fd == fd) {
+            *client = clients[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint32_t evictions(void) {
+    clients_fanout_t fanout;
+    clients_get_fanout(&fanout);
+    return fanout.evictions;
+}
+
+static void test_stalled_client_evicted(void) {
+    ws_subscription_t sub = { .format = WS_FORMAT_SSE };
+    ws_client_t client;
+    int64_t full_at = 0;
+    int64_t evicted_at = 0;
+    uint32_t sent = 0;
+
+    open_streams(STREAMS, WS_FORMAT_SSE);
+    TEST_ASSERT_EQUAL(ESP_OK, clients_add(FAKE_FD(0), &sub, WS_POLICY_DROP_OLDEST, NULL));
+    uint32_t before = evictions();
+
+    // The unwritable client's queue fills after CLIENTS_QUEUE_LEN events, which starts its stall timer
+    while(evicted_at == 0) {
+        int64_t now = esp_timer_get_time();
+        TEST_ASSERT_TRUE(sent <= CLIENTS_QUEUE_LEN + (CONFIG_WS_STALL_TIMEOUT_MS + EVICT_SLACK_MS) / EVENT_MS);
+        TEST_ASSERT_TRUE(full_at == 0 || now - full_at < (CONFIG_WS_STALL_TIMEOUT_MS + EVICT_SLACK_MS) * 1000LL);
+
+        TEST_ASSERT_EQUAL(STREAMS + 1, publish_event());
+        sent++;
+        TEST_ASSERT_TRUE(find_client(FAKE_FD(0), &client));
+        if(full_at == 0 && client.dropped > 0) {
+            full_at = now;
+        }
+
+        clients_tick(server);
+        if(evictions() != before) {
+            evicted_at = esp_timer_get_time();
+        }
+        read_streams();
+        vTaskDelay(pdMS_TO_TICKS(EVENT_MS));
+    }
+
+    TEST_ASSERT_TRUE(full_at > 0);
+    TEST_ASSERT_TRUE(evicted_at - full_at >= CONFIG_WS_STALL_TIMEOUT_MS * 1000LL);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, evictions());
+
+    // The evicted client gets nothing more while the others carry on
+    for(int i = 0; i < EVENTS_AFTER; i++) {
+        TEST_ASSERT_EQUAL(STREAMS, publish_event());
+        sent++;
+        clients_tick(server);
+        vTaskDelay(pdMS_TO_TICKS(EVENT_MS));
+    }
+    wait_streams(sent);
+    for(int i = 0; i < STREAMS; i++) {
+        TEST_ASSERT_TRUE(find_client(stream_fds[i], &client));
+        TEST_ASSERT_EQUAL_UINT32(0, client.dropped);
+    }
+    TEST_ASSERT_EQUAL_UINT32(before + 1, evictions());
+
+    // No session to close for the fake descriptor, so stand in for on_close
+    clients_remove(FAKE_FD(0));
+    close_streams();
+    vTaskDelay(pdMS_TO_TICKS(10));
+    TEST_ASSERT_EQUAL_UINT32(CLIENTS_POOL_SIZE, pool_free());
+}
+
+static void test_silent_client_evicted(void) {
+    ws_subscription_t sub = { .format = WS_FORMAT_BINARY, .decimation = 1 };
+    ws_client_t client;
+    int64_t evicted_at = 0;
+
+    // FAKE_FD(1) answers like a browser answering pings; FAKE_FD(0) never does
+    open_streams(STREAMS, WS_FORMAT_SSE);
+    TEST_ASSERT_EQUAL(ESP_OK, clients_add(FAKE_FD(0), &sub, WS_POLICY_DROP_OLDEST, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, clients_add(FAKE_FD(1), &sub, WS_POLICY_DROP_OLDEST, NULL));
+    TEST_ASSERT_TRUE(find_client(FAKE_FD(0), &client));
+    int64_t added_at = client.connected_us;
+    uint32_t before = evictions();
+
+    // Run one ping interval past the eviction to check nobody else goes: the streams stay
+    // alive on their keepalive writes alone
+    int64_t end = added_at + (CONFIG_WS_PONG_TIMEOUT_MS + CONFIG_WS_PING_INTERVAL_MS) * 1000LL;
+    while(esp_timer_get_time() < end) {
+        clients_seen(FAKE_FD(1));
+        clients_tick(server);
+        if(evicted_at == 0 && evictions() != before) {
+            evicted_at = esp_timer_get_time();
+        }
+        read_streams();
+        vTaskDelay(pdMS_TO_TICKS(EVENT_MS));
+    }
+
+    TEST_ASSERT_TRUE(evicted_at - added_at >= CONFIG_WS_PONG_TIMEOUT_MS * 1000LL);
+    TEST_ASSERT_TRUE(evicted_at - added_at < (CONFIG_WS_PONG_TIMEOUT_MS + EVICT_SLACK_MS) * 1000LL);
+    TEST_ASSERT_EQUAL_UINT32(before + 1, evictions());
+
+    // The pings sent meanwhile never filled the answering client's queue
+    TEST_ASSERT_TRUE(find_client(FAKE_FD(1), &client));
+    TEST_ASSERT_EQUAL_UINT32(0, client.dropped);
+    TEST_ASSERT_TRUE(client.depth > 0);
+
+    // Only the answering client still gets frames
+    ws_frame_t* frame = clients_frame_alloc();
+    TEST_ASSERT_NOT_NULL(frame);
+    frame->type = HTTPD_WS_TYPE_BINARY;
+    frame->len = 0;
+    TEST_ASSERT_EQUAL(1, clients_publish(server, frame, WS_FORMAT_BINARY, 1));
+
+    clients_remove(FAKE_FD(0));
+    clients_remove(FAKE_FD(1));
+    close_streams();
+    vTaskDelay(pdMS_TO_TICKS(10));
+    TEST_ASSERT_EQUAL_UINT32(CLIENTS_POOL_SIZE, pool_free());
+}
+
+// The fan-out the registry replaced: a descriptor list allocated per broadcast, a session lookup
+// per descriptor and the sends on the caller's task
+static void fanout_before(httpd_ws_frame_t* ws_pkt) {
+    size_t fds = CONFIG_LWIP_MAX_LISTENING_TCP;
+    int* client_fds = malloc(sizeof(int) * fds);
+
+    TEST_ASSERT_NOT_NULL(client_fds);
+    if(httpd_get_client_list(server, &fds, client_fds) == ESP_OK) {
+        for(size_t i = 0; i < fds; i++) {
+            if(httpd_ws_get_fd_info(server, client_fds[i]) == HTTPD_WS_CLIENT_WEBSOCKET) {
+                httpd_ws_send_frame_async(server, client_fds[i], ws_pkt);
+            }
+        }
+    }
+    free(client_fds);
+}
+
+// Cost on the publishing task per fan-out against the number of WebSocket clients, before and after
+// the registry. After, the publishing task walks the registry and schedules a flush, and the sends
+// move to the httpd task: the walk alone, the whole call and the time until every client has sent
+// the frame are reported.
+static void test_benchmark_fanout(void) {
+    httpd_ws_frame_t ws_pkt = { .final = true, .type = HTTPD_WS_TYPE_BINARY, .payload = bench_payload, .len = BENCH_FRAME_LEN };
+    char msg[128];
+
+    memset(bench_payload, 0x55, sizeof(bench_payload));
+    for(int count = 1; count <= MAX_STREAMS; count++) {
+        int64_t before_us = 0;
+        int64_t queue_us = 0;
+        int64_t sent_us = 0;
+        clients_fanout_t walk_before, walk_after;
+
+        open_streams(count, WS_FORMAT_BINARY);
+        for(int r = 0; r < BENCH_ROUNDS; r++) {
+            int64_t start = esp_timer_get_time();
+            fanout_before(&ws_pkt);
+            before_us += esp_timer_get_time() - start;
+            read_streams();
+        }
+
+        clients_get_fanout(&walk_before);
+        for(int r = 0; r < BENCH_ROUNDS; r++) {
+            int64_t start = esp_timer_get_time();
+            ws_frame_t* frame = clients_frame_alloc();
+            TEST_ASSERT_NOT_NULL(frame);
+            frame->type = HTTPD_WS_TYPE_BINARY;
+            frame->len = BENCH_FRAME_LEN;
+            TEST_ASSERT_EQUAL(count, clients_publish(server, frame, WS_FORMAT_BINARY, 1));
+            queue_us += esp_timer_get_time() - start;
+
+            // The frame returns to the pool once the last client has sent it
+            while(pool_free() < CLIENTS_POOL_SIZE) {
+                taskYIELD();
+            }
+            sent_us += esp_timer_get_time() - start;
+            read_streams();
+        }
+        clients_get_fanout(&walk_after);
+        close_streams();
+
+        snprintf(msg, sizeof(msg), "%d clients: before %6.1f us, after %4.1f us walk, %5.1f us call, %6.1f us until sent",
+            count, (double) before_us / BENCH_ROUNDS, (double) (walk_after.total_us - walk_before.total_us) / BENCH_ROUNDS,
+            (double) queue_us / BENCH_ROUNDS, (double) sent_us / BENCH_ROUNDS);
+        TEST_MESSAGE(msg);
+    }
+}
+
+static uint8_t deepest_queue(void) {
+    ws_client_t clients[CLIENTS_MAX];
+    size_t n = clients_get(clients);
+    uint8_t depth = 0;
+
+    for(size_t i = 0; i < n; i++) {
+        depth = clients[i].depth > depth ? clients[i].depth : depth;
+    }
+    return depth;
+}
+
+// Frames per second delivered to each of 1 to MAX_STREAMS concurrent streams, event streams against
+// WebSocket clients. Both go through the same registry and flush; only the send differs (a raw
+// socket write against a WebSocket frame). The publisher keeps every queue short of full, so the
+// rate is what the slowest stream sustains without drops.
+static void test_benchmark_sse_against_ws(void) {
+    const ws_format_t formats[] = { WS_FORMAT_SSE, WS_FORMAT_BINARY };
+    char msg[128];
+
+    for(size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); f++) {
+        for(int count = 1; count <= MAX_STREAMS; count++) {
+            uint32_t published = 0;
+
+            open_streams(count, formats[f]);
+            int64_t start = esp_timer_get_time();
+            while(published < THROUGHPUT_FRAMES) {
+                ws_frame_t* frame = deepest_queue() < CLIENTS_QUEUE_LEN - 1 ? clients_frame_alloc() : NULL;
+                if(frame == NULL) {
+                    read_streams();
+                    taskYIELD();
+                    continue;
+                }
+
+                // One '#' per frame in either format, as in the event text
+                frame->type = HTTPD_WS_TYPE_BINARY;
+                frame->len = BENCH_FRAME_LEN;
+                memset(frame->data, 'U', BENCH_FRAME_LEN);
+                memcpy(frame->data, "data: ", 6);
+                memcpy(&frame->data[BENCH_FRAME_LEN - 3], "#\n\n", 3);
+                TEST_ASSERT_EQUAL(count, clients_publish(server, frame, formats[f], 1));
+                published++;
+                read_streams();
+            }
+            while(pool_free() < CLIENTS_POOL_SIZE) {
+                read_streams();
+                taskYIELD();
+            }
+            wait_streams(published);
+            int64_t us = esp_timer_get_time() - start;
+
+            uint64_t bytes = 0;
+            for(int i = 0; i < count; i++) {
+                bytes += stream_bytes[i];
+            }
+            close_streams();
+
+            snprintf(msg, sizeof(msg), "%-6s %d streams: %6.0f frames/s per stream, %5.2f MB/s in total",
+                formats[f] == WS_FORMAT_SSE ? "events" : "ws", count, published * 1e6 / us, bytes / (double) us);
+            TEST_MESSAGE(msg);
+        }
+    }
+}
+
+// Accepts the handshake. The benchmark never sends frames to the server.
+static esp_err_t ws_handler(httpd_req_t* req) {
+    return ESP_OK;
+}
+
+void app_main(void) {
+    // clients_publish() only queues with a running server, which schedules the flushes
+    httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(httpd_start(&server, &config));
+    server_port = config.server_port;
+
+    httpd_uri_t ws_uri = { .uri = "/ws", .method = HTTP_GET, .handler = ws_handler, .is_websocket = true };
+    ESP_ERROR_CHECK(httpd_register_uri_handler(server, &ws_uri));
+
+    UNITY_BEGIN();
+    RUN_TEST(test_pool_exhaustion);
+    RUN_TEST(test_pool_concurrent_refs);
+    RUN_TEST(test_fanout_concurrent);
+    RUN_TEST(test_stalled_client_evicted);
+    RUN_TEST(test_silent_client_evicted);
+    RUN_TEST(test_benchmark_fanout);
+    RUN_TEST(test_benchmark_sse_against_ws);
+    UNITY_END();
+
+    httpd_stop(server);
+}
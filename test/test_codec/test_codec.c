@@ -0,0 +1,234 @@
+/**
+ * @file test_codec.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity round-trip tests of the delta + zigzag varint codec, with a compression and throughput benchmark
+ *        on the traces in traces.h
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "codec.h"
+#include "traces.h"
+
+#define MAX_SAMPLES 64
+#define BENCH_BLOCK 128         // Samples per encoded block, as in an acquisition block
+#define BENCH_ROUNDS 50
+
+static uint8_t buf[CODEC_DELTA_MAX_SIZE(MAX_SAMPLES)];
+static uint16_t out[MAX_SAMPLES];
+static uint8_t bench_buf[TRACE_LEN / BENCH_BLOCK][CODEC_DELTA_MAX_SIZE(BENCH_BLOCK)];
+static size_t bench_len[TRACE_LEN / BENCH_BLOCK];
+static uint16_t bench_out[TRACE_LEN];
+
+void setUp(void) {
+    memset(buf, 0xAA, sizeof(buf));
+    memset(out, 0, sizeof(out));
+}
+
+void tearDown(void) {
+}
+
+// Encode and decode count packed samples, checking the sizes agree. Returns the encoded size.
+static size_t round_trip(const uint16_t* samples, size_t count) {
+    size_t len = codec_delta_encode(samples, count, 1, buf, sizeof(buf));
+    TEST_ASSERT_TRUE(len > 0 || count == 0);
+    TEST_ASSERT_TRUE(len <= CODEC_DELTA_MAX_SIZE(count));
+    TEST_ASSERT_EQUAL(len, codec_delta_decode(buf, len, out, count, 1));
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(samples, out, count);
+    return len;
+}
+
+static void test_empty_block(void) {
+    TEST_ASSERT_EQUAL(0, codec_delta_encode(out, 0, 1, buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL(0, codec_delta_decode(buf, 0, out, 0, 1));
+}
+
+static void test_zigzag_maps_small_steps_to_one_byte(void) {
+    // Steps of +64 (two bytes from 0), then +1, -1, +63, 0 and -64, which all zigzag below 0x80
+    const uint16_t samples[] = { 64, 65, 64, 127, 127, 63 };
+    TEST_ASSERT_EQUAL(2 + 5, round_trip(samples, 6));
+}
+
+static void test_varint_byte_boundaries(void) {
+    // The largest step of each varint length and the step one past it, from 0
+    const struct {
+        uint16_t value;
+        size_t bytes;
+    } cases[] = {
+        { 63, 1 },          // zigzag 126
+        { 64, 2 },          // zigzag 128
+        { 8191, 2 },        // zigzag 16382
+        { 8192, 3 },        // zigzag 16384
+        { 65535, 3 },       // zigzag 131070, the largest step
+    };
+
+    for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        TEST_ASSERT_EQUAL(cases[i].bytes, round_trip(&cases[i].value, 1));
+    }
+
+    // Negative steps of the same sizes, from 65535 down
+    const uint16_t down[][2] = {
+        { 65535, 65535 - 64 }, { 65535, 65535 - 65 }, { 65535, 65535 - 8192 }, { 65535, 65535 - 8193 }, { 65535, 0 },
+    };
+    const size_t down_bytes[] = { 3 + 1, 3 + 2, 3 + 2, 3 + 3, 3 + 3 };
+    for(size_t i = 0; i < sizeof(down) / sizeof(down[0]); i++) {
+        TEST_ASSERT_EQUAL(down_bytes[i], round_trip(down[i], 2));
+    }
+}
+
+static void test_int16_extremes(void) {
+    // Signed samples stored as uint16: the largest swings the codec can see
+    const int16_t signed_samples[] = { INT16_MIN, INT16_MAX, INT16_MIN, 0, -1, INT16_MAX, INT16_MAX, INT16_MIN, 1 };
+    uint16_t samples[sizeof(signed_samples) / sizeof(signed_samples[0])];
+    size_t count = sizeof(samples) / sizeof(samples[0]);
+
+    memcpy(samples, signed_samples, sizeof(samples));
+    size_t len = round_trip(samples, count);
+    TEST_ASSERT_TRUE(len <= CODEC_DELTA_MAX_SIZE(count));
+
+    for(size_t i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_INT(signed_samples[i], (int16_t) out[i]);
+    }
+}
+
+static void test_every_step_round_trips(void) {
+    uint16_t samples[2];
+
+    // Every step from two starting points covers every zigzag value the codec produces
+    for(uint32_t step = 0; step <= UINT16_MAX; step++) {
+        samples[0] = 0x8000;
+        samples[1] = (uint16_t) (0x8000 + step);
+        round_trip(samples, 2);
+        samples[0] = 0;
+        samples[1] = (uint16_t) step;
+        round_trip(samples, 2);
+    }
+}
+
+static void test_strided_channels(void) {
+    // Four interleaved channels, each encoded as its own block
+    uint16_t frames[MAX_SAMPLES / 4][4];
+    uint16_t decoded[MAX_SAMPLES / 4][4];
+    size_t n = MAX_SAMPLES / 4;
+
+    for(size_t i = 0; i < n; i++) {
+        frames[i][0] = 2048 + i;
+        frames[i][1] = 4095 - i * 3;
+        frames[i][2] = i % 2 ? 0 : 4095;
+        frames[i][3] = 1234;
+    }
+    memset(decoded, 0, sizeof(decoded));
+
+    for(int ch = 0; ch < 4; ch++) {
+        size_t len = codec_delta_encode(&frames[0][ch], n, 4, buf, sizeof(buf));
+        TEST_ASSERT_TRUE(len > 0);
+        TEST_ASSERT_EQUAL(len, codec_delta_decode(buf, len, &decoded[0][ch], n, 4));
+    }
+    TEST_ASSERT_EQUAL_MEMORY(frames, decoded, sizeof(frames));
+}
+
+static void test_short_output_buffer(void) {
+    const uint16_t samples[] = { 0, 65535, 1 };     // 1 + 3 + 3 bytes
+
+    TEST_ASSERT_EQUAL(7, codec_delta_encode(samples, 3, 1, buf, 7));
+    TEST_ASSERT_EQUAL(0, codec_delta_encode(samples, 3, 1, buf, 6));
+    TEST_ASSERT_EQUAL(0, codec_delta_encode(samples, 3, 1, buf, 4));
+    TEST_ASSERT_EQUAL(0, codec_delta_encode(samples, 3, 1, buf, 0));
+}
+
+static void test_truncated_and_malformed_input(void) {
+    const uint16_t samples[] = { 0, 65535, 1 };
+    size_t len = codec_delta_encode(samples, 3, 1, buf, sizeof(buf));
+
+    // Every prefix is too short for three samples
+    for(size_t cut = 0; cut < len; cut++) {
+        TEST_ASSERT_EQUAL(0, codec_delta_decode(buf, cut, out, 3, 1));
+    }
+
+    // A varint longer than three bytes cannot come from the encoder
+    const uint8_t overlong[] = { 0x80, 0x80, 0x80, 0x01 };
+    TEST_ASSERT_EQUAL(0, codec_delta_decode(overlong, sizeof(overlong), out, 1, 1));
+
+    // A continuation bit on the last byte runs off the end
+    const uint8_t open[] = { 0x81 };
+    TEST_ASSERT_EQUAL(0, codec_delta_decode(open, sizeof(open), out, 1, 1));
+}
+
+static void test_decode_stops_at_count(void) {
+    const uint16_t samples[] = { 10, 20, 30, 40 };
+    size_t len = codec_delta_encode(samples, 4, 1, buf, sizeof(buf));
+
+    // Trailing bytes belong to the next channel and are left alone
+    TEST_ASSERT_EQUAL(2, codec_delta_decode(buf, len, out, 2, 1));
+    TEST_ASSERT_EQUAL_UINT16(10, out[0]);
+    TEST_ASSERT_EQUAL_UINT16(20, out[1]);
+    TEST_ASSERT_EQUAL_UINT16(0, out[2]);
+}
+
+// Compression ratio against 16 bits per sample, and encode and decode throughput in MB/s of samples
+static void test_benchmark_traces(void) {
+    const struct {
+        const char* name;
+        const uint16_t* samples;
+    } traces[] = {
+        { "mock", trace_mock },
+        { "slow", trace_slow },
+        { "fast", trace_fast },
+    };
+    const size_t blocks = TRACE_LEN / BENCH_BLOCK;
+    const double mb = (double) BENCH_ROUNDS * TRACE_LEN * sizeof(uint16_t) / 1e6;
+    char msg[128];
+
+    for(size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+        size_t bytes = 0;
+
+        int64_t start = esp_timer_get_time();
+        for(int r = 0; r < BENCH_ROUNDS; r++) {
+            bytes = 0;
+            for(size_t b = 0; b < blocks; b++) {
+                bench_len[b] = codec_delta_encode(&traces[t].samples[b * BENCH_BLOCK], BENCH_BLOCK, 1, bench_buf[b], sizeof(bench_buf[b]));
+                bytes += bench_len[b];
+            }
+        }
+        int64_t encode_us = esp_timer_get_time() - start;
+
+        start = esp_timer_get_time();
+        for(int r = 0; r < BENCH_ROUNDS; r++) {
+            for(size_t b = 0; b < blocks; b++) {
+                codec_delta_decode(bench_buf[b], bench_len[b], &bench_out[b * BENCH_BLOCK], BENCH_BLOCK, 1);
+            }
+        }
+        int64_t decode_us = esp_timer_get_time() - start;
+
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(traces[t].samples, bench_out, TRACE_LEN);
+        snprintf(msg, sizeof(msg), "%s: %.2f B per sample, ratio %.2f, encode %.0f MB/s, decode %.0f MB/s", traces[t].name,
+            (double) bytes / TRACE_LEN, (double) TRACE_LEN * sizeof(uint16_t) / bytes, mb / (encode_us / 1e6),
+            mb / (decode_us / 1e6));
+        TEST_MESSAGE(msg);
+
+        // Every step of these 12-bit traces fits in two varint bytes
+        TEST_ASSERT_TRUE(bytes <= TRACE_LEN * sizeof(uint16_t));
+    }
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_block);
+    RUN_TEST(test_zigzag_maps_small_steps_to_one_byte);
+    RUN_TEST(test_varint_byte_boundaries);
+    RUN_TEST(test_int16_extremes);
+    RUN_TEST(test_every_step_round_trips);
+    RUN_TEST(test_strided_channels);
+    RUN_TEST(test_short_output_buffer);
+    RUN_TEST(test_truncated_and_malformed_input);
+    RUN_TEST(test_decode_stops_at_count);
+    RUN_TEST(test_benchmark_traces);
+    UNITY_END();
+}
@@ -0,0 +1,794 @@
+#ifndef TRACES_H
+#define TRACES_H
+
+#include <stdint.h>
+
+/**
+ * 12-bit ADC code traces for the codec benchmark, one channel at 2 kHz. trace_mock is the
+ * output of the firmware's mock source. The other two are generated with fixed seeds to stand in
+ * for a slowly varying sensor and a fast full-range signal. To benchmark real input, replace them
+ * with a board recording ('tools/udp_receiver.py --out' writes the raw stream as CSV).
+ */
+#define TRACE_LEN 4096
+
+// acq_mock_source, slot 0 at 2 kHz: a 1 Hz sine over most of the range with +-8 LSB of noise
+static const uint16_t trace_mock[TRACE_LEN] = {
+    2041, 2047, 2063, 2068, 2073, 2080, 2076, 2083, 2098, 2095, 2096, 2102, 2123, 2120, 2122, 2133,
+    2139, 2138, 2152, 2153, 2167, 2168, 2171, 2185, 2190, 2197, 2188, 2205, 2201, 2209, 2216, 2225,
+    2233, 2228, 2232, 2253, 2251, 2250, 2261, 2271, 2268, 2286, 2284, 2290, 2301, 2303, 2311, 2304,
+    2326, 2319, 2333, 2328, 2347, 2352, 2343, 2357, 2363, 2367, 2376, 2372, 2377, 2390, 2397, 2404,
+    2409, 2416, 2417, 2417, 2428, 2429, 2445, 2441, 2447, 2460, 2464, 2472, 2481, 2481, 2481, 2494,
+    2496, 2501, 2505, 2506, 2522, 2521, 2521, 2531, 2535, 2548, 2544, 2555, 2559, 2568, 2573, 2576,
+    2582, 2590, 2591, 2594, 2609, 2614, 2607, 2621, 2622, 2631, 2640, 2645, 2639, 2649, 2663, 2658,
+    2675, 2666, 2684, 2688, 2692, 2686, 2703, 2708, 2716, 2708, 2728, 2725, 2739, 2728, 2742, 2751,
+    2745, 2762, 2766, 2764, 2773, 2773, 2780, 2793, 2786, 2792, 2804, 2806, 2814, 2822, 2824, 2832,
+    2837, 2838, 2843, 2849, 2863, 2862, 2863, 2865, 2877, 2885, 2892, 2895, 2895, 2903, 2913, 2915,
+    2907, 2922, 2928, 2932, 2940, 2936, 2937, 2956, 2956, 2956, 2957, 2968, 2981, 2973, 2983, 2988,
+    2993, 2999, 2995, 3004, 3015, 3012, 3028, 3021, 3035, 3034, 3036, 3051, 3043, 3049, 3066, 3068,
+    3070, 3076, 3072, 3086, 3087, 3097, 3104, 3105, 3109, 3115, 3112, 3125, 3121, 3125, 3138, 3145,
+    3147, 3147, 3158, 3149, 3154, 3165, 3162, 3166, 3181, 3189, 3183, 3186, 3187, 3205, 3201, 3213,
+    3209, 3214, 3226, 3230, 3228, 3228, 3235, 3243, 3248, 3253, 3254, 3252, 3267, 3269, 3267, 3270,
+    3277, 3287, 3296, 3295, 3295, 3293, 3296, 3316, 3309, 3322, 3322, 3319, 3324, 3338, 3344, 3347,
+    3344, 3348, 3359, 3364, 3365, 3365, 3375, 3369, 3374, 3383, 3391, 3382, 3389, 3392, 3401, 3401,
+    3407, 3411, 3409, 3410, 3426, 3430, 3426, 3428, 3440, 3430, 3449, 3448, 3449, 3450, 3451, 3458,
+    3458, 3471, 3478, 3478, 3474, 3480, 3492, 3481, 3489, 3501, 3497, 3504, 3503, 3509, 3504, 3518,
+    3518, 3522, 3524, 3521, 3536, 3535, 3535, 3532, 3549, 3541, 3557, 3555, 3552, 3552, 3558, 3560,
+    3562, 3566, 3579, 3573, 3576, 3574, 3577, 3595, 3589, 3599, 3604, 3599, 3608, 3598, 3610, 3608,
+    3615, 3616, 3621, 3618, 3618, 3629, 3631, 3632, 3637, 3637, 3643, 3647, 3652, 3645, 3658, 3647,
+    3649, 3652, 3662, 3667, 3666, 3662, 3668, 3673, 3680, 3679, 3673, 3682, 3688, 3686, 3692, 3687,
+    3687, 3696, 3698, 3710, 3696, 3709, 3706, 3711, 3714, 3721, 3725, 3717, 3714, 3728, 3727, 3719,
+    3724, 3728, 3731, 3735, 3739, 3734, 3738, 3744, 3737, 3752, 3743, 3747, 3752, 3753, 3762, 3752,
+    3765, 3759, 3759, 3761, 3768, 3768, 3769, 3774, 3771, 3777, 3773, 3776, 3780, 3783, 3785, 3787,
+    3777, 3792, 3792, 3784, 3790, 3791, 3795, 3795, 3798, 3790, 3802, 3795, 3794, 3809, 3800, 3800,
+    3807, 3800, 3812, 3808, 3811, 3809, 3818, 3815, 3824, 3820, 3811, 3823, 3826, 3816, 3818, 3825,
+    3821, 3828, 3822, 3818, 3829, 3834, 3832, 3836, 3828, 3836, 3838, 3841, 3828, 3841, 3838, 3834,
+    3828, 3835, 3832, 3830, 3844, 3844, 3842, 3833, 3833, 3847, 3836, 3848, 3841, 3837, 3837, 3852,
+    3842, 3842, 3837, 3850, 3851, 3844, 3852, 3854, 3844, 3851, 3843, 3855, 3854, 3855, 3842, 3839,
+    3855, 3842, 3850, 3849, 3851, 3839, 3849, 3846, 3855, 3840, 3850, 3842, 3853, 3854, 3847, 3849,
+    3853, 3852, 3846, 3851, 3839, 3837, 3846, 3837, 3839, 3848, 3837, 3847, 3840, 3846, 3836, 3837,
+    3848, 3841, 3842, 3832, 3841, 3834, 3842, 3838, 3836, 3833, 3838, 3831, 3839, 3838, 3832, 3838,
+    3837, 3837, 3827, 3828, 3820, 3831, 3823, 3826, 3818, 3829, 3816, 3818, 3821, 3817, 3812, 3824,
+    3811, 3822, 3819, 3816, 3808, 3816, 3816, 3811, 3802, 3805, 3808, 3800, 3797, 3808, 3802, 3798,
+    3803, 3790, 3789, 3800, 3797, 3786, 3793, 3783, 3792, 3781, 3785, 3786, 3775, 3783, 3777, 3770,
+    3775, 3772, 3776, 3770, 3768, 3765, 3763, 3767, 3751, 3760, 3755, 3755, 3745, 3747, 3741, 3745,
+    3739, 3744, 3739, 3746, 3740, 3733, 3736, 3739, 3736, 3728, 3730, 3726, 3723, 3725, 3716, 3714,
+    3706, 3716, 3710, 3714, 3708, 3706, 3706, 3700, 3688, 3688, 3689, 3688, 3682, 3682, 3678, 3674,
+    3674, 3681, 3674, 3676, 3662, 3657, 3669, 3667, 3659, 3656, 3657, 3641, 3644, 3651, 3638, 3635,
+    3642, 3636, 3633, 3634, 3619, 3619, 3617, 3622, 3620, 3612, 3614, 3603, 3610, 3603, 3590, 3598,
+    3590, 3582, 3577, 3581, 3587, 3569, 3571, 3575, 3563, 3556, 3553, 3554, 3561, 3545, 3551, 3553,
+    3543, 3531, 3535, 3537, 3527, 3526, 3522, 3527, 3513, 3513, 3514, 3502, 3509, 3496, 3494, 3498,
+    3493, 3488, 3487, 3483, 3474, 3469, 3472, 3462, 3467, 3459, 3461, 3446, 3455, 3451, 3449, 3435,
+    3439, 3426, 3432, 3419, 3423, 3415, 3408, 3407, 3411, 3409, 3396, 3401, 3389, 3378, 3391, 3384,
+    3374, 3376, 3375, 3360, 3356, 3354, 3351, 3341, 3342, 3337, 3342, 3329, 3332, 3319, 3320, 3316,
+    3320, 3310, 3310, 3307, 3289, 3299, 3281, 3276, 3283, 3280, 3277, 3262, 3256, 3253, 3261, 3250,
+    3243, 3234, 3240, 3242, 3236, 3219, 3217, 3220, 3209, 3206, 3198, 3206, 3190, 3186, 3179, 3176,
+    3179, 3179, 3162, 3159, 3157, 3153, 3145, 3140, 3150, 3133, 3130, 3126, 3131, 3124, 3117, 3114,
+    3113, 3099, 3100, 3096, 3093, 3090, 3080, 3077, 3067, 3064, 3055, 3062, 3050, 3041, 3034, 3043,
+    3029, 3028, 3019, 3018, 3011, 3004, 2998, 2993, 2997, 2985, 2977, 2984, 2978, 2975, 2964, 2963,
+    2961, 2954, 2944, 2934, 2937, 2924, 2921, 2924, 2908, 2905, 2913, 2897, 2896, 2895, 2878, 2879,
+    2877, 2873, 2867, 2855, 2854, 2842, 2843, 2837, 2841, 2822, 2825, 2811, 2814, 2817, 2810, 2799,
+    2786, 2795, 2791, 2772, 2769, 2775, 2762, 2753, 2747, 2752, 2745, 2734, 2729, 2734, 2729, 2707,
+    2707, 2710, 2702, 2687, 2686, 2688, 2673, 2672, 2669, 2670, 2650, 2647, 2654, 2633, 2640, 2639,
+    2630, 2616, 2606, 2602, 2604, 2598, 2592, 2594, 2589, 2585, 2578, 2564, 2567, 2559, 2543, 2543,
+    2532, 2538, 2531, 2522, 2520, 2513, 2503, 2507, 2487, 2498, 2487, 2486, 2480, 2473, 2466, 2465,
+    2450, 2446, 2444, 2436, 2430, 2417, 2420, 2415, 2402, 2401, 2392, 2392, 2385, 2378, 2366, 2361,
+    2367, 2361, 2352, 2345, 2337, 2339, 2323, 2324, 2317, 2309, 2305, 2309, 2299, 2292, 2281, 2271,
+    2271, 2274, 2258, 2262, 2258, 2240, 2247, 2232, 2232, 2228, 2218, 2207, 2200, 2200, 2186, 2187,
+    2191, 2170, 2172, 2168, 2156, 2156, 2145, 2148, 2144, 2124, 2122, 2119, 2110, 2106, 2097, 2099,
+    2099, 2093, 2074, 2069, 2067, 2061, 2066, 2047, 2054, 2045, 2032, 2023, 2023, 2016, 2020, 2009,
+    1996, 1995, 1995, 1985, 1972, 1973, 1966, 1969, 1959, 1955, 1951, 1946, 1928, 1936, 1928, 1924,
+    1914, 1901, 1894, 1893, 1884, 1889, 1877, 1871, 1867, 1861, 1850, 1847, 1837, 1842, 1828, 1820,
+    1818, 1816, 1811, 1811, 1796, 1788, 1784, 1785, 1775, 1771, 1771, 1761, 1753, 1741, 1746, 1735,
+    1730, 1723, 1718, 1709, 1702, 1698, 1699, 1702, 1692, 1675, 1685, 1674, 1673, 1665, 1659, 1654,
+    1645, 1636, 1640, 1631, 1620, 1621, 1619, 1605, 1605, 1601, 1597, 1581, 1576, 1578, 1572, 1566,
+    1552, 1552, 1550, 1544, 1539, 1533, 1516, 1510, 1507, 1515, 1497, 1494, 1499, 1492, 1479, 1482,
+    1472, 1463, 1461, 1451, 1440, 1446, 1444, 1429, 1424, 1414, 1422, 1413, 1401, 1404, 1387, 1382,
+    1386, 1377, 1377, 1372, 1370, 1355, 1355, 1349, 1339, 1335, 1339, 1327, 1314, 1324, 1318, 1314,
+    1295, 1297, 1293, 1294, 1274, 1276, 1274, 1270, 1267, 1256, 1255, 1253, 1242, 1231, 1231, 1231,
+    1219, 1212, 1209, 1211, 1198, 1197, 1191, 1179, 1179, 1170, 1169, 1158, 1153, 1150, 1156, 1148,
+    1137, 1137, 1135, 1129, 1118, 1111, 1106, 1099, 1094, 1097, 1093, 1090, 1085, 1081, 1077, 1065,
+    1062, 1052, 1060, 1054, 1052, 1034, 1037, 1039, 1023, 1021, 1025, 1013, 1015, 1009, 998, 997,
+    994, 979, 987, 971, 973, 973, 966, 956, 951, 943, 944, 942, 930, 927, 922, 929,
+    913, 915, 917, 910, 895, 889, 893, 885, 889, 878, 872, 867, 861, 864, 861, 847,
+    853, 851, 837, 842, 837, 826, 825, 813, 812, 813, 813, 806, 792, 795, 786, 791,
+    789, 781, 777, 774, 770, 759, 757, 762, 755, 752, 738, 734, 740, 730, 730, 725,
+    714, 719, 719, 704, 701, 699, 694, 702, 683, 692, 675, 676, 680, 667, 668, 658,
+    656, 662, 655, 655, 648, 643, 646, 644, 638, 625, 624, 617, 615, 607, 615, 611,
+    600, 601, 591, 592, 591, 584, 592, 576, 573, 570, 567, 569, 573, 564, 564, 550,
+    557, 550, 554, 547, 544, 534, 531, 529, 521, 525, 523, 516, 515, 509, 507, 513,
+    499, 503, 496, 501, 494, 495, 494, 488, 480, 470, 474, 474, 462, 473, 459, 463,
+    467, 461, 452, 455, 447, 452, 450, 449, 442, 430, 429, 433, 426, 432, 428, 421,
+    422, 414, 422, 411, 415, 403, 398, 402, 393, 406, 389, 401, 397, 388, 392, 385,
+    389, 378, 372, 381, 366, 377, 371, 370, 371, 367, 354, 366, 352, 359, 348, 345,
+    353, 343, 343, 353, 350, 333, 339, 340, 341, 327, 326, 332, 332, 329, 321, 316,
+    315, 325, 318, 310, 308, 312, 317, 313, 311, 306, 313, 310, 301, 308, 305, 308,
+    291, 300, 298, 287, 300, 291, 283, 298, 293, 287, 290, 282, 286, 290, 283, 279,
+    273, 281, 275, 279, 277, 274, 276, 266, 275, 275, 275, 271, 265, 265, 266, 271,
+    260, 263, 266, 268, 254, 269, 258, 256, 266, 258, 265, 254, 258, 253, 252, 261,
+    259, 255, 251, 253, 246, 256, 255, 249, 258, 243, 254, 254, 247, 257, 257, 247,
+    244, 251, 245, 243, 240, 256, 255, 251, 246, 252, 247, 250, 248, 247, 245, 245,
+    241, 253, 246, 242, 249, 253, 254, 246, 254, 248, 251, 250, 258, 247, 243, 257,
+    249, 258, 256, 260, 246, 253, 255, 258, 259, 258, 260, 263, 249, 253, 261, 252,
+    267, 260, 268, 269, 265, 255, 261, 272, 260, 267, 269, 274, 264, 271, 265, 274,
+    278, 277, 273, 267, 268, 270, 274, 284, 280, 276, 278, 284, 290, 283, 293, 288,
+    293, 294, 294, 287, 294, 300, 298, 297, 291, 299, 296, 295, 310, 303, 314, 303,
+    308, 306, 307, 314, 324, 319, 316, 322, 315, 330, 324, 328, 328, 338, 338, 328,
+    329, 335, 342, 341, 341, 348, 343, 350, 346, 354, 347, 352, 363, 367, 366, 367,
+    362, 368, 365, 380, 374, 368, 380, 382, 374, 377, 392, 385, 385, 389, 401, 392,
+    394, 403, 410, 407, 403, 416, 412, 410, 416, 418, 426, 433, 434, 433, 429, 437,
+    435, 438, 449, 450, 442, 456, 448, 453, 459, 458, 473, 469, 472, 474, 479, 486,
+    476, 484, 483, 494, 488, 498, 499, 509, 504, 501, 518, 521, 523, 518, 520, 524,
+    532, 530, 533, 537, 533, 542, 551, 547, 554, 557, 559, 560, 573, 571, 570, 583,
+    573, 584, 591, 595, 597, 593, 594, 608, 604, 615, 609, 619, 619, 629, 630, 629,
+    630, 644, 642, 638, 639, 646, 654, 657, 659, 666, 667, 678, 672, 675, 682, 694,
+    697, 686, 705, 706, 704, 711, 713, 712, 726, 731, 727, 731, 732, 744, 747, 747,
+    758, 761, 761, 769, 770, 779, 773, 782, 787, 782, 799, 796, 794, 809, 802, 819,
+    820, 816, 820, 834, 827, 831, 846, 846, 857, 855, 859, 865, 860, 870, 874, 881,
+    886, 894, 898, 889, 902, 912, 909, 906, 920, 927, 926, 939, 935, 944, 940, 951,
+    953, 950, 959, 973, 972, 983, 985, 992, 991, 988, 999, 1009, 1012, 1009, 1023, 1026,
+    1021, 1030, 1039, 1041, 1046, 1045, 1051, 1064, 1058, 1065, 1067, 1081, 1090, 1092, 1095, 1093,
+    1102, 1107, 1118, 1123, 1120, 1120, 1123, 1134, 1137, 1140, 1145, 1151, 1168, 1173, 1176, 1182,
+    1187, 1190, 1183, 1195, 1202, 1212, 1209, 1212, 1215, 1217, 1227, 1242, 1247, 1241, 1246, 1253,
+    1265, 1267, 1276, 1278, 1283, 1292, 1293, 1303, 1309, 1304, 1318, 1316, 1329, 1329, 1325, 1340,
+    1340, 1350, 1358, 1360, 1363, 1376, 1366, 1377, 1386, 1390, 1403, 1408, 1400, 1413, 1421, 1428,
+    1430, 1428, 1445, 1444, 1452, 1448, 1462, 1462, 1466, 1471, 1489, 1480, 1490, 1497, 1499, 1500,
+    1513, 1512, 1531, 1533, 1542, 1546, 1551, 1554, 1561, 1559, 1574, 1579, 1584, 1585, 1597, 1590,
+    1605, 1601, 1604, 1624, 1630, 1631, 1632, 1631, 1650, 1653, 1647, 1666, 1658, 1674, 1673, 1677,
+    1689, 1692, 1698, 1702, 1704, 1723, 1720, 1727, 1724, 1746, 1741, 1752, 1755, 1752, 1759, 1775,
+    1775, 1791, 1783, 1792, 1793, 1799, 1803, 1813, 1827, 1828, 1837, 1836, 1849, 1849, 1854, 1867,
+    1862, 1877, 1878, 1886, 1896, 1890, 1900, 1901, 1919, 1920, 1915, 1926, 1937, 1941, 1942, 1955,
+    1955, 1963, 1964, 1967, 1975, 1981, 1991, 1991, 2008, 2011, 2009, 2011, 2032, 2034, 2033, 2044,
+    2040, 2054, 2058, 2067, 2072, 2070, 2086, 2095, 2095, 2098, 2099, 2114, 2114, 2129, 2123, 2137,
+    2140, 2136, 2156, 2158, 2156, 2166, 2177, 2170, 2183, 2197, 2191, 2206, 2206, 2216, 2217, 2229,
+    2233, 2230, 2243, 2253, 2254, 2253, 2265, 2266, 2279, 2286, 2283, 2283, 2301, 2309, 2303, 2319,
+    2323, 2318, 2323, 2335, 2343, 2350, 2344, 2365, 2358, 2362, 2367, 2379, 2381, 2389, 2397, 2398,
+    2401, 2409, 2412, 2425, 2427, 2438, 2443, 2442, 2449, 2453, 2462, 2470, 2478, 2472, 2486, 2488,
+    2499, 2493, 2504, 2520, 2509, 2514, 2521, 2540, 2539, 2549, 2546, 2557, 2557, 2570, 2571, 2575,
+    2584, 2587, 2600, 2601, 2612, 2613, 2617, 2628, 2627, 2636, 2631, 2637, 2652, 2653, 2653, 2666,
+    2676, 2675, 2682, 2677, 2691, 2698, 2700, 2708, 2714, 2708, 2714, 2718, 2733, 2734, 2750, 2743,
+    2759, 2751, 2761, 2766, 2781, 2770, 2776, 2780, 2798, 2799, 2801, 2803, 2819, 2815, 2828, 2826,
+    2836, 2841, 2850, 2847, 2854, 2867, 2859, 2873, 2882, 2883, 2882, 2889, 2896, 2898, 2906, 2918,
+    2919, 2914, 2926, 2924, 2930, 2939, 2952, 2945, 2961, 2954, 2968, 2974, 2972, 2979, 2976, 2992,
+    2995, 2998, 3006, 3012, 3012, 3013, 3026, 3019, 3037, 3039, 3038, 3048, 3058, 3048, 3057, 3059,
+    3062, 3071, 3082, 3082, 3081, 3085, 3098, 3097, 3113, 3114, 3120, 3120, 3126, 3124, 3141, 3138,
+    3144, 3141, 3146, 3149, 3164, 3167, 3167, 3177, 3181, 3185, 3183, 3187, 3201, 3207, 3196, 3204,
+    3217, 3215, 3225, 3220, 3228, 3227, 3241, 3250, 3253, 3252, 3247, 3261, 3264, 3264, 3279, 3271,
+    3285, 3279, 3280, 3284, 3295, 3303, 3308, 3316, 3312, 3310, 3316, 3324, 3321, 3333, 3330, 3342,
+    3351, 3348, 3347, 3348, 3359, 3372, 3364, 3378, 3382, 3384, 3390, 3385, 3389, 3386, 3393, 3402,
+    3400, 3415, 3412, 3410, 3421, 3425, 3432, 3439, 3427, 3436, 3447, 3447, 3445, 3451, 3448, 3461,
+    3467, 3470, 3476, 3477, 3475, 3477, 3477, 3488, 3498, 3487, 3504, 3496, 3496, 3515, 3502, 3517,
+    3514, 3523, 3519, 3520, 3529, 3532, 3543, 3544, 3546, 3554, 3541, 3556, 3547, 3556, 3561, 3572,
+    3563, 3573, 3571, 3570, 3584, 3588, 3587, 3583, 3588, 3598, 3596, 3604, 3595, 3605, 3612, 3606,
+    3620, 3614, 3621, 3628, 3631, 3628, 3628, 3638, 3633, 3634, 3635, 3641, 3652, 3645, 3659, 3658,
+    3660, 3652, 3666, 3664, 3659, 3666, 3669, 3675, 3668, 3680, 3673, 3681, 3693, 3696, 3692, 3690,
+    3688, 3701, 3703, 3705, 3706, 3706, 3701, 3703, 3711, 3720, 3724, 3717, 3720, 3723, 3719, 3729,
+    3724, 3727, 3738, 3737, 3745, 3740, 3740, 3748, 3749, 3745, 3753, 3749, 3748, 3755, 3753, 3753,
+    3765, 3754, 3759, 3760, 3763, 3765, 3767, 3768, 3774, 3770, 3784, 3770, 3782, 3778, 3782, 3781,
+    3789, 3790, 3795, 3783, 3784, 3797, 3795, 3800, 3788, 3793, 3795, 3798, 3804, 3800, 3808, 3801,
+    3803, 3802, 3803, 3804, 3813, 3811, 3817, 3819, 3810, 3811, 3824, 3817, 3819, 3827, 3830, 3817,
+    3828, 3821, 3818, 3826, 3823, 3835, 3834, 3826, 3838, 3836, 3837, 3828, 3833, 3836, 3833, 3835,
+    3834, 3843, 3840, 3840, 3843, 3841, 3833, 3848, 3848, 3847, 3834, 3838, 3847, 3844, 3843, 3845,
+    3845, 3849, 3852, 3838, 3853, 3840, 3842, 3845, 3842, 3849, 3854, 3849, 3846, 3852, 3855, 3842,
+    3846, 3843, 3854, 3853, 3855, 3841, 3839, 3851, 3840, 3851, 3840, 3847, 3842, 3846, 3853, 3849,
+    3839, 3850, 3845, 3846, 3845, 3841, 3842, 3837, 3839, 3844, 3840, 3851, 3847, 3839, 3833, 3844,
+    3841, 3840, 3840, 3839, 3842, 3830, 3833, 3831, 3844, 3828, 3827, 3836, 3837, 3841, 3839, 3830,
+    3831, 3824, 3836, 3829, 3829, 3818, 3831, 3828, 3829, 3825, 3825, 3828, 3822, 3817, 3811, 3815,
+    3818, 3815, 3818, 3820, 3819, 3803, 3810, 3810, 3802, 3803, 3808, 3797, 3798, 3807, 3796, 3797,
+    3793, 3788, 3790, 3788, 3792, 3789, 3785, 3786, 3791, 3785, 3778, 3780, 3787, 3779, 3780, 3771,
+    3772, 3776, 3768, 3773, 3761, 3766, 3767, 3765, 3752, 3750, 3761, 3755, 3754, 3748, 3744, 3755,
+    3745, 3751, 3745, 3746, 3736, 3742, 3730, 3726, 3724, 3728, 3732, 3717, 3728, 3722, 3725, 3722,
+    3717, 3702, 3700, 3699, 3701, 3694, 3697, 3689, 3699, 3698, 3683, 3684, 3694, 3681, 3689, 3685,
+    3677, 3672, 3667, 3662, 3671, 3657, 3659, 3663, 3657, 3655, 3647, 3655, 3645, 3640, 3634, 3644,
+    3636, 3641, 3630, 3635, 3619, 3630, 3618, 3613, 3620, 3614, 3603, 3603, 3600, 3605, 3589, 3587,
+    3593, 3582, 3590, 3581, 3582, 3584, 3577, 3574, 3570, 3569, 3562, 3554, 3561, 3544, 3555, 3538,
+    3537, 3539, 3528, 3538, 3525, 3529, 3515, 3524, 3511, 3522, 3510, 3514, 3512, 3498, 3501, 3492,
+    3496, 3483, 3476, 3480, 3469, 3472, 3477, 3474, 3460, 3464, 3461, 3452, 3449, 3440, 3444, 3444,
+    3426, 3439, 3432, 3424, 3423, 3419, 3421, 3413, 3407, 3395, 3399, 3387, 3396, 3387, 3390, 3377,
+    3375, 3370, 3373, 3370, 3352, 3362, 3350, 3347, 3343, 3344, 3331, 3328, 3329, 3319, 3327, 3310,
+    3313, 3313, 3305, 3295, 3304, 3300, 3295, 3288, 3272, 3270, 3277, 3270, 3266, 3267, 3262, 3247,
+    3242, 3247, 3241, 3230, 3226, 3229, 3219, 3219, 3212, 3214, 3205, 3201, 3187, 3191, 3189, 3176,
+    3172, 3180, 3161, 3159, 3156, 3149, 3151, 3152, 3145, 3129, 3137, 3129, 3119, 3119, 3117, 3109,
+    3101, 3102, 3088, 3089, 3079, 3084, 3076, 3077, 3064, 3058, 3065, 3057, 3042, 3041, 3039, 3044,
+    3035, 3019, 3015, 3014, 3012, 3013, 2996, 2991, 2998, 2980, 2991, 2970, 2972, 2977, 2958, 2963,
+    2953, 2942, 2951, 2942, 2932, 2928, 2930, 2920, 2910, 2903, 2898, 2907, 2894, 2893, 2879, 2877,
+    2882, 2874, 2871, 2858, 2858, 2856, 2836, 2837, 2837, 2833, 2827, 2823, 2821, 2817, 2805, 2793,
+    2797, 2796, 2779, 2780, 2766, 2764, 2757, 2754, 2755, 2751, 2740, 2732, 2729, 2728, 2725, 2711,
+    2712, 2700, 2704, 2695, 2691, 2681, 2678, 2680, 2672, 2661, 2664, 2654, 2651, 2647, 2633, 2633,
+    2632, 2617, 2616, 2605, 2611, 2606, 2588, 2588, 2582, 2584, 2570, 2571, 2569, 2559, 2555, 2541,
+    2537, 2532, 2527, 2523, 2524, 2511, 2502, 2503, 2498, 2483, 2488, 2474, 2475, 2463, 2454, 2462,
+    2446, 2438, 2444, 2443, 2422, 2416, 2421, 2413, 2404, 2408, 2394, 2384, 2384, 2372, 2374, 2363,
+    2358, 2353, 2353, 2340, 2334, 2330, 2325, 2318, 2323, 2316, 2309, 2295, 2302, 2294, 2279, 2286,
+    2277, 2262, 2269, 2255, 2251, 2239, 2234, 2242, 2230, 2225, 2215, 2204, 2205, 2193, 2201, 2190,
+    2189, 2181, 2173, 2168, 2166, 2149, 2149, 2146, 2135, 2127, 2125, 2121, 2117, 2103, 2100, 2106,
+    2090, 2081, 2082, 2071, 2071, 2069, 2063, 2055, 2053, 2038, 2038, 2026, 2030, 2012, 2010, 2014,
+    2006, 1994, 1997, 1988, 1974, 1979, 1963, 1961, 1959, 1957, 1939, 1938, 1938, 1933, 1931, 1921,
+    1914, 1898, 1895, 1900, 1892, 1881, 1874, 1876, 1865, 1860, 1856, 1843, 1836, 1846, 1834, 1836,
+    1816, 1815, 1816, 1800, 1793, 1801, 1789, 1785, 1784, 1779, 1768, 1755, 1747, 1745, 1746, 1735,
+    1726, 1732, 1717, 1713, 1716, 1713, 1697, 1702, 1691, 1688, 1675, 1678, 1660, 1662, 1661, 1656,
+    1645, 1637, 1625, 1634, 1628, 1619, 1607, 1606, 1602, 1593, 1586, 1585, 1576, 1566, 1573, 1562,
+    1560, 1547, 1545, 1544, 1534, 1532, 1519, 1515, 1513, 1503, 1508, 1497, 1487, 1478, 1481, 1481,
+    1474, 1458, 1452, 1454, 1447, 1446, 1439, 1436, 1427, 1430, 1419, 1414, 1402, 1401, 1398, 1388,
+    1392, 1376, 1381, 1371, 1366, 1352, 1345, 1340, 1342, 1335, 1325, 1335, 1322, 1312, 1307, 1304,
+    1301, 1295, 1298, 1289, 1286, 1274, 1269, 1273, 1261, 1255, 1254, 1247, 1232, 1230, 1232, 1217,
+    1225, 1218, 1207, 1209, 1203, 1197, 1187, 1179, 1183, 1172, 1176, 1171, 1166, 1154, 1147, 1150,
+    1143, 1141, 1128, 1121, 1122, 1112, 1108, 1110, 1099, 1102, 1089, 1095, 1078, 1083, 1066, 1067,
+    1056, 1057, 1050, 1050, 1038, 1039, 1029, 1027, 1032, 1025, 1021, 1013, 1008, 1010, 1004, 995,
+    990, 984, 980, 978, 967, 959, 956, 965, 961, 950, 943, 937, 933, 933, 926, 920,
+    922, 913, 902, 906, 896, 895, 895, 893, 883, 881, 866, 871, 872, 859, 862, 853,
+    846, 838, 841, 833, 833, 820, 822, 819, 810, 819, 801, 806, 795, 789, 797, 787,
+    780, 780, 772, 775, 768, 762, 760, 747, 757, 752, 737, 737, 739, 736, 721, 731,
+    713, 713, 718, 705, 697, 696, 695, 695, 697, 689, 682, 672, 667, 677, 664, 659,
+    668, 650, 645, 652, 653, 642, 631, 635, 626, 636, 623, 624, 625, 619, 616, 614,
+    600, 593, 596, 598, 596, 594, 586, 589, 578, 573, 566, 564, 566, 555, 565, 554,
+    555, 546, 546, 540, 545, 530, 539, 527, 520, 528, 522, 527, 514, 511, 515, 514,
+    510, 503, 505, 502, 500, 484, 486, 479, 473, 483, 480, 474, 462, 461, 458, 470,
+    466, 457, 452, 459, 457, 453, 449, 445, 444, 435, 441, 430, 435, 422, 421, 425,
+    419, 408, 416, 406, 409, 403, 407, 400, 398, 392, 394, 401, 396, 385, 392, 392,
+    386, 386, 370, 373, 366, 364, 370, 369, 369, 357, 360, 366, 364, 356, 347, 348,
+    354, 342, 350, 340, 348, 339, 344, 337, 336, 326, 331, 337, 324, 333, 319, 328,
+    330, 314, 313, 318, 310, 319, 309, 303, 316, 314, 307, 297, 307, 296, 306, 298,
+    296, 300, 299, 289, 286, 285, 285, 292, 294, 284, 281, 284, 284, 288, 280, 284,
+    286, 284, 281, 281, 269, 272, 273, 273, 270, 275, 264, 277, 270, 260, 269, 273,
+    262, 270, 257, 259, 262, 258, 266, 260, 254, 262, 252, 253, 259, 258, 262, 249,
+    251, 249, 251, 257, 261, 251, 251, 257, 256, 250, 251, 257, 250, 241, 241, 254,
+    255, 256, 244, 256, 242, 244, 254, 246, 252, 247, 248, 245, 254, 246, 251, 247,
+    241, 250, 255, 250, 241, 250, 247, 253, 250, 244, 245, 250, 253, 245, 251, 251,
+    252, 250, 251, 247, 254, 251, 251, 253, 253, 248, 255, 255, 260, 263, 255, 262,
+    256, 261, 257, 268, 255, 262, 261, 258, 264, 260, 260, 274, 270, 274, 275, 271,
+    279, 276, 272, 278, 274, 271, 273, 271, 284, 273, 286, 278, 286, 278, 288, 287,
+    281, 282, 299, 297, 286, 298, 296, 303, 301, 295, 297, 300, 307, 300, 302, 302,
+    310, 312, 320, 307, 319, 314, 314, 320, 330, 328, 329, 320, 335, 328, 331, 329,
+    333, 331, 332, 335, 344, 349, 341, 354, 346, 353, 358, 350, 362, 363, 356, 356,
+    363, 374, 363, 380, 369, 381, 377, 383, 383, 378, 382, 383, 397, 397, 397, 400,
+    396, 400, 402, 412, 413, 420, 409, 412, 417, 413, 417, 429, 435, 424, 436, 432,
+    447, 448, 437, 452, 449, 450, 453, 464, 464, 464, 470, 474, 466, 481, 477, 481,
+    478, 477, 483, 497, 498, 497, 495, 501, 504, 512, 508, 518, 521, 511, 530, 533,
+    526, 523, 529, 541, 544, 549, 550, 557, 558, 551, 561, 563, 572, 565, 569, 569,
+    574, 581, 593, 596, 596, 598, 605, 597, 611, 601, 615, 621, 621, 629, 619, 624,
+    626, 644, 644, 651, 653, 653, 655, 659, 660, 657, 665, 664, 668, 672, 681, 686,
+    692, 696, 698, 705, 698, 702, 713, 716, 713, 718, 727, 739, 735, 747, 742, 740,
+    743, 748, 756, 766, 761, 775, 777, 778, 791, 794, 792, 793, 804, 808, 801, 807,
+    818, 812, 817, 836, 835, 840, 844, 840, 850, 856, 851, 853, 873, 864, 875, 880,
+    876, 892, 888, 893, 908, 896, 913, 919, 926, 930, 918, 925, 940, 933, 944, 947,
+    961, 950, 959, 966, 972, 984, 974, 984, 986, 994, 995, 997, 1014, 1010, 1025, 1017,
+    1034, 1023, 1038, 1032, 1037, 1053, 1061, 1065, 1069, 1077, 1069, 1080, 1084, 1083, 1101, 1094,
+    1103, 1100, 1109, 1114, 1123, 1123, 1137, 1135, 1146, 1142, 1153, 1157, 1168, 1165, 1165, 1180,
+    1182, 1180, 1186, 1192, 1193, 1208, 1206, 1207, 1216, 1217, 1238, 1235, 1233, 1241, 1248, 1261,
+    1266, 1265, 1274, 1275, 1284, 1282, 1286, 1290, 1307, 1315, 1306, 1313, 1323, 1328, 1329, 1342,
+    1343, 1352, 1356, 1361, 1368, 1374, 1366, 1388, 1391, 1383, 1403, 1400, 1398, 1407, 1413, 1425,
+    1427, 1435, 1436, 1436, 1453, 1449, 1458, 1464, 1469, 1468, 1479, 1482, 1494, 1489, 1510, 1505,
+    1518, 1521, 1517, 1535, 1526, 1537, 1538, 1554, 1554, 1556, 1567, 1565, 1584, 1579, 1591, 1598,
+    1597, 1603, 1611, 1619, 1627, 1621, 1633, 1637, 1647, 1644, 1652, 1660, 1666, 1672, 1676, 1674,
+    1691, 1701, 1691, 1703, 1710, 1716, 1717, 1728, 1731, 1739, 1740, 1742, 1748, 1756, 1768, 1780,
+    1771, 1781, 1787, 1802, 1793, 1811, 1817, 1816, 1817, 1836, 1839, 1842, 1847, 1856, 1855, 1869,
+    1871, 1875, 1873, 1884, 1883, 1900, 1899, 1913, 1920, 1920, 1926, 1927, 1933, 1945, 1938, 1946,
+    1961, 1965, 1964, 1975, 1979, 1981, 1986, 2002, 2009, 2010, 2020, 2013, 2022, 2032, 2033, 2034,
+    2050, 2049, 2057, 2068, 2069, 2078, 2082, 2092, 2096, 2090, 2107, 2112, 2110, 2123, 2124, 2140,
+    2135, 2149, 2147, 2155, 2163, 2165, 2166, 2184, 2188, 2183, 2196, 2200, 2212, 2212, 2220, 2231,
+    2234, 2234, 2232, 2246, 2256, 2262, 2262, 2269, 2278, 2282, 2285, 2294, 2303, 2293, 2308, 2314,
+    2316, 2329, 2330, 2341, 2337, 2351, 2353, 2355, 2362, 2361, 2376, 2375, 2381, 2383, 2393, 2396,
+    2403, 2413, 2416, 2416, 2431, 2439, 2437, 2445, 2443, 2450, 2459, 2460, 2467, 2486, 2477, 2489,
+    2503, 2503, 2510, 2516, 2513, 2520, 2528, 2527, 2535, 2541, 2557, 2547, 2564, 2567, 2569, 2583,
+};
+
+// Slow sensor: a random walk of up to 2 LSB every 32 samples with +-3 LSB of noise
+static const uint16_t trace_slow[TRACE_LEN] = {
+    1402, 1405, 1403, 1402, 1404, 1399, 1400, 1402, 1404, 1400, 1405, 1405, 1399, 1400, 1400, 1403,
+    1399, 1401, 1399, 1405, 1403, 1403, 1405, 1405, 1401, 1403, 1403, 1403, 1400, 1404, 1402, 1404,
+    1403, 1400, 1399, 1402, 1402, 1399, 1399, 1400, 1403, 1398, 1397, 1402, 1398, 1397, 1400, 1403,
+    1398, 1397, 1397, 1402, 1397, 1400, 1402, 1403, 1403, 1397, 1397, 1402, 1403, 1402, 1400, 1400,
+    1402, 1402, 1397, 1401, 1396, 1402, 1399, 1401, 1400, 1399, 1402, 1399, 1398, 1400, 1397, 1400,
+    1400, 1400, 1399, 1400, 1402, 1398, 1399, 1399, 1396, 1400, 1399, 1402, 1396, 1397, 1402, 1402,
+    1401, 1402, 1398, 1401, 1398, 1401, 1404, 1404, 1400, 1399, 1402, 1404, 1401, 1402, 1401, 1400,
+    1401, 1399, 1398, 1402, 1403, 1400, 1401, 1401, 1401, 1403, 1398, 1398, 1404, 1403, 1400, 1399,
+    1399, 1403, 1403, 1405, 1405, 1401, 1401, 1404, 1399, 1405, 1402, 1402, 1401, 1401, 1401, 1402,
+    1402, 1403, 1403, 1400, 1400, 1401, 1400, 1404, 1400, 1402, 1403, 1401, 1401, 1404, 1403, 1403,
+    1400, 1402, 1398, 1398, 1399, 1398, 1400, 1403, 1401, 1401, 1403, 1399, 1402, 1402, 1398, 1402,
+    1403, 1402, 1397, 1397, 1403, 1402, 1398, 1401, 1403, 1397, 1398, 1399, 1400, 1398, 1397, 1399,
+    1395, 1400, 1400, 1400, 1398, 1399, 1396, 1398, 1400, 1401, 1400, 1400, 1397, 1398, 1398, 1401,
+    1401, 1398, 1396, 1399, 1401, 1401, 1397, 1397, 1397, 1395, 1396, 1401, 1400, 1397, 1397, 1400,
+    1394, 1395, 1398, 1397, 1400, 1399, 1399, 1394, 1398, 1398, 1394, 1399, 1400, 1396, 1399, 1395,
+    1396, 1399, 1400, 1398, 1394, 1398, 1399, 1396, 1395, 1400, 1396, 1397, 1396, 1395, 1398, 1395,
+    1398, 1395, 1394, 1399, 1398, 1396, 1396, 1400, 1400, 1399, 1395, 1398, 1397, 1394, 1399, 1394,
+    1398, 1395, 1398, 1396, 1396, 1398, 1394, 1397, 1398, 1400, 1398, 1396, 1398, 1398, 1399, 1398,
+    1396, 1397, 1394, 1398, 1393, 1397, 1399, 1399, 1396, 1398, 1397, 1398, 1398, 1395, 1397, 1395,
+    1395, 1398, 1399, 1399, 1396, 1399, 1398, 1395, 1394, 1398, 1396, 1398, 1394, 1397, 1399, 1398,
+    1399, 1396, 1398, 1400, 1396, 1399, 1395, 1400, 1396, 1395, 1396, 1395, 1396, 1399, 1397, 1399,
+    1398, 1401, 1399, 1399, 1399, 1396, 1400, 1398, 1400, 1400, 1397, 1398, 1396, 1397, 1396, 1397,
+    1398, 1395, 1395, 1396, 1399, 1399, 1399, 1399, 1393, 1393, 1394, 1396, 1396, 1398, 1396, 1399,
+    1396, 1397, 1394, 1395, 1395, 1397, 1396, 1398, 1397, 1395, 1396, 1394, 1399, 1399, 1397, 1393,
+    1394, 1395, 1396, 1396, 1395, 1392, 1397, 1393, 1394, 1397, 1395, 1394, 1393, 1392, 1392, 1396,
+    1397, 1398, 1392, 1392, 1398, 1392, 1393, 1395, 1397, 1395, 1394, 1393, 1397, 1396, 1397, 1397,
+    1392, 1396, 1396, 1395, 1392, 1391, 1394, 1394, 1393, 1392, 1394, 1392, 1394, 1394, 1393, 1391,
+    1391, 1391, 1393, 1390, 1390, 1392, 1390, 1394, 1394, 1393, 1393, 1394, 1396, 1395, 1393, 1396,
+    1392, 1391, 1392, 1395, 1393, 1394, 1395, 1395, 1395, 1396, 1396, 1396, 1395, 1396, 1394, 1392,
+    1390, 1394, 1393, 1392, 1396, 1392, 1396, 1394, 1391, 1390, 1394, 1395, 1394, 1392, 1391, 1392,
+    1395, 1396, 1392, 1392, 1393, 1395, 1395, 1397, 1395, 1397, 1396, 1397, 1394, 1393, 1396, 1392,
+    1393, 1397, 1395, 1397, 1398, 1393, 1396, 1397, 1393, 1393, 1393, 1397, 1397, 1398, 1396, 1396,
+    1400, 1400, 1397, 1400, 1399, 1399, 1394, 1399, 1395, 1398, 1400, 1400, 1398, 1398, 1400, 1396,
+    1395, 1394, 1396, 1398, 1397, 1394, 1394, 1397, 1394, 1394, 1398, 1394, 1395, 1400, 1399, 1394,
+    1398, 1396, 1395, 1394, 1396, 1392, 1398, 1395, 1394, 1394, 1392, 1394, 1398, 1395, 1397, 1393,
+    1394, 1396, 1397, 1393, 1394, 1395, 1396, 1396, 1397, 1392, 1398, 1398, 1393, 1392, 1396, 1396,
+    1395, 1394, 1393, 1395, 1395, 1393, 1392, 1391, 1392, 1395, 1393, 1394, 1391, 1393, 1392, 1395,
+    1397, 1392, 1391, 1395, 1394, 1392, 1395, 1394, 1396, 1394, 1395, 1393, 1392, 1397, 1397, 1393,
+    1396, 1392, 1392, 1391, 1390, 1395, 1395, 1392, 1394, 1392, 1393, 1394, 1393, 1390, 1393, 1392,
+    1392, 1395, 1394, 1390, 1392, 1393, 1391, 1396, 1393, 1393, 1395, 1390, 1392, 1395, 1396, 1391,
+    1396, 1394, 1396, 1390, 1391, 1393, 1392, 1395, 1390, 1391, 1392, 1390, 1392, 1395, 1394, 1395,
+    1392, 1394, 1392, 1394, 1393, 1394, 1394, 1393, 1391, 1391, 1395, 1393, 1395, 1394, 1395, 1394,
+    1394, 1392, 1390, 1393, 1393, 1392, 1390, 1391, 1394, 1390, 1388, 1392, 1388, 1393, 1392, 1390,
+    1388, 1392, 1392, 1390, 1389, 1389, 1388, 1393, 1393, 1389, 1392, 1388, 1391, 1389, 1390, 1392,
+    1390, 1395, 1390, 1393, 1391, 1394, 1390, 1391, 1394, 1396, 1394, 1392, 1391, 1392, 1394, 1396,
+    1393, 1395, 1396, 1393, 1390, 1392, 1392, 1395, 1392, 1393, 1392, 1393, 1392, 1390, 1396, 1391,
+    1394, 1389, 1392, 1395, 1393, 1390, 1393, 1390, 1391, 1392, 1392, 1395, 1392, 1389, 1392, 1394,
+    1389, 1389, 1394, 1395, 1390, 1390, 1393, 1389, 1389, 1391, 1391, 1391, 1395, 1391, 1395, 1390,
+    1389, 1390, 1394, 1394, 1394, 1389, 1392, 1394, 1394, 1392, 1389, 1388, 1394, 1390, 1391, 1393,
+    1393, 1392, 1393, 1392, 1388, 1390, 1394, 1389, 1388, 1392, 1389, 1389, 1388, 1393, 1394, 1391,
+    1388, 1388, 1392, 1386, 1389, 1391, 1389, 1390, 1387, 1388, 1390, 1388, 1391, 1391, 1388, 1392,
+    1388, 1392, 1391, 1390, 1392, 1391, 1391, 1386, 1390, 1390, 1389, 1390, 1386, 1390, 1388, 1387,
+    1392, 1392, 1387, 1387, 1390, 1391, 1393, 1390, 1389, 1388, 1391, 1388, 1388, 1388, 1392, 1391,
+    1389, 1389, 1388, 1388, 1392, 1389, 1387, 1392, 1390, 1389, 1391, 1389, 1391, 1390, 1392, 1393,
+    1394, 1390, 1391, 1390, 1392, 1392, 1391, 1394, 1392, 1392, 1394, 1388, 1390, 1390, 1388, 1389,
+    1394, 1391, 1392, 1389, 1392, 1392, 1391, 1391, 1393, 1393, 1389, 1389, 1388, 1392, 1390, 1393,
+    1394, 1395, 1393, 1391, 1394, 1395, 1395, 1390, 1391, 1395, 1393, 1393, 1389, 1391, 1393, 1392,
+    1395, 1391, 1391, 1389, 1389, 1390, 1394, 1389, 1394, 1393, 1393, 1389, 1389, 1392, 1391, 1389,
+    1394, 1397, 1392, 1395, 1391, 1393, 1394, 1394, 1392, 1392, 1394, 1394, 1393, 1394, 1395, 1391,
+    1396, 1395, 1394, 1394, 1392, 1396, 1396, 1391, 1397, 1397, 1391, 1392, 1394, 1392, 1396, 1392,
+    1391, 1392, 1396, 1393, 1396, 1396, 1393, 1395, 1395, 1395, 1394, 1393, 1390, 1392, 1390, 1395,
+    1393, 1390, 1396, 1396, 1394, 1396, 1391, 1394, 1393, 1392, 1393, 1392, 1392, 1390, 1396, 1394,
+    1389, 1392, 1389, 1390, 1394, 1390, 1392, 1390, 1389, 1390, 1393, 1388, 1389, 1391, 1394, 1390,
+    1392, 1394, 1389, 1393, 1388, 1394, 1388, 1388, 1389, 1390, 1392, 1393, 1394, 1388, 1392, 1394,
+    1393, 1389, 1392, 1394, 1395, 1390, 1391, 1394, 1391, 1394, 1393, 1391, 1394, 1393, 1389, 1390,
+    1390, 1391, 1389, 1392, 1395, 1395, 1390, 1392, 1391, 1395, 1389, 1393, 1391, 1389, 1389, 1392,
+    1396, 1393, 1397, 1391, 1392, 1391, 1397, 1394, 1391, 1394, 1395, 1392, 1395, 1393, 1395, 1393,
+    1397, 1396, 1397, 1391, 1394, 1397, 1395, 1391, 1396, 1392, 1394, 1394, 1393, 1393, 1395, 1396,
+    1392, 1390, 1393, 1389, 1389, 1392, 1392, 1393, 1394, 1389, 1391, 1393, 1390, 1389, 1391, 1393,
+    1395, 1392, 1389, 1392, 1395, 1390, 1395, 1389, 1395, 1391, 1393, 1393, 1394, 1394, 1395, 1389,
+    1392, 1392, 1394, 1390, 1392, 1390, 1395, 1393, 1391, 1395, 1393, 1389, 1395, 1390, 1394, 1395,
+    1393, 1389, 1391, 1391, 1390, 1390, 1390, 1393, 1395, 1391, 1395, 1389, 1395, 1391, 1393, 1389,
+    1396, 1394, 1397, 1395, 1395, 1391, 1396, 1393, 1397, 1395, 1392, 1392, 1394, 1397, 1391, 1393,
+    1395, 1394, 1394, 1391, 1395, 1395, 1397, 1392, 1393, 1395, 1396, 1393, 1391, 1397, 1392, 1395,
+    1392, 1394, 1397, 1395, 1394, 1394, 1396, 1394, 1394, 1396, 1394, 1395, 1393, 1395, 1397, 1393,
+    1396, 1397, 1395, 1398, 1398, 1398, 1393, 1394, 1398, 1394, 1393, 1396, 1392, 1392, 1393, 1395,
+    1395, 1398, 1399, 1397, 1398, 1395, 1396, 1394, 1393, 1398, 1399, 1395, 1395, 1393, 1396, 1394,
+    1399, 1395, 1399, 1393, 1398, 1395, 1398, 1394, 1397, 1396, 1397, 1394, 1398, 1398, 1399, 1398,
+    1396, 1401, 1396, 1399, 1395, 1399, 1398, 1396, 1398, 1396, 1401, 1398, 1401, 1396, 1398, 1396,
+    1401, 1400, 1396, 1400, 1401, 1400, 1398, 1401, 1397, 1400, 1401, 1396, 1401, 1400, 1397, 1398,
+    1394, 1393, 1395, 1398, 1397, 1393, 1398, 1397, 1395, 1395, 1397, 1394, 1398, 1397, 1397, 1398,
+    1395, 1395, 1393, 1396, 1397, 1395, 1395, 1398, 1394, 1393, 1394, 1398, 1394, 1394, 1396, 1395,
+    1397, 1393, 1397, 1398, 1394, 1398, 1394, 1399, 1396, 1397, 1395, 1393, 1398, 1399, 1397, 1399,
+    1394, 1397, 1394, 1397, 1399, 1399, 1398, 1394, 1396, 1399, 1394, 1396, 1395, 1398, 1398, 1399,
+    1393, 1396, 1395, 1396, 1398, 1394, 1394, 1395, 1393, 1395, 1394, 1398, 1396, 1395, 1395, 1393,
+    1394, 1398, 1395, 1398, 1397, 1393, 1399, 1396, 1393, 1395, 1393, 1397, 1398, 1397, 1399, 1395,
+    1401, 1400, 1397, 1397, 1400, 1397, 1396, 1397, 1400, 1400, 1397, 1398, 1399, 1396, 1398, 1401,
+    1399, 1398, 1400, 1398, 1396, 1397, 1395, 1399, 1396, 1397, 1398, 1399, 1396, 1400, 1397, 1397,
+    1396, 1400, 1400, 1399, 1396, 1399, 1396, 1397, 1395, 1399, 1400, 1395, 1398, 1399, 1394, 1400,
+    1397, 1395, 1396, 1398, 1397, 1395, 1399, 1396, 1397, 1394, 1396, 1397, 1398, 1397, 1399, 1394,
+    1398, 1398, 1395, 1396, 1400, 1395, 1395, 1400, 1395, 1400, 1399, 1400, 1401, 1395, 1397, 1400,
+    1400, 1398, 1400, 1395, 1397, 1395, 1398, 1395, 1397, 1398, 1400, 1399, 1397, 1400, 1396, 1395,
+    1401, 1398, 1401, 1400, 1401, 1397, 1396, 1399, 1398, 1401, 1400, 1396, 1397, 1402, 1402, 1400,
+    1397, 1402, 1402, 1398, 1401, 1397, 1399, 1402, 1402, 1401, 1402, 1402, 1402, 1401, 1397, 1397,
+    1401, 1400, 1401, 1402, 1399, 1397, 1400, 1401, 1400, 1397, 1402, 1399, 1396, 1400, 1399, 1396,
+    1396, 1402, 1396, 1399, 1401, 1400, 1402, 1397, 1397, 1399, 1396, 1398, 1402, 1401, 1396, 1398,
+    1404, 1401, 1402, 1401, 1404, 1404, 1403, 1399, 1401, 1401, 1401, 1403, 1400, 1401, 1403, 1402,
+    1402, 1398, 1404, 1399, 1402, 1404, 1403, 1402, 1403, 1404, 1399, 1401, 1401, 1400, 1404, 1403,
+    1401, 1401, 1398, 1402, 1397, 1398, 1398, 1396, 1398, 1399, 1401, 1396, 1400, 1402, 1399, 1397,
+    1397, 1400, 1401, 1397, 1401, 1402, 1397, 1402, 1396, 1400, 1398, 1399, 1401, 1399, 1401, 1401,
+    1399, 1399, 1397, 1396, 1397, 1397, 1401, 1398, 1399, 1397, 1401, 1399, 1396, 1397, 1398, 1399,
+    1398, 1398, 1397, 1400, 1395, 1396, 1400, 1400, 1397, 1396, 1398, 1397, 1398, 1395, 1397, 1395,
+    1395, 1399, 1394, 1394, 1394, 1398, 1400, 1399, 1400, 1399, 1400, 1399, 1395, 1397, 1395, 1394,
+    1395, 1396, 1400, 1396, 1396, 1396, 1396, 1394, 1394, 1399, 1399, 1395, 1396, 1399, 1397, 1399,
+    1399, 1398, 1396, 1396, 1399, 1395, 1396, 1394, 1395, 1394, 1397, 1395, 1397, 1396, 1399, 1398,
+    1399, 1396, 1394, 1400, 1399, 1397, 1396, 1395, 1397, 1399, 1398, 1400, 1400, 1396, 1398, 1400,
+    1396, 1398, 1397, 1399, 1401, 1396, 1398, 1396, 1396, 1400, 1401, 1400, 1399, 1400, 1399, 1400,
+    1401, 1399, 1399, 1401, 1396, 1398, 1396, 1397, 1400, 1397, 1397, 1401, 1399, 1398, 1396, 1398,
+    1400, 1399, 1398, 1396, 1399, 1395, 1396, 1394, 1395, 1398, 1395, 1400, 1396, 1400, 1394, 1395,
+    1400, 1394, 1398, 1397, 1394, 1399, 1400, 1397, 1399, 1395, 1398, 1400, 1394, 1395, 1400, 1400,
+    1395, 1399, 1396, 1396, 1394, 1395, 1394, 1394, 1397, 1394, 1395, 1396, 1399, 1397, 1399, 1393,
+    1394, 1399, 1399, 1397, 1394, 1396, 1399, 1398, 1394, 1397, 1396, 1394, 1398, 1397, 1394, 1394,
+    1393, 1396, 1397, 1394, 1395, 1396, 1396, 1393, 1397, 1394, 1399, 1395, 1394, 1396, 1395, 1395,
+    1395, 1399, 1393, 1394, 1399, 1394, 1396, 1398, 1398, 1398, 1395, 1394, 1393, 1397, 1396, 1398,
+    1394, 1396, 1391, 1394, 1394, 1394, 1395, 1392, 1392, 1394, 1391, 1395, 1391, 1397, 1392, 1394,
+    1393, 1391, 1392, 1395, 1391, 1395, 1394, 1391, 1396, 1396, 1397, 1397, 1397, 1394, 1396, 1393,
+    1397, 1395, 1392, 1396, 1398, 1397, 1398, 1395, 1394, 1392, 1395, 1397, 1393, 1396, 1393, 1396,
+    1395, 1396, 1396, 1394, 1393, 1394, 1392, 1393, 1394, 1397, 1393, 1394, 1392, 1397, 1394, 1393,
+    1396, 1394, 1394, 1396, 1397, 1398, 1394, 1399, 1400, 1396, 1399, 1395, 1396, 1397, 1394, 1396,
+    1395, 1400, 1399, 1395, 1394, 1395, 1397, 1397, 1400, 1396, 1400, 1399, 1396, 1395, 1397, 1394,
+    1401, 1395, 1396, 1398, 1396, 1396, 1398, 1401, 1395, 1399, 1395, 1397, 1396, 1401, 1397, 1395,
+    1399, 1395, 1399, 1397, 1400, 1395, 1395, 1401, 1395, 1400, 1401, 1396, 1399, 1395, 1397, 1401,
+    1397, 1396, 1395, 1397, 1393, 1398, 1397, 1397, 1395, 1398, 1393, 1395, 1393, 1396, 1396, 1397,
+    1395, 1393, 1395, 1396, 1398, 1399, 1397, 1395, 1398, 1399, 1393, 1395, 1396, 1398, 1394, 1395,
+    1401, 1397, 1399, 1395, 1399, 1396, 1395, 1400, 1401, 1395, 1396, 1398, 1398, 1400, 1399, 1395,
+    1400, 1396, 1396, 1395, 1395, 1397, 1395, 1397, 1395, 1395, 1400, 1399, 1396, 1399, 1401, 1399,
+    1396, 1399, 1394, 1394, 1400, 1394, 1396, 1400, 1394, 1400, 1395, 1394, 1397, 1400, 1399, 1394,
+    1396, 1399, 1394, 1397, 1394, 1397, 1394, 1396, 1396, 1398, 1400, 1397, 1399, 1399, 1400, 1397,
+    1397, 1394, 1395, 1399, 1398, 1398, 1394, 1396, 1395, 1395, 1396, 1400, 1396, 1400, 1395, 1398,
+    1400, 1398, 1399, 1395, 1400, 1394, 1394, 1396, 1399, 1399, 1396, 1397, 1399, 1398, 1398, 1395,
+    1398, 1401, 1401, 1399, 1401, 1396, 1396, 1396, 1402, 1396, 1400, 1398, 1400, 1397, 1402, 1400,
+    1402, 1396, 1400, 1402, 1396, 1399, 1402, 1397, 1400, 1396, 1400, 1400, 1400, 1398, 1398, 1401,
+    1397, 1401, 1400, 1397, 1399, 1402, 1397, 1402, 1399, 1402, 1401, 1401, 1403, 1399, 1397, 1400,
+    1399, 1402, 1397, 1401, 1401, 1403, 1398, 1403, 1402, 1403, 1397, 1399, 1397, 1397, 1397, 1398,
+    1399, 1401, 1405, 1401, 1403, 1401, 1401, 1401, 1403, 1400, 1404, 1404, 1402, 1403, 1405, 1402,
+    1401, 1403, 1403, 1402, 1400, 1402, 1403, 1400, 1399, 1403, 1402, 1400, 1405, 1400, 1404, 1405,
+    1401, 1403, 1399, 1404, 1402, 1399, 1403, 1401, 1401, 1399, 1404, 1399, 1403, 1404, 1403, 1400,
+    1400, 1401, 1402, 1405, 1400, 1404, 1400, 1399, 1403, 1403, 1399, 1405, 1405, 1401, 1399, 1405,
+    1400, 1400, 1401, 1404, 1398, 1403, 1403, 1403, 1398, 1402, 1398, 1402, 1401, 1399, 1404, 1401,
+    1401, 1399, 1404, 1398, 1401, 1404, 1402, 1404, 1404, 1400, 1401, 1400, 1404, 1398, 1400, 1399,
+    1399, 1405, 1405, 1401, 1400, 1405, 1399, 1401, 1402, 1405, 1403, 1402, 1401, 1399, 1399, 1403,
+    1401, 1403, 1401, 1402, 1401, 1401, 1405, 1405, 1405, 1403, 1405, 1401, 1402, 1403, 1402, 1403,
+    1400, 1399, 1399, 1398, 1403, 1402, 1402, 1399, 1404, 1400, 1401, 1399, 1402, 1398, 1401, 1404,
+    1399, 1403, 1403, 1404, 1401, 1399, 1399, 1398, 1403, 1401, 1398, 1403, 1402, 1402, 1404, 1400,
+    1404, 1402, 1403, 1406, 1401, 1400, 1405, 1404, 1406, 1403, 1404, 1401, 1401, 1404, 1400, 1405,
+    1404, 1405, 1401, 1403, 1405, 1402, 1405, 1404, 1403, 1401, 1405, 1400, 1405, 1400, 1403, 1405,
+    1405, 1400, 1403, 1399, 1399, 1404, 1399, 1403, 1404, 1403, 1399, 1405, 1405, 1405, 1402, 1404,
+    1405, 1402, 1402, 1399, 1402, 1403, 1404, 1400, 1405, 1402, 1403, 1401, 1402, 1400, 1402, 1401,
+    1404, 1400, 1403, 1400, 1403, 1404, 1400, 1405, 1403, 1402, 1404, 1402, 1402, 1400, 1403, 1402,
+    1406, 1404, 1403, 1406, 1405, 1402, 1403, 1403, 1400, 1401, 1400, 1400, 1400, 1400, 1405, 1406,
+    1402, 1405, 1400, 1401, 1402, 1401, 1400, 1401, 1403, 1404, 1402, 1404, 1406, 1406, 1406, 1402,
+    1406, 1404, 1401, 1405, 1402, 1406, 1406, 1400, 1405, 1402, 1402, 1404, 1406, 1403, 1402, 1406,
+    1406, 1404, 1402, 1402, 1404, 1407, 1405, 1402, 1402, 1407, 1404, 1405, 1406, 1402, 1408, 1404,
+    1402, 1405, 1406, 1402, 1406, 1402, 1407, 1404, 1406, 1407, 1404, 1406, 1405, 1402, 1408, 1407,
+    1403, 1405, 1404, 1400, 1405, 1400, 1404, 1402, 1400, 1405, 1406, 1400, 1406, 1405, 1400, 1400,
+    1403, 1402, 1405, 1404, 1402, 1405, 1401, 1406, 1404, 1401, 1401, 1405, 1404, 1406, 1406, 1406,
+    1401, 1405, 1405, 1404, 1405, 1400, 1404, 1404, 1400, 1401, 1405, 1405, 1403, 1403, 1402, 1399,
+    1402, 1402, 1402, 1402, 1402, 1405, 1400, 1401, 1401, 1401, 1404, 1404, 1405, 1404, 1401, 1404,
+    1407, 1402, 1405, 1407, 1402, 1401, 1404, 1406, 1403, 1402, 1406, 1402, 1403, 1401, 1401, 1406,
+    1403, 1402, 1401, 1406, 1405, 1407, 1405, 1404, 1404, 1407, 1403, 1406, 1404, 1401, 1403, 1406,
+    1400, 1400, 1400, 1401, 1402, 1402, 1405, 1406, 1406, 1404, 1405, 1403, 1400, 1406, 1402, 1405,
+    1405, 1401, 1406, 1401, 1400, 1405, 1405, 1406, 1405, 1402, 1404, 1403, 1400, 1404, 1405, 1400,
+    1399, 1399, 1402, 1399, 1401, 1399, 1399, 1403, 1403, 1402, 1403, 1401, 1402, 1403, 1403, 1399,
+    1401, 1398, 1400, 1401, 1402, 1400, 1398, 1399, 1398, 1404, 1403, 1402, 1403, 1403, 1403, 1404,
+    1402, 1400, 1400, 1403, 1404, 1405, 1401, 1399, 1400, 1404, 1404, 1400, 1399, 1402, 1401, 1405,
+    1405, 1401, 1404, 1405, 1404, 1402, 1399, 1399, 1405, 1401, 1404, 1403, 1401, 1402, 1400, 1405,
+    1401, 1399, 1397, 1400, 1400, 1403, 1397, 1403, 1401, 1403, 1401, 1402, 1402, 1402, 1402, 1400,
+    1403, 1399, 1403, 1399, 1402, 1398, 1402, 1397, 1401, 1400, 1402, 1402, 1399, 1401, 1401, 1400,
+    1398, 1396, 1398, 1401, 1397, 1396, 1400, 1397, 1402, 1402, 1396, 1400, 1398, 1402, 1399, 1396,
+    1399, 1402, 1397, 1396, 1401, 1400, 1399, 1401, 1401, 1402, 1397, 1400, 1402, 1397, 1397, 1398,
+    1397, 1402, 1400, 1403, 1401, 1402, 1399, 1400, 1401, 1400, 1403, 1399, 1402, 1398, 1401, 1401,
+    1403, 1400, 1397, 1403, 1401, 1401, 1403, 1398, 1400, 1398, 1402, 1403, 1401, 1403, 1401, 1397,
+    1405, 1401, 1403, 1401, 1403, 1403, 1403, 1405, 1404, 1402, 1401, 1400, 1399, 1405, 1399, 1404,
+    1405, 1400, 1399, 1400, 1405, 1402, 1402, 1399, 1402, 1402, 1402, 1402, 1403, 1404, 1402, 1401,
+    1400, 1398, 1402, 1399, 1402, 1400, 1400, 1402, 1401, 1404, 1399, 1399, 1402, 1398, 1401, 1400,
+    1398, 1398, 1403, 1399, 1403, 1403, 1403, 1398, 1404, 1402, 1402, 1402, 1402, 1403, 1400, 1401,
+    1397, 1398, 1401, 1400, 1397, 1403, 1401, 1401, 1398, 1397, 1399, 1400, 1401, 1397, 1403, 1398,
+    1397, 1402, 1402, 1398, 1401, 1399, 1400, 1403, 1401, 1399, 1400, 1403, 1397, 1399, 1398, 1400,
+    1401, 1399, 1403, 1398, 1403, 1398, 1398, 1403, 1401, 1399, 1403, 1401, 1400, 1401, 1401, 1403,
+    1399, 1401, 1404, 1402, 1404, 1402, 1398, 1403, 1401, 1400, 1398, 1400, 1400, 1403, 1404, 1401,
+    1401, 1400, 1403, 1404, 1398, 1403, 1404, 1402, 1399, 1399, 1399, 1404, 1403, 1400, 1400, 1399,
+    1400, 1404, 1403, 1398, 1404, 1400, 1401, 1400, 1400, 1400, 1403, 1402, 1403, 1400, 1403, 1402,
+    1403, 1404, 1399, 1399, 1401, 1403, 1399, 1401, 1399, 1402, 1399, 1404, 1404, 1404, 1401, 1403,
+    1401, 1401, 1400, 1405, 1404, 1400, 1402, 1403, 1401, 1405, 1405, 1403, 1405, 1403, 1402, 1405,
+    1397, 1398, 1400, 1400, 1402, 1400, 1402, 1403, 1398, 1397, 1398, 1401, 1398, 1400, 1400, 1403,
+    1402, 1400, 1403, 1397, 1397, 1400, 1397, 1398, 1398, 1401, 1403, 1399, 1399, 1401, 1399, 1398,
+    1402, 1403, 1397, 1398, 1401, 1403, 1398, 1398, 1400, 1401, 1399, 1399, 1399, 1399, 1401, 1402,
+    1400, 1397, 1399, 1398, 1402, 1402, 1403, 1403, 1401, 1402, 1402, 1403, 1402, 1397, 1398, 1402,
+    1402, 1401, 1399, 1398, 1400, 1400, 1401, 1399, 1401, 1397, 1401, 1402, 1398, 1399, 1398, 1402,
+    1402, 1402, 1401, 1402, 1398, 1400, 1397, 1396, 1401, 1399, 1401, 1402, 1401, 1396, 1402, 1398,
+    1398, 1398, 1402, 1403, 1399, 1401, 1401, 1399, 1400, 1400, 1399, 1402, 1398, 1400, 1397, 1401,
+    1403, 1402, 1401, 1397, 1400, 1397, 1400, 1398, 1399, 1401, 1397, 1398, 1402, 1401, 1401, 1403,
+    1401, 1401, 1399, 1400, 1399, 1397, 1396, 1397, 1396, 1397, 1398, 1398, 1396, 1400, 1396, 1396,
+    1399, 1400, 1398, 1399, 1397, 1396, 1401, 1401, 1396, 1398, 1401, 1402, 1396, 1399, 1402, 1401,
+    1400, 1394, 1399, 1398, 1395, 1399, 1400, 1396, 1396, 1396, 1394, 1396, 1397, 1400, 1399, 1399,
+    1394, 1395, 1397, 1399, 1396, 1394, 1396, 1399, 1397, 1399, 1399, 1396, 1396, 1394, 1400, 1395,
+    1399, 1396, 1400, 1396, 1399, 1397, 1401, 1402, 1397, 1401, 1400, 1397, 1398, 1396, 1398, 1398,
+    1400, 1402, 1397, 1402, 1397, 1396, 1402, 1398, 1398, 1402, 1397, 1399, 1401, 1402, 1399, 1402,
+    1398, 1398, 1402, 1401, 1403, 1398, 1400, 1399, 1400, 1399, 1403, 1403, 1398, 1402, 1401, 1403,
+    1398, 1404, 1403, 1403, 1404, 1404, 1399, 1404, 1402, 1404, 1404, 1398, 1398, 1398, 1401, 1400,
+    1397, 1397, 1396, 1399, 1397, 1399, 1396, 1402, 1400, 1401, 1399, 1396, 1397, 1402, 1401, 1400,
+    1400, 1399, 1400, 1396, 1400, 1400, 1397, 1400, 1396, 1396, 1400, 1400, 1399, 1398, 1397, 1401,
+    1400, 1401, 1399, 1401, 1401, 1399, 1400, 1403, 1402, 1404, 1401, 1402, 1403, 1400, 1400, 1404,
+    1399, 1398, 1399, 1404, 1400, 1403, 1402, 1398, 1402, 1404, 1398, 1398, 1401, 1403, 1400, 1401,
+    1405, 1403, 1402, 1401, 1400, 1403, 1406, 1404, 1401, 1406, 1403, 1405, 1406, 1400, 1402, 1405,
+    1406, 1405, 1406, 1406, 1405, 1400, 1401, 1402, 1406, 1404, 1402, 1401, 1403, 1401, 1405, 1406,
+    1407, 1403, 1405, 1407, 1407, 1403, 1408, 1403, 1404, 1407, 1403, 1405, 1404, 1408, 1407, 1404,
+    1407, 1406, 1405, 1408, 1407, 1408, 1404, 1402, 1404, 1405, 1405, 1402, 1403, 1403, 1402, 1404,
+    1406, 1405, 1404, 1404, 1404, 1407, 1407, 1406, 1409, 1407, 1409, 1405, 1406, 1409, 1407, 1408,
+    1403, 1407, 1409, 1404, 1404, 1407, 1409, 1408, 1404, 1403, 1404, 1403, 1409, 1406, 1403, 1404,
+    1405, 1405, 1405, 1408, 1405, 1408, 1409, 1410, 1404, 1408, 1408, 1405, 1408, 1405, 1409, 1410,
+    1410, 1408, 1405, 1408, 1406, 1410, 1404, 1408, 1407, 1404, 1410, 1406, 1410, 1404, 1410, 1410,
+    1405, 1405, 1409, 1410, 1410, 1404, 1407, 1410, 1405, 1405, 1404, 1404, 1407, 1410, 1409, 1407,
+    1407, 1404, 1408, 1405, 1410, 1407, 1408, 1405, 1407, 1408, 1407, 1404, 1405, 1408, 1406, 1409,
+    1403, 1408, 1404, 1403, 1406, 1409, 1404, 1406, 1403, 1407, 1408, 1404, 1404, 1403, 1403, 1407,
+    1407, 1407, 1406, 1406, 1404, 1404, 1409, 1404, 1403, 1408, 1409, 1404, 1406, 1403, 1409, 1409,
+    1404, 1407, 1406, 1406, 1403, 1403, 1404, 1407, 1405, 1403, 1401, 1402, 1407, 1406, 1401, 1405,
+    1404, 1405, 1406, 1407, 1401, 1402, 1404, 1403, 1406, 1403, 1405, 1407, 1406, 1403, 1405, 1405,
+    1407, 1408, 1405, 1403, 1407, 1407, 1405, 1409, 1405, 1408, 1406, 1409, 1404, 1407, 1408, 1403,
+    1408, 1406, 1407, 1406, 1404, 1409, 1409, 1409, 1404, 1409, 1405, 1406, 1407, 1407, 1408, 1409,
+    1407, 1407, 1405, 1408, 1402, 1405, 1408, 1404, 1407, 1402, 1408, 1407, 1408, 1405, 1406, 1403,
+    1402, 1407, 1404, 1403, 1402, 1404, 1407, 1402, 1403, 1403, 1403, 1407, 1407, 1407, 1405, 1403,
+    1404, 1406, 1409, 1407, 1408, 1406, 1407, 1403, 1403, 1405, 1407, 1406, 1407, 1403, 1408, 1404,
+    1405, 1406, 1409, 1406, 1408, 1407, 1405, 1409, 1406, 1407, 1409, 1406, 1404, 1405, 1409, 1409,
+    1405, 1406, 1406, 1404, 1404, 1408, 1404, 1405, 1405, 1404, 1409, 1410, 1408, 1410, 1406, 1406,
+    1409, 1406, 1409, 1404, 1404, 1410, 1404, 1407, 1405, 1408, 1407, 1409, 1410, 1406, 1410, 1404,
+    1409, 1408, 1407, 1408, 1409, 1408, 1410, 1408, 1412, 1411, 1407, 1411, 1406, 1411, 1409, 1412,
+    1408, 1406, 1408, 1410, 1412, 1407, 1410, 1411, 1410, 1411, 1407, 1411, 1407, 1406, 1408, 1407,
+    1408, 1411, 1408, 1411, 1409, 1414, 1413, 1414, 1412, 1413, 1412, 1409, 1414, 1414, 1413, 1414,
+    1410, 1409, 1412, 1408, 1411, 1413, 1409, 1411, 1408, 1409, 1412, 1412, 1410, 1411, 1413, 1408,
+    1412, 1411, 1413, 1408, 1412, 1408, 1412, 1409, 1410, 1412, 1408, 1411, 1410, 1409, 1407, 1413,
+    1408, 1411, 1410, 1409, 1409, 1413, 1407, 1407, 1409, 1411, 1407, 1407, 1413, 1411, 1407, 1413,
+    1411, 1408, 1407, 1411, 1407, 1408, 1407, 1411, 1405, 1408, 1410, 1406, 1411, 1410, 1407, 1409,
+    1407, 1408, 1406, 1407, 1410, 1405, 1409, 1405, 1409, 1409, 1410, 1409, 1408, 1405, 1410, 1411,
+    1406, 1409, 1411, 1406, 1406, 1408, 1410, 1411, 1406, 1412, 1409, 1406, 1406, 1408, 1408, 1408,
+    1409, 1407, 1406, 1409, 1410, 1412, 1411, 1407, 1410, 1406, 1406, 1410, 1411, 1406, 1411, 1411,
+    1409, 1409, 1407, 1410, 1407, 1405, 1408, 1408, 1409, 1408, 1405, 1407, 1406, 1408, 1404, 1409,
+    1404, 1406, 1404, 1405, 1410, 1406, 1404, 1405, 1406, 1404, 1408, 1407, 1405, 1406, 1405, 1407,
+    1406, 1408, 1408, 1411, 1409, 1406, 1412, 1406, 1412, 1411, 1409, 1409, 1407, 1411, 1406, 1408,
+    1407, 1408, 1406, 1411, 1411, 1409, 1411, 1411, 1407, 1408, 1411, 1408, 1406, 1412, 1408, 1406,
+    1407, 1410, 1407, 1405, 1406, 1411, 1411, 1408, 1406, 1406, 1410, 1405, 1410, 1411, 1407, 1407,
+    1409, 1409, 1405, 1406, 1407, 1407, 1410, 1411, 1405, 1405, 1407, 1411, 1410, 1408, 1408, 1411,
+    1406, 1409, 1404, 1404, 1407, 1406, 1408, 1404, 1405, 1408, 1403, 1404, 1408, 1409, 1407, 1405,
+    1409, 1408, 1403, 1405, 1406, 1403, 1409, 1404, 1407, 1405, 1405, 1405, 1404, 1407, 1409, 1404,
+    1406, 1406, 1401, 1404, 1405, 1405, 1405, 1404, 1402, 1406, 1405, 1403, 1406, 1405, 1402, 1401,
+    1403, 1404, 1406, 1403, 1406, 1406, 1404, 1401, 1406, 1407, 1403, 1406, 1407, 1404, 1404, 1403,
+    1409, 1404, 1406, 1406, 1407, 1409, 1403, 1407, 1409, 1403, 1407, 1406, 1406, 1405, 1406, 1408,
+    1403, 1407, 1405, 1404, 1406, 1409, 1408, 1403, 1403, 1405, 1403, 1408, 1407, 1407, 1405, 1407,
+    1407, 1406, 1403, 1402, 1405, 1407, 1406, 1402, 1406, 1407, 1402, 1402, 1407, 1408, 1402, 1402,
+    1408, 1406, 1403, 1405, 1408, 1408, 1402, 1406, 1405, 1405, 1408, 1406, 1402, 1406, 1404, 1408,
+    1404, 1406, 1406, 1403, 1405, 1400, 1400, 1406, 1402, 1404, 1401, 1402, 1402, 1402, 1401, 1403,
+    1401, 1406, 1406, 1406, 1406, 1402, 1405, 1405, 1400, 1406, 1400, 1402, 1400, 1406, 1402, 1403,
+    1403, 1403, 1407, 1402, 1407, 1407, 1406, 1405, 1403, 1406, 1407, 1406, 1403, 1404, 1407, 1406,
+    1407, 1404, 1406, 1402, 1405, 1403, 1405, 1403, 1403, 1405, 1406, 1402, 1404, 1406, 1402, 1404,
+    1402, 1404, 1404, 1404, 1407, 1406, 1404, 1405, 1402, 1407, 1404, 1405, 1405, 1405, 1404, 1406,
+    1405, 1403, 1403, 1407, 1407, 1405, 1402, 1408, 1402, 1406, 1407, 1403, 1405, 1404, 1402, 1402,
+};
+
+// Fast signal: a 16 Hz sine at 2 kHz over most of the range with +-8 LSB of noise
+static const uint16_t trace_fast[TRACE_LEN] = {
+    2050, 2142, 2236, 2318, 2402, 2496, 2581, 2666, 2744, 2835, 2911, 3000, 3073, 3134, 3212, 3280,
+    3347, 3410, 3459, 3522, 3559, 3607, 3662, 3696, 3724, 3762, 3777, 3808, 3824, 3843, 3837, 3840,
+    3849, 3836, 3827, 3821, 3797, 3776, 3740, 3708, 3672, 3638, 3586, 3538, 3491, 3429, 3377, 3319,
+    3242, 3175, 3113, 3032, 2962, 2868, 2798, 2709, 2626, 2538, 2459, 2355, 2280, 2177, 2095, 2001,
+    1912, 1814, 1739, 1645, 1554, 1477, 1386, 1308, 1212, 1147, 1068, 989, 911, 854, 775, 726,
+    658, 607, 551, 507, 452, 422, 379, 353, 318, 303, 287, 272, 261, 249, 251, 243,
+    267, 268, 280, 316, 340, 360, 404, 437, 481, 527, 577, 628, 683, 745, 819, 887,
+    948, 1024, 1105, 1184, 1258, 1342, 1434, 1514, 1601, 1692, 1780, 1869, 1951, 2054, 2144, 2234,
+    2311, 2403, 2494, 2588, 2674, 2750, 2834, 2909, 2986, 3066, 3140, 3219, 3287, 3349, 3407, 3469,
+    3517, 3562, 3610, 3648, 3688, 3732, 3764, 3787, 3809, 3831, 3832, 3845, 3849, 3843, 3839, 3822,
+    3814, 3799, 3774, 3741, 3720, 3668, 3629, 3587, 3548, 3482, 3438, 3379, 3318, 3247, 3180, 3100,
+    3034, 2949, 2871, 2794, 2708, 2632, 2540, 2443, 2362, 2270, 2186, 2096, 2002, 1917, 1823, 1727,
+    1638, 1550, 1469, 1382, 1307, 1212, 1148, 1070, 983, 924, 843, 791, 724, 655, 601, 553,
+    500, 465, 418, 378, 357, 315, 305, 276, 273, 249, 246, 253, 246, 261, 277, 281,
+    316, 343, 372, 392, 444, 475, 533, 575, 635, 691, 755, 818, 887, 945, 1026, 1106,
+    1184, 1257, 1337, 1422, 1520, 1592, 1695, 1774, 1872, 1956, 2040, 2143, 2236, 2318, 2402, 2500,
+    2579, 2671, 2745, 2834, 2923, 2993, 3077, 3142, 3220, 3273, 3347, 3402, 3469, 3515, 3567, 3609,
+    3649, 3695, 3728, 3761, 3783, 3806, 3822, 3843, 3848, 3846, 3842, 3839, 3833, 3818, 3798, 3775,
+    3745, 3714, 3668, 3641, 3589, 3537, 3483, 3426, 3383, 3304, 3242, 3185, 3112, 3024, 2947, 2869,
+    2799, 2707, 2628, 2545, 2458, 2359, 2277, 2179, 2098, 1996, 1914, 1823, 1733, 1645, 1551, 1475,
+    1381, 1310, 1227, 1143, 1069, 981, 912, 844, 781, 725, 663, 610, 552, 509, 456, 416,
+    386, 352, 328, 291, 274, 268, 261, 252, 243, 254, 253, 268, 290, 305, 339, 362,
+    404, 434, 474, 535, 570, 636, 686, 756, 814, 878, 956, 1026, 1104, 1175, 1258, 1342,
+    1429, 1513, 1596, 1690, 1772, 1870, 1964, 2051, 2134, 2222, 2323, 2405, 2500, 2575, 2675, 2746,
+    2831, 2915, 2989, 3071, 3136, 3213, 3284, 3343, 3413, 3461, 3513, 3563, 3622, 3654, 3703, 3726,
+    3767, 3793, 3813, 3832, 3833, 3845, 3854, 3849, 3847, 3832, 3812, 3802, 3767, 3751, 3706, 3680,
+    3628, 3584, 3548, 3482, 3432, 3377, 3319, 3240, 3169, 3102, 3031, 2956, 2879, 2794, 2708, 2618,
+    2544, 2447, 2359, 2269, 2180, 2090, 2002, 1914, 1818, 1726, 1636, 1560, 1465, 1387, 1301, 1220,
+    1134, 1059, 987, 923, 843, 787, 719, 667, 606, 550, 497, 455, 423, 377, 349, 321,
+    303, 286, 267, 247, 245, 253, 250, 267, 279, 287, 309, 335, 358, 394, 440, 488,
+    534, 572, 634, 694, 755, 808, 889, 948, 1019, 1102, 1185, 1268, 1338, 1434, 1506, 1604,
+    1688, 1778, 1869, 1958, 2049, 2133, 2228, 2317, 2400, 2490, 2584, 2674, 2748, 2835, 2914, 3000,
+    3064, 3143, 3219, 3280, 3347, 3408, 3456, 3513, 3573, 3606, 3649, 3694, 3732, 3753, 3782, 3808,
+    3830, 3835, 3840, 3842, 3850, 3838, 3837, 3816, 3796, 3777, 3745, 3712, 3676, 3630, 3585, 3539,
+    3488, 3433, 3368, 3318, 3252, 3182, 3109, 3038, 2946, 2883, 2797, 2712, 2622, 2536, 2443, 2371,
+    2281, 2177, 2094, 2000, 1913, 1823, 1739, 1640, 1559, 1463, 1382, 1308, 1227, 1144, 1062, 991,
+    925, 847, 776, 725, 665, 612, 556, 496, 464, 412, 386, 353, 315, 305, 277, 258,
+    256, 255, 248, 247, 263, 274, 289, 310, 334, 371, 396, 442, 481, 524, 577, 632,
+    693, 752, 817, 880, 954, 1034, 1094, 1179, 1269, 1342, 1425, 1516, 1600, 1692, 1781, 1874,
+    1955, 2043, 2144, 2227, 2319, 2401, 2503, 2574, 2662, 2745, 2836, 2909, 2998, 3061, 3150, 3218,
+    3280, 3336, 3403, 3470, 3523, 3569, 3617, 3648, 3691, 3722, 3764, 3791, 3811, 3828, 3834, 3844,
+    3844, 3838, 3834, 3825, 3822, 3797, 3768, 3751, 3715, 3682, 3644, 3593, 3551, 3493, 3427, 3371,
+    3315, 3239, 3181, 3106, 3033, 2957, 2877, 2796, 2709, 2629, 2540, 2451, 2359, 2276, 2179, 2098,
+    2003, 1915, 1820, 1737, 1649, 1558, 1473, 1386, 1307, 1212, 1134, 1071, 996, 923, 850, 777,
+    719, 666, 598, 550, 510, 452, 423, 384, 349, 318, 306, 284, 268, 258, 255, 253,
+    257, 266, 278, 296, 306, 335, 372, 408, 432, 483, 530, 580, 634, 697, 743, 822,
+    880, 960, 1024, 1101, 1187, 1267, 1351, 1423, 1505, 1605, 1683, 1785, 1861, 1955, 2052, 2136,
+    2236, 2322, 2402, 2503, 2581, 2671, 2754, 2838, 2908, 2994, 3075, 3139, 3213, 3276, 3343, 3397,
+    3462, 3519, 3563, 3619, 3649, 3699, 3721, 3763, 3783, 3809, 3816, 3832, 3852, 3848, 3849, 3837,
+    3835, 3823, 3797, 3778, 3741, 3719, 3678, 3634, 3596, 3539, 3482, 3436, 3378, 3308, 3254, 3175,
+    3113, 3025, 2959, 2882, 2788, 2717, 2627, 2531, 2449, 2371, 2270, 2181, 2088, 2007, 1916, 1819,
+    1730, 1650, 1552, 1466, 1383, 1305, 1216, 1141, 1057, 989, 918, 850, 782, 724, 663, 597,
+    549, 497, 455, 427, 387, 343, 326, 307, 272, 261, 255, 252, 254, 245, 263, 278,
+    295, 309, 334, 360, 404, 445, 480, 523, 573, 638, 693, 745, 808, 879, 948, 1022,
+    1107, 1175, 1255, 1339, 1429, 1520, 1592, 1689, 1771, 1872, 1959, 2053, 2142, 2231, 2314, 2403,
+    2489, 2585, 2663, 2753, 2826, 2918, 2994, 3063, 3145, 3208, 3274, 3351, 3407, 3462, 3516, 3562,
+    3610, 3663, 3699, 3728, 3766, 3784, 3813, 3823, 3838, 3842, 3839, 3844, 3838, 3824, 3811, 3804,
+    3770, 3753, 3705, 3683, 3640, 3584, 3547, 3486, 3434, 3369, 3309, 3241, 3172, 3111, 3031, 2953,
+    2869, 2791, 2716, 2630, 2545, 2457, 2359, 2270, 2183, 2093, 1995, 1918, 1814, 1739, 1641, 1562,
+    1471, 1383, 1302, 1227, 1136, 1057, 997, 926, 848, 775, 715, 658, 606, 560, 504, 467,
+    423, 386, 349, 326, 297, 272, 258, 246, 250, 240, 246, 259, 277, 282, 302, 339,
+    368, 404, 442, 478, 532, 575, 627, 696, 755, 821, 891, 953, 1033, 1095, 1185, 1264,
+    1335, 1433, 1511, 1601, 1690, 1774, 1864, 1953, 2053, 2139, 2232, 2322, 2405, 2497, 2585, 2660,
+    2758, 2840, 2909, 2991, 3072, 3144, 3209, 3277, 3349, 3408, 3462, 3515, 3574, 3617, 3652, 3689,
+    3733, 3752, 3792, 3809, 3819, 3828, 3846, 3847, 3852, 3833, 3824, 3818, 3802, 3768, 3741, 3708,
+    3674, 3629, 3584, 3548, 3497, 3426, 3369, 3307, 3249, 3181, 3106, 3033, 2953, 2868, 2799, 2708,
+    2625, 2543, 2454, 2371, 2266, 2181, 2089, 2009, 1919, 1826, 1736, 1645, 1548, 1476, 1383, 1296,
+    1227, 1140, 1070, 986, 919, 849, 778, 725, 657, 604, 552, 506, 466, 415, 385, 347,
+    328, 304, 277, 261, 247, 249, 240, 253, 252, 270, 293, 316, 334, 368, 405, 437,
+    476, 520, 572, 636, 694, 743, 809, 882, 945, 1029, 1099, 1186, 1255, 1350, 1430, 1515,
+    1600, 1683, 1781, 1861, 1957, 2055, 2145, 2235, 2315, 2402, 2499, 2585, 2666, 2755, 2829, 2908,
+    2989, 3071, 3144, 3210, 3277, 3344, 3412, 3463, 3518, 3564, 3622, 3651, 3701, 3737, 3751, 3781,
+    3812, 3822, 3840, 3843, 3842, 3846, 3837, 3831, 3812, 3802, 3780, 3747, 3712, 3683, 3630, 3585,
+    3550, 3497, 3437, 3383, 3313, 3248, 3169, 3102, 3035, 2948, 2867, 2798, 2712, 2622, 2535, 2448,
+    2355, 2274, 2188, 2088, 2010, 1908, 1830, 1739, 1642, 1551, 1465, 1381, 1298, 1222, 1138, 1058,
+    984, 918, 849, 787, 726, 669, 609, 559, 508, 459, 425, 379, 352, 322, 306, 272,
+    258, 250, 251, 245, 246, 255, 273, 284, 308, 338, 368, 398, 444, 477, 533, 570,
+    631, 695, 755, 821, 885, 957, 1019, 1100, 1174, 1262, 1343, 1420, 1519, 1598, 1690, 1772,
+    1869, 1965, 2054, 2133, 2230, 2315, 2408, 2503, 2584, 2670, 2750, 2842, 2914, 2998, 3074, 3134,
+    3215, 3285, 3348, 3413, 3461, 3509, 3561, 3609, 3658, 3694, 3734, 3764, 3778, 3812, 3822, 3838,
+    3840, 3850, 3848, 3840, 3835, 3819, 3800, 3778, 3741, 3713, 3668, 3630, 3583, 3545, 3486, 3442,
+    3378, 3317, 3250, 3171, 3109, 3027, 2961, 2872, 2799, 2716, 2627, 2535, 2449, 2359, 2273, 2182,
+    2097, 1995, 1917, 1827, 1740, 1639, 1558, 1463, 1383, 1301, 1214, 1134, 1068, 986, 914, 855,
+    786, 717, 663, 604, 553, 506, 463, 423, 380, 358, 328, 299, 283, 262, 252, 244,
+    255, 255, 254, 266, 281, 303, 338, 372, 407, 444, 474, 533, 586, 634, 696, 750,
+    819, 880, 957, 1032, 1100, 1186, 1259, 1351, 1429, 1521, 1599, 1693, 1771, 1861, 1954, 2048,
+    2140, 2232, 2318, 2404, 2495, 2583, 2674, 2747, 2840, 2911, 2997, 3061, 3140, 3212, 3274, 3349,
+    3401, 3455, 3516, 3575, 3615, 3652, 3696, 3729, 3752, 3788, 3804, 3823, 3836, 3836, 3852, 3853,
+    3841, 3835, 3819, 3798, 3765, 3751, 3715, 3674, 3635, 3585, 3549, 3498, 3435, 3369, 3315, 3243,
+    3182, 3112, 3025, 2951, 2869, 2799, 2703, 2627, 2532, 2445, 2371, 2266, 2190, 2099, 2005, 1912,
+    1818, 1724, 1647, 1551, 1472, 1377, 1300, 1217, 1148, 1072, 982, 913, 855, 776, 717, 658,
+    613, 544, 499, 461, 412, 375, 348, 315, 299, 274, 271, 252, 246, 255, 259, 263,
+    267, 288, 309, 332, 364, 408, 446, 481, 530, 574, 630, 693, 746, 814, 888, 957,
+    1032, 1097, 1183, 1269, 1343, 1419, 1507, 1592, 1685, 1773, 1864, 1952, 2040, 2133, 2231, 2311,
+    2407, 2493, 2586, 2674, 2747, 2827, 2917, 2995, 3068, 3145, 3219, 3284, 3345, 3403, 3462, 3516,
+    3573, 3606, 3651, 3691, 3726, 3754, 3784, 3814, 3823, 3842, 3845, 3847, 3847, 3837, 3834, 3816,
+    3800, 3770, 3740, 3716, 3673, 3631, 3587, 3539, 3482, 3438, 3378, 3313, 3243, 3185, 3100, 3035,
+    2948, 2872, 2797, 2707, 2626, 2536, 2443, 2371, 2266, 2184, 2099, 2007, 1909, 1822, 1738, 1638,
+    1548, 1462, 1390, 1295, 1219, 1144, 1067, 997, 924, 852, 787, 722, 660, 606, 560, 499,
+    466, 414, 385, 351, 324, 291, 276, 266, 252, 249, 254, 255, 252, 271, 294, 305,
+    334, 365, 393, 441, 476, 527, 580, 624, 690, 756, 810, 883, 952, 1033, 1096, 1176,
+    1265, 1349, 1420, 1516, 1605, 1690, 1781, 1863, 1951, 2054, 2138, 2230, 2324, 2415, 2491, 2580,
+    2667, 2757, 2828, 2922, 3000, 3070, 3134, 3218, 3281, 3338, 3400, 3456, 3525, 3573, 3617, 3660,
+    3689, 3727, 3754, 3782, 3806, 3824, 3834, 3850, 3849, 3852, 3840, 3838, 3816, 3800, 3771, 3738,
+    3710, 3684, 3633, 3598, 3538, 3497, 3440, 3377, 3314, 3252, 3169, 3108, 3036, 2955, 2876, 2786,
+    2702, 2624, 2536, 2454, 2360, 2278, 2184, 2090, 2008, 1914, 1815, 1725, 1642, 1550, 1477, 1384,
+    1303, 1215, 1145, 1065, 993, 915, 847, 786, 720, 664, 599, 557, 496, 467, 423, 379,
+    349, 324, 296, 272, 265, 247, 257, 255, 258, 264, 271, 296, 318, 343, 362, 399,
+    436, 485, 525, 577, 636, 698, 759, 812, 887, 958, 1026, 1106, 1188, 1254, 1344, 1431,
+    1509, 1604, 1687, 1777, 1863, 1955, 2044, 2133, 2224, 2312, 2399, 2501, 2579, 2663, 2746, 2826,
+    2914, 2990, 3070, 3143, 3204, 3275, 3347, 3413, 3464, 3517, 3561, 3609, 3655, 3688, 3726, 3763,
+    3778, 3803, 3822, 3844, 3851, 3843, 3853, 3845, 3826, 3815, 3792, 3768, 3740, 3707, 3681, 3641,
+    3583, 3537, 3485, 3441, 3375, 3308, 3240, 3175, 3099, 3027, 2955, 2880, 2785, 2708, 2622, 2539,
+    2455, 2363, 2267, 2188, 2092, 1997, 1917, 1815, 1728, 1642, 1555, 1475, 1385, 1306, 1215, 1139,
+    1072, 992, 920, 847, 776, 726, 662, 611, 547, 512, 458, 415, 379, 349, 324, 303,
+    275, 261, 254, 255, 248, 254, 262, 279, 294, 311, 340, 374, 395, 441, 476, 522,
+    576, 628, 690, 752, 818, 878, 956, 1021, 1102, 1183, 1262, 1346, 1419, 1521, 1592, 1682,
+    1785, 1869, 1959, 2050, 2141, 2228, 2320, 2415, 2502, 2578, 2670, 2753, 2833, 2917, 2986, 3063,
+    3142, 3208, 3286, 3344, 3405, 3466, 3525, 3561, 3613, 3654, 3700, 3734, 3751, 3789, 3808, 3817,
+    3829, 3852, 3844, 3847, 3845, 3835, 3823, 3791, 3770, 3738, 3715, 3677, 3639, 3597, 3540, 3490,
+    3442, 3368, 3319, 3240, 3172, 3109, 3033, 2957, 2868, 2789, 2713, 2625, 2535, 2457, 2356, 2269,
+    2184, 2093, 2010, 1918, 1822, 1731, 1652, 1556, 1477, 1378, 1295, 1217, 1136, 1061, 981, 912,
+    848, 779, 718, 653, 604, 548, 505, 457, 412, 388, 348, 318, 303, 286, 258, 261,
+    249, 248, 245, 254, 279, 282, 314, 331, 360, 392, 441, 474, 527, 581, 633, 684,
+    743, 807, 881, 950, 1023, 1098, 1175, 1262, 1341, 1429, 1518, 1607, 1694, 1772, 1869, 1954,
+    2046, 2144, 2227, 2321, 2403, 2499, 2584, 2668, 2744, 2835, 2912, 3001, 3075, 3139, 3211, 3273,
+    3345, 3407, 3463, 3525, 3560, 3618, 3653, 3687, 3726, 3766, 3788, 3815, 3824, 3828, 3849, 3850,
+    3838, 3840, 3827, 3823, 3793, 3777, 3748, 3717, 3672, 3628, 3586, 3538, 3494, 3437, 3367, 3320,
+    3239, 3170, 3114, 3039, 2957, 2879, 2787, 2715, 2628, 2541, 2455, 2359, 2265, 2188, 2090, 1997,
+    1908, 1820, 1733, 1645, 1558, 1473, 1383, 1305, 1213, 1134, 1058, 987, 923, 843, 781, 715,
+    668, 597, 557, 503, 454, 423, 386, 346, 327, 291, 280, 267, 253, 257, 243, 254,
+    266, 271, 295, 302, 336, 360, 394, 447, 477, 536, 577, 632, 695, 743, 812, 887,
+    946, 1025, 1104, 1177, 1266, 1335, 1428, 1517, 1599, 1682, 1769, 1859, 1953, 2056, 2131, 2233,
+    2312, 2399, 2500, 2579, 2660, 2758, 2830, 2908, 2995, 3072, 3147, 3204, 3283, 3338, 3405, 3463,
+    3512, 3574, 3620, 3653, 3700, 3732, 3756, 3789, 3800, 3822, 3834, 3838, 3845, 3846, 3838, 3834,
+    3823, 3790, 3772, 3745, 3710, 3669, 3631, 3592, 3549, 3485, 3428, 3377, 3304, 3249, 3183, 3101,
+    3037, 2954, 2882, 2794, 2710, 2618, 2532, 2444, 2366, 2281, 2188, 2085, 2000, 1910, 1827, 1728,
+    1651, 1553, 1474, 1381, 1306, 1223, 1135, 1069, 983, 919, 846, 780, 726, 666, 604, 559,
+    502, 457, 415, 388, 349, 316, 301, 279, 269, 251, 253, 256, 256, 253, 278, 290,
+    306, 338, 363, 397, 439, 482, 526, 586, 640, 694, 744, 818, 883, 953, 1029, 1106,
+    1175, 1268, 1337, 1425, 1509, 1598, 1688, 1778, 1864, 1962, 2045, 2144, 2232, 2312, 2415, 2496,
+    2587, 2660, 2749, 2838, 2909, 2996, 3072, 3146, 3210, 3284, 3349, 3406, 3468, 3521, 3565, 3608,
+    3649, 3687, 3727, 3763, 3781, 3814, 3826, 3830, 3847, 3854, 3841, 3842, 3828, 3811, 3792, 3765,
+    3753, 3716, 3677, 3629, 3586, 3549, 3494, 3432, 3382, 3314, 3247, 3180, 3098, 3030, 2950, 2879,
+    2794, 2704, 2622, 2533, 2458, 2362, 2278, 2178, 2089, 1998, 1910, 1823, 1737, 1637, 1558, 1465,
+    1392, 1306, 1223, 1144, 1063, 985, 912, 850, 790, 717, 661, 598, 544, 498, 467, 417,
+    389, 358, 326, 300, 273, 261, 255, 248, 243, 247, 258, 272, 295, 310, 336, 364,
+    394, 432, 487, 527, 581, 627, 696, 755, 810, 888, 949, 1022, 1103, 1177, 1267, 1346,
+    1426, 1508, 1599, 1690, 1774, 1866, 1958, 2050, 2134, 2226, 2313, 2399, 2493, 2582, 2663, 2758,
+    2834, 2910, 2992, 3061, 3135, 3209, 3281, 3350, 3404, 3455, 3510, 3573, 3618, 3662, 3703, 3733,
+    3758, 3783, 3807, 3822, 3834, 3850, 3841, 3845, 3834, 3822, 3811, 3791, 3772, 3742, 3711, 3679,
+    3641, 3589, 3544, 3498, 3441, 3377, 3315, 3243, 3171, 3102, 3030, 2947, 2882, 2801, 2717, 2629,
+    2534, 2455, 2368, 2267, 2187, 2094, 2003, 1907, 1814, 1740, 1642, 1552, 1476, 1393, 1301, 1215,
+    1141, 1070, 986, 915, 852, 790, 720, 659, 598, 550, 499, 457, 424, 389, 350, 328,
+    297, 281, 257, 256, 250, 244, 251, 261, 267, 289, 306, 332, 369, 400, 434, 484,
+    534, 575, 627, 691, 751, 816, 885, 947, 1023, 1098, 1178, 1268, 1342, 1432, 1521, 1599,
+    1684, 1770, 1859, 1958, 2053, 2135, 2229, 2313, 2409, 2489, 2587, 2667, 2746, 2829, 2909, 2995,
+    3067, 3134, 3206, 3283, 3341, 3411, 3455, 3511, 3574, 3612, 3661, 3699, 3737, 3758, 3789, 3807,
+    3825, 3828, 3841, 3850, 3846, 3838, 3832, 3822, 3801, 3777, 3749, 3719, 3679, 3635, 3583, 3538,
+    3487, 3436, 3379, 3309, 3252, 3180, 3107, 3037, 2962, 2869, 2798, 2718, 2625, 2542, 2458, 2355,
+    2276, 2182, 2098, 2000, 1911, 1818, 1726, 1644, 1550, 1467, 1379, 1298, 1226, 1136, 1065, 988,
+    920, 850, 776, 715, 657, 612, 549, 497, 464, 415, 387, 346, 330, 304, 285, 273,
+    258, 256, 243, 249, 267, 266, 282, 309, 337, 358, 405, 431, 489, 522, 578, 624,
+    691, 745, 822, 882, 948, 1023, 1098, 1173, 1261, 1348, 1427, 1513, 1594, 1683, 1778, 1865,
+    1958, 2041, 2134, 2232, 2326, 2414, 2489, 2582, 2671, 2754, 2837, 2907, 2986, 3069, 3136, 3209,
+    3288, 3347, 3406, 3465, 3513, 3572, 3614, 3662, 3698, 3737, 3763, 3789, 3805, 3823, 3841, 3836,
+    3850, 3849, 3846, 3837, 3809, 3797, 3765, 3740, 3706, 3676, 3634, 3593, 3536, 3482, 3437, 3367,
+    3319, 3243, 3178, 3105, 3023, 2955, 2871, 2789, 2717, 2628, 2547, 2447, 2356, 2272, 2185, 2100,
+    2003, 1919, 1819, 1734, 1643, 1562, 1467, 1378, 1303, 1225, 1136, 1063, 995, 917, 857, 783,
+    721, 657, 597, 559, 504, 460, 414, 390, 351, 326, 305, 279, 258, 262, 252, 243,
+    244, 265, 267, 284, 318, 335, 359, 405, 434, 478, 520, 586, 628, 691, 746, 823,
+    881, 958, 1032, 1096, 1173, 1253, 1338, 1427, 1513, 1607, 1685, 1779, 1866, 1955, 2054, 2144,
+    2230, 2312, 2405, 2492, 2586, 2661, 2753, 2835, 2912, 2992, 3066, 3141, 3214, 3275, 3339, 3399,
+    3469, 3510, 3572, 3609, 3656, 3699, 3727, 3755, 3792, 3810, 3818, 3843, 3840, 3840, 3844, 3848,
+    3832, 3808, 3794, 3775, 3749, 3706, 3682, 3630, 3595, 3548, 3487, 3426, 3372, 3310, 3246, 3179,
+    3100, 3037, 2948, 2869, 2800, 2718, 2631, 2534, 2444, 2364, 2268, 2181, 2089, 2003, 1917, 1818,
+    1738, 1649, 1551, 1469, 1389, 1310, 1220, 1139, 1056, 989, 924, 848, 791, 728, 667, 613,
+    552, 508, 464, 419, 386, 344, 325, 302, 275, 260, 259, 252, 241, 256, 254, 271,
+    285, 309, 330, 360, 408, 446, 487, 533, 586, 637, 687, 756, 815, 884, 949, 1025,
+    1099, 1175, 1266, 1346, 1426, 1505, 1603, 1687, 1775, 1864, 1962, 2050, 2130, 2221, 2315, 2405,
+    2503, 2576, 2660, 2760, 2833, 2911, 2995, 3067, 3143, 3205, 3280, 3348, 3412, 3464, 3514, 3560,
+    3616, 3660, 3687, 3722, 3760, 3782, 3812, 3819, 3836, 3851, 3842, 3845, 3838, 3830, 3822, 3792,
+    3780, 3749, 3711, 3676, 3632, 3590, 3538, 3495, 3437, 3380, 3309, 3239, 3170, 3098, 3029, 2959,
+    2877, 2793, 2718, 2619, 2531, 2448, 2356, 2268, 2176, 2089, 2001, 1909, 1829, 1734, 1636, 1557,
+    1476, 1388, 1307, 1222, 1141, 1070, 983, 917, 851, 783, 720, 653, 597, 557, 510, 462,
+    420, 389, 356, 330, 305, 284, 259, 257, 249, 240, 247, 260, 268, 289, 307, 330,
+    374, 405, 435, 480, 523, 572, 624, 696, 755, 822, 890, 946, 1022, 1108, 1180, 1253,
+    1347, 1425, 1516, 1593, 1680, 1772, 1862, 1952, 2056, 2135, 2220, 2323, 2405, 2496, 2586, 2667,
+    2752, 2826, 2917, 2997, 3063, 3143, 3219, 3280, 3341, 3413, 3464, 3521, 3559, 3618, 3649, 3695,
+    3737, 3761, 3781, 3814, 3829, 3828, 3837, 3842, 3845, 3837, 3828, 3813, 3792, 3771, 3740, 3708,
+    3672, 3633, 3597, 3535, 3490, 3437, 3382, 3305, 3243, 3181, 3103, 3032, 2953, 2880, 2801, 2713,
+    2623, 2540, 2459, 2361, 2278, 2182, 2091, 2010, 1911, 1820, 1735, 1643, 1562, 1462, 1377, 1301,
+    1221, 1138, 1058, 988, 922, 842, 779, 715, 656, 609, 555, 502, 455, 419, 374, 356,
+    320, 302, 284, 271, 253, 253, 246, 249, 253, 277, 291, 314, 340, 374, 400, 432,
+    489, 536, 575, 636, 687, 747, 815, 883, 957, 1024, 1095, 1174, 1269, 1344, 1426, 1514,
+    1600, 1691, 1773, 1872, 1954, 2056, 2143, 2229, 2311, 2407, 2495, 2579, 2669, 2757, 2828, 2908,
+    3000, 3071, 3150, 3205, 3273, 3342, 3397, 3467, 3517, 3575, 3616, 3658, 3696, 3734, 3760, 3793,
+    3800, 3828, 3839, 3851, 3852, 3847, 3847, 3838, 3824, 3788, 3779, 3745, 3709, 3675, 3640, 3585,
+    3550, 3493, 3426, 3377, 3317, 3246, 3185, 3114, 3028, 2954, 2877, 2796, 2716, 2627, 2541, 2451,
+    2356, 2265, 2190, 2095, 2005, 1916, 1827, 1731, 1642, 1555, 1469, 1383, 1305, 1225, 1149, 1057,
+    995, 918, 847, 790, 727, 653, 597, 548, 508, 463, 412, 376, 356, 320, 305, 285,
+    271, 253, 255, 254, 252, 266, 267, 281, 309, 330, 359, 404, 443, 478, 528, 578,
+    624, 690, 746, 823, 880, 957, 1033, 1099, 1175, 1266, 1341, 1419, 1512, 1592, 1681, 1772,
+    1859, 1950, 2048, 2139, 2235, 2311, 2400, 2489, 2586, 2667, 2746, 2840, 2919, 2996, 3072, 3135,
+    3219, 3286, 3350, 3403, 3470, 3509, 3575, 3606, 3653, 3699, 3721, 3754, 3784, 3814, 3830, 3829,
+    3851, 3848, 3841, 3836, 3833, 3809, 3801, 3777, 3737, 3707, 3674, 3634, 3583, 3545, 3485, 3428,
+    3369, 3308, 3247, 3172, 3113, 3038, 2956, 2878, 2800, 2703, 2632, 2541, 2447, 2371, 2281, 2191,
+    2091, 2002, 1915, 1814, 1736, 1650, 1561, 1471, 1379, 1308, 1217, 1145, 1057, 985, 926, 842,
+    787, 724, 669, 601, 547, 496, 454, 414, 388, 350, 329, 301, 280, 273, 251, 242,
+    247, 245, 251, 272, 286, 306, 338, 368, 399, 444, 481, 520, 570, 635, 697, 748,
+    819, 875, 957, 1019, 1108, 1180, 1259, 1340, 1425, 1520, 1604, 1682, 1771, 1870, 1964, 2048,
+    2138, 2234, 2322, 2403, 2495, 2586, 2665, 2746, 2828, 2910, 2995, 3070, 3142, 3219, 3273, 3339,
+    3407, 3469, 3521, 3561, 3608, 3659, 3695, 3722, 3758, 3781, 3802, 3820, 3829, 3851, 3854, 3843,
+    3844, 3837, 3822, 3791, 3768, 3744, 3708, 3670, 3630, 3587, 3538, 3483, 3440, 3378, 3313, 3244,
+    3178, 3108, 3036, 2948, 2874, 2789, 2703, 2623, 2544, 2457, 2370, 2270, 2179, 2093, 1998, 1911,
+    1816, 1729, 1646, 1554, 1465, 1387, 1304, 1225, 1139, 1065, 995, 926, 852, 779, 722, 666,
+    600, 559, 498, 455, 422, 379, 342, 319, 293, 285, 267, 251, 242, 243, 255, 252,
+    277, 282, 315, 333, 367, 406, 445, 475, 528, 583, 625, 695, 756, 814, 875, 947,
+    1026, 1100, 1182, 1259, 1349, 1424, 1517, 1600, 1682, 1775, 1872, 1955, 2050, 2130, 2231, 2324,
+    2401, 2492, 2574, 2671, 2757, 2839, 2913, 3001, 3061, 3146, 3210, 3281, 3351, 3409, 3460, 3513,
+    3567, 3607, 3657, 3698, 3726, 3754, 3789, 3801, 3821, 3830, 3840, 3854, 3841, 3840, 3838, 3814,
+    3794, 3772, 3744, 3720, 3682, 3644, 3590, 3542, 3498, 3442, 3370, 3318, 3254, 3181, 3111, 3024,
+    2951, 2867, 2793, 2702, 2629, 2534, 2447, 2363, 2278, 2187, 2092, 2000, 1912, 1817, 1732, 1643,
+    1559, 1475, 1377, 1304, 1220, 1139, 1056, 991, 926, 853, 787, 721, 662, 600, 544, 497,
+    455, 416, 389, 356, 327, 305, 278, 264, 257, 249, 253, 243, 259, 277, 289, 305,
+    340, 368, 403, 447, 477, 521, 581, 626, 682, 749, 817, 879, 958, 1030, 1102, 1174,
+    1253, 1345, 1427, 1516, 1600, 1688, 1784, 1868, 1955, 2046, 2135, 2225, 2319, 2406, 2497, 2584,
+    2667, 2746, 2827, 2915, 2989, 3064, 3140, 3220, 3287, 3341, 3397, 3468, 3521, 3563, 3610, 3660,
+    3690, 3732, 3756, 3781, 3807, 3827, 3835, 3848, 3853, 3845, 3845, 3829, 3824, 3793, 3780, 3752,
+    3720, 3674, 3644, 3588, 3539, 3497, 3434, 3371, 3315, 3252, 3182, 3097, 3028, 2947, 2872, 2789,
+    2702, 2617, 2531, 2452, 2359, 2267, 2178, 2094, 1999, 1908, 1828, 1740, 1640, 1563, 1469, 1388,
+    1304, 1219, 1149, 1067, 982, 916, 842, 786, 721, 669, 602, 558, 500, 455, 424, 377,
+    349, 324, 299, 284, 261, 255, 245, 254, 254, 260, 278, 294, 317, 335, 370, 406,
+    431, 489, 528, 579, 635, 683, 748, 809, 886, 948, 1025, 1096, 1172, 1265, 1342, 1433,
+    1510, 1598, 1696, 1783, 1859, 1952, 2051, 2140, 2233, 2312, 2404, 2496, 2582, 2670, 2754, 2842,
+    2909, 2996, 3066, 3135, 3205, 3272, 3351, 3402, 3455, 3518, 3570, 3609, 3660, 3702, 3730, 3754,
+    3791, 3807, 3821, 3835, 3852, 3844, 3853, 3835, 3824, 3822, 3801, 3780, 3742, 3718, 3679, 3635,
+    3587, 3535, 3490, 3428, 3371, 3311, 3246, 3172, 3108, 3023, 2954, 2871, 2797, 2709, 2625, 2540,
+    2451, 2356, 2267, 2189, 2098, 2003, 1908, 1816, 1740, 1641, 1558, 1464, 1390, 1299, 1213, 1144,
+    1072, 992, 925, 846, 786, 728, 655, 604, 557, 507, 463, 427, 381, 358, 326, 292,
+    275, 262, 258, 243, 255, 243, 267, 263, 292, 318, 333, 367, 408, 447, 487, 530,
+    578, 640, 697, 744, 813, 890, 955, 1018, 1105, 1184, 1264, 1340, 1421, 1506, 1594, 1688,
+    1776, 1865, 1964, 2052, 2132, 2228, 2323, 2403, 2503, 2577, 2665, 2753, 2836, 2914, 2994, 3065,
+    3140, 3215, 3288, 3341, 3400, 3461, 3519, 3572, 3619, 3663, 3698, 3723, 3765, 3789, 3804, 3828,
+    3840, 3839, 3849, 3851, 3848, 3831, 3814, 3800, 3778, 3749, 3718, 3676, 3642, 3591, 3535, 3491,
+    3435, 3372, 3320, 3239, 3172, 3104, 3036, 2956, 2867, 2793, 2709, 2620, 2541, 2458, 2356, 2270,
+    2176, 2098, 2001, 1904, 1825, 1728, 1637, 1560, 1465, 1383, 1307, 1220, 1146, 1057, 997, 915,
+    854, 785, 723, 660, 597, 559, 499, 463, 412, 377, 348, 324, 297, 280, 270, 254,
+    244, 248, 256, 261, 274, 281, 313, 328, 359, 400, 446, 487, 529, 572, 627, 687,
+    756, 821, 882, 946, 1021, 1104, 1180, 1259, 1348, 1421, 1519, 1598, 1680, 1778, 1867, 1957,
+    2044, 2140, 2234, 2313, 2402, 2492, 2584, 2674, 2753, 2839, 2915, 2992, 3077, 3145, 3217, 3281,
+    3352, 3402, 3470, 3521, 3562, 3621, 3659, 3689, 3733, 3757, 3779, 3812, 3827, 3842, 3849, 3850,
+    3843, 3833, 3823, 3808, 3802, 3766, 3752, 3705, 3668, 3634, 3599, 3537, 3487, 3433, 3372, 3317,
+    3251, 3172, 3103, 3026, 2958, 2877, 2789, 2715, 2631, 2547, 2458, 2357, 2265, 2184, 2097, 2004,
+    1915, 1824, 1736, 1646, 1563, 1478, 1387, 1301, 1222, 1149, 1063, 981, 924, 852, 787, 713,
+    667, 600, 555, 509, 454, 416, 382, 353, 322, 291, 272, 272, 258, 252, 248, 244,
+};
+
+#endif
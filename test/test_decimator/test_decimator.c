@@ -0,0 +1,231 @@
+/**
+ * @file test_decimator.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity tests of the CIC decimator: bit-exact output against a direct-form reference and the Q12.4 range
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "decimator.h"
+
+#define MAX_FRAMES 4096
+#define ADC_FULL_SCALE 4095
+#define Q4_FULL_SCALE (ADC_FULL_SCALE << DECIM_OUT_FRAC_BITS)
+#define SETTLE_OUTPUTS DECIM_ORDER  // Outputs before a step has passed through every stage
+
+static decimator_t decim;
+static uint16_t in[MAX_FRAMES][ACQ_MAX_CHANNELS];
+static uint16_t out[MAX_FRAMES][ACQ_MAX_CHANNELS];
+static uint16_t expected[MAX_FRAMES][ACQ_MAX_CHANNELS];
+static uint64_t taps[DECIM_ORDER * DECIM_MAX_RATIO];
+static uint32_t rng_state;
+
+void setUp(void) {
+    memset(in, 0, sizeof(in));
+    memset(out, 0, sizeof(out));
+    rng_state = 12345;
+}
+
+void tearDown(void) {
+}
+
+static uint32_t next_random(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 8;
+}
+
+// Impulse response of DECIM_ORDER boxcars of length ratio, in 64 bits. Returns the tap count.
+static size_t cic_taps(uint32_t ratio) {
+    size_t len = 1;
+
+    memset(taps, 0, sizeof(taps));
+    taps[0] = 1;
+    for(int stage = 0; stage < DECIM_ORDER; stage++) {
+        for(size_t k = len + ratio - 1; k-- > 0;) {
+            uint64_t sum = 0;
+            for(size_t j = 0; j < ratio && j <= k; j++) {
+                sum += k - j < len ? taps[k - j] : 0;
+            }
+            taps[k] = sum;
+        }
+        len += ratio - 1;
+    }
+    return len;
+}
+
+// Direct-form FIR over the whole input, without the modular arithmetic of the integrators
+static size_t reference(uint32_t ratio, uint8_t channels, size_t n) {
+    size_t len = cic_taps(ratio);
+    int shift = DECIM_ORDER * __builtin_ctz(ratio) - DECIM_OUT_FRAC_BITS;
+    size_t produced = 0;
+
+    for(size_t i = ratio - 1; i < n; i += ratio) {
+        for(int ch = 0; ch < channels; ch++) {
+            uint64_t y = 0;
+            for(size_t k = 0; k < len && k <= i; k++) {
+                y += taps[k] * in[i - k][ch];
+            }
+            uint64_t q4 = shift > 0 ? (y + (1ull << (shift - 1))) >> shift : y << -shift;
+            expected[produced][ch] = q4 > UINT16_MAX ? UINT16_MAX : (uint16_t) q4;
+        }
+        produced++;
+    }
+    return produced;
+}
+
+static void check_against_reference(uint32_t ratio, uint8_t channels, size_t n) {
+    TEST_ASSERT_EQUAL(ESP_OK, decimator_init(&decim, ratio, channels));
+    size_t produced = decimator_process(&decim, (const uint16_t(*)[ACQ_MAX_CHANNELS]) in, n, out);
+
+    TEST_ASSERT_EQUAL(reference(ratio, channels, n), produced);
+    for(size_t i = 0; i < produced; i++) {
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(expected[i], out[i], channels);
+    }
+}
+
+static void test_init_rejects_bad_arguments(void) {
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, decimator_init(&decim, 0, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, decimator_init(&decim, 3, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, decimator_init(&decim, DECIM_MAX_RATIO * 2, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, decimator_init(&decim, 4, ACQ_MAX_CHANNELS + 1));
+    TEST_ASSERT_EQUAL(ESP_OK, decimator_init(&decim, DECIM_MAX_RATIO, ACQ_MAX_CHANNELS));
+}
+
+static void test_known_outputs(void) {
+    // Ratio 2: taps 1 3 3 1 (gain 8), so Q12.4 is the filter output shifted left by one
+    const uint16_t step[] = { 800, 1600, 1600 };        // 100 from the first frame on
+    const uint16_t impulse[] = { 6000, 2000, 0 };       // 1000 in the first frame only
+    uint16_t got[3];
+
+    TEST_ASSERT_EQUAL(ESP_OK, decimator_init(&decim, 2, 2));
+    for(int i = 0; i < 6; i++) {
+        in[i][0] = 100;
+        in[i][1] = i == 0 ? 1000 : 0;
+    }
+    TEST_ASSERT_EQUAL(3, decimator_process(&decim, (const uint16_t(*)[ACQ_MAX_CHANNELS]) in, 6, out));
+    for(int i = 0; i < 3; i++) {
+        got[i] = out[i][0];
+    }
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(step, got, 3);
+    for(int i = 0; i < 3; i++) {
+        got[i] = out[i][1];
+    }
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(impulse, got, 3);
+
+    // Ratio 1 passes codes through as Q12.4
+    TEST_ASSERT_EQUAL(ESP_OK, decimator_init(&decim, 1, 1));
+    in[0][0] = ADC_FULL_SCALE;
+    in[1][0] = 1;
+    TEST_ASSERT_EQUAL(2, decimator_process(&decim, (const uint16_t(*)[ACQ_MAX_CHANNELS]) in, 2, out));
+    TEST_ASSERT_EQUAL_UINT16(Q4_FULL_SCALE, out[0][0]);
+    TEST_ASSERT_EQUAL_UINT16(16, out[1][0]);
+
+    // Ratio 4: a 4095 step from rest, rounded at each output (taps 1 3 6 10 12 12 10 6 3 1, gain 64)
+    const uint16_t step4[] = { 20475, 61425, 65520, 65520 };
+    TEST_ASSERT_EQUAL(ESP_OK, decimator_init(&decim, 4, 1));
+    for(int i = 0; i < 16; i++) {
+        in[i][0] = ADC_FULL_SCALE;
+    }
+    TEST_ASSERT_EQUAL(4, decimator_process(&decim, (const uint16_t(*)[ACQ_MAX_CHANNELS]) in, 16, out));
+    for(int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT16(step4[i], out[i][0]);
+    }
+}
+
+static void test_random_input_matches_reference(void) {
+    for(uint32_t ratio = 1; ratio <= DECIM_MAX_RATIO; ratio <<= 1) {
+        for(size_t i = 0; i < MAX_FRAMES; i++) {
+            for(int ch = 0; ch < ACQ_MAX_CHANNELS; ch++) {
+                in[i][ch] = next_random() % (ADC_FULL_SCALE + 1);
+            }
+        }
+        check_against_reference(ratio, ACQ_MAX_CHANNELS, MAX_FRAMES);
+    }
+}
+
+static void test_blocks_split_anywhere(void) {
+    static uint16_t whole[MAX_FRAMES][ACQ_MAX_CHANNELS];
+    const size_t cuts[] = { 1, 7, 63, 64, 65, 500 };
+
+    for(size_t i = 0; i < MAX_FRAMES; i++) {
+        in[i][0] = next_random() % (ADC_FULL_SCALE + 1);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, decimator_init(&decim, 16, 1));
+    size_t n_whole = decimator_process(&decim, (const uint16_t(*)[ACQ_MAX_CHANNELS]) in, MAX_FRAMES, whole);
+
+    // The phase and filter state carry over from one block to the next
+    for(size_t c = 0; c < sizeof(cuts) / sizeof(cuts[0]); c++) {
+        size_t produced = 0;
+        TEST_ASSERT_EQUAL(ESP_OK, decimator_init(&decim, 16, 1));
+        for(size_t i = 0; i < MAX_FRAMES; i += cuts[c]) {
+            size_t n = MAX_FRAMES - i < cuts[c] ? MAX_FRAMES - i : cuts[c];
+            produced += decimator_process(&decim, (const uint16_t(*)[ACQ_MAX_CHANNELS]) &in[i], n, &out[produced]);
+        }
+        TEST_ASSERT_EQUAL(n_whole, produced);
+        TEST_ASSERT_EQUAL_MEMORY(whole, out, n_whole * sizeof(out[0]));
+    }
+}
+
+static void test_full_scale_at_max_ratio(void) {
+    // Full scale on every input for long enough that every integrator wraps many times over.
+    // The outputs must settle on the exact Q12.4 full scale and never exceed it.
+    const uint32_t rounds = 256;
+    size_t produced = 0;
+
+    TEST_ASSERT_EQUAL(ESP_OK, decimator_init(&decim, DECIM_MAX_RATIO, ACQ_MAX_CHANNELS));
+    for(size_t i = 0; i < MAX_FRAMES; i++) {
+        for(int ch = 0; ch < ACQ_MAX_CHANNELS; ch++) {
+            in[i][ch] = ADC_FULL_SCALE;
+        }
+    }
+
+    for(uint32_t r = 0; r < rounds; r++) {
+        size_t n = decimator_process(&decim, (const uint16_t(*)[ACQ_MAX_CHANNELS]) in, MAX_FRAMES, out);
+        TEST_ASSERT_EQUAL(MAX_FRAMES / DECIM_MAX_RATIO, n);
+        for(size_t i = 0; i < n; i++, produced++) {
+            for(int ch = 0; ch < ACQ_MAX_CHANNELS; ch++) {
+                TEST_ASSERT_TRUE(out[i][ch] <= Q4_FULL_SCALE);
+                if(produced >= SETTLE_OUTPUTS - 1) {
+                    TEST_ASSERT_EQUAL_UINT16(Q4_FULL_SCALE, out[i][ch]);
+                }
+            }
+        }
+    }
+}
+
+static void test_worst_case_swings_at_max_ratio(void) {
+    // Square waves between 0 and full scale, in phase with the output and against it, stay within
+    // Q12.4 and match the reference exactly
+    const uint32_t periods[] = { 1, DECIM_MAX_RATIO / 2, DECIM_MAX_RATIO, DECIM_MAX_RATIO * 3 / 2, DECIM_MAX_RATIO * 2 };
+
+    for(size_t p = 0; p < sizeof(periods) / sizeof(periods[0]); p++) {
+        for(size_t i = 0; i < MAX_FRAMES; i++) {
+            for(int ch = 0; ch < ACQ_MAX_CHANNELS; ch++) {
+                bool high = (i / periods[p] + ch) % 2 == 0;
+                in[i][ch] = high ? ADC_FULL_SCALE : 0;
+            }
+        }
+        check_against_reference(DECIM_MAX_RATIO, ACQ_MAX_CHANNELS, MAX_FRAMES);
+        for(size_t i = 0; i < MAX_FRAMES / DECIM_MAX_RATIO; i++) {
+            for(int ch = 0; ch < ACQ_MAX_CHANNELS; ch++) {
+                TEST_ASSERT_TRUE(out[i][ch] <= Q4_FULL_SCALE);
+            }
+        }
+    }
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_init_rejects_bad_arguments);
+    RUN_TEST(test_known_outputs);
+    RUN_TEST(test_random_input_matches_reference);
+    RUN_TEST(test_blocks_split_anywhere);
+    RUN_TEST(test_full_scale_at_max_ratio);
+    RUN_TEST(test_worst_case_swings_at_max_ratio);
+    UNITY_END();
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_history.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity tests of the averaged history range queries, with a benchmark of /api/history query latency
+ *        against window size
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "history.h"
+
+#define STREAM_RATE_HZ (ACQ_SAMPLE_RATE_HZ / ACQ_DECIMATION_RATIO)  // Rate the pipeline feeds the history at
+#define PERIOD_US (1000000 / HISTORY_RATE_HZ)                          // Point spacing when fed at HISTORY_RATE_HZ
+#define BUCKET_CHUNK 16                                                 // Buckets aggregated per call, as in web.c
+#define BENCH_ROUNDS 20
+
+static history_bucket_t buckets[HISTORY_LEN];
+
+void setUp(void) {
+    memset(buckets, 0, sizeof(buckets));
+}
+
+void tearDown(void) {
+}
+
+// Feed count frames at the given rate from time 0: slot 0 counts up from 0, slot 1 down from 4000
+static void feed(uint32_t count, uint32_t rate_hz) {
+    for(uint32_t i = 0; i < count; i++) {
+        uint16_t mv[ACQ_MAX_CHANNELS] = { i % (HISTORY_MAX_MV + 1), 4000 - i % 4001 };
+        history_push_frame(i, (int64_t) i * 1000000 / rate_hz, mv);
+    }
+}
+
+static void test_find_resolves_times_to_points(void) {
+    history_range_t range;
+
+    // One point per frame, 100 points at 0 .. 9.9 s
+    history_reset(0x5, 2, HISTORY_RATE_HZ);
+    feed(100, HISTORY_RATE_HZ);
+
+    // Both ends fall on points
+    TEST_ASSERT_EQUAL(11, history_find(2 * PERIOD_US, 12 * PERIOD_US, &range));
+    TEST_ASSERT_EQUAL(2 * PERIOD_US, range.first_us);
+    TEST_ASSERT_EQUAL(PERIOD_US, range.period_us);
+    TEST_ASSERT_EQUAL_HEX16(0x5, range.channel_mask);
+    TEST_ASSERT_EQUAL(2, range.channel_count);
+
+    // Ends between points take the points inside
+    TEST_ASSERT_EQUAL(10, history_find(2 * PERIOD_US - 1, 12 * PERIOD_US - 1, &range));
+    TEST_ASSERT_EQUAL(2 * PERIOD_US, range.first_us);
+
+    // A start before the oldest point is clipped; a range past the newest point is empty
+    TEST_ASSERT_EQUAL(100, history_find(-1000000, 100 * PERIOD_US, &range));
+    TEST_ASSERT_EQUAL(0, range.first_us);
+    TEST_ASSERT_EQUAL(0, history_find(100 * PERIOD_US, 200 * PERIOD_US, &range));
+    TEST_ASSERT_EQUAL(0, history_find(5 * PERIOD_US, 4 * PERIOD_US, &range));
+    TEST_ASSERT_EQUAL(0, history_find(PERIOD_US + 1, 2 * PERIOD_US - 1, &range));
+}
+
+static void test_aggregate_buckets(void) {
+    history_range_t range;
+
+    history_reset(0x3, 2, HISTORY_RATE_HZ);
+    feed(100, HISTORY_RATE_HZ);
+    TEST_ASSERT_EQUAL(100, history_find(0, 99 * PERIOD_US, &range));
+
+    // Buckets of 30: the last one holds the 10 points left over
+    TEST_ASSERT_EQUAL(4, history_aggregate(&range, 0, 0, 30, buckets, 8));
+    TEST_ASSERT_EQUAL_UINT16(0, buckets[0].min_mv);
+    TEST_ASSERT_EQUAL_UINT16(29, buckets[0].max_mv);
+    TEST_ASSERT_EQUAL_UINT16(15, buckets[0].mean_mv);       // 14.5 rounded up
+    TEST_ASSERT_EQUAL_UINT16(90, buckets[3].min_mv);
+    TEST_ASSERT_EQUAL_UINT16(99, buckets[3].max_mv);
+    TEST_ASSERT_EQUAL_UINT16(95, buckets[3].mean_mv);
+
+    // Other slots, an offset into the range and fewer buckets than it holds
+    TEST_ASSERT_EQUAL(2, history_aggregate(&range, 1, 30, 30, buckets, 2));
+    TEST_ASSERT_EQUAL_UINT16(3941, buckets[0].min_mv);
+    TEST_ASSERT_EQUAL_UINT16(3970, buckets[0].max_mv);
+    TEST_ASSERT_EQUAL_UINT16(3911, buckets[1].min_mv);
+
+    // Bad arguments
+    TEST_ASSERT_EQUAL(0, history_aggregate(&range, 2, 0, 30, buckets, 8));
+    TEST_ASSERT_EQUAL(0, history_aggregate(&range, 0, 0, 0, buckets, 8));
+    TEST_ASSERT_EQUAL(0, history_aggregate(&range, 0, 100, 30, buckets, 8));
+}
+
+static void test_aggregate_averaged_points(void) {
+    history_range_t range;
+
+    // The stream rate is averaged down by the closest whole number of frames
+    const uint32_t decimation = (STREAM_RATE_HZ + HISTORY_RATE_HZ / 2) / HISTORY_RATE_HZ;
+    history_reset(0x1, 1, STREAM_RATE_HZ);
+    feed(decimation * 10, STREAM_RATE_HZ);
+
+    TEST_ASSERT_EQUAL(10, history_find(0, INT64_MAX, &range));
+    TEST_ASSERT_EQUAL(decimation * 1000000 / STREAM_RATE_HZ, range.period_us);
+    TEST_ASSERT_EQUAL(1, history_aggregate(&range, 0, 0, 10, buckets, 1));
+    TEST_ASSERT_EQUAL_UINT16((decimation - 1) / 2, buckets[0].min_mv);
+    TEST_ASSERT_EQUAL_UINT16(decimation * 9 + (decimation - 1) / 2, buckets[0].max_mv);
+}
+
+static void test_aggregate_fails_after_reset_or_overwrite(void) {
+    history_range_t range;
+
+    history_reset(0x1, 1, HISTORY_RATE_HZ);
+    feed(100, HISTORY_RATE_HZ);
+    TEST_ASSERT_EQUAL(100, history_find(0, INT64_MAX, &range));
+    history_reset(0x1, 1, HISTORY_RATE_HZ);
+    feed(100, HISTORY_RATE_HZ);
+    TEST_ASSERT_EQUAL(0, history_aggregate(&range, 0, 0, 10, buckets, 10));
+
+    // The oldest points are overwritten once the ring wraps past them
+    TEST_ASSERT_EQUAL(100, history_find(0, INT64_MAX, &range));
+    feed(HISTORY_LEN, HISTORY_RATE_HZ);
+    TEST_ASSERT_EQUAL(0, history_aggregate(&range, 0, 0, 10, buckets, 10));
+}
+
+// Time of the last window-seconds query of /api/history over a full history fed at the stream rate:
+// history_find() and every history_aggregate() call, with the [t, min, max, mean] text formatted into
+// the handler's 512-byte buffer but not sent. Reported per query and per point read.
+static void test_benchmark_query_latency(void) {
+    const uint32_t windows_s[] = { 10, 30, 60, 120, 300 };
+    const uint32_t points[] = { 500, 5000 };
+    char msg[128];
+    char buf[512];
+
+    history_reset(0xF, ACQ_MAX_CHANNELS, STREAM_RATE_HZ);
+    feed((uint32_t) ((uint64_t) HISTORY_LEN * STREAM_RATE_HZ / HISTORY_RATE_HZ) + STREAM_RATE_HZ, STREAM_RATE_HZ);
+
+    history_range_t full;
+    history_find(0, INT64_MAX, &full);
+    int64_t newest_us = full.first_us + (int64_t) (full.count - 1) * full.period_us;
+
+    for(size_t p = 0; p < sizeof(points) / sizeof(points[0]); p++) {
+        for(size_t w = 0; w < sizeof(windows_s) / sizeof(windows_s[0]); w++) {
+            history_range_t range;
+            uint32_t n_buckets = 0;
+            size_t chars = 0;
+
+            int64_t start = esp_timer_get_time();
+            for(int r = 0; r < BENCH_ROUNDS; r++) {
+                history_find(newest_us - (int64_t) windows_s[w] * 1000000, newest_us, &range);
+                uint32_t per_bucket = (range.count + points[p] - 1) / points[p];
+                n_buckets = (range.count + per_bucket - 1) / per_bucket;
+
+                int len = 0;
+                chars = 0;
+                for(uint32_t b = 0; b < n_buckets;) {
+                    size_t n = history_aggregate(&range, 0, b * per_bucket, per_bucket, buckets,
+                        n_buckets - b < BUCKET_CHUNK ? n_buckets - b : BUCKET_CHUNK);
+                    TEST_ASSERT_TRUE(n > 0);
+                    for(size_t i = 0; i < n; i++, b++) {
+                        if((size_t) len > sizeof(buf) - 48) {
+                            chars += len;
+                            len = 0;
+                        }
+                        len += snprintf(buf + len, sizeof(buf) - len, "%s[%lld,%u,%u,%u]", b > 0 ? "," : "",
+                            (long long) (range.first_us + (int64_t) b * per_bucket * range.period_us),
+                            buckets[i].min_mv, buckets[i].max_mv, buckets[i].mean_mv);
+                    }
+                }
+                chars += len;
+            }
+            double query_us = (double) (esp_timer_get_time() - start) / BENCH_ROUNDS;
+
+            snprintf(msg, sizeof(msg), "%u s window, points=%u: %u points in %u buckets, %zu B, %.1f us, %.1f ns per point",
+                (unsigned) windows_s[w], (unsigned) points[p], (unsigned) range.count, (unsigned) n_buckets, chars,
+                query_us, query_us * 1000 / range.count);
+            TEST_MESSAGE(msg);
+
+            // Bounded by points whatever the window
+            TEST_ASSERT_TRUE(n_buckets <= points[p]);
+        }
+    }
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_find_resolves_times_to_points);
+    RUN_TEST(test_aggregate_buckets);
+    RUN_TEST(test_aggregate_averaged_points);
+    RUN_TEST(test_aggregate_fails_after_reset_or_overwrite);
+    RUN_TEST(test_benchmark_query_latency);
+    UNITY_END();
+}
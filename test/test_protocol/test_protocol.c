@@ -0,0 +1,323 @@
+/**
+ * @file test_protocol.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity conformance tests of the binary frame header and payload encoding, with a size and encode time
+ *        benchmark against the JSON updates
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "esp_timer.h"
+#include "protocol.h"
+#include "codec.h"
+
+#define MAX_FRAMES 16
+#define MAX_SLOTS 4
+#define BENCH_FRAMES 4096
+#define BENCH_BATCH 32          // Frames per binary message in the batched runs
+#define BENCH_JSON_SIZE 256
+
+static uint8_t buf[PROTO_HEADER_SIZE + 4 + CODEC_DELTA_MAX_SIZE(MAX_FRAMES * MAX_SLOTS)];
+static uint16_t bench_mv[BENCH_FRAMES][MAX_SLOTS];
+static uint8_t bench_buf[PROTO_HEADER_SIZE + CODEC_DELTA_MAX_SIZE(BENCH_BATCH * MAX_SLOTS)];
+
+void setUp(void) {
+    memset(buf, 0xAA, sizeof(buf));
+}
+
+void tearDown(void) {
+}
+
+static uint16_t get_le16(const uint8_t* p) {
+    return p[0] | p[1] << 8;
+}
+
+static void assert_header_equal(const proto_header_t* expected, const proto_header_t* actual) {
+    TEST_ASSERT_EQUAL_UINT8(PROTO_VERSION, actual->version);
+    TEST_ASSERT_EQUAL_UINT8(expected->type, actual->type);
+    TEST_ASSERT_EQUAL_UINT8(expected->flags, actual->flags);
+    TEST_ASSERT_EQUAL_UINT8(__builtin_popcount(expected->channel_mask), actual->channel_count);
+    TEST_ASSERT_EQUAL_HEX16(expected->channel_mask, actual->channel_mask);
+    TEST_ASSERT_EQUAL_UINT16(expected->sample_count, actual->sample_count);
+    TEST_ASSERT_EQUAL_UINT32(expected->seq, actual->seq);
+    TEST_ASSERT_EQUAL_INT64(expected->timestamp_us, actual->timestamp_us);
+}
+
+static void test_header_byte_layout(void) {
+    proto_header_t header = {
+        .type = PROTO_TYPE_SAMPLES,
+        .flags = PROTO_FLAG_PIN | PROTO_FLAG_RETRANSMIT,
+        .channel_mask = 0x0109,
+        .sample_count = 0x0203,
+        .seq = 0x04050607,
+        .timestamp_us = 0x08090A0B0C0D0E0FLL,
+    };
+    const uint8_t expected[PROTO_HEADER_SIZE] = {
+        PROTO_VERSION, PROTO_TYPE_SAMPLES, 0x03, 3,
+        0x09, 0x01,
+        0x03, 0x02,
+        0x07, 0x06, 0x05, 0x04,
+        0x0F, 0x0E, 0x0D, 0x0C, 0x0B, 0x0A, 0x09, 0x08,
+    };
+
+    TEST_ASSERT_EQUAL(PROTO_HEADER_SIZE, proto_encode_header(buf, sizeof(buf), &header));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buf, PROTO_HEADER_SIZE);
+    TEST_ASSERT_EQUAL_HEX8(0xAA, buf[PROTO_HEADER_SIZE]);
+}
+
+static void test_header_round_trip_extremes(void) {
+    const proto_header_t cases[] = {
+        { .type = PROTO_TYPE_SAMPLES_DELTA, .channel_mask = 0x0001, .seq = 0, .timestamp_us = 0 },
+        { .type = PROTO_TYPE_SAMPLES_DELTA, .channel_mask = 0xFFFF, .sample_count = UINT16_MAX, .seq = UINT32_MAX,
+          .timestamp_us = INT64_MAX },
+        { .type = PROTO_TYPE_SAMPLES_DELTA, .flags = 0xFF, .channel_mask = 0x8000, .seq = 0x80000000,
+          .timestamp_us = INT64_MIN },
+        { .type = PROTO_TYPE_SAMPLES_DELTA, .channel_mask = 0x0000, .timestamp_us = -1 },
+        { .type = PROTO_TYPE_SAMPLES_DELTA, .channel_mask = 0x00F0, .timestamp_us = 0x00000001FFFFFFFFLL },
+    };
+    proto_header_t decoded;
+
+    for(size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        TEST_ASSERT_EQUAL(PROTO_HEADER_SIZE, proto_encode_header(buf, sizeof(buf), &cases[i]));
+        TEST_ASSERT_EQUAL_PTR(buf + PROTO_HEADER_SIZE, proto_decode_header(buf, PROTO_HEADER_SIZE, &decoded));
+        assert_header_equal(&cases[i], &decoded);
+        TEST_ASSERT_EQUAL_UINT32(0, decoded.period_us);
+        TEST_ASSERT_EQUAL_UINT32(0, decoded.rate_hz);
+    }
+}
+
+static void test_history_and_raw_carry_a_word(void) {
+    proto_header_t history = { .type = PROTO_TYPE_HISTORY, .channel_mask = 0x3, .period_us = 104000 };
+    proto_header_t raw = { .type = PROTO_TYPE_RAW, .channel_mask = 0x1, .rate_hz = 0xDEADBEEF };
+    proto_header_t decoded;
+
+    TEST_ASSERT_EQUAL(PROTO_HEADER_SIZE + 4, proto_encode_header(buf, sizeof(buf), &history));
+    TEST_ASSERT_EQUAL_PTR(buf + PROTO_HEADER_SIZE + 4, proto_decode_header(buf, PROTO_HEADER_SIZE + 4, &decoded));
+    TEST_ASSERT_EQUAL_UINT32(104000, decoded.period_us);
+    TEST_ASSERT_EQUAL_UINT32(0, decoded.rate_hz);
+
+    // With no samples, the raw header and its rate word are a complete frame
+    TEST_ASSERT_EQUAL(PROTO_HEADER_SIZE + 4, proto_encode_header(buf, sizeof(buf), &raw));
+    TEST_ASSERT_EQUAL_PTR(buf + PROTO_HEADER_SIZE + 4, proto_decode_header(buf, PROTO_HEADER_SIZE + 4, &decoded));
+    TEST_ASSERT_EQUAL_UINT32(0xDEADBEEF, decoded.rate_hz);
+    TEST_ASSERT_EQUAL_UINT32(0, decoded.period_us);
+
+    // Neither fits without room for the word
+    TEST_ASSERT_EQUAL(0, proto_encode_header(buf, PROTO_HEADER_SIZE + 3, &history));
+    TEST_ASSERT_EQUAL(0, proto_encode_header(buf, PROTO_HEADER_SIZE + 3, &raw));
+    TEST_ASSERT_EQUAL(PROTO_HEADER_SIZE + 4, proto_encode_header(buf, sizeof(buf), &history));
+    TEST_ASSERT_NULL(proto_decode_header(buf, PROTO_HEADER_SIZE + 3, &decoded));
+}
+
+static void test_decode_rejects_malformed_headers(void) {
+    proto_header_t header = { .type = PROTO_TYPE_SAMPLES_DELTA, .channel_mask = 0x5, .sample_count = 4 };
+    proto_header_t decoded;
+
+    TEST_ASSERT_EQUAL(0, proto_encode_header(buf, PROTO_HEADER_SIZE - 1, &header));
+    TEST_ASSERT_EQUAL(PROTO_HEADER_SIZE, proto_encode_header(buf, sizeof(buf), &header));
+    TEST_ASSERT_NULL(proto_decode_header(buf, PROTO_HEADER_SIZE - 1, &decoded));
+
+    buf[0] = PROTO_VERSION + 1;
+    TEST_ASSERT_NULL(proto_decode_header(buf, PROTO_HEADER_SIZE, &decoded));
+    buf[0] = PROTO_VERSION;
+
+    // Channel count that disagrees with the mask
+    buf[3] = 3;
+    TEST_ASSERT_NULL(proto_decode_header(buf, PROTO_HEADER_SIZE, &decoded));
+}
+
+static void test_samples_frame_round_trip(void) {
+    // Three channels out of frames of MAX_SLOTS, so the stride skips a slot
+    uint16_t frames[MAX_FRAMES][MAX_SLOTS];
+    proto_header_t header = { .type = PROTO_TYPE_SAMPLES, .channel_mask = 0x0D, .sample_count = MAX_FRAMES, .seq = 77 };
+    proto_header_t decoded;
+    size_t size = proto_frame_size(3, MAX_FRAMES);
+
+    for(int i = 0; i < MAX_FRAMES; i++) {
+        frames[i][0] = i;
+        frames[i][1] = 0xFFFF - i;
+        frames[i][2] = 0x8000 | i;
+        frames[i][3] = 0xDEAD;
+    }
+
+    TEST_ASSERT_EQUAL(0, proto_encode(buf, size - 1, &header, &frames[0][0], MAX_SLOTS));
+    TEST_ASSERT_EQUAL(size, proto_encode(buf, sizeof(buf), &header, &frames[0][0], MAX_SLOTS));
+
+    const uint8_t* p = proto_decode_header(buf, size, &decoded);
+    TEST_ASSERT_EQUAL_PTR(buf + PROTO_HEADER_SIZE, p);
+    assert_header_equal(&header, &decoded);
+    for(int i = 0; i < MAX_FRAMES; i++) {
+        for(int slot = 0; slot < 3; slot++, p += 2) {
+            TEST_ASSERT_EQUAL_HEX16(frames[i][slot], get_le16(p));
+        }
+    }
+
+    // A frame cut short of its samples is rejected
+    TEST_ASSERT_NULL(proto_decode_header(buf, size - 1, &decoded));
+}
+
+static void test_raw_frame_round_trip(void) {
+    uint16_t frames[MAX_FRAMES][MAX_SLOTS] = { { 0 } };
+    proto_header_t header = { .type = PROTO_TYPE_RAW, .channel_mask = 0x1, .sample_count = MAX_FRAMES, .rate_hz = 2000 };
+    proto_header_t decoded;
+    size_t size = proto_frame_size(1, MAX_FRAMES) + 4;
+
+    for(int i = 0; i < MAX_FRAMES; i++) {
+        frames[i][0] = 4095 - i;
+    }
+
+    TEST_ASSERT_EQUAL(0, proto_encode(buf, size - 1, &header, &frames[0][0], MAX_SLOTS));
+    TEST_ASSERT_EQUAL(size, proto_encode(buf, sizeof(buf), &header, &frames[0][0], MAX_SLOTS));
+
+    const uint8_t* p = proto_decode_header(buf, size, &decoded);
+    TEST_ASSERT_EQUAL_PTR(buf + PROTO_HEADER_SIZE + 4, p);
+    TEST_ASSERT_EQUAL_UINT32(2000, decoded.rate_hz);
+    for(int i = 0; i < MAX_FRAMES; i++, p += 2) {
+        TEST_ASSERT_EQUAL_UINT16(4095 - i, get_le16(p));
+    }
+    TEST_ASSERT_NULL(proto_decode_header(buf, size - 1, &decoded));
+}
+
+// Encode a delta frame for a channel mask and decode it with the channel count read from the header
+static void delta_round_trip(proto_type_t type, uint16_t channel_mask, uint16_t sample_count) {
+    uint16_t frames[MAX_FRAMES][MAX_SLOTS];
+    uint16_t decoded_frames[MAX_FRAMES][MAX_SLOTS];
+    proto_header_t header = { .type = type, .channel_mask = channel_mask, .sample_count = sample_count, .period_us = 1000 };
+    proto_header_t decoded;
+
+    for(int i = 0; i < MAX_FRAMES; i++) {
+        for(int slot = 0; slot < MAX_SLOTS; slot++) {
+            frames[i][slot] = (uint16_t) (slot * 1000 + i * (slot % 2 ? -7 : 5) + (i % 3 == 0 ? 0x7FFF : 0));
+        }
+    }
+    memset(decoded_frames, 0, sizeof(decoded_frames));
+
+    size_t len = proto_encode(buf, sizeof(buf), &header, &frames[0][0], MAX_SLOTS);
+    TEST_ASSERT_TRUE(len > 0);
+
+    const uint8_t* p = proto_decode_header(buf, len, &decoded);
+    TEST_ASSERT_NOT_NULL(p);
+    assert_header_equal(&header, &decoded);
+
+    const uint8_t* end = buf + len;
+    for(int slot = 0; slot < decoded.channel_count; slot++) {
+        size_t n = codec_delta_decode(p, end - p, &decoded_frames[0][slot], decoded.sample_count, MAX_SLOTS);
+        TEST_ASSERT_TRUE(n > 0 || sample_count == 0);
+        p += n;
+    }
+    TEST_ASSERT_EQUAL_PTR(end, p);
+
+    for(int i = 0; i < sample_count; i++) {
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(frames[i], decoded_frames[i], decoded.channel_count);
+    }
+}
+
+static void test_delta_frames_follow_channel_mask_changes(void) {
+    // Consecutive frames of one stream as channels are added and removed
+    const uint16_t masks[] = { 0x0001, 0x0005, 0x000F, 0x0008, 0x0006, 0x0001 };
+
+    for(size_t i = 0; i < sizeof(masks) / sizeof(masks[0]); i++) {
+        delta_round_trip(PROTO_TYPE_SAMPLES_DELTA, masks[i], MAX_FRAMES);
+        delta_round_trip(PROTO_TYPE_HISTORY, masks[i], MAX_FRAMES / 2);
+    }
+    delta_round_trip(PROTO_TYPE_SAMPLES_DELTA, 0x000F, 0);
+}
+
+static void test_delta_frame_too_small(void) {
+    uint16_t frames[MAX_FRAMES][MAX_SLOTS] = { { 0 } };
+    proto_header_t header = { .type = PROTO_TYPE_SAMPLES_DELTA, .channel_mask = 0x3, .sample_count = MAX_FRAMES };
+
+    // All zeros cost one byte per sample
+    TEST_ASSERT_EQUAL(PROTO_HEADER_SIZE + 2 * MAX_FRAMES, proto_encode(buf, sizeof(buf), &header, &frames[0][0], MAX_SLOTS));
+    TEST_ASSERT_EQUAL(0, proto_encode(buf, PROTO_HEADER_SIZE + 2 * MAX_FRAMES - 1, &header, &frames[0][0], MAX_SLOTS));
+}
+
+// One update in the text format the JSON clients receive (see the broadcast in web.c), without stats
+static int json_update(char* json, uint32_t seq, int64_t t, const uint16_t* mv, int channels) {
+    int len = snprintf(json, BENCH_JSON_SIZE, "{\"seq\": %lu, \"t\": %lld, \"pin\": %d, \"adc\": %d, \"channels\": [",
+        (unsigned long) seq, (long long) t, 0, mv[0]);
+    for(int ch = 0; ch < channels; ch++) {
+        len += snprintf(json + len, BENCH_JSON_SIZE - len, "%s{\"ch\": %d, \"mv\": %d}", ch ? "," : "", ch, mv[ch]);
+    }
+    len += snprintf(json + len, BENCH_JSON_SIZE - len, "]}");
+    return len;
+}
+
+// Bytes and encode time per frame of the binary formats, one frame and BENCH_BATCH frames per
+// message, against one JSON update per frame. The signal is a 16 Hz sine per channel at 2 kHz.
+static void test_benchmark_against_json(void) {
+    const int channel_counts[] = { 1, MAX_SLOTS };
+    const int batches[] = { 1, BENCH_BATCH };
+    const int64_t t0 = 1000000000LL;
+    char json[BENCH_JSON_SIZE];
+    char msg[128];
+
+    for(int i = 0; i < BENCH_FRAMES; i++) {
+        for(int slot = 0; slot < MAX_SLOTS; slot++) {
+            bench_mv[i][slot] = (uint16_t) (1650 + 1450 * sinf(2 * (float) M_PI * i / 125 + slot));
+        }
+    }
+
+    for(size_t c = 0; c < sizeof(channel_counts) / sizeof(channel_counts[0]); c++) {
+        int channels = channel_counts[c];
+        size_t json_bytes = 0;
+
+        int64_t start = esp_timer_get_time();
+        for(int i = 0; i < BENCH_FRAMES; i++) {
+            json_bytes += json_update(json, i, t0 + i * 500, bench_mv[i], channels);
+        }
+        int64_t json_us = esp_timer_get_time() - start;
+
+        for(size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); b++) {
+            for(uint8_t type = PROTO_TYPE_SAMPLES; type <= PROTO_TYPE_SAMPLES_DELTA; type++) {
+                size_t bytes = 0;
+
+                start = esp_timer_get_time();
+                for(int i = 0; i < BENCH_FRAMES; i += batches[b]) {
+                    proto_header_t header = {
+                        .type = type,
+                        .channel_mask = (1 << channels) - 1,
+                        .sample_count = batches[b],
+                        .seq = i,
+                        .timestamp_us = t0 + i * 500,
+                    };
+                    size_t len = proto_encode(bench_buf, sizeof(bench_buf), &header, bench_mv[i], MAX_SLOTS);
+                    TEST_ASSERT_TRUE(len > 0);
+                    bytes += len;
+                }
+                int64_t us = esp_timer_get_time() - start;
+
+                snprintf(msg, sizeof(msg), "%d ch, %2d per message, %-6s %5.1f B %5.0f ns per frame (JSON %5.1f B %5.0f ns)",
+                    channels, batches[b], type == PROTO_TYPE_SAMPLES ? "binary" : "delta", (double) bytes / BENCH_FRAMES,
+                    us * 1000.0 / BENCH_FRAMES, (double) json_bytes / BENCH_FRAMES, json_us * 1000.0 / BENCH_FRAMES);
+                TEST_MESSAGE(msg);
+                TEST_ASSERT_TRUE(bytes < json_bytes);
+            }
+        }
+    }
+
+    // The single-channel update quoted in protocol.h
+    TEST_ASSERT_EQUAL(22, proto_frame_size(1, 1));
+    TEST_ASSERT_EQUAL(90, json_update(json, 1234, t0, bench_mv[0], 1));
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_header_byte_layout);
+    RUN_TEST(test_header_round_trip_extremes);
+    RUN_TEST(test_history_and_raw_carry_a_word);
+    RUN_TEST(test_decode_rejects_malformed_headers);
+    RUN_TEST(test_samples_frame_round_trip);
+    RUN_TEST(test_raw_frame_round_trip);
+    RUN_TEST(test_delta_frames_follow_channel_mask_changes);
+    RUN_TEST(test_delta_frame_too_small);
+    RUN_TEST(test_benchmark_against_json);
+    UNITY_END();
+}
@@ -0,0 +1,274 @@
+/**
+ * @file test_sample_ring.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity tests of the SPSC sample ring: ordering, overruns, dropped blocks and a lossless run at the configured rate
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "sample_ring.h"
+#include "acquisition.h"
+
+#define RING_CAPACITY 8
+#define STALL_RATE_HZ 20000     // Frames per second of the mock producer in the stalling test
+#define STALL_CHANNELS 2
+#define STALL_BLOCKS 400        // Blocks attempted in the stalling test (2.56 s at 128 frames per block)
+#define TARGET_SECONDS 5        // Length of the run at the configured rate
+
+// Mock producer settings, and its results shared with the consumer only through the ring and done
+typedef struct {
+    uint32_t rate_hz;
+    uint8_t channels;
+    uint32_t blocks;
+    uint32_t dropped;
+} mock_run_t;
+
+static sample_block_t slots[RING_CAPACITY > ACQ_RING_BLOCKS ? RING_CAPACITY : ACQ_RING_BLOCKS];
+static sample_ring_t ring;
+static SemaphoreHandle_t done;
+
+void setUp(void) {
+    memset(slots, 0, sizeof(slots));
+    TEST_ASSERT_EQUAL(ESP_OK, sample_ring_init(&ring, slots, RING_CAPACITY));
+}
+
+void tearDown(void) {
+}
+
+// Sum of every sample of a block, carried in timestamp_us so the consumer can spot a torn block
+static int64_t block_checksum(const sample_block_t* block) {
+    int64_t sum = block->seq;
+    for(int i = 0; i < block->count; i++) {
+        for(int slot = 0; slot < block->channel_count; slot++) {
+            sum += block->samples[i][slot] * (slot + 1);
+        }
+    }
+    return sum;
+}
+
+static bool produce(uint32_t seq) {
+    sample_block_t* block = sample_ring_acquire(&ring);
+    if(block == NULL) {
+        return false;
+    }
+    block->seq = seq;
+    block->count = 1;
+    sample_ring_commit(&ring);
+    return true;
+}
+
+static uint32_t consume(void) {
+    const sample_block_t* block = sample_ring_peek(&ring);
+    TEST_ASSERT_NOT_NULL(block);
+    uint32_t seq = block->seq;
+    sample_ring_release(&ring);
+    return seq;
+}
+
+static void test_init_rejects_bad_capacity(void) {
+    sample_ring_t bad;
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, sample_ring_init(&bad, slots, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, sample_ring_init(&bad, slots, 6));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, sample_ring_init(&bad, NULL, RING_CAPACITY));
+    TEST_ASSERT_EQUAL(ESP_OK, sample_ring_init(&bad, slots, 1));
+}
+
+static void test_empty_ring(void) {
+    TEST_ASSERT_NULL(sample_ring_peek(&ring));
+    TEST_ASSERT_EQUAL_UINT32(0, sample_ring_count(&ring));
+}
+
+static void test_blocks_come_out_in_order(void) {
+    uint32_t next = 0;
+
+    // Varying fill levels walk the indices around the ring several times
+    for(uint32_t seq = 0; seq < 5 * RING_CAPACITY; seq++) {
+        TEST_ASSERT_TRUE(produce(seq));
+        if(seq % 3 != 0) {
+            while(sample_ring_count(&ring) > 0) {
+                TEST_ASSERT_EQUAL_UINT32(next++, consume());
+            }
+        }
+    }
+    while(sample_ring_count(&ring) > 0) {
+        TEST_ASSERT_EQUAL_UINT32(next++, consume());
+    }
+    TEST_ASSERT_EQUAL_UINT32(5 * RING_CAPACITY, next);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overruns);
+}
+
+static void test_full_ring_counts_overruns(void) {
+    for(uint32_t seq = 0; seq < RING_CAPACITY; seq++) {
+        TEST_ASSERT_TRUE(produce(seq));
+    }
+    TEST_ASSERT_EQUAL_UINT32(RING_CAPACITY, sample_ring_count(&ring));
+    TEST_ASSERT_EQUAL_UINT32(RING_CAPACITY, ring.high_water);
+
+    TEST_ASSERT_NULL(sample_ring_acquire(&ring));
+    TEST_ASSERT_NULL(sample_ring_acquire(&ring));
+    TEST_ASSERT_EQUAL_UINT32(2, ring.overruns);
+
+    // Releasing one block makes room for exactly one more
+    TEST_ASSERT_EQUAL_UINT32(0, consume());
+    TEST_ASSERT_TRUE(produce(RING_CAPACITY));
+    TEST_ASSERT_FALSE(produce(RING_CAPACITY + 1));
+    TEST_ASSERT_EQUAL_UINT32(3, ring.overruns);
+}
+
+static void test_dropped_blocks_leave_gaps_not_reordering(void) {
+    uint32_t dropped = 0;
+
+    // The acquisition task numbers every block, stored or not, so a drop shows up as a gap
+    for(uint32_t seq = 0; seq < RING_CAPACITY + 4; seq++) {
+        dropped += !produce(seq);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, dropped);
+    TEST_ASSERT_EQUAL_UINT32(dropped, ring.overruns);
+
+    // The oldest blocks are kept, the newest dropped
+    for(uint32_t seq = 0; seq < RING_CAPACITY; seq++) {
+        TEST_ASSERT_EQUAL_UINT32(seq, consume());
+    }
+    TEST_ASSERT_TRUE(produce(RING_CAPACITY + 4));
+    TEST_ASSERT_EQUAL_UINT32(RING_CAPACITY + 4, consume());
+    TEST_ASSERT_NULL(sample_ring_peek(&ring));
+}
+
+static void test_indices_wrap(void) {
+    // Start just below the wrap of the free-running indices
+    atomic_store(&ring.head, UINT32_MAX - 2);
+    atomic_store(&ring.tail, UINT32_MAX - 2);
+
+    for(uint32_t seq = 0; seq < RING_CAPACITY; seq++) {
+        TEST_ASSERT_TRUE(produce(seq));
+    }
+    TEST_ASSERT_EQUAL_UINT32(RING_CAPACITY, sample_ring_count(&ring));
+    TEST_ASSERT_NULL(sample_ring_acquire(&ring));
+
+    for(uint32_t seq = 0; seq < RING_CAPACITY; seq++) {
+        TEST_ASSERT_EQUAL_UINT32(seq, consume());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sample_ring_count(&ring));
+}
+
+// Fills blocks from the mock ADC source the way the acquisition task does, on the other core
+static void mock_producer_task(void* arg) {
+    static sample_block_t overrun_block;
+    mock_run_t* run = arg;
+    acq_scan_t scan = { .count = run->channels };
+
+    acq_mock_source.start(run->rate_hz, &scan);
+    run->dropped = 0;
+
+    for(uint32_t seq = 0; seq < run->blocks; seq++) {
+        sample_block_t* block = sample_ring_acquire(&ring);
+        if(block == NULL) {
+            block = &overrun_block;
+            run->dropped++;
+        }
+
+        block->count = 0;
+        while(block->count < ACQ_BLOCK_SIZE) {
+            block->count += acq_mock_source.read(&block->samples[block->count], ACQ_BLOCK_SIZE - block->count, 100);
+        }
+        block->seq = seq;
+        block->channel_count = run->channels;
+        block->timestamp_us = block_checksum(block);
+
+        if(block != &overrun_block) {
+            sample_ring_commit(&ring);
+        }
+    }
+
+    acq_mock_source.stop();
+    xSemaphoreGive(done);
+    vTaskDelete(NULL);
+}
+
+// Runs the mock producer and consumes on the test task, pausing stall_ms after every stall_every blocks
+// (0 for never). Returns the blocks received, all checked for order and content.
+static uint32_t run_mock_producer(mock_run_t* run, uint32_t stall_every, uint32_t stall_ms) {
+    uint32_t received = 0;
+    int64_t last_seq = -1;
+    bool finished = false;
+
+    done = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(done);
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(mock_producer_task, "mock_producer", 4096, run, 10, NULL, 1));
+
+    while(!finished || sample_ring_count(&ring) > 0) {
+        if(!finished) {
+            finished = xSemaphoreTake(done, 0) == pdTRUE;
+        }
+
+        const sample_block_t* block = sample_ring_peek(&ring);
+        if(block == NULL) {
+            vTaskDelay(1);
+            continue;
+        }
+
+        TEST_ASSERT_TRUE(block->seq > last_seq);
+        TEST_ASSERT_EQUAL_UINT16(ACQ_BLOCK_SIZE, block->count);
+        TEST_ASSERT_EQUAL_INT64(block_checksum(block), block->timestamp_us);
+        last_seq = block->seq;
+        received++;
+        sample_ring_release(&ring);
+
+        if(stall_every > 0 && received % stall_every == 0) {
+            vTaskDelay(pdMS_TO_TICKS(stall_ms));
+        }
+    }
+
+    vSemaphoreDelete(done);
+    return received;
+}
+
+static void test_mock_producer_stalled_consumer(void) {
+    mock_run_t run = { .rate_hz = STALL_RATE_HZ, .channels = STALL_CHANNELS, .blocks = STALL_BLOCKS };
+
+    // Stall now and then so the ring fills and the producer has to drop
+    uint32_t received = run_mock_producer(&run, 50, 100);
+
+    TEST_ASSERT_EQUAL_UINT32(STALL_BLOCKS, received + run.dropped);
+    TEST_ASSERT_EQUAL_UINT32(run.dropped, ring.overruns);
+    TEST_ASSERT_TRUE(run.dropped > 0);
+    TEST_ASSERT_TRUE(ring.high_water <= RING_CAPACITY);
+}
+
+static void test_mock_producer_at_target_rate(void) {
+    mock_run_t run = {
+        .rate_hz = ACQ_SAMPLE_RATE_HZ,
+        .channels = ACQ_MAX_CHANNELS,
+        .blocks = TARGET_SECONDS * ACQ_SAMPLE_RATE_HZ / ACQ_BLOCK_SIZE,
+    };
+
+    // The ring the acquisition task uses, and a consumer that keeps up: nothing may be lost
+    TEST_ASSERT_EQUAL(ESP_OK, sample_ring_init(&ring, slots, ACQ_RING_BLOCKS));
+    uint32_t received = run_mock_producer(&run, 0, 0);
+
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overruns);
+    TEST_ASSERT_EQUAL_UINT32(0, run.dropped);
+    TEST_ASSERT_EQUAL_UINT32(run.blocks, received);
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_init_rejects_bad_capacity);
+    RUN_TEST(test_empty_ring);
+    RUN_TEST(test_blocks_come_out_in_order);
+    RUN_TEST(test_full_ring_counts_overruns);
+    RUN_TEST(test_dropped_blocks_leave_gaps_not_reordering);
+    RUN_TEST(test_indices_wrap);
+    RUN_TEST(test_mock_producer_stalled_consumer);
+    RUN_TEST(test_mock_producer_at_target_rate);
+    UNITY_END();
+}
@@ -0,0 +1,325 @@
+/**
+ * @file test_template.c
+ * @author Creed Zagrzebski (czagrzebski@gmail.com)
+ * @brief Unity tests of the precompiled page templates against a string-replace reference, with a benchmark of
+ *        render time, chunk sends and peak heap against the old line-by-line renderer
+ * @version 0.1
+ * @date 2024-03-02
+ *
+ * @copyright Creed Zagrzebski (c) 2024
+ *
+ */
+
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "esp_timer.h"
+#include "template.h"
+
+#define INDEX_PAGE "data/index.html"     // Relative to the project directory, where the tests run
+#define CAPTURE_SIZE 65536
+#define BENCH_ROUNDS 50
+
+// Placeholders of the index page, as in web.c
+enum { VAR_GIT, VAR_MAC, VAR_AP_IP, VAR_STA_SSID, VAR_AP_SSID, VAR_AP_PASSKEY, VAR_STA_IP, VAR_MODE,
+    VAR_STATIC_IP, VAR_GATEWAY, VAR_NETMASK, VAR_IP_MODE, VAR_COUNT };
+
+static const char* const vars[VAR_COUNT] = {
+    "GIT_COMMIT_HASH", "MAC_ADDRESS", "AP_IP", "STA_SSID", "AP_SSID", "AP_PASSKEY", "STA_IP", "MODE",
+    "STA_STATIC_IP", "STA_GATEWAY", "STA_NETMASK", "STA_IP_MODE",
+};
+
+static const char* const values[VAR_COUNT] = {
+    "3f9c2d1", "7C:DF:A1:0B:22:3C", "192.168.4.1", "Workshop", "SensorLink-223C", "sensorlink", "10.0.0.42",
+    "APSTA", "10.0.0.42", "10.0.0.1", "255.255.255.0", "1",
+};
+
+// What was sent
+typedef struct {
+    bool capture;
+    size_t len;
+    size_t sends;
+    size_t largest;
+    bool finished;
+    char data[CAPTURE_SIZE];
+} response_t;
+
+static response_t response;
+static esp_err_t send_chunk(httpd_req_t* r, const char* buf, ssize_t buf_len);
+static httpd_req_t req = { .user_ctx = &response, .send_chunk = send_chunk };
+static template_t tpl;
+static char path[] = "/tmp/test_templateXXXXXX";
+static char expected[CAPTURE_SIZE];
+
+// Heap in use by the test thread while counting, through the glibc allocator entry points
+#ifdef __GLIBC__
+#include <malloc.h>
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static __thread bool heap_counting = false;
+static int64_t heap_in_use;
+static int64_t heap_peak;
+static size_t heap_allocs;
+
+static void heap_add(void* ptr, int64_t sign) {
+    if(heap_counting && ptr != NULL) {
+        heap_in_use += sign * (int64_t) malloc_usable_size(ptr);
+        heap_peak = heap_in_use > heap_peak ? heap_in_use : heap_peak;
+        heap_allocs += sign > 0;
+    }
+}
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    heap_add(ptr, 1);
+    return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+    void* ptr = __libc_calloc(count, size);
+    heap_add(ptr, 1);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    heap_add(ptr, -1);
+    ptr = __libc_realloc(ptr, size);
+    heap_add(ptr, 1);
+    return ptr;
+}
+
+void free(void* ptr) {
+    heap_add(ptr, -1);
+    __libc_free(ptr);
+}
+
+static void heap_start(void) {
+    heap_in_use = 0;
+    heap_peak = 0;
+    heap_allocs = 0;
+    heap_counting = true;
+}
+
+static void heap_stop(void) {
+    heap_counting = false;
+}
+#else
+static int64_t heap_peak = -1;
+static size_t heap_allocs = 0;
+
+static void heap_start(void) {
+}
+
+static void heap_stop(void) {
+}
+#endif
+
+static esp_err_t send_chunk(httpd_req_t* r, const char* buf, ssize_t buf_len) {
+    response_t* resp = r->user_ctx;
+
+    if(buf == NULL) {
+        resp->finished = true;
+        return ESP_OK;
+    }
+    TEST_ASSERT_FALSE(resp->finished);
+    if(resp->capture) {
+        TEST_ASSERT_TRUE(resp->len + buf_len <= sizeof(resp->data));
+        memcpy(resp->data + resp->len, buf, buf_len);
+    }
+    resp->len += buf_len;
+    resp->sends++;
+    resp->largest = (size_t) buf_len > resp->largest ? (size_t) buf_len : resp->largest;
+    return ESP_OK;
+}
+
+void setUp(void) {
+    memset(&response, 0, sizeof(response));
+    response.capture = true;
+    memset(&tpl, 0, sizeof(tpl));
+}
+
+void tearDown(void) {
+    unlink(path);
+}
+
+static void write_page(const char* text) {
+    strcpy(path, "/tmp/test_templateXXXXXX");
+    int fd = mkstemp(path);
+    TEST_ASSERT_TRUE(fd >= 0);
+    TEST_ASSERT_EQUAL(strlen(text), write(fd, text, strlen(text)));
+    close(fd);
+}
+
+// The old renderer's replace_variable(): a fresh string with every placeholder replaced
+static char* replace_variable(const char* source, const char* placeholder, const char* replacement) {
+    const char* p = source;
+    size_t placeholder_len = strlen(placeholder);
+    size_t replacement_len = strlen(replacement);
+    size_t count = 0;
+
+    while((p = strstr(p, placeholder)) != NULL) {
+        p += placeholder_len;
+        count++;
+    }
+
+    char* result = malloc(strlen(source) + count * replacement_len - count * placeholder_len + 1);
+    char* out = result;
+    while(*source) {
+        if(strstr(source, placeholder) == source) {
+            memcpy(out, replacement, replacement_len);
+            out += replacement_len;
+            source += placeholder_len;
+        } else {
+            *out++ = *source++;
+        }
+    }
+    *out = '\0';
+    return result;
+}
+
+// The old index_handler: fgets() line by line, every placeholder replaced in turn, one chunk per line
+static void render_before(const char* file, const char* const* vals) {
+    char placeholder[TEMPLATE_MAX_NAME + 4];
+    char line[1024];
+
+    FILE* f = fopen(file, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    while(fgets(line, sizeof(line), f)) {
+        char* text = NULL;
+        for(int v = 0; v < VAR_COUNT; v++) {
+            snprintf(placeholder, sizeof(placeholder), "{{%s}}", vars[v]);
+            char* next = replace_variable(v == 0 ? line : text, placeholder, vals[v] != NULL ? vals[v] : "");
+            free(text);
+            text = next;
+        }
+        httpd_resp_send_chunk(&req, text, strlen(text));
+        free(text);
+    }
+    fclose(f);
+    httpd_resp_send_chunk(&req, NULL, 0);
+}
+
+static void test_placeholders_replaced(void) {
+    write_page("<p>{{MODE}}</p>{{AP_IP}}{{AP_IP}} {{UNKNOWN}} {MODE}} {{MODE} {{mode}}\n");
+
+    TEST_ASSERT_EQUAL(ESP_OK, template_compile(&tpl, path, vars, VAR_COUNT));
+    TEST_ASSERT_EQUAL(ESP_OK, template_render(&tpl, &req, values));
+    TEST_ASSERT_TRUE(response.finished);
+
+    // Unknown and malformed names stay in the page
+    const char* page = "<p>APSTA</p>192.168.4.1192.168.4.1 {{UNKNOWN}} {MODE}} {{MODE} {{mode}}\n";
+    TEST_ASSERT_EQUAL(strlen(page), response.len);
+    TEST_ASSERT_EQUAL_MEMORY(page, response.data, response.len);
+}
+
+static void test_values_of_any_length(void) {
+    static char long_value[3 * TEMPLATE_SEND_BUFFER];
+    const char* vals[VAR_COUNT] = { NULL };
+
+    memset(long_value, 'x', sizeof(long_value) - 1);
+    vals[VAR_MODE] = long_value;
+    write_page("[{{MODE}}][{{AP_IP}}]");
+
+    // NULL values render empty; values longer than the send buffer are split over chunks
+    TEST_ASSERT_EQUAL(ESP_OK, template_compile(&tpl, path, vars, VAR_COUNT));
+    TEST_ASSERT_EQUAL(ESP_OK, template_render(&tpl, &req, vals));
+    TEST_ASSERT_EQUAL(strlen(long_value) + 4, response.len);
+    TEST_ASSERT_EQUAL_MEMORY("[x", response.data, 2);
+    TEST_ASSERT_EQUAL_MEMORY("x][]", response.data + response.len - 4, 4);
+    TEST_ASSERT_EQUAL(TEMPLATE_SEND_BUFFER, response.largest);
+    TEST_ASSERT_EQUAL((response.len + TEMPLATE_SEND_BUFFER - 1) / TEMPLATE_SEND_BUFFER, response.sends);
+}
+
+static void test_errors(void) {
+    static char page[TEMPLATE_MAX_SEGMENTS * 10];
+
+    // Not compiled, missing file
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, template_render(&tpl, &req, values));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, template_compile(&tpl, "/tmp/no/such/page.html", vars, VAR_COUNT));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, template_render(&tpl, &req, values));
+
+    // More segments than a template holds
+    page[0] = '\0';
+    for(int i = 0; i < TEMPLATE_MAX_SEGMENTS; i++) {
+        strcat(page, "-{{MODE}}");
+    }
+    write_page(page);
+    TEST_ASSERT_EQUAL(ESP_ERR_NO_MEM, template_compile(&tpl, path, vars, VAR_COUNT));
+    TEST_ASSERT_FALSE(tpl.compiled);
+    unlink(path);
+
+    // A page edited after it was compiled is refused rather than rendered from stale offsets
+    write_page("<p>{{MODE}}</p>");
+    TEST_ASSERT_EQUAL(ESP_OK, template_compile(&tpl, path, vars, VAR_COUNT));
+    FILE* f = fopen(path, "a");
+    fputs("<p>more</p>", f);
+    fclose(f);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, template_render(&tpl, &req, values));
+    TEST_ASSERT_EQUAL(0, response.sends);
+}
+
+static void test_index_page_matches_reference(void) {
+    TEST_ASSERT_EQUAL(ESP_OK, template_compile(&tpl, INDEX_PAGE, vars, VAR_COUNT));
+    TEST_ASSERT_EQUAL(ESP_OK, template_render(&tpl, &req, values));
+    size_t len = response.len;
+    memcpy(expected, response.data, len);
+
+    memset(&response, 0, sizeof(response));
+    response.capture = true;
+    render_before(INDEX_PAGE, values);
+    TEST_ASSERT_EQUAL(response.len, len);
+    TEST_ASSERT_EQUAL_MEMORY(response.data, expected, len);
+}
+
+// Render time, chunk sends and peak heap of the index page with the old line-by-line renderer and the
+// precompiled template. Sends are counted, not made; the file is read from the host's page cache.
+static void test_benchmark_render(void) {
+    char msg[160];
+
+    TEST_ASSERT_EQUAL(ESP_OK, template_compile(&tpl, INDEX_PAGE, vars, VAR_COUNT));
+    response.capture = false;
+
+    for(int after = 0; after < 2; after++) {
+        int64_t start = esp_timer_get_time();
+        for(int r = 0; r < BENCH_ROUNDS; r++) {
+            response.len = 0;
+            response.sends = 0;
+            response.largest = 0;
+            response.finished = false;
+            heap_start();
+            if(after) {
+                TEST_ASSERT_EQUAL(ESP_OK, template_render(&tpl, &req, values));
+            } else {
+                render_before(INDEX_PAGE, values);
+            }
+            heap_stop();
+        }
+        double render_us = (double) (esp_timer_get_time() - start) / BENCH_ROUNDS;
+
+        snprintf(msg, sizeof(msg), "%s: %zu B in %zu sends (largest %zu), %.1f us, %zu mallocs, peak heap %lld B",
+            after ? "template" : "line by line", response.len, response.sends, response.largest, render_us,
+            heap_allocs, (long long) heap_peak);
+        TEST_MESSAGE(msg);
+
+        if(after) {
+            TEST_ASSERT_EQUAL(0, heap_allocs);
+            TEST_ASSERT_EQUAL((response.len + TEMPLATE_SEND_BUFFER - 1) / TEMPLATE_SEND_BUFFER, response.sends);
+        }
+    }
+}
+
+void app_main(void) {
+    UNITY_BEGIN();
+    RUN_TEST(test_placeholders_replaced);
+    RUN_TEST(test_values_of_any_length);
+    RUN_TEST(test_errors);
+    RUN_TEST(test_index_page_matches_reference);
+    RUN_TEST(test_benchmark_render);
+    UNITY_END();
+}
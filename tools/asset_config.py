@@ -0,0 +1,57 @@
+"""Which files of data/ are static assets, read from the firmware sources.
+
+The content types come from the table in src/content_types.c and the limits from
+src/assets.h, so tools/compress_assets.py and tools/pack_assets.py select exactly the
+files the server can index and serve, and fail rather than build something it would
+silently cut short.
+"""
+
+import collections
+import os
+import re
+
+MANIFEST = "etags.txt"
+
+AssetConfig = collections.namedtuple("AssetConfig", "types max_assets max_name")
+
+
+def _define(text, name):
+    match = re.search(r"^#define %s (\d+)" % name, text, re.MULTILINE)
+    if match is None:
+        raise ValueError("%s not found in assets.h" % name)
+    return int(match.group(1))
+
+
+def load(src_dir):
+    """Extension -> (content type, worth a gzip copy), ASSETS_MAX and ASSETS_MAX_NAME."""
+    with open(os.path.join(src_dir, "content_types.c")) as f:
+        rows = re.findall(r'\{\s*"(\.\w+)",\s*"([^"]+)",\s*(true|false)\s*\}', f.read())
+    if not rows:
+        raise ValueError("no content types found in content_types.c")
+    with open(os.path.join(src_dir, "assets.h")) as f:
+        header = f.read()
+    return AssetConfig(types={ext: (ctype, gzip == "true") for ext, ctype, gzip in rows},
+                       max_assets=_define(header, "ASSETS_MAX"), max_name=_define(header, "ASSETS_MAX_NAME"))
+
+
+def select(config, data_dir):
+    """Sorted (name, path) of the assets in data_dir. Raises ValueError past the firmware's limits."""
+    assets = []
+    for name in sorted(os.listdir(data_dir)):
+        path = os.path.join(data_dir, name)
+        if os.path.isfile(path) and os.path.splitext(name)[1] in config.types and name != MANIFEST:
+            if len(name) >= config.max_name:
+                raise ValueError("asset name too long (ASSETS_MAX_NAME is %d): %s" % (config.max_name, name))
+            assets.append((name, path))
+    if len(assets) > config.max_assets:
+        raise ValueError("%d assets in %s, the firmware serves at most ASSETS_MAX = %d"
+                         % (len(assets), data_dir, config.max_assets))
+    return assets
+
+
+def content_type(config, name):
+    return config.types[os.path.splitext(name)[1]][0]
+
+
+def compressible(config, name):
+    return config.types[os.path.splitext(name)[1]][1]
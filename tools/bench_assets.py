@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Measure requests/s and latency of a static asset served by SensorLink.
+
+Each connection fetches the asset over a persistent HTTP/1.1 connection, back to back, and
+the time from sending the request to reading the last byte of the body is recorded. The
+report gives the encoding sent, which path served it (flash: one response with a
+Content-Length, straight from the mapped assets partition; spiffs: chunked, read through
+the file system), the size, requests/s, MB/s and latency percentiles.
+
+To compare the two paths for chart.js on one board:
+    pio run -t upload -t uploadfs -t uploadassets
+    python tools/bench_assets.py sensorlink.local                  # flash
+    python tools/bench_assets.py sensorlink.local --gzip
+    parttool.py erase_partition --partition-name assets             # then reset the board
+    python tools/bench_assets.py sensorlink.local                  # spiffs
+    python tools/bench_assets.py sensorlink.local --gzip
+"""
+
+import argparse
+import http.client
+import sys
+import threading
+import time
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))]
+
+
+class Worker(threading.Thread):
+    def __init__(self, host, port, path, headers, count, timeout):
+        super().__init__(daemon=True)
+        self.host = host
+        self.port = port
+        self.path = path
+        self.headers = headers
+        self.count = count
+        self.timeout = timeout
+        self.latencies = []
+        self.bytes = 0
+        self.errors = 0
+        self.reconnects = 0
+        self.chunked = None
+        self.encoding = None
+        self.length = None
+
+    def run(self):
+        conn = None
+        for _ in range(self.count):
+            if conn is None:
+                conn = http.client.HTTPConnection(self.host, self.port, timeout=self.timeout)
+            try:
+                start = time.perf_counter()
+                conn.request("GET", self.path, headers=self.headers)
+                resp = conn.getresponse()
+                body = resp.read()
+                elapsed = time.perf_counter() - start
+            except (OSError, http.client.HTTPException):
+                self.errors += 1
+                self.reconnects += 1
+                conn.close()
+                conn = None
+                continue
+
+            if resp.status != 200:
+                self.errors += 1
+                continue
+            self.latencies.append(elapsed)
+            self.bytes += len(body)
+            self.chunked = resp.getheader("Transfer-Encoding", "").lower() == "chunked"
+            self.encoding = resp.getheader("Content-Encoding", "identity")
+            self.length = len(body)
+            if resp.will_close:
+                self.reconnects += 1
+                conn.close()
+                conn = None
+        if conn is not None:
+            conn.close()
+
+
+def run(args):
+    headers = {"Accept-Encoding": "gzip" if args.gzip else "identity"}
+    per_connection = max(1, args.requests // args.connections)
+
+    # One request first, so the connection setup and a cold cache are not counted
+    warm = Worker(args.host, args.port, args.path, headers, 1, args.timeout)
+    warm.run()
+    if not warm.latencies:
+        print("%s:%d%s did not answer 200" % (args.host, args.port, args.path), file=sys.stderr)
+        return 1
+
+    workers = [Worker(args.host, args.port, args.path, headers, per_connection, args.timeout)
+               for _ in range(args.connections)]
+    start = time.perf_counter()
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    elapsed = time.perf_counter() - start
+
+    latencies = [t for w in workers for t in w.latencies]
+    total_bytes = sum(w.bytes for w in workers)
+    errors = sum(w.errors for w in workers)
+    if not latencies:
+        print("no successful requests, %d errors" % errors, file=sys.stderr)
+        return 1
+
+    print("%s%s, %s, %s: %d B" % (args.host, args.path, warm.encoding, "spiffs" if warm.chunked else "flash",
+                                  warm.length))
+    print("  %d requests on %d connections in %.2f s, %d errors, %d reconnects"
+          % (len(latencies), args.connections, elapsed, errors, sum(w.reconnects for w in workers)))
+    print("  %.1f requests/s, %.2f MB/s" % (len(latencies) / elapsed, total_bytes / elapsed / 1e6))
+    print("  latency ms: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f"
+          % tuple(1000 * v for v in (percentile(latencies, 50), percentile(latencies, 90),
+                                     percentile(latencies, 99), max(latencies))))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("host", help="device address, e.g. sensorlink.local or 192.168.4.1")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--path", default="/chart.js")
+    parser.add_argument("--requests", type=int, default=200, help="requests in total")
+    parser.add_argument("--connections", type=int, default=1,
+                        help="parallel connections (the server answers one request at a time)")
+    parser.add_argument("--gzip", action="store_true", help="accept the gzip copy")
+    parser.add_argument("--timeout", type=float, default=10.0)
+    return run(parser.parse_args())
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Gzip the static web assets in data/ and record their content hashes.
+
+For every static asset (a file whose extension is listed in src/content_types.c; not the
+HTML pages, which are templates rendered on the device) this writes data/etags.txt with one
+"<name> <hash>" line per asset, and data/<name>.gz, compressed reproducibly, for the types
+worth compressing. The hash is the start of the SHA-256 of the uncompressed file; the
+server uses it as the strong ETag of the asset. More assets than ASSETS_MAX (src/assets.h)
+are an error.
+
+Runs as a PlatformIO pre-script (extra_scripts in platformio.ini), so the files are up to
+date before "pio run -t buildfs/uploadfs", or on its own: python tools/compress_assets.py
+"""
+
+import gzip
+import hashlib
+import io
+import os
+import sys
+
+try:
+    Import("env")  # noqa: F821 - defined when run by PlatformIO
+    sys.path.insert(0, env.subst("$PROJECT_DIR/tools"))  # noqa: F821
+except NameError:
+    env = None
+
+import asset_config  # noqa: E402
+
+HASH_LEN = 16
+
+
+def compress(data):
+    out = io.BytesIO()
+    # mtime=0 keeps the output identical for identical input
+    with gzip.GzipFile(filename="", mode="wb", fileobj=out, compresslevel=9, mtime=0) as gz:
+        gz.write(data)
+    return out.getvalue()
+
+
+def write_if_changed(path, data):
+    if os.path.exists(path):
+        with open(path, "rb") as f:
+            if f.read() == data:
+                return False
+    with open(path, "wb") as f:
+        f.write(data)
+    return True
+
+
+def build(data_dir, src_dir):
+    config = asset_config.load(src_dir)
+    lines = []
+    for name, path in asset_config.select(config, data_dir):
+        with open(path, "rb") as f:
+            data = f.read()
+
+        digest = hashlib.sha256(data).hexdigest()[:HASH_LEN]
+        if asset_config.compressible(config, name):
+            packed = compress(data)
+            if write_if_changed(path + ".gz", packed):
+                print("assets: %s %d -> %d bytes (%s)" % (name, len(data), len(packed), digest))
+        elif os.path.exists(path + ".gz"):
+            # The server would send a stale copy
+            os.remove(path + ".gz")
+        lines.append("%s %s\n" % (name, digest))
+
+    write_if_changed(os.path.join(data_dir, asset_config.MANIFEST), "".join(lines).encode())
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    try:
+        build(sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, "data"), os.path.join(root, "src"))
+    except ValueError as e:
+        print("assets: %s" % e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if env is not None:
+    try:
+        build(env.subst("$PROJECT_DATA_DIR"), env.subst("$PROJECT_SRC_DIR"))
+    except ValueError as e:
+        print("assets: %s" % e, file=sys.stderr)
+        env.Exit(1)
+elif __name__ == "__main__":
+    sys.exit(main())
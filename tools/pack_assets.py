@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Pack the static web assets in data/ into a read-only flash partition image.
+
+The image is mapped into the address space by the firmware (esp_partition_mmap) and the
+assets are sent straight from flash, without going through SPIFFS. Layout, little endian:
+
+    header  magic "SLA1", u16 version, u16 entry count, u32 image size, u32 reserved
+    entry   char path[32], char content_type[32], char hash[16],
+            u32 offset, u32 length, u32 gz_offset, u32 gz_length      (one per asset)
+    data    identity and gzip copy of each asset, 4-byte aligned
+
+Offsets are from the start of the partition. The hash is the same content hash as in
+data/etags.txt (tools/compress_assets.py) and is the asset's ETag. The assets and their
+content types are the files whose extension is listed in src/content_types.c; a gzip copy
+is kept for the types worth compressing, when it is smaller. More assets than ASSETS_MAX
+(src/assets.h) are an error, as the firmware would not index the rest.
+
+As a PlatformIO pre-script (extra_scripts in platformio.ini) the image is written to
+$BUILD_DIR/assets.bin and "pio run -t uploadassets" flashes it to the "assets" partition.
+Standalone: python tools/pack_assets.py [data_dir] [output]
+"""
+
+import gzip
+import hashlib
+import io
+import os
+import struct
+import sys
+
+try:
+    Import("env")  # noqa: F821 - defined when run by PlatformIO
+    sys.path.insert(0, env.subst("$PROJECT_DIR/tools"))  # noqa: F821
+except NameError:
+    env = None
+
+import asset_config  # noqa: E402
+
+PARTITION_LABEL = "assets"
+PARTITION_SIZE = 512 * 1024  # Keep in line with partitions.csv
+MAGIC = 0x31414C53  # "SLA1"
+VERSION = 1
+HEADER = struct.Struct("<IHHII")
+ENTRY = struct.Struct("<32s32s16sIIII")
+NAME_LEN = 32
+TYPE_LEN = 32
+HASH_LEN = 16
+
+
+def compress(data):
+    out = io.BytesIO()
+    with gzip.GzipFile(filename="", mode="wb", fileobj=out, compresslevel=9, mtime=0) as gz:
+        gz.write(data)
+    return out.getvalue()
+
+
+def align(blob):
+    blob.extend(b"\0" * (-len(blob) % 4))
+
+
+def pack(data_dir, src_dir):
+    config = asset_config.load(src_dir)
+    assets = []
+    for name, path in asset_config.select(config, data_dir):
+        if len(name) >= NAME_LEN:
+            raise ValueError("asset name too long: %s" % name)
+        with open(path, "rb") as f:
+            assets.append((name, f.read()))
+
+    blob = bytearray(HEADER.size + ENTRY.size * len(assets))
+    entries = []
+    for name, data in assets:
+        digest = hashlib.sha256(data).hexdigest()[:HASH_LEN]
+        offset = len(blob)
+        blob.extend(data)
+        align(blob)
+
+        # Only keep the gzip copy when it is smaller
+        packed = compress(data) if asset_config.compressible(config, name) else data
+        gz_offset, gz_length = 0, 0
+        if len(packed) < len(data):
+            gz_offset, gz_length = len(blob), len(packed)
+            blob.extend(packed)
+            align(blob)
+
+        content_type = asset_config.content_type(config, name)
+        if len(content_type) >= TYPE_LEN:
+            raise ValueError("content type too long: %s" % content_type)
+        entries.append(ENTRY.pack(name.encode(), content_type.encode(),
+                                  digest.encode(), offset, len(data), gz_offset, gz_length))
+
+    HEADER.pack_into(blob, 0, MAGIC, VERSION, len(entries), len(blob), 0)
+    blob[HEADER.size:HEADER.size + ENTRY.size * len(entries)] = b"".join(entries)
+    if len(blob) > PARTITION_SIZE:
+        raise ValueError("assets image is %d bytes, the partition holds %d" % (len(blob), PARTITION_SIZE))
+    return bytes(blob), len(entries)
+
+
+def write(data_dir, src_dir, output):
+    image, count = pack(data_dir, src_dir)
+    if os.path.exists(output):
+        with open(output, "rb") as f:
+            if f.read() == image:
+                return
+    os.makedirs(os.path.dirname(os.path.abspath(output)), exist_ok=True)
+    with open(output, "wb") as f:
+        f.write(image)
+    print("assets: %s, %d assets, %d of %d bytes" % (output, count, len(image), PARTITION_SIZE))
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    data_dir = sys.argv[1] if len(sys.argv) > 1 else os.path.join(root, "data")
+    output = sys.argv[2] if len(sys.argv) > 2 else os.path.join(root, ".pio", "build", "assets.bin")
+    try:
+        write(data_dir, os.path.join(root, "src"), output)
+    except ValueError as e:
+        print("assets: %s" % e, file=sys.stderr)
+        return 1
+    return 0
+
+
+if env is not None:
+    image = env.subst("$BUILD_DIR/assets.bin")
+    try:
+        write(env.subst("$PROJECT_DATA_DIR"), env.subst("$PROJECT_SRC_DIR"), image)
+    except ValueError as e:
+        print("assets: %s" % e, file=sys.stderr)
+        env.Exit(1)
+
+    parttool = os.path.join(env.PioPlatform().get_package_dir("framework-espidf"),
+                            "components", "partition_table", "parttool.py")
+    port = env.subst("$UPLOAD_PORT")
+    env.AddCustomTarget(
+        name="uploadassets",
+        dependencies=None,
+        actions=['"$PYTHONEXE" "%s" %s write_partition --partition-name %s --input "%s"'
+                 % (parttool, '--port "%s"' % port if port else "", PARTITION_LABEL, image)],
+        title="Upload assets",
+        description="Write the static assets image to the assets partition",
+    )
+elif __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+"""Record the SensorLink raw UDP stream and report loss and throughput.
+
+Enable the stream on the device first, e.g.
+    curl -d "host=192.168.1.20&port=5005&enabled=1" http://sensorlink.local/udp
+or use a multicast group ("host=239.255.0.1") and pass --group here.
+
+Datagrams are PROTO_TYPE_RAW frames (see src/protocol.h): a 20-byte header, a uint32
+sample rate in Hz, then one little-endian uint16 millivolt value per channel per frame.
+Sequence numbers count frames, so a datagram of n frames starting at s is followed by
+one starting at s + n; anything else is counted as loss.
+"""
+
+import argparse
+import csv
+import socket
+import struct
+import sys
+import time
+
+PROTO_VERSION = 1
+PROTO_TYPE_RAW = 4
+HEADER = struct.Struct("<BBBBHHIqI")
+
+
+def channels_of(mask):
+    return [ch for ch in range(16) if mask & (1 << ch)]
+
+
+class Receiver:
+    def __init__(self, writer):
+        self.writer = writer
+        self.expected = None
+        self.packets = 0
+        self.bytes = 0
+        self.samples = 0
+        self.lost = 0
+        self.late = 0
+        self.malformed = 0
+        self.mask = None
+
+    def handle(self, data):
+        if len(data) < HEADER.size:
+            self.malformed += 1
+            return
+        version, ptype, _flags, count, mask, n, seq, t_us, rate = HEADER.unpack_from(data)
+        if version != PROTO_VERSION or ptype != PROTO_TYPE_RAW or len(data) < HEADER.size + 2 * count * n:
+            self.malformed += 1
+            return
+
+        self.packets += 1
+        self.bytes += len(data)
+
+        # Sequence numbers are uint32 and wrap. Late datagrams were already counted as lost.
+        if self.expected is not None and seq != self.expected:
+            gap = (seq - self.expected) & 0xFFFFFFFF
+            if gap < 0x80000000:
+                self.lost += gap
+            else:
+                self.late += 1
+                return
+        self.expected = (seq + n) & 0xFFFFFFFF
+        self.samples += n
+
+        if self.writer is not None:
+            if mask != self.mask:
+                self.mask = mask
+                self.writer.writerow(["seq", "t_us"] + ["ch%d" % ch for ch in channels_of(mask)])
+            values = struct.unpack_from("<%dH" % (count * n), data, HEADER.size)
+            for i in range(n):
+                self.writer.writerow([(seq + i) & 0xFFFFFFFF, t_us + i * 1000000 // rate] +
+                                     list(values[i * count:(i + 1) * count]))
+
+    def report(self, seconds, prefix=""):
+        total = self.samples + self.lost
+        print("%s%d packets, %.1f kB/s, %.1f samples/s, lost %d (%.3f%%), late %d, malformed %d" % (
+            prefix, self.packets, self.bytes / seconds / 1000, self.samples / seconds, self.lost,
+            100.0 * self.lost / total if total else 0.0, self.late, self.malformed))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=5005, help="UDP port (default 5005)")
+    parser.add_argument("--bind", default="0.0.0.0", help="local address to bind")
+    parser.add_argument("--group", help="multicast group to join, e.g. 239.255.0.1")
+    parser.add_argument("--out", help="write the samples to this CSV file")
+    parser.add_argument("--duration", type=float, help="stop after this many seconds")
+    parser.add_argument("--interval", type=float, default=1.0, help="seconds between reports")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 << 20)
+    sock.bind((args.bind, args.port))
+    if args.group:
+        mreq = struct.pack("4s4s", socket.inet_aton(args.group), socket.inet_aton("0.0.0.0"))
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+    sock.settimeout(0.2)
+
+    out = open(args.out, "w", newline="") if args.out else None
+    receiver = Receiver(csv.writer(out) if out else None)
+    interval = Receiver(None)
+
+    start = time.monotonic()
+    last = start
+    try:
+        while args.duration is None or time.monotonic() - start < args.duration:
+            try:
+                data = sock.recv(65536)
+            except socket.timeout:
+                data = None
+            if data:
+                receiver.handle(data)
+                interval.handle(data)
+
+            now = time.monotonic()
+            if now - last >= args.interval:
+                interval.report(now - last)
+                expected = interval.expected
+                interval = Receiver(None)
+                interval.expected = expected
+                last = now
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if out:
+            out.close()
+
+    receiver.report(max(time.monotonic() - start, 1e-3), "total: ")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())